@@ -111,8 +111,8 @@ bool ClawHumanView::VLoadGameDelegate(TiXmlElement* pLevelXmlElem, LevelData* pL
         return false;
     }
 
-    m_ScreenElements.push_back(m_pHUD);
-    m_ScreenElements.push_back(m_pIngameMenu);
+    m_ScreenElements.PushOnTop(m_pHUD);
+    m_ScreenElements.PushOnTop(m_pIngameMenu);
     m_pIngameMenu->VSetVisible(false);
 
     return true;
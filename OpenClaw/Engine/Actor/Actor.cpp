@@ -11,6 +11,8 @@ Actor::Actor(uint32 actorGUID)
     _GUID = actorGUID;
     _name = "Unknown";
     _resource = "Unknown";
+    m_ComponentsVersion = 0;
+    m_PrefabProto = ActorPrototype_None;
 }
 
 Actor::~Actor()
@@ -87,6 +89,7 @@ void Actor::AddComponent(StrongActorComponentPtr component)
         _components.insert(std::make_pair(component->VGetId(), component));
 
     assert(success.second);
+    m_ComponentsVersion++;
 }
 
 void Actor::OnWorldFinishedLoading()
@@ -96,6 +96,8 @@ public:
     const ActorComponentsMap* GetComponents() { return &_components; }
 
     void AddComponent(StrongActorComponentPtr pComponent);
+    // Changes whenever a component is added, lets caches of component pointers detect they are stale
+    uint32_t GetComponentsVersion() const { return m_ComponentsVersion; }
 
     void OnWorldFinishedLoading();
 
@@ -113,7 +115,11 @@ private:
     uint32_t _GUID;
     std::string _name;
 
+    // Set for actors spawned from prefab, they can be returned to its pool
+    ActorPrototype m_PrefabProto;
+
     ActorComponentsMap _components;
+    uint32_t m_ComponentsVersion;
 
     // Resource from which this actor was loaded
     std::string _resource;
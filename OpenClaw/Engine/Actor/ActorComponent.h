@@ -15,6 +15,7 @@
 class ActorComponent
 {
     friend class ActorFactory;
+    POOLED_ALLOCATION_DECLARATION()
 
 public:
     virtual ~ActorComponent() { m_pOwner.reset(); }
@@ -32,6 +33,15 @@ public:
     // For potential editor
     virtual TiXmlElement* VGenerateXml() { return NULL; }
 
+    // Copy of the component in the state VInit left it in, used by actor prefabs. Components which do not
+    // support it return NULL and actors which have them are always created from XML
+    virtual ActorComponent* VClone() const { return NULL; }
+
+    // Puts component of pooled prefab actor back to the state of prefab component before the actor is reused and
+    // post-initialized again. Scene nodes and physics bodies are kept. Returns false if it is not supported, such
+    // actors are destroyed instead of pooled
+    virtual bool VResetFromPrefab(const ActorComponent* pPrefabComponent) { return false; }
+
     // This function has to be be overriden by the interface class
     virtual const char* VGetName() const = 0;
 
@@ -44,6 +54,17 @@ public:
     virtual void VOnWorldFinishedLoading() { }
 
 protected:
+    // VResetFromPrefab of components whose state is fully restored by copying the prefab component
+    template <class ComponentType>
+    bool ResetFromPrefabCopy(const ActorComponent* pPrefabComponent)
+    {
+        StrongActorPtr pOwner = m_pOwner;
+        *static_cast<ComponentType*>(this) = *static_cast<const ComponentType*>(pPrefabComponent);
+        m_pOwner = pOwner;
+
+        return true;
+    }
+
     StrongActorPtr m_pOwner;
 
 private:
@@ -60,6 +60,9 @@
 #include "Components/EnemyAI/Aquatis/AquatisEncounter.h"
 #include "Components/EnemyAI/RedTail/RedTailEncounter.h"
 
+// Bounds memory kept by pools after bursts, e.g. many projectiles fired at once
+const uint32 MAX_POOLED_ACTORS_PER_PREFAB = 32;
+
 ActorFactory::ActorFactory()
 {
     _lastActorGUID = 0;
@@ -139,11 +142,18 @@ ActorFactory::ActorFactory()
     _componentFactory.Register<RedTailAIStateComponent>();
 }
 
+ActorFactory::~ActorFactory()
+{
+    ClearPrefabs();
+}
+
 StrongActorPtr ActorFactory::CreateActor(TiXmlElement* pActorRoot, TiXmlElement* overrides)
 {
     //PROFILE_CPU("Create actor");
+    TRACK_ALLOCATIONS(AllocTag_Actors);
     uint32 nextActorGUID = GetNextActorGUID();
-    StrongActorPtr actor(new Actor(nextActorGUID));
+    // Actor and its control block share one pooled allocation
+    StrongActorPtr actor = std::allocate_shared<Actor>(PoolAllocator<Actor>(), nextActorGUID);
     if (!actor->Init(pActorRoot))
     {
         LOG_ERROR("Failed to initialize actor.");
@@ -220,10 +230,175 @@ void ActorFactory::ModifyActor(StrongActorPtr actor, TiXmlElement* overrides)
     }
 }
 
+StrongActorPtr ActorFactory::CreateActorFromPrefab(ActorPrototype proto, const ActorPrefabOverrides& overrides)
+{
+    ActorPrefab& prefab = GetPrefab(proto);
+    if (!prefab.isCloneable)
+    {
+        return nullptr;
+    }
+
+    if (!prefab.pooledActors.empty())
+    {
+        StrongActorPtr actor = prefab.pooledActors.back();
+        prefab.pooledActors.pop_back();
+
+        // Components, scene node and physics body are kept, the rest is done by post-initialization as for clones
+        actor->_GUID = GetNextActorGUID();
+        if (overrides)
+        {
+            overrides(actor);
+        }
+
+        actor->PostInit();
+        actor->PostPostInit();
+
+        return actor;
+    }
+
+    TRACK_ALLOCATIONS(AllocTag_Actors);
+
+    std::vector<StrongActorComponentPtr> components;
+    components.reserve(prefab.pPrototypeActor->_components.size());
+    for (const auto& componentPair : prefab.pPrototypeActor->_components)
+    {
+        StrongActorComponentPtr component(componentPair.second->VClone(),
+            std::default_delete<ActorComponent>(), PoolAllocator<ActorComponent>());
+        if (!component)
+        {
+            // Found out on the first spawn, from now on this prototype goes through XML
+            LOG_WARNING("Component: " + std::string(componentPair.second->VGetName()) + " can not be cloned, " +
+                EnumToString_ActorPrototype(proto) + " will be created from XML");
+            prefab.isCloneable = false;
+            return nullptr;
+        }
+
+        components.push_back(component);
+    }
+
+    StrongActorPtr actor = std::allocate_shared<Actor>(PoolAllocator<Actor>(), GetNextActorGUID());
+    actor->_name = prefab.pPrototypeActor->_name;
+    actor->m_PrefabProto = proto;
+    for (StrongActorComponentPtr& component : components)
+    {
+        actor->AddComponent(component);
+        component->SetOwner(actor);
+    }
+
+    if (overrides)
+    {
+        overrides(actor);
+    }
+
+    actor->PostInit();
+    actor->PostPostInit();
+
+    return actor;
+}
+
+ActorFactory::ActorPrefab& ActorFactory::GetPrefab(ActorPrototype proto)
+{
+    auto findIt = m_PrefabMap.find(proto);
+    if (findIt != m_PrefabMap.end())
+    {
+        return findIt->second;
+    }
+
+    ActorPrefab& prefab = m_PrefabMap[proto];
+
+    // Parent prototypes are merged here, only once per prefab
+    std::unique_ptr<TiXmlElement> pActorRoot(g_pApp->GetActorPrototypeElem(proto));
+    prefab.pPrototypeActor = std::allocate_shared<Actor>(PoolAllocator<Actor>(), INVALID_ACTOR_ID);
+    prefab.pPrototypeActor->Init(pActorRoot.get());
+
+    for (TiXmlElement* node = pActorRoot->FirstChildElement(); node != NULL; node = node->NextSiblingElement())
+    {
+        StrongActorComponentPtr component = VCreateComponent(node);
+        if (!component)
+        {
+            LOG_ERROR("Failed to create prefab component from node: " + std::string(node->Value()));
+            prefab.isCloneable = false;
+            break;
+        }
+
+        prefab.pPrototypeActor->AddComponent(component);
+        component->SetOwner(prefab.pPrototypeActor);
+    }
+
+    return prefab;
+}
+
+StrongActorPtr ActorFactory::ReturnActorToPool(StrongActorPtr pActor)
+{
+    // Prefabs could have been cleared since the actor was spawned
+    auto findIt = m_PrefabMap.find(pActor->m_PrefabProto);
+    if (findIt == m_PrefabMap.end())
+    {
+        return nullptr;
+    }
+
+    ActorPrefab& prefab = findIt->second;
+    if (!prefab.isPoolable || prefab.pooledActors.size() >= MAX_POOLED_ACTORS_PER_PREFAB)
+    {
+        return nullptr;
+    }
+
+    const ActorComponentsMap& prefabComponents = prefab.pPrototypeActor->_components;
+    if (pActor->_components.size() != prefabComponents.size())
+    {
+        return nullptr;
+    }
+
+    for (const auto& componentPair : pActor->_components)
+    {
+        auto prefabComponentIt = prefabComponents.find(componentPair.first);
+        if (prefabComponentIt == prefabComponents.end() ||
+            !componentPair.second->VResetFromPrefab(prefabComponentIt->second.get()))
+        {
+            LOG_WARNING("Component: " + std::string(componentPair.second->VGetName()) + " can not be reset, " +
+                EnumToString_ActorPrototype(pActor->m_PrefabProto) + " will not be pooled");
+            prefab.isPoolable = false;
+            return nullptr;
+        }
+    }
+
+    // Returned actor is left without components, the same as destroyed actor
+    StrongActorPtr pPooledActor = std::allocate_shared<Actor>(PoolAllocator<Actor>(), pActor->_GUID);
+    pPooledActor->_name = pActor->_name;
+    pPooledActor->_resource = pActor->_resource;
+    pPooledActor->m_PrefabProto = pActor->m_PrefabProto;
+    pPooledActor->_components.swap(pActor->_components);
+    for (auto& componentPair : pPooledActor->_components)
+    {
+        componentPair.second->SetOwner(pPooledActor);
+    }
+    pActor->Destroy();
+
+    prefab.pooledActors.push_back(pPooledActor);
+
+    return pPooledActor;
+}
+
+void ActorFactory::ClearPrefabs()
+{
+    for (auto& prefabPair : m_PrefabMap)
+    {
+        prefabPair.second.pPrototypeActor->Destroy();
+        for (StrongActorPtr& pPooledActor : prefabPair.second.pooledActors)
+        {
+            pPooledActor->Destroy();
+        }
+    }
+
+    m_PrefabMap.clear();
+}
+
 StrongActorComponentPtr ActorFactory::VCreateComponent(TiXmlElement* data)
 {
     const char* name = data->Value();
-    StrongActorComponentPtr component(_componentFactory.Create(ActorComponent::GetIdFromName(name)));
+    // Component itself is pooled by ActorComponent::operator new, pool the control block too
+    StrongActorComponentPtr component(_componentFactory.Create(ActorComponent::GetIdFromName(name)),
+        std::default_delete<ActorComponent>(), PoolAllocator<ActorComponent>());
 
     // Initialize the component if we found one
     if (component)
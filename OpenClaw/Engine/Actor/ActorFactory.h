@@ -2,9 +2,13 @@
 #define ACTORFACTORY_H_
 
 #include <map>
+#include <functional>
 
 #include "ActorComponent.h"
 
+// Called on actor created from prefab before its components are post-initialized
+typedef std::function<void(StrongActorPtr)> ActorPrefabOverrides;
+
 //-------------------------------------------------------------------------------------------------
 // Actor factory
 //-------------------------------------------------------------------------------------------------
@@ -13,17 +17,45 @@ class ActorFactory
 {
 public:
     ActorFactory();
+    ~ActorFactory();
 
     StrongActorPtr CreateActor(TiXmlElement* pActorRoot, TiXmlElement* overrides);
     StrongActorPtr CreateActor(const char* actorResource, TiXmlElement* overrides);
     void ModifyActor(StrongActorPtr actor, TiXmlElement* overrides);
 
+    // Prefab is actor prototype resolved and initialized once, actors are then spawned by cloning its
+    // components. Returns NULL if any component of the prototype does not support cloning
+    StrongActorPtr CreateActorFromPrefab(ActorPrototype proto, const ActorPrefabOverrides& overrides);
+    // Actor spawned from prefab is kept in pool of the prefab instead of being destroyed, components are reset
+    // to the state of prefab by VResetFromPrefab. Pool keeps them in a new actor so that references to the returned
+    // one expire as if it was destroyed. Returns the pooled actor, NULL if the returned actor has to be destroyed
+    StrongActorPtr ReturnActorToPool(StrongActorPtr pActor);
+    // Prefab components reference resources of current level (physics, palette)
+    void ClearPrefabs();
+
     virtual StrongActorComponentPtr VCreateComponent(TiXmlElement* data);
 
 protected:
     GenericObjectFactory<ActorComponent, uint32_t> _componentFactory;
 
 private:
+    struct ActorPrefab
+    {
+        ActorPrefab() : isCloneable(true), isPoolable(true) { }
+
+        // Its components are initialized but never post-initialized
+        StrongActorPtr pPrototypeActor;
+        bool isCloneable;
+
+        // Returned actors, reused before any new clone is made
+        std::vector<StrongActorPtr> pooledActors;
+        bool isPoolable;
+    };
+
+    ActorPrefab& GetPrefab(ActorPrototype proto);
+
+    std::map<ActorPrototype, ActorPrefab> m_PrefabMap;
+
     uint32_t _lastActorGUID;
     uint32_t GetNextActorGUID() { ++_lastActorGUID; return _lastActorGUID; }
 };
@@ -3,6 +3,9 @@
 #include "../GameApp/BaseGameLogic.h"
 #include "../Events/EventMgr.h"
 #include "../Events/Events.h"
+#include "Components/PositionComponent.h"
+#include "Components/RenderComponent.h"
+#include "Components/AIComponents/ProjectileAIComponent.h"
 
 #include <time.h>
 
@@ -331,6 +334,19 @@ namespace ActorTemplates
         return pActor;
     }
 
+    // Returns NULL if the prototype can not be spawned from prefab and has to be created from XML
+    StrongActorPtr CreateAndReturnPrefabActor(ActorPrototype proto, const ActorPrefabOverrides& overrides)
+    {
+        StrongActorPtr pActor = g_pApp->GetGameLogic()->CreateActorFromPrefab(proto, overrides);
+        if (pActor)
+        {
+            shared_ptr<EventData_New_Actor> pNewActorEvent(new EventData_New_Actor(pActor->GetGUID()));
+            IEventMgr::Get()->VQueueEvent(pNewActorEvent);
+        }
+
+        return pActor;
+    }
+
     void ImageSetToWildcardImagePath(std::string& imageSet)
     {
         std::replace(imageSet.begin(), imageSet.end(), '_', '/');
@@ -1200,11 +1216,10 @@ namespace ActorTemplates
 
         pActorElem->LinkEndChild(CreateTriggerComponent(1, false, false));
 
-        srand((long)pActorElem + time(NULL));
-        double speedX = 0.5 + (rand() % 100) / 50.0;
-        double speedY = -(1 + (rand() % 100) / 50.0);
+        double speedX = 0.5 + Util::GetRandomNumber(0, 99) / 50.0;
+        double speedY = -(1 + Util::GetRandomNumber(0, 99) / 50.0);
 
-        if (rand() % 2 == 1) { speedX *= -1; }
+        if (Util::GetRandomNumber(0, 1) == 1) { speedX *= -1; }
 
         ActorBodyDef bodyDef;
         if (isStatic)
@@ -2122,11 +2137,43 @@ namespace ActorTemplates
 
     StrongActorPtr CreateActor(ActorPrototype proto, const Point& position)
     {
+        StrongActorPtr pActor = CreateAndReturnPrefabActor(proto, [&position](StrongActorPtr pPrefabActor)
+        {
+            pPrefabActor->GetRawComponent<PositionComponent>(true)->SetPosition((int)position.x, (int)position.y);
+        });
+        if (pActor)
+        {
+            return pActor;
+        }
+
         return CreateAndReturnActor(CreateXmlData_Actor(proto, position));
     }
 
     StrongActorPtr CreateActor_Projectile(ActorPrototype proto, const Point& position, Direction dir, int sourceActorId)
     {
+        // Same overrides as CreateXmlData_ProjectileActor applies to XML
+        StrongActorPtr pActor = CreateAndReturnPrefabActor(proto, [&](StrongActorPtr pPrefabActor)
+        {
+            pPrefabActor->GetRawComponent<PositionComponent>(true)->SetPosition((int)position.x, (int)position.y);
+
+            ProjectileAIComponent* pProjectileAIComponent = pPrefabActor->GetRawComponent<ProjectileAIComponent>(true);
+            pProjectileAIComponent->SetSourceActorId(sourceActorId);
+
+            if (dir == Direction_Left)
+            {
+                // XML stores the inverted speed as integers
+                Point projectileSpeed = pProjectileAIComponent->GetProjectileSpeed();
+                pProjectileAIComponent->SetProjectileSpeed(Point((int)(projectileSpeed.x * -1.0), (int)projectileSpeed.y));
+
+                ActorRenderComponent* pRenderComponent = pPrefabActor->GetRawComponent<ActorRenderComponent>(true);
+                pRenderComponent->SetMirrored(!pRenderComponent->IsMirrored());
+            }
+        });
+        if (pActor)
+        {
+            return pActor;
+        }
+
         return CreateAndReturnActor(CreateXmlData_ProjectileActor(proto, position, dir, sourceActorId));
     }
 
@@ -101,7 +101,7 @@ void CrumblingPegAIComponent::ClawDiedDelegate(IEventDataPtr pEventData)
 
     auto pARC = MakeStrongPtr(m_pOwner->GetComponent<ActorRenderComponent>(ActorRenderComponent::g_Name));
     pARC->SetVisible(true);
-    pARC->SetImage(pAnimationComponent->GetCurrentAnimation()->GetCurrentAnimationFrame()->imageName);
+    pARC->SetImage(pAnimationComponent->GetCurrentAnimation()->GetCurrentAnimationFrame()->imageId);
 
     m_pPhysics->VActivate(m_pOwner->GetGUID());
 }
\ No newline at end of file
@@ -117,6 +117,18 @@ void ProjectileAIComponent::VPostInit()
     }
 }
 
+bool ProjectileAIComponent::VResetFromPrefab(const ActorComponent* pPrefabComponent)
+{
+    // Sparkles are created again in VPostInit
+    for (const auto &pSparkle : m_PowerupSparkles)
+    {
+        shared_ptr<EventData_Destroy_Actor> pEvent(new EventData_Destroy_Actor(pSparkle->GetGUID()));
+        IEventMgr::Get()->VQueueEvent(pEvent);
+    }
+
+    return ResetFromPrefabCopy<ProjectileAIComponent>(pPrefabComponent);
+}
+
 TiXmlElement* ProjectileAIComponent::VGenerateXml()
 {
     TiXmlElement* baseElement = new TiXmlElement(VGetName());
@@ -21,6 +21,12 @@ public:
 
     virtual bool VInit(TiXmlElement* data) override;
     virtual TiXmlElement* VGenerateXml() override;
+    virtual ActorComponent* VClone() const override { return new ProjectileAIComponent(*this); }
+    virtual bool VResetFromPrefab(const ActorComponent* pPrefabComponent) override;
+
+    void SetSourceActorId(int sourceActorId) { m_SourceActorId = sourceActorId; }
+    const Point& GetProjectileSpeed() const { return m_ProjectileSpeed; }
+    void SetProjectileSpeed(const Point& projectileSpeed) { m_ProjectileSpeed = projectileSpeed; }
 
     void OnCollidedWithSolidTile();
     void OnCollidedWithActor(Actor* pActorWhoWasShot);
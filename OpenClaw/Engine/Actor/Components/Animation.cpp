@@ -8,8 +8,13 @@
 #include "../../Events/EventMgr.h"
 #include "../../Events/Events.h"
 
+// Index 0 is the empty "no event" name
+static std::vector<std::string> g_FrameEventNames(1);
+static std::unordered_map<std::string, uint32> g_FrameEventIds;
+
 Animation::Animation() :
     _name("Unknown"),
+    _currentFrameIdx(0),
     _currentTime(0),
     _delay(0),
     _paused(false),
@@ -23,6 +28,27 @@ Animation::~Animation()
     _animationFrames.clear();
 }
 
+uint32 Animation::InternFrameEvent(const std::string& eventName)
+{
+    auto findIt = g_FrameEventIds.find(eventName);
+    if (findIt != g_FrameEventIds.end())
+    {
+        return findIt->second;
+    }
+
+    uint32 eventId = g_FrameEventNames.size();
+    g_FrameEventNames.push_back(eventName);
+    g_FrameEventIds.insert(std::make_pair(eventName, eventId));
+
+    return eventId;
+}
+
+const std::string& Animation::GetFrameEventName(uint32 eventId)
+{
+    assert(eventId < g_FrameEventNames.size());
+    return g_FrameEventNames[eventId];
+}
+
 std::shared_ptr<Animation> Animation::CreateAnimation(WapAni* wapAni, const char* animationName, const char* resourcePath, AnimationComponent* owner)
 {
     std::shared_ptr<Animation> animation{new Animation()};
@@ -70,7 +96,6 @@ bool Animation::Initialize(WapAni* wapAni, const char* animationName, const char
         AnimationFrame animFrame;
         animFrame.idx = frameIdx;
         animFrame.imageId = aniAnimFrames[frameIdx].imageFileId;
-        animFrame.imageName = "frame" + Util::ConvertToThreeDigitsString(animFrame.imageId);
         animFrame.duration = aniAnimFrames[frameIdx].duration;
          
         // if pWapAni->unk0 == 1, then skip all sounds in this animation
@@ -106,13 +131,7 @@ bool Animation::Initialize(WapAni* wapAni, const char* animationName, const char
 
             //LOG("Sound: " + soundPath);
 
-            animFrame.hasEvent = true;
-            animFrame.eventName = soundPath;
-        }
-        else
-        {
-            animFrame.hasEvent = false;
-            animFrame.eventName = "";
+            animFrame.eventId = InternFrameEvent(soundPath);
         }
 
         // HACK: For specific reason, dynamite jump throw takes too long
@@ -130,7 +149,7 @@ bool Animation::Initialize(WapAni* wapAni, const char* animationName, const char
         return false;
     }
 
-    _currentAnimationFrame = _animationFrames[0];
+    _currentFrameIdx = 0;
 
     return true;
 }
@@ -147,7 +166,7 @@ bool Animation::Initialize(const std::vector<AnimationFrame> &animFrames, const
     m_pOwner = owner;
     _animationFrames = animFrames;
 
-    _currentAnimationFrame = _animationFrames[0];
+    _currentFrameIdx = 0;
 
     return true;
 }
@@ -160,10 +179,7 @@ bool Animation::Initialize(int numAnimFrames, int animFrameTime, const char* ani
         AnimationFrame animFrame;
         animFrame.idx = frameIdx;
         animFrame.imageId = frameIdx + 1;
-        animFrame.imageName = "frame" + Util::ConvertToThreeDigitsString(animFrame.imageId);
         animFrame.duration = animFrameTime;
-        animFrame.hasEvent = false;
-        animFrame.eventName = "";
 
         _animationFrames.push_back(animFrame);
     }
@@ -176,7 +192,7 @@ bool Animation::Initialize(int numAnimFrames, int animFrameTime, const char* ani
         return false;
     }
 
-    _currentAnimationFrame = _animationFrames[0];
+    _currentFrameIdx = 0;
 
     return true;
 }
@@ -203,25 +219,27 @@ void Animation::Update(uint32 msDiff)
         }
     }
 
+    AnimationFrame* pCurrentFrame = &_animationFrames[_currentFrameIdx];
+
     // Hack for now
-    if (_currentAnimationFrame.hasEvent)
+    if (pCurrentFrame->HasEvent())
     {
-        if (_currentAnimationFrame.idx == 0 && _currentTime == 0)
+        if (_currentFrameIdx == 0 && _currentTime == 0)
         {
-            PlayFrameSound(_currentAnimationFrame.eventName);
+            PlayFrameSound(pCurrentFrame->eventId);
         }
     }
 
     _currentTime += msDiff;
 
-    int32 currentFrameDuration = _currentAnimationFrame.duration;
+    int32 currentFrameDuration = pCurrentFrame->duration;
     if (_currentTime >= currentFrameDuration)
     {
         _currentTime = _currentTime - currentFrameDuration;
 
         if (m_pOwner)
         {
-            m_pOwner->OnAnimationFrameFinished(&_currentAnimationFrame);
+            m_pOwner->OnAnimationFrameFinished(pCurrentFrame);
         }
 
         SetNextFrame();
@@ -230,7 +248,7 @@ void Animation::Update(uint32 msDiff)
 
 void Animation::Reset()
 {
-    _currentAnimationFrame = _animationFrames[0];
+    _currentFrameIdx = 0;
     _delay = 0;
     _currentTime = 0;
     _paused = false;
@@ -244,12 +262,12 @@ void Animation::SetNextFrame()
     // Certain animations play in loop while being reversed - e.g.: 0,1,2,3,4,3,2,1,0,1,....
     if (_reversed)
     {
-        if (_currentAnimationFrame.idx == (_animationFrames.size() - 1))
+        if (_currentFrameIdx == (_animationFrames.size() - 1))
         {
             _isBeingReversed = true;
             looped = true;
         }
-        else if (_isBeingReversed && _currentAnimationFrame.idx == 0)
+        else if (_isBeingReversed && _currentFrameIdx == 0)
         {
             _isBeingReversed = false;
             looped = true;
@@ -262,7 +280,7 @@ void Animation::SetNextFrame()
             looped = true;
         }
         // If next frame will be last
-        else if (_currentAnimationFrame.idx + 2 == _animationFrames.size())
+        else if (_currentFrameIdx + 2 == _animationFrames.size())
         {
             m_pOwner->OnAnimationAtLastFrame();
         }
@@ -271,25 +289,30 @@ void Animation::SetNextFrame()
     int32 delta = 0;
     _isBeingReversed ? delta-- : delta++;
 
-    AnimationFrame* lastAnimFrame = &_animationFrames[_currentAnimationFrame.idx];
-    _currentAnimationFrame = _animationFrames[(_currentAnimationFrame.idx + delta) % countAnimationFrames];    
+    AnimationFrame* lastAnimFrame = &_animationFrames[_currentFrameIdx];
+    _currentFrameIdx = (_currentFrameIdx + delta) % countAnimationFrames;
+    AnimationFrame* pCurrentFrame = &_animationFrames[_currentFrameIdx];
 
-    m_pOwner->OnAnimationFrameStarted(&_currentAnimationFrame);
+    m_pOwner->OnAnimationFrameStarted(pCurrentFrame);
 
-    m_pOwner->OnAnimationFrameChanged(lastAnimFrame, &_currentAnimationFrame);
+    m_pOwner->OnAnimationFrameChanged(lastAnimFrame, pCurrentFrame);
     if (looped)
     {
         m_pOwner->OnAnimationLooped();
     }
 
-    if (_currentAnimationFrame.idx != 0 && _currentAnimationFrame.hasEvent)
+    // Listeners may have changed the frame
+    pCurrentFrame = &_animationFrames[_currentFrameIdx];
+    if (_currentFrameIdx != 0 && pCurrentFrame->HasEvent())
     {
-        PlayFrameSound(_currentAnimationFrame.eventName);
+        PlayFrameSound(pCurrentFrame->eventId);
     }
 }
 
-void Animation::PlayFrameSound(const std::string& sound)
+void Animation::PlayFrameSound(uint32 eventId)
 {
+    const std::string& sound = GetFrameEventName(eventId);
+
     assert(m_pOwner && m_pOwner->m_pOwner && m_pOwner->m_pOwner->GetPositionComponent());
 
     //LOG("Sound: " + sound + ", Owner: " + m_pOwner->m_pOwner->GetName());
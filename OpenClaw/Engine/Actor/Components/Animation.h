@@ -7,24 +7,26 @@
 #include <libwap.h>
 
 class Image;
+
+// Frames are resolved when animation is loaded so that stepping through them involves no string work.
+// Image is referenced by imageId which render components map directly to their "frameXXX" image,
+// frame event (sound) is interned, see Animation::GetFrameEventName
 struct AnimationFrame
 {
     AnimationFrame()
     {
         imageId = 0;
-        imageName = "";
         idx = 0;
         duration = 0;
-        eventName = "";
-        hasEvent = false;
+        eventId = 0;
     }
 
+    bool HasEvent() const { return eventId != 0; }
+
     uint32 imageId;
-    std::string imageName;
     uint32 idx;
     uint32 duration;
-    std::string eventName;
-    bool hasEvent;
+    uint32 eventId;
 };
 
 // AnimationComponent and Animation are tightly coupled together
@@ -41,12 +43,16 @@ public:
 
     inline std::string GetName() const { return _name; }
 
-    AnimationFrame* GetCurrentAnimationFrame() { return &_currentAnimationFrame; }
+    // Returns ID of the event, 0 is reserved for no event
+    static uint32 InternFrameEvent(const std::string& eventName);
+    static const std::string& GetFrameEventName(uint32 eventId);
+
+    AnimationFrame* GetCurrentAnimationFrame() { return &_animationFrames[_currentFrameIdx]; }
 
     void Update(uint32 msDiff);
     void Reset();
     void SetNextFrame();
-    void SetAnimationFrame(int idx) { assert(idx < (int)_animationFrames.size()); _currentAnimationFrame = _animationFrames[idx]; }
+    void SetAnimationFrame(int idx) { assert(idx < (int)_animationFrames.size()); _currentFrameIdx = idx; }
 
     void Pause() { _paused = true; }
     void Resume() { _paused = false; }
@@ -56,8 +62,8 @@ public:
 
     const std::vector<AnimationFrame>& GetAnimFrames() const { return _animationFrames; }
     uint32 GetAnimFramesSize() const { return _animationFrames.size(); }
-    bool IsAtLastAnimFrame() const { return _currentAnimationFrame.idx + 1 == _animationFrames.size(); }
-    bool IsAtFirstAnimFrame() const { return _currentAnimationFrame.idx == 0; }
+    bool IsAtLastAnimFrame() const { return _currentFrameIdx + 1 == _animationFrames.size(); }
+    bool IsAtFirstAnimFrame() const { return _currentFrameIdx == 0; }
     bool IsPaused() const { return _paused; }
 
     const AnimationComponent* GetOwnerComponent() const { return m_pOwner; }
@@ -71,10 +77,11 @@ private:
     bool Initialize(const std::vector<AnimationFrame> &animFrames, const char* animationName, AnimationComponent* owner);
     bool Initialize(int numAnimFrames, int animFrameTime, const char* animName, AnimationComponent* owner);
 
-    void PlayFrameSound(const std::string& sound);
+    void PlayFrameSound(uint32 eventId);
 
     std::string _name;
-    AnimationFrame _currentAnimationFrame;
+    // Frame advance only moves this index
+    uint32 _currentFrameIdx;
     int32 _currentTime;
     int32 _delay;
     bool _paused;
@@ -99,6 +99,59 @@ bool AnimationComponent::VInit(TiXmlElement* data)
     return true;
 }
 
+ActorComponent* AnimationComponent::VClone() const
+{
+    AnimationComponent* pClone = new AnimationComponent();
+    pClone->m_PauseOnStart = m_PauseOnStart;
+    pClone->m_PauseOnEnd = m_PauseOnEnd;
+    pClone->m_SpecialAnimationRequestList = m_SpecialAnimationRequestList;
+    pClone->m_SpecialAnimationList = m_SpecialAnimationList;
+
+    // Animations keep playback state and point back to their component, each clone needs its own
+    for (const auto& animPair : _animationMap)
+    {
+        std::shared_ptr<Animation> pAnimation =
+            Animation::CreateAnimation(animPair.second->GetAnimFrames(), animPair.second->GetName().c_str(), pClone);
+        assert(pAnimation);
+
+        pClone->_animationMap.insert(std::make_pair(animPair.first, pAnimation));
+    }
+
+    return pClone;
+}
+
+bool AnimationComponent::VResetFromPrefab(const ActorComponent* pPrefabComponent)
+{
+    const AnimationComponent* pPrefab = static_cast<const AnimationComponent*>(pPrefabComponent);
+
+    // Observers register themselves again in VPostInit
+    RemoveAllObservers();
+
+    // Special animations are created in VPostInit, animations of prefab are only rewound
+    for (auto animIt = _animationMap.begin(); animIt != _animationMap.end();)
+    {
+        if (pPrefab->_animationMap.count(animIt->first) == 0)
+        {
+            animIt = _animationMap.erase(animIt);
+            continue;
+        }
+
+        animIt->second->Reset();
+        animIt->second->SetReverseAnim(false);
+        ++animIt;
+    }
+
+    if (_animationMap.size() != pPrefab->_animationMap.size())
+    {
+        return false;
+    }
+
+    _currentAnimation.reset();
+    m_pActorRenderComponent.reset();
+
+    return true;
+}
+
 void AnimationComponent::VPostInit()
 {
     shared_ptr<ActorRenderComponent> pRenderComponent = MakeStrongPtr(m_pOwner->GetComponent<ActorRenderComponent>());
@@ -149,8 +202,7 @@ void AnimationComponent::VPostInit()
             // This hack is specific to Toggle pegs which set their on delay
             if (cycleDuration != 75 && cycleDuration != 50 && cycleDuration != 99)
             {
-                srand(pPositionComponent->GetX());
-                pCycleAnim->SetDelay(rand() % 1000);
+                pCycleAnim->SetDelay(Util::GetSeededRandomNumber((uint32)pPositionComponent->GetX(), 0, 999));
             }
 
             _animationMap.insert(std::make_pair(animType, pCycleAnim));
@@ -196,8 +248,7 @@ void AnimationComponent::VPostInit()
                     continue;
                 }
 
-                srand(pPositionComponent->GetX());
-                pCycleAnim->SetDelay(rand() % 1000);
+                pCycleAnim->SetDelay(Util::GetSeededRandomNumber((uint32)pPositionComponent->GetX(), 0, 999));
             }
 
             _animationMap.insert(std::make_pair(specialAnim.type, pCycleAnim));
@@ -324,7 +375,7 @@ void AnimationComponent::OnAnimationFrameStarted(AnimationFrame* frame)
     shared_ptr<ActorRenderComponent> renderComponent = MakeStrongPtr(m_pActorRenderComponent);
     if (renderComponent)
     {
-        renderComponent->SetImage(frame->imageName);
+        renderComponent->SetImage(frame->imageId);
     }
     else
     {
@@ -24,6 +24,7 @@ public:
     void NotifyAnimationEndedDelay(Animation* pAnimation);
     void AddObserver(AnimationObserver* pObserver);
     void RemoveObserver(AnimationObserver* pObserver);
+    void RemoveAllObservers() { m_AnimationObservers.clear(); }
 
 private:
     std::vector<AnimationObserver*> m_AnimationObservers;
@@ -72,6 +73,8 @@ public:
 
     virtual bool VInit(TiXmlElement* data) override;
     virtual TiXmlElement* VGenerateXml() override;
+    virtual ActorComponent* VClone() const override;
+    virtual bool VResetFromPrefab(const ActorComponent* pPrefabComponent) override;
 
     virtual void VPostInit() override;
 
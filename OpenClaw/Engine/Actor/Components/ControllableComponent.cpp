@@ -158,7 +158,6 @@ void ClawControllableComponent::VPostInit()
             AnimationFrame frame;
             frame.idx = i;
             frame.imageId = climbImageId;
-            frame.imageName = "frame" + ToStr(climbImageId);
             frame.duration = 55;
             climbAnimFrames.push_back(frame);
         }
@@ -175,7 +174,6 @@ void ClawControllableComponent::VPostInit()
             AnimationFrame frame;
             frame.idx = i;
             frame.imageId = climbImageId;
-            frame.imageName = "frame" + ToStr(climbImageId);
             frame.duration = 55;
             climbAnimFrames.push_back(frame);
         }
@@ -188,7 +186,6 @@ void ClawControllableComponent::VPostInit()
         AnimationFrame frame;
         frame.idx = 0;
         frame.imageId = 100;
-        frame.imageName = "frame100";
         frame.duration = 500;
         std::vector<AnimationFrame> freezeAnimFrames = {frame};
 
@@ -201,7 +198,6 @@ void ClawControllableComponent::VPostInit()
         AnimationFrame frame;
         frame.idx = 0;
         frame.imageId = 401;
-        frame.imageName = "frame401";
         frame.duration = 2000;
         std::vector<AnimationFrame> highFallAnimFrames = {frame};
 
@@ -540,7 +536,7 @@ void ClawControllableComponent::OnAttack()
         }
         else
         {
-            int attackType = rand() % 5;
+            int attackType = Util::GetRandomNumber(0, 4);
             if (attackType == 0)
             {
                 m_pClawAnimationComponent->SetAnimation("kick");
@@ -806,9 +802,9 @@ void ClawControllableComponent::VOnAnimationFrameChanged(Animation* pAnimation,
     }
 
     // Shooting, only magic and pistol supported at the moment
-    if (((animName.find("pistol") != std::string::npos) && pNewFrame->hasEvent) ||
-        ((animName.find("magic") != std::string::npos) && pNewFrame->hasEvent) ||
-        ((animName.find("dynamite") != std::string::npos) && pNewFrame->hasEvent))
+    if (((animName.find("pistol") != std::string::npos) && pNewFrame->HasEvent()) ||
+        ((animName.find("magic") != std::string::npos) && pNewFrame->HasEvent()) ||
+        ((animName.find("dynamite") != std::string::npos) && pNewFrame->HasEvent()))
     {
         if (m_pAmmoComponent->CanFire())
         {
@@ -890,7 +886,7 @@ void ClawControllableComponent::VOnAnimationFrameChanged(Animation* pAnimation,
             animName == "jumpswipe" ||
             animName == "duckswipe"))
     {
-        if (pAnimation->GetCurrentAnimationFrame()->hasEvent ||
+        if (pAnimation->GetCurrentAnimationFrame()->HasEvent() ||
             (animName == "swipe" && pNewFrame->idx == 3))
         {
             Point position = m_pPositionComponent->GetPosition();
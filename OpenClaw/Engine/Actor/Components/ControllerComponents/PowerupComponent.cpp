@@ -43,6 +43,11 @@ void PowerupComponent::VPostInit()
     {
         BroadcastPowerupStatusUpdated(m_pOwner->GetGUID(), m_ActivePowerup, false);
         BroadcastPowerupTimeUpdated(m_pOwner->GetGUID(), m_ActivePowerup, m_RemainingPowerupTime);
+
+        if (m_ActivePowerup == PowerupType_Invisibility)
+        {
+            SetOwnerPaletteVariant(ImagePaletteVariant_Ghost);
+        }
     }
 
     // Create powerup sparkles. Is this a good place ?
@@ -90,6 +95,7 @@ void PowerupComponent::VUpdate(uint32 msDiff)
             m_RemainingPowerupTime = 0;
 
             SetPowerupSparklesVisibility(false);
+            SetOwnerPaletteVariant(ImagePaletteVariant_None);
         }
         else if (oldSecsRemaining != currentSecsRemainig)
         {
@@ -106,6 +112,7 @@ void PowerupComponent::ApplyPowerup(PowerupType powerupType, int32 msDuration)
         {
             // Clear internal state
             SetPowerupSparklesVisibility(false);
+            SetOwnerPaletteVariant(ImagePaletteVariant_None);
         }
 
         m_ActivePowerup = powerupType;
@@ -119,6 +126,10 @@ void PowerupComponent::ApplyPowerup(PowerupType powerupType, int32 msDuration)
         {
             SetPowerupSparklesVisibility(true);
         }
+        else if (m_ActivePowerup == PowerupType_Invisibility)
+        {
+            SetOwnerPaletteVariant(ImagePaletteVariant_Ghost);
+        }
     }
 }
 
@@ -134,6 +145,16 @@ void PowerupComponent::SetPowerupSparklesVisibility(bool visible)
     }
 }
 
+void PowerupComponent::SetOwnerPaletteVariant(ImagePaletteVariant variant)
+{
+    shared_ptr<ActorRenderComponent> pRenderComponent =
+        MakeStrongPtr(m_pOwner->GetComponent<ActorRenderComponent>(ActorRenderComponent::g_Name));
+    if (pRenderComponent)
+    {
+        pRenderComponent->SetPaletteVariant(variant);
+    }
+}
+
 void PowerupComponent::BroadcastPowerupTimeUpdated(uint32 actorId, PowerupType powerupType, int32 secondsRemaining)
 {
     shared_ptr<EventData_Updated_Powerup_Time> pEvent(new EventData_Updated_Powerup_Time(actorId, powerupType, secondsRemaining));
@@ -156,6 +177,7 @@ void PowerupComponent::ClawDiedDelegate(IEventDataPtr pEventData)
 
         m_RemainingPowerupTime = 0;
         SetPowerupSparklesVisibility(false);
+        SetOwnerPaletteVariant(ImagePaletteVariant_None);
         m_ActivePowerup = PowerupType_None;
     }
 }
@@ -3,6 +3,7 @@
 
 #include "../../ActorComponent.h"
 #include "../../../Util/Subject.h"
+#include "../../../Graphics2D/Image.h"
 
 typedef std::map<AmmoType, uint32> AmmoMap;
 
@@ -45,6 +46,8 @@ private:
     void BroadcastPowerupStatusUpdated(uint32 actorId, PowerupType powerupType, bool isPowerupFinished);
 
     void SetPowerupSparklesVisibility(bool visible);
+    // Invisible owner is drawn with its ghost palette variant
+    void SetOwnerPaletteVariant(ImagePaletteVariant variant);
 
     int32 m_RemainingPowerupTime;
     PowerupType m_ActivePowerup;
@@ -144,8 +144,7 @@ void DestroyableComponent::VOnHealthBelowZero(DamageType damageType, int sourceA
     if (!m_PossibleDestructionSounds.empty())
     {
         // Pick random death sound
-        srand((long)this + (long)&m_PossibleDestructionSounds);
-        int soundToPlayIdx = rand() % m_PossibleDestructionSounds.size();
+        int soundToPlayIdx = Util::GetRandomNumber(0, m_PossibleDestructionSounds.size() - 1);
 
         // And play it
         SoundInfo soundInfo(m_PossibleDestructionSounds[soundToPlayIdx]);
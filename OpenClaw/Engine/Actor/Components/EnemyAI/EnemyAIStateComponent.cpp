@@ -9,6 +9,7 @@
 #include "../../../GameApp/BaseGameLogic.h"
 #include "../../../GameApp/BaseGameApp.h"
 #include "../../../Physics/ClawPhysics.h"
+#include "../../../Physics/NavigationMap.h"
 #include "../ControllableComponent.h"
 
 #include "../../../Events/EventMgr.h"
@@ -149,17 +150,11 @@ bool BaseEnemyAIStateComponent::IsActorWithinLOS(Actor* pActor)
         return false;
     }
 
-    RaycastResult raycastResult = g_pApp->GetGameLogic()->VGetGamePhysics()->VRayCast(
-        fromPoint,
-        toPoint,
-        CollisionFlag_Solid);
-    if (raycastResult.foundIntersection)
-    {
-        // Vision is obstructed
-        return false;
-    }
+    // Only static tiles are solid, navigation map knows all of them
+    NavigationMap* pNavigationMap = g_pApp->GetGameLogic()->GetNavigationMap();
+    assert(pNavigationMap != NULL);
 
-    return true;
+    return pNavigationMap->IsLineOfSight(fromPoint, toPoint, CollisionFlag_Solid);
 }
 
 //=====================================================================================================================
@@ -534,8 +529,21 @@ void PatrolEnemyAIStateComponent::VOnAnimationLooped(Animation* pAnimation)
     }
 }
 
-double PatrolEnemyAIStateComponent::FindClosestHole(const Point &center, int height, float maxSearchDistance)
+double PatrolEnemyAIStateComponent::FindClosestHole(const Point &center, int height, float maxSearchDistance,
+    const NavigationMap* pNavigationMap)
 {
+    if (pNavigationMap)
+    {
+        int holeOffset = 0;
+        if (pNavigationMap->FindClosestHole((int)center.x, (int)center.y, (int)center.y + height,
+            (int)maxSearchDistance, (CollisionFlag_Solid | CollisionFlag_Ground), holeOffset))
+        {
+            return holeOffset;
+        }
+
+        return 0.0;
+    }
+
     double leftDelta = 0.0;
     for (leftDelta = 0.0; leftDelta < fabs(maxSearchDistance); leftDelta += 1.0)
     {
@@ -565,22 +573,52 @@ void PatrolEnemyAIStateComponent::CalculatePatrolBorders()
 
     Point center = m_pPositionComponent->GetPosition();
 
-    Point toLeftRay = Point(center.x - 10000, center.y);
-    Point toRightRay = Point(center.x + 10000, center.y);
+    // Navigation map knows only tiles, units which stand on something else (e.g. elevator) have to use raycasts
+    NavigationMap* pNavigationMap = g_pApp->GetGameLogic()->GetNavigationMap();
+    if (pNavigationMap && !pNavigationMap->HasFloor((int)center.x, (int)center.y, (int)center.y + aabb.h,
+        (CollisionFlag_Solid | CollisionFlag_Ground)))
+    {
+        pNavigationMap = NULL;
+    }
 
-    RaycastResult raycastResultLeft = m_pPhysics->VRayCast(center, toLeftRay, CollisionFlag_Solid | CollisionFlag_Ground);
-    RaycastResult raycastResultRight = m_pPhysics->VRayCast(center, toRightRay, CollisionFlag_Solid | CollisionFlag_Ground);
+    RaycastResult raycastResultLeft;
+    RaycastResult raycastResultRight;
+    if (pNavigationMap)
+    {
+        int wallOffset = 0;
+        if (pNavigationMap->FindClosestWall((int)center.x, (int)center.y, -10000, (CollisionFlag_Solid | CollisionFlag_Ground), wallOffset))
+        {
+            raycastResultLeft.foundIntersection = true;
+            raycastResultLeft.deltaX = (float)wallOffset;
+        }
+        if (pNavigationMap->FindClosestWall((int)center.x, (int)center.y, 10000, (CollisionFlag_Solid | CollisionFlag_Ground), wallOffset))
+        {
+            raycastResultRight.foundIntersection = true;
+            raycastResultRight.deltaX = (float)wallOffset;
+        }
+    }
+    else
+    {
+        std::vector<RaycastQuery> queries;
+        queries.push_back(RaycastQuery(center, Point(center.x - 10000, center.y), CollisionFlag_Solid | CollisionFlag_Ground));
+        queries.push_back(RaycastQuery(center, Point(center.x + 10000, center.y), CollisionFlag_Solid | CollisionFlag_Ground));
+
+        std::vector<RaycastResult> results;
+        m_pPhysics->VRayCastBatch(queries, results);
+        raycastResultLeft = results[0];
+        raycastResultRight = results[1];
+    }
 
     if (!raycastResultLeft.foundIntersection)
     {
-        LOG_WARNING("Did not find raycastResultLeft intersection for actor: " + m_pOwner->GetName() +
+        LOG_CATEGORY(LogCategory_AI, LogLevel_Warning, "Did not find raycastResultLeft intersection for actor: " + m_pOwner->GetName() +
             " with position: " + m_pOwner->GetPositionComponent()->GetPosition().ToString());
         // Dummy large value, should be sufficient
         raycastResultLeft.deltaX = center.x - 10000;
     }
     if (!raycastResultRight.foundIntersection)
     {
-        LOG_WARNING("Did not find raycastResultRight intersection for actor: " + m_pOwner->GetName() +
+        LOG_CATEGORY(LogCategory_AI, LogLevel_Warning, "Did not find raycastResultRight intersection for actor: " + m_pOwner->GetName() +
             " with position: " + m_pOwner->GetPositionComponent()->GetPosition().ToString());
         // Dummy large value, should be sufficient
         raycastResultRight.deltaX = center.x + 10000;
@@ -589,7 +627,7 @@ void PatrolEnemyAIStateComponent::CalculatePatrolBorders()
     double patrolLeftBorder = 0.0;
     double patrolRightBorder = 0.0;
 
-    double leftDelta = FindClosestHole(center, aabb.h, raycastResultLeft.deltaX);
+    double leftDelta = FindClosestHole(center, aabb.h, raycastResultLeft.deltaX, pNavigationMap);
     if (fabs(leftDelta) < DBL_EPSILON)
     {
         patrolLeftBorder = center.x + raycastResultLeft.deltaX;
@@ -599,7 +637,7 @@ void PatrolEnemyAIStateComponent::CalculatePatrolBorders()
         patrolLeftBorder = center.x + leftDelta;
     }
 
-    double rightDelta = FindClosestHole(center, aabb.h, raycastResultRight.deltaX);
+    double rightDelta = FindClosestHole(center, aabb.h, raycastResultRight.deltaX, pNavigationMap);
     if (fabs(rightDelta) < DBL_EPSILON)
     {
         patrolRightBorder = center.x + raycastResultRight.deltaX;
@@ -646,14 +684,14 @@ void PatrolEnemyAIStateComponent::CalculatePatrolBorders()
 
     if (m_LeftPatrolBorder <= 0)
     {
-        LOG_ERROR("Invalid left patrol border for actor: " + m_pOwner->GetName() + ". Setting to AlwaysIdle.");
+        LOG_CATEGORY(LogCategory_AI, LogLevel_Error, "Invalid left patrol border for actor: " + m_pOwner->GetName() + ". Setting to AlwaysIdle.");
         m_IsAlwaysIdle = true;
         m_bRetainDirection = true;
         //assert(m_LeftPatrolBorder > 0);
     }
     if (m_RightPatrolBorder <= 0)
     {
-        LOG_ERROR("Invalid right patrol border for actor: " + m_pOwner->GetName() + ". Setting to AlwaysIdle.");
+        LOG_CATEGORY(LogCategory_AI, LogLevel_Error, "Invalid right patrol border for actor: " + m_pOwner->GetName() + ". Setting to AlwaysIdle.");
         m_IsAlwaysIdle = true;
         m_bRetainDirection = true;
         //assert(m_RightPatrolBorder > 0);
@@ -1026,8 +1064,6 @@ void BaseAttackAIStateComponent::VExecuteAttack()
         m_pRenderComponent->SetMirrored(true);
     }
 
-    srand((long)this + time(NULL));
-
     // TODO: Pick randomly melee action ?
 
     m_pAnimationComponent->SetAnimation(m_AttackActions[m_CurrentAttackActionIdx]->animation);
@@ -1121,7 +1157,7 @@ void BaseAttackAIStateComponent::OnEnemyLeftAgroRange(Actor* pEnemy)
         }
     }
 
-    LOG_WARNING("Could not remove enemy - no such actor found");
+    LOG_CATEGORY(LogCategory_AI, LogLevel_Warning, "Could not remove enemy - no such actor found");
 }
 
 Actor* BaseAttackAIStateComponent::FindClosestHostileActor()
@@ -1189,7 +1225,7 @@ bool BaseAttackAIStateComponent::VCanEnter()
     Point toPoint(m_EnemyAgroList[0]->GetPositionComponent()->GetPosition().x,
             m_pOwner->GetPositionComponent()->GetPosition().y + action.agroSensorFixture.offset.y);
 
-    RaycastResult raycastResult = g_pApp->GetGameLogic()->VGetGamePhysics()->VRayCast(
+    RaycastResult raycastResult = g_pApp->GetGameLogic()->VGetGamePhysics()->VRayCastStatic(
         fromPoint, 
         toPoint, 
         CollisionFlag_Solid);
@@ -1424,7 +1460,7 @@ bool DuckRangedAttackAIStateComponent::VCanEnter()
         MakeStrongPtr(pClosestEnemy->GetComponent<ClawControllableComponent>(ClawControllableComponent::g_Name));
     if (pClawComponent == nullptr)
     {
-        LOG("Closest enemy name: " + pClosestEnemy->GetName());
+        LOG_CATEGORY(LogCategory_AI, LogLevel_Info, "Closest enemy name: " + pClosestEnemy->GetName());
     }
     assert(pClawComponent != nullptr);
 
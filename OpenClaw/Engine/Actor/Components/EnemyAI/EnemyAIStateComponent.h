@@ -82,6 +82,7 @@ class PhysicsComponent;
 class PositionComponent;
 class EnemyAIComponent;
 class ActorRenderComponent;
+class NavigationMap;
 
 //=====================================================================================================================
 // BaseEnemyAIStateComponent
@@ -228,7 +229,8 @@ public:
 
 private:
     void CalculatePatrolBorders();
-    double FindClosestHole(const Point &center, int height, float maxSearchDistance);
+    // Uses navigation map if given, per pixel raycasts otherwise
+    double FindClosestHole(const Point &center, int height, float maxSearchDistance, const NavigationMap* pNavigationMap);
     void ChangeDirection(Direction newDirection);
     void CommenceIdleBehaviour();
     bool TryChaseEnemy();
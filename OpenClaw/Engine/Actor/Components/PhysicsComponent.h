@@ -18,6 +18,8 @@ public:
 
     virtual bool VInit(TiXmlElement* data) override;
     virtual TiXmlElement* VGenerateXml() override;
+    virtual ActorComponent* VClone() const override { return new PhysicsComponent(*this); }
+    virtual bool VResetFromPrefab(const ActorComponent* pPrefabComponent) override { return ResetFromPrefabCopy<PhysicsComponent>(pPrefabComponent); }
     virtual void VPostInit() override;
     virtual void VPostPostInit() override;
 
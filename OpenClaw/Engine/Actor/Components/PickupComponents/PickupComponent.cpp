@@ -11,7 +11,9 @@
 #include "../GlitterComponent.h"
 
 #include "../../../GameApp/BaseGameApp.h"
+#include "../../../GameApp/BaseGameLogic.h"
 #include "../../../UserInterface/HumanView.h"
+#include "../../../UserInterface/ScoreScreen/ScoreScreenProcesses.h"
 #include "../../../Scene/SceneNodes.h"
 
 #include "../../../Events/EventMgr.h"
@@ -544,26 +546,26 @@ bool EndLevelPickupComponent::VOnApply(Actor* pActorWhoPickedThis)
     shared_ptr<ClawControllableComponent> pClawComponent = MakeStrongPtr(pActorWhoPickedThis->GetComponent<ClawControllableComponent>());
     assert(pClawComponent != nullptr && "Only claw should be able to pick end level item !");
 
-    shared_ptr<EventData_Finished_Level> pEvent(new EventData_Finished_Level());
-    IEventMgr::Get()->VQueueEvent(pEvent);
-
     // Play sound here
     assert(!m_PickupSound.empty());
     SoundInfo soundInfo(m_PickupSound);
     IEventMgr::Get()->VTriggerEvent(IEventDataPtr(
         new EventData_Request_Play_Sound(soundInfo)));
 
-    // TODO: This is hack. But it suffices.
+    // Let the sound play out before the score screen. Game is paused meanwhile, view processes still run
+    shared_ptr<EventData_Finished_Level> pEvent(new EventData_Finished_Level());
+    HumanView* pHumanView = g_pApp->GetHumanView();
+    if (pHumanView)
+    {
+        g_pApp->GetGameLogic()->SetRunning(false);
 
-    // Lets wait a bit
-    int waitDuration = 1500;
-    SDL_Event evt;
-    while (waitDuration > 0)
+        StrongProcessPtr pDelayProcess(new DelayedProcess(1500));
+        pDelayProcess->AttachChild(StrongProcessPtr(new FireEventProcess(pEvent, false)));
+        pHumanView->GetProcessMgr()->AttachProcess(pDelayProcess);
+    }
+    else
     {
-        // Eat events
-        while (SDL_PollEvent(&evt));
-        SDL_Delay(10);
-        waitDuration -= 10;
+        IEventMgr::Get()->VQueueEvent(pEvent);
     }
 
     // We already played it
@@ -12,6 +12,8 @@ public:
 
     virtual bool VInit(TiXmlElement* data) override;
     virtual TiXmlElement* VGenerateXml() override;
+    virtual ActorComponent* VClone() const override { return new PositionComponent(*this); }
+    virtual bool VResetFromPrefab(const ActorComponent* pPrefabComponent) override { return ResetFromPrefabCopy<PositionComponent>(pPrefabComponent); }
 
     // API
     inline Point GetPosition() const { return &m_Position; } 
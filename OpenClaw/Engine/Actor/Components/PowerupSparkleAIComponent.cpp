@@ -30,11 +30,8 @@ void PowerupSparkleAIComponent::VPostInit()
     assert(pAnimationComponent && pAnimationComponent->GetCurrentAnimation());
     pAnimationComponent->AddObserver(this);
 
-    srand((long)this);
-    //pAnimationComponent->SetDelay(rand() % 1000);
-
     int numFrames = pAnimationComponent->GetCurrentAnimation()->GetAnimFramesSize();
-    int skipFrames = rand() % numFrames;
+    int skipFrames = Util::GetRandomNumber(0, numFrames - 1);
     for (int i = 0; i < skipFrames; i++)
     {
         pAnimationComponent->GetCurrentAnimation()->SetNextFrame();
@@ -80,9 +77,8 @@ void PowerupSparkleAIComponent::ChooseNewPosition()
     assert(m_pTargetPositionComponent);
 
     Point targetPos = m_pTargetPositionComponent->GetPosition();
-    srand((long)this + (int)m_pPositonComponent->GetX() + (int)m_pPositonComponent->GetY() + time(NULL));
-    m_pPositonComponent->SetX(targetPos.x - m_TargetSize.x / 2 + rand() % (int)m_TargetSize.x);
-    m_pPositonComponent->SetY(targetPos.y - m_TargetSize.y / 2 + rand() % (int)m_TargetSize.y);
+    m_pPositonComponent->SetX(targetPos.x - m_TargetSize.x / 2 + Util::GetRandomNumber(0, (int)m_TargetSize.x - 1));
+    m_pPositonComponent->SetY(targetPos.y - m_TargetSize.y / 2 + Util::GetRandomNumber(0, (int)m_TargetSize.y - 1));
 
     shared_ptr<EventData_Teleport_Actor> pEvent(new EventData_Teleport_Actor(m_pOwner->GetGUID(), m_pPositonComponent->GetPosition()));
     IEventMgr::Get()->VTriggerEvent(pEvent);
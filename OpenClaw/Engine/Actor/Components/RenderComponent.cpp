@@ -137,7 +137,36 @@ bool BaseRenderComponent::VInit(TiXmlElement* pXmlData)
         LOG(it.first);
     }*/
 
-    return VDelegateInit(pXmlData);
+    // Delegates can still rename the images
+    bool delegateInitialized = VDelegateInit(pXmlData);
+    BuildFrameImageTable();
+
+    return delegateInitialized;
+}
+
+void BaseRenderComponent::BuildFrameImageTable()
+{
+    m_FrameImages.clear();
+    m_FrameImageIndices.clear();
+
+    for (auto& imagePair : m_ImageMap)
+    {
+        const std::string& imageName = imagePair.first;
+        if (imageName.length() <= 5 || imageName.compare(0, 5, "frame") != 0 ||
+            imageName.find_first_not_of("0123456789", 5) != std::string::npos)
+        {
+            continue;
+        }
+
+        uint32 imageId = std::stoi(imageName.substr(5));
+        if (imageId >= m_FrameImageIndices.size())
+        {
+            m_FrameImageIndices.resize(imageId + 1, -1);
+        }
+
+        m_FrameImageIndices[imageId] = (int16)m_FrameImages.size();
+        m_FrameImages.push_back(imagePair.second);
+    }
 }
 
 TiXmlElement* BaseRenderComponent::VGenerateXml()
@@ -150,6 +179,13 @@ void BaseRenderComponent::VPostInit()
     shared_ptr<SceneNode> pNode = GetSceneNode();
     if (pNode)
     {
+        // Node kept by pooled actor still has its previous ID and position
+        if (pNode->VGetProperties()->GetActorId() != m_pOwner->GetGUID())
+        {
+            pNode->SetActorId(m_pOwner->GetGUID());
+            pNode->VSetPosition(m_pOwner->GetPositionComponent()->GetPosition());
+        }
+
         shared_ptr<EventData_New_Render_Component> pEvent(new EventData_New_Render_Component(m_pOwner->GetGUID(), pNode));
         IEventMgr::Get()->VTriggerEvent(pEvent);
     }
@@ -185,7 +221,13 @@ weak_ptr<Image> BaseRenderComponent::GetImage(std::string imageName)
 
 weak_ptr<Image> BaseRenderComponent::GetImage(uint32 imageId)
 {
-    return weak_ptr<Image>();
+    int32 frameImageIdx = GetFrameImageIdx(imageId);
+    if (frameImageIdx < 0)
+    {
+        return weak_ptr<Image>();
+    }
+
+    return m_FrameImages[frameImageIdx];
 }
 
 bool BaseRenderComponent::HasImage(std::string imageName)
@@ -200,7 +242,7 @@ bool BaseRenderComponent::HasImage(std::string imageName)
 
 bool BaseRenderComponent::HasImage(int32 imageId)
 {
-    return false;
+    return imageId >= 0 && GetFrameImageIdx(imageId) >= 0;
 }
 
 //=================================================================================================
@@ -212,13 +254,16 @@ bool BaseRenderComponent::HasImage(int32 imageId)
 
 ActorRenderComponent::ActorRenderComponent()
     :
-    m_Alpha(255)
+    m_Alpha(255),
+    m_PaletteVariant(ImagePaletteVariant_None)
 {
     // Everything is visible by default, should be explicitly stated that its not visible
     m_IsVisible = true;
     m_IsMirrored = false;
     m_IsInverted = false;
     m_ZCoord = 0;
+    m_CurrentImageId = INVALID_IMAGE_ID;
+    m_IsCachedImageExpired = false;
     m_ColorMod.r = m_ColorMod.g = m_ColorMod.b = m_ColorMod.a = 255;
 }
 
@@ -294,6 +339,16 @@ bool ActorRenderComponent::VDelegateInit(TiXmlElement* pXmlData)
     return true;
 }
 
+bool ActorRenderComponent::VResetFromPrefab(const ActorComponent* pPrefabComponent)
+{
+    // Scene node is reused, it points back to this component
+    shared_ptr<SceneNode> pSceneNode = m_pSceneNode;
+    ResetFromPrefabCopy<ActorRenderComponent>(pPrefabComponent);
+    m_pSceneNode = pSceneNode;
+
+    return true;
+}
+
 SDL_Rect ActorRenderComponent::VGetPositionRect()
 {
     SDL_Rect positionRect = { 0 };
@@ -343,6 +398,7 @@ void ActorRenderComponent::VCreateInheritedXmlElements(TiXmlElement* pBaseElemen
 
 void ActorRenderComponent::SetImage(std::string imageName) {
     m_CurrentImageName.assign(std::move(imageName));
+    m_CurrentImageId = INVALID_IMAGE_ID;
     m_IsCachedImageExpired = true;
 }
 
@@ -374,6 +430,21 @@ void ActorRenderComponent::UpdateCurrentImage() {
     }
 
     m_IsCachedImageExpired = false;
+
+    if (m_CurrentImageId != INVALID_IMAGE_ID)
+    {
+        int32 frameImageIdx = GetFrameImageIdx(m_CurrentImageId);
+        if (frameImageIdx >= 0)
+        {
+            m_CachedImage = m_FrameImages[frameImageIdx];
+            return;
+        }
+
+        // Missing frame, name is only needed by the fallbacks below
+        m_CurrentImageName = "frame" + Util::ConvertToThreeDigitsString(m_CurrentImageId);
+        m_CurrentImageId = INVALID_IMAGE_ID;
+    }
+
     const auto image = m_ImageMap.find(m_CurrentImageName);
     if (m_ImageMap.end() != image)
     {
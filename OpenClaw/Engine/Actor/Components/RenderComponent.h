@@ -3,10 +3,13 @@
 
 #include "../../SharedDefines.h"
 #include "../ActorComponent.h"
+#include "../../Graphics2D/Image.h"
 
 class Image;
 typedef std::map<std::string, shared_ptr<Image>> ImageMap;
 
+const uint32 INVALID_IMAGE_ID = 0xFFFFFFFF;
+
 //=================================================================================================
 // BaseRenderComponent Declaration
 //
@@ -22,6 +25,7 @@ public:
     virtual void VOnChanged() override;
 
     weak_ptr<Image> GetImage(std::string imageName);
+    // Image ID is the number of "frameXXX" image, the same as AnimationFrame::imageId. Lookups are plain indexing
     weak_ptr<Image> GetImage(uint32 imageId);
     bool HasImage(std::string imageName);
     bool HasImage(int32 imageId);
@@ -42,7 +46,16 @@ protected:
     virtual TiXmlElement* VCreateBaseElement(void) { return NULL; /*return new TiXmlElement(VGetName());*/ }
     virtual void VCreateInheritedXmlElements(TiXmlElement* pBaseElement) = 0;
 
+    // Returns index to m_FrameImages, -1 if there is no such image
+    int32 GetFrameImageIdx(uint32 imageId) const
+    {
+        return imageId < m_FrameImageIndices.size() ? m_FrameImageIndices[imageId] : -1;
+    }
+
     ImageMap m_ImageMap;
+    // "frameXXX" images of m_ImageMap indexed through their number, built once the map is final
+    std::vector<shared_ptr<Image>> m_FrameImages;
+    std::vector<int16> m_FrameImageIndices;
 
     shared_ptr<SceneNode> m_pSceneNode;
 
@@ -50,6 +63,7 @@ protected:
 
 private:
     shared_ptr<SceneNode> GetSceneNode();
+    void BuildFrameImageTable();
 };
 
 //=================================================================================================
@@ -68,6 +82,8 @@ public:
     virtual const char* VGetName() const override { return g_Name; }
 
     virtual bool VDelegateInit(TiXmlElement* pXmlData) override;
+    virtual ActorComponent* VClone() const override { return new ActorRenderComponent(*this); }
+    virtual bool VResetFromPrefab(const ActorComponent* pPrefabComponent) override;
 
     virtual SDL_Rect VGetPositionRect() override;
 
@@ -76,6 +92,12 @@ public:
     // Now it is lazy functions. It does not update image until a GetCurrentImage call.
     weak_ptr<Image> GetCurrentImage();
     void SetImage(std::string imageName);
+    // Used by animations on every frame change, see BaseRenderComponent::GetImage(uint32)
+    void SetImage(uint32 imageId)
+    {
+        m_CurrentImageId = imageId;
+        m_IsCachedImageExpired = true;
+    }
 
     void SetMirrored(bool mirrored) { m_IsMirrored = mirrored; }
 
@@ -87,6 +109,10 @@ public:
     inline void SetAlpha(int alpha) { m_Alpha = alpha; }
     inline SDL_Color GetColorMod() { return m_ColorMod; }
     void SetColorMod(const SDL_Color& color) { m_ColorMod = color; }
+    // Recolored variant of the image, only indexed images have them, see Image::GetVariantTexture.
+    // Other images approximate it, see Image::ApplyVariantModulation
+    inline ImagePaletteVariant GetPaletteVariant() { return m_PaletteVariant; }
+    inline void SetPaletteVariant(ImagePaletteVariant variant) { m_PaletteVariant = variant; }
 
 protected:
     virtual shared_ptr<SceneNode> VCreateSceneNode() override;
@@ -97,6 +123,8 @@ protected:
     void UpdateCurrentImage();
 
     shared_ptr<Image> m_CachedImage;
+    // Image is set either by its ID or by name, INVALID_IMAGE_ID when it is set by name
+    uint32 m_CurrentImageId;
     std::string m_CurrentImageName;
     bool m_IsCachedImageExpired;
 
@@ -106,6 +134,7 @@ private:
     bool m_IsInverted;
     int m_Alpha;
     SDL_Color m_ColorMod;
+    ImagePaletteVariant m_PaletteVariant;
     int32 m_ZCoord;
 };
 
@@ -216,6 +245,8 @@ public:
     static const char* g_Name;
     virtual const char* VGetName() const override { return g_Name; }
     virtual bool VDelegateInit(TiXmlElement* pXmlData) override;
+    // HUD elements are not spawned at runtime
+    virtual ActorComponent* VClone() const override { return NULL; }
 
     virtual SDL_Rect VGetPositionRect() override;
 
@@ -8,6 +8,7 @@
 #include <FastDelegate/FastDelegate.h>
 
 #include "../Interfaces.h"
+#include "../Util/Memory/AllocationTracker.h"
 
 using fastdelegate::MakeDelegate;
 
@@ -45,6 +46,9 @@ public:
     virtual const char* GetName(void) const = 0;
 
     //GCC_MEMORY_WATCHER_DECLARATION();
+
+    // Events are allocated all over the engine, account them where they belong
+    ALLOCATION_TAG_DECLARATION(AllocTag_Events);
 };
 
 
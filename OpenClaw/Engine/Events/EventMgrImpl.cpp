@@ -194,8 +194,10 @@ bool EventMgr::VUpdate(unsigned long maxMillis)
 {
     assert(!m_bIsUpdating && "Attempted to nest updating events - EventMgr::VUpdate inside EventMgr::VUpdate");
 
+    TRACK_ALLOCATIONS(AllocTag_Events);
+
     m_bIsUpdating = true;
-    unsigned long currMs = SDL_GetTicks();
+    unsigned long currMs = Util::GetTicks();
     unsigned long maxMs = ((maxMillis == IEventMgr::kINFINITE) ? (IEventMgr::kINFINITE) : (currMs + maxMillis));
 
     // This section added to handle events from other threads.  Check out Chapter 20.
@@ -248,7 +250,7 @@ bool EventMgr::VUpdate(unsigned long maxMillis)
         }
 
         // check to see if time ran out
-        currMs = SDL_GetTicks();
+        currMs = Util::GetTicks();
         if (maxMillis != IEventMgr::kINFINITE && currMs >= maxMs)
         {
             LOG_TAG("EventLoop", "Aborting event processing; time ran out");
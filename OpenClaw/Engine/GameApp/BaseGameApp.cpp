@@ -7,6 +7,7 @@
 #include "../UserInterface/HumanView.h"
 #include "../Resource/ResourceMgr.h"
 #include "../Graphics2D/Image.h"
+#include "../Graphics2D/RenderCommands.h"
 
 // Resource loaders
 #include "../Resource/Loaders/DefaultLoader.h"
@@ -21,6 +22,8 @@
 #include "../Resource/Loaders/PngLoader.h"
 
 #include "BaseGameApp.h"
+#include "Benchmark.h"
+#include "PrototypeCache.h"
 
 #include <cctype>
 
@@ -59,6 +62,8 @@ bool BaseGameApp::Initialize(int argc, char** argv)
     VRegisterGameEvents();
 
     // Initialization sequence
+    if (!InitializeLogger(m_DebugOptions)) return false;
+    if (!InitializeBenchmark(argc, argv)) return false;
     if (!InitializeEventMgr()) return false;
     if (!InitializeDisplay(m_GameOptions)) return false;
     if (!InitializeAudio(m_GameOptions)) return false;
@@ -66,8 +71,7 @@ bool BaseGameApp::Initialize(int argc, char** argv)
     if (!InitializeResources(m_GameOptions)) return false;
     if (!InitializeLocalization(m_GameOptions)) return false;
     if (!InitializeTouchManager(m_GameOptions)) return false;
-    if (!ReadActorXmlPrototypes(m_GameOptions)) return false;
-    if (!ReadLevelMetadata(m_GameOptions)) return false;
+    if (!ReadActorPrototypesAndLevelMetadata(m_GameOptions)) return false;
 
     RegisterAllDelegates();
 
@@ -90,6 +94,14 @@ bool BaseGameApp::Initialize(int argc, char** argv)
         return false;
     }
 
+    Benchmark::OnInitialized();
+
+    if (m_GameOptions.usePipelinedLoop &&
+        !m_PipelinedLoop.Start(m_pRenderer, [this](uint32_t msDiff) { SimulateFrame(msDiff); }))
+    {
+        LOG_WARNING("Pipelined loop is not available, using serial loop");
+    }
+
     m_IsRunning = true;
 
     return true;
@@ -99,6 +111,9 @@ void BaseGameApp::Terminate()
 {
     LOG("Terminating...");
 
+    // Simulation thread uses the game
+    m_PipelinedLoop.Stop();
+
     RemoveAllDelegates();
 
     SAFE_DELETE(m_pGame);
@@ -119,6 +134,8 @@ void BaseGameApp::Terminate()
     m_ActorXmlPrototypeMap.clear();
 
     SaveGameOptions();
+
+    Logger::Shutdown();
 }
 
 #define STARTUP_TEST(condition, error) \
@@ -182,22 +199,99 @@ bool BaseGameApp::VPerformStartupTests()
         CUSTOM_RESOURCE,
         "/ACTOR_PROTOTYPES/LEVEL1/LEVEL1_OFFICER.XML not found in: " + std::string(CUSTOM_RESOURCE));
 
+    // Prototype cache has to yield the same prototypes and metadata as XML
+    if (Benchmark::GetOptions().verifyPrototypeCache)
+    {
+        STARTUP_TEST(VerifyPrototypeCache(), "Prototype cache does not match XML");
+    }
+
     return bTestsOk;
 }
 
-void BaseGameApp::StepLoop() {
-    static uint32 lastTime = SDL_GetTicks();
+void BaseGameApp::HandleInput()
+{
     SDL_Event event;
     Touch_Event touchEvent;
+
+    BENCHMARK_SCOPE(BenchmarkSection_Input);
+    Benchmark::InjectInput();
+    while (SDL_PollEvent(&event))
+    {
+        Benchmark::RecordInput(event);
+        OnEvent(event);
+    }
+
+    // Handle all touch events
+    if (m_pTouchManager) {
+        m_pTouchManager->Update();
+        while (m_pTouchManager->PollEvent(&touchEvent)) {
+            OnEvent(touchEvent.sdlEvent);
+        }
+    }
+}
+
+void BaseGameApp::SimulateFrame(uint32 elapsedTime)
+{
+    if (!m_pGame)
+    {
+        return;
+    }
+
+    // Update game
+    {
+        //PROFILE_CPU("ONLY GAME UPDATE");
+        {
+            BENCHMARK_SCOPE(BenchmarkSection_Events);
+            IEventMgr::Get()->VUpdate(20); // Allow event queue to process for up to 20 ms
+        }
+        {
+            BENCHMARK_SCOPE(BenchmarkSection_Logic);
+            m_pGame->VOnUpdate(elapsedTime);
+        }
+    }
+
+    // Render game
+    for (auto &pGameView : m_pGame->m_GameViews)
+    {
+        //PROFILE_CPU("ONLY RENDER");
+        BENCHMARK_SCOPE(BenchmarkSection_Render);
+        pGameView->VOnRender(elapsedTime);
+    }
+
+    //m_pGame->VRenderDiagnostics();
+
+    if (m_pGame->GetGameState() == GameState_IngameRunning)
+    {
+        Benchmark::OnLevelRunning();
+    }
+}
+
+bool BaseGameApp::EndSimulatedFrame()
+{
+    AllocationTracker::OnFrameEnd();
+
+    if (Benchmark::IsStateHashRequested() && m_pGame)
+    {
+        Benchmark::AddStateHash(m_pGame->ComputeWorldStateHash());
+    }
+
+    return Benchmark::OnFrameEnd();
+}
+
+void BaseGameApp::StepLoop() {
     static int consecutiveLagSpikes = 0;
 
     if (m_IsRunning)
     {
         //PROFILE_CPU("MAINLOOP");
 
-        uint32 now = SDL_GetTicks();
-        uint32 elapsedTime = now - lastTime;
-        lastTime = now;
+        uint32 elapsedTime = m_FramePacer.BeginFrame();
+
+        // Headless benchmark uses simulated clock so that runs are comparable regardless of how long frames take
+        if (Benchmark::IsHeadless())
+        {
+            elapsedTime = Benchmark::GetOptions().frameTimeMs;
+        }
 
         // This occurs when recovering program from background or after load
         // We want to ignore these situations
@@ -212,41 +306,38 @@ void BaseGameApp::StepLoop() {
         }
         consecutiveLagSpikes = 0;
 
-        // Handle all input events
-        while (SDL_PollEvent(&event))
+        if (m_PipelinedLoop.IsRunning())
         {
-            OnEvent(event);
-        }
-
-        // Handle all touch events
-        if (m_pTouchManager) {
-            m_pTouchManager->Update();
-            while (m_pTouchManager->PollEvent(&touchEvent)) {
-                OnEvent(touchEvent.sdlEvent);
+            // Input is handled while simulation thread waits, then it simulates this frame while the previous one is
+            // drawn. Frame stats and world state are only read while it waits
+            m_PipelinedLoop.FinishSimulation();
+            if (!EndSimulatedFrame())
+            {
+                m_IsRunning = false;
             }
-        }
-
-        if (m_pGame)
-        {
-            // Update game
+            Benchmark::OnFrameBegin();
+            HandleInput();
+            if (m_IsRunning)
             {
-                //PROFILE_CPU("ONLY GAME UPDATE");
-                IEventMgr::Get()->VUpdate(20); // Allow event queue to process for up to 20 ms
-                m_pGame->VOnUpdate(elapsedTime);
+                m_PipelinedLoop.StartSimulation(elapsedTime);
             }
-
-            // Render game
-            for (auto &pGameView : m_pGame->m_GameViews)
+            m_PipelinedLoop.RenderFrame();
+        }
+        else
+        {
+            Benchmark::OnFrameBegin();
+            HandleInput();
+            SimulateFrame(elapsedTime);
+            if (!EndSimulatedFrame())
             {
-                //PROFILE_CPU("ONLY RENDER");
-                pGameView->VOnRender(elapsedTime);
+                m_IsRunning = false;
             }
-            
-            //m_pGame->VRenderDiagnostics();
         }
 
         // Artificially decrease fps. Configurable from console
         Util::Sleep(m_DebugOptions.cpuDelayMs);
+
+        m_FramePacer.EndFrame();
     }
 }
 
@@ -271,15 +362,17 @@ int32 BaseGameApp::Run()
     // Some systems (like web browsers) does not support infinite loops.
     // We need to return control after each loop steps.
 #ifdef __EMSCRIPTEN__
-    emscripten_set_main_loop_arg(Loop, this, 0, 1);
+    // Browser paces the loop itself, 0 = requestAnimationFrame
+    emscripten_set_main_loop_arg(Loop, this, m_GameOptions.targetFps, 1);
     // Loop must call emscripten_cancel_main_loop() to exit
 #else
     while (m_IsRunning) {
         Loop(this);
     }
 #endif
+    bool benchmarkOk = Benchmark::Finish();
     Terminate();
-    return 0;
+    return benchmarkOk ? 0 : 1;
 }
 
 void BaseGameApp::OnEvent(SDL_Event& event)
@@ -311,6 +404,20 @@ void BaseGameApp::OnEvent(SDL_Event& event)
             break;
         }
 
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+        {
+            LOG_WARNING("Render targets were reset");
+            if (m_pGame)
+            {
+                for (shared_ptr<IGameView> pGameView : m_pGame->m_GameViews)
+                {
+                    pGameView->VOnLostDevice();
+                }
+            }
+            break;
+        }
+
         case SDL_APP_LOWMEMORY:
         {
             LOG_WARNING("Running low on memory");
@@ -471,6 +578,10 @@ bool BaseGameApp::LoadGameOptions(const char* inConfigFile)
             displayElem->FirstChildElement("Scale"));
         ParseValueFromXmlElem(&m_GameOptions.useVerticalSync,
             displayElem->FirstChildElement("UseVerticalSync"));
+        ParseValueFromXmlElem(&m_GameOptions.targetFps,
+            displayElem->FirstChildElement("TargetFps"));
+        ParseValueFromXmlElem(&m_GameOptions.usePipelinedLoop,
+            displayElem->FirstChildElement("PipelinedLoop"));
         ParseValueFromXmlElem(&m_GameOptions.isFullscreen,
             displayElem->FirstChildElement("IsFullscreen"));
         ParseValueFromXmlElem(&m_GameOptions.isFullscreenDesktop,
@@ -565,6 +676,10 @@ bool BaseGameApp::LoadGameOptions(const char* inConfigFile)
             assetsElem->FirstChildElement("TempDir"));
         DO_AND_CHECK(ParseValueFromXmlElem(&m_GameOptions.savesFile,
             assetsElem->FirstChildElement("SavesFile")));
+        ParseValueFromXmlElem(&m_GameOptions.prototypeCacheFile,
+            assetsElem->FirstChildElement("PrototypeCacheFile"));
+        ParseValueFromXmlElem(&m_GameOptions.useIndexedSprites,
+            assetsElem->FirstChildElement("IndexedSprites"));
     }
 
     //-------------------------------------------------------------------------
@@ -723,6 +838,14 @@ bool BaseGameApp::LoadGameOptions(const char* inConfigFile)
             pDebugOptionsRootElem->FirstChildElement("LastImplementedLevel"));
         ParseValueFromXmlElem(&m_DebugOptions.skipMenuToLevel,
             pDebugOptionsRootElem->FirstChildElement("SkipMenuToLevel"));
+        ParseValueFromXmlElem(&m_DebugOptions.logLevel,
+            pDebugOptionsRootElem->FirstChildElement("LogLevel"));
+        ParseValueFromXmlElem(&m_DebugOptions.logFile,
+            pDebugOptionsRootElem->FirstChildElement("LogFile"));
+        ParseValueFromXmlElem(&m_DebugOptions.bAsyncLogging,
+            pDebugOptionsRootElem->FirstChildElement("AsyncLogging"));
+        ParseValueFromXmlElem(&m_DebugOptions.logRateLimit,
+            pDebugOptionsRootElem->FirstChildElement("LogRateLimit"));
     }
 
     return true;
@@ -774,6 +897,13 @@ bool BaseGameApp::InitializeDisplay(GameOptions& gameOptions)
 {
     LOG(">>>>> Initializing display...");
 
+    if (Benchmark::IsHeadless())
+    {
+        // No display or sound device is needed, SDL dummy drivers discard the output
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    }
+
     if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_AUDIO | SDL_INIT_VIDEO) != 0)
     {
         LOG_ERROR("Failed to initialize SDL2 library. Error: %s" + std::string(SDL_GetError()));
@@ -781,7 +911,7 @@ bool BaseGameApp::InitializeDisplay(GameOptions& gameOptions)
     }
 
     m_pWindow = SDL_CreateWindow(VGetGameTitle(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
-        gameOptions.windowWidth, gameOptions.windowHeight, SDL_WINDOW_SHOWN);
+        gameOptions.windowWidth, gameOptions.windowHeight, Benchmark::IsHeadless() ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
     if (m_pWindow == NULL)
     {
         LOG_ERROR("Failed to create main window");
@@ -801,7 +931,7 @@ bool BaseGameApp::InitializeDisplay(GameOptions& gameOptions)
 
     m_WindowSize.Set(gameOptions.windowWidth, gameOptions.windowHeight);
 
-    uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+    uint32 rendererFlags = Benchmark::IsHeadless() ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
     if (gameOptions.useVerticalSync)
     {
         rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
@@ -816,6 +946,10 @@ bool BaseGameApp::InitializeDisplay(GameOptions& gameOptions)
 
     SDL_RenderSetScale(m_pRenderer, (float)gameOptions.scale, (float)gameOptions.scale);
 
+    SDL_DisplayMode displayMode;
+    int refreshRate = SDL_GetWindowDisplayMode(m_pWindow, &displayMode) == 0 ? displayMode.refresh_rate : 0;
+    m_FramePacer.Initialize(gameOptions.targetFps, gameOptions.useVerticalSync, refreshRate);
+
     LOG("Display successfully initialized.");
 
     return true;
@@ -949,6 +1083,129 @@ bool BaseGameApp::InitializeTouchManager(GameOptions& gameOptions)
     return true;
 }
 
+static void DeleteActorPrototypes(ActorXmlPrototypeMap& actorPrototypes)
+{
+    for (auto& actorProto : actorPrototypes)
+    {
+        delete actorProto.second;
+    }
+    actorPrototypes.clear();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// BaseGameApp::ReadActorPrototypesAndLevelMetadata
+//
+//     Loads actor prototypes and level metadata from prototype cache when it is up to date with the XML files,
+//     otherwise reads the XML files and compiles the cache from them for next startup
+//---------------------------------------------------------------------------------------------------------------------
+bool BaseGameApp::ReadActorPrototypesAndLevelMetadata(GameOptions& gameOptions)
+{
+    std::vector<std::string> sourceFiles = m_pResourceMgr->VMatch("/ACTOR_PROTOTYPES/*.XML");
+    std::vector<std::string> metadataFiles = m_pResourceMgr->VMatch("/LEVEL_METADATA/*.XML");
+    sourceFiles.insert(sourceFiles.end(), metadataFiles.begin(), metadataFiles.end());
+
+    uint64 sourceHash = 0;
+    bool useCache = !gameOptions.prototypeCacheFile.empty() &&
+        PrototypeCache::CalcSourceHash(m_pResourceMgr, sourceFiles, sourceHash);
+    std::string cacheFilePath = gameOptions.userDirectory + gameOptions.prototypeCacheFile;
+
+    if (useCache)
+    {
+        ActorXmlPrototypeMap cachedPrototypes;
+        LevelMetadataMap cachedLevelMetadata;
+        if (PrototypeCache::Read(cacheFilePath, sourceHash, cachedPrototypes, cachedLevelMetadata))
+        {
+            DeleteActorPrototypes(m_ActorXmlPrototypeMap);
+            m_ActorXmlPrototypeMap.swap(cachedPrototypes);
+            m_LevelMetadataMap.swap(cachedLevelMetadata);
+
+            LOG("Loaded " + ToStr((int)m_ActorXmlPrototypeMap.size()) + " actor prototypes and " +
+                ToStr((int)m_LevelMetadataMap.size()) + " level metadata from: " + cacheFilePath);
+            return true;
+        }
+    }
+
+    if (!ReadActorXmlPrototypes(gameOptions) || !ReadLevelMetadata(gameOptions))
+    {
+        return false;
+    }
+
+    if (useCache && PrototypeCache::Write(cacheFilePath, sourceHash, m_ActorXmlPrototypeMap, m_LevelMetadataMap))
+    {
+        LOG("Compiled prototype cache: " + cacheFilePath);
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// BaseGameApp::VerifyPrototypeCache
+//
+//     Reads the XML files again and checks that both what was loaded at startup (possibly from the cache) and
+//     what gets loaded from cache compiled from them now are the same
+//---------------------------------------------------------------------------------------------------------------------
+bool BaseGameApp::VerifyPrototypeCache()
+{
+    ActorXmlPrototypeMap xmlPrototypes;
+    LevelMetadataMap xmlLevelMetadata;
+
+    // XML readers fill the members, keep what was loaded at startup aside
+    m_ActorXmlPrototypeMap.swap(xmlPrototypes);
+    m_LevelMetadataMap.swap(xmlLevelMetadata);
+    bool readXml = ReadActorXmlPrototypes(m_GameOptions) && ReadLevelMetadata(m_GameOptions);
+    m_ActorXmlPrototypeMap.swap(xmlPrototypes);
+    m_LevelMetadataMap.swap(xmlLevelMetadata);
+
+    if (!readXml)
+    {
+        LOG_ERROR("Failed to read actor prototypes and level metadata from XML");
+        DeleteActorPrototypes(xmlPrototypes);
+        return false;
+    }
+
+    bool isSame = PrototypeCache::Compare(xmlPrototypes, xmlLevelMetadata, m_ActorXmlPrototypeMap, m_LevelMetadataMap);
+
+    // Round trip through a file so that memory mapping is tested too
+    std::string cacheFilePath = m_GameOptions.userDirectory + "PROTOTYPES_VERIFY.CACHE";
+    const uint64 sourceHash = 1;
+    ActorXmlPrototypeMap cachedPrototypes;
+    LevelMetadataMap cachedLevelMetadata;
+    if (!PrototypeCache::Write(cacheFilePath, sourceHash, xmlPrototypes, xmlLevelMetadata) ||
+        !PrototypeCache::Read(cacheFilePath, sourceHash, cachedPrototypes, cachedLevelMetadata))
+    {
+        LOG_ERROR("Failed to write and read back prototype cache: " + cacheFilePath);
+        isSame = false;
+    }
+    else
+    {
+        isSame &= PrototypeCache::Compare(xmlPrototypes, xmlLevelMetadata, cachedPrototypes, cachedLevelMetadata);
+    }
+    remove(cacheFilePath.c_str());
+
+    // Stale cache has to be refused
+    ActorXmlPrototypeMap stalePrototypes;
+    LevelMetadataMap staleLevelMetadata;
+    std::vector<char> cacheData;
+    PrototypeCache::Serialize(sourceHash, xmlPrototypes, xmlLevelMetadata, cacheData);
+    if (PrototypeCache::Deserialize(cacheData.data(), cacheData.size(), sourceHash + 1, stalePrototypes, staleLevelMetadata))
+    {
+        LOG_ERROR("Prototype cache with different source hash was accepted");
+        DeleteActorPrototypes(stalePrototypes);
+        isSame = false;
+    }
+
+    DeleteActorPrototypes(xmlPrototypes);
+    DeleteActorPrototypes(cachedPrototypes);
+
+    if (isSame)
+    {
+        LOG("Prototype cache matches XML: " + ToStr((int)m_ActorXmlPrototypeMap.size()) + " actor prototypes, " +
+            ToStr((int)m_LevelMetadataMap.size()) + " level metadata");
+    }
+
+    return isSame;
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 // BaseGameApp::ReadActorXmlPrototypes
 // 
@@ -963,9 +1220,12 @@ bool BaseGameApp::ReadActorXmlPrototypes(GameOptions& gameOptions)
     if (!m_ActorXmlPrototypeMap.empty())
     {
         LOG_TRACE("Detected reload of actor prototypes !");
-        m_ActorXmlPrototypeMap.clear();
+        DeleteActorPrototypes(m_ActorXmlPrototypeMap);
     }
 
+    // Prototypes as they are in XML, they are resolved once all of them are read
+    ActorXmlPrototypeMap sourcePrototypes;
+
     std::vector<std::string> xmlActorPrototypeFiles = m_pResourceMgr->VMatch("/ACTOR_PROTOTYPES/*.XML");
 
     for (const std::string& protoFile : xmlActorPrototypeFiles)
@@ -987,7 +1247,7 @@ bool BaseGameApp::ReadActorXmlPrototypes(GameOptions& gameOptions)
             TiXmlElement* pActorProtoElemDuplicate = pDuplicateNode->ToElement();
             assert(pActorProtoElemDuplicate);
 
-            auto iter = m_ActorXmlPrototypeMap.insert(std::make_pair(actorProto, pActorProtoElemDuplicate));
+            auto iter = sourcePrototypes.insert(std::make_pair(actorProto, pActorProtoElemDuplicate));
             if (!iter.second) {
                 LOG_WARNING("Multi " + EnumToString_ActorPrototype(actorProto) + " actor prototype definitions! Fix ASSETS!");
                 std::string typeName;
@@ -999,6 +1259,13 @@ bool BaseGameApp::ReadActorXmlPrototypes(GameOptions& gameOptions)
         }
     }
 
+    for (auto& sourceProto : sourcePrototypes)
+    {
+        m_ActorXmlPrototypeMap.insert(std::make_pair(sourceProto.first,
+            ResolveActorPrototype(sourceProto.first, sourcePrototypes)));
+    }
+    DeleteActorPrototypes(sourcePrototypes);
+
     bool loadedAllRequired = true;
 
     // When I provide specific purpose API, I should be very dilligent
@@ -1213,6 +1480,66 @@ const shared_ptr<LevelMetadata> BaseGameApp::GetLevelMetadata(int levelNumber) c
     return findIt->second;
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+// BaseGameApp::InitializeLogger
+//---------------------------------------------------------------------------------------------------------------------
+bool BaseGameApp::InitializeLogger(DebugOptions& debugOptions)
+{
+    LogLevel logLevel = Logger::StringToLogLevel(debugOptions.logLevel);
+    if (logLevel == LogLevel_None && debugOptions.logLevel != "none")
+    {
+        LOG_WARNING("Unknown log level: " + debugOptions.logLevel + ". Using info.");
+        logLevel = LogLevel_Info;
+    }
+
+    Logger::SetLevel(logLevel);
+    Logger::SetRateLimit(max(debugOptions.logRateLimit, 0));
+
+    std::string logFilePath;
+    if (!debugOptions.logFile.empty())
+    {
+        logFilePath = m_GameOptions.userDirectory + debugOptions.logFile;
+    }
+
+    if (!Logger::Init(logFilePath, debugOptions.bAsyncLogging))
+    {
+        LOG_WARNING("Could not open log file: " + logFilePath + ". Logging to stderr.");
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// BaseGameApp::InitializeBenchmark
+//
+// Parses benchmark related command line arguments, see Benchmark.h
+//---------------------------------------------------------------------------------------------------------------------
+bool BaseGameApp::InitializeBenchmark(int argc, char** argv)
+{
+    BenchmarkOptions benchmarkOptions;
+    if (!Benchmark::ParseCommandLine(argc, argv, benchmarkOptions) || !Benchmark::Start(benchmarkOptions))
+    {
+        LOG_ERROR("Failed to start benchmark.");
+        return false;
+    }
+
+    if (benchmarkOptions.isHeadless)
+    {
+        // Go straight to the level and do not limit frame rate
+        m_DebugOptions.bSkipMenu = true;
+        m_DebugOptions.skipMenuToLevel = benchmarkOptions.levelNumber;
+        m_DebugOptions.cpuDelayMs = 0;
+        m_GameOptions.useVerticalSync = false;
+        m_GameOptions.targetFps = 0;
+        // Runs have to be deterministic
+        m_GameOptions.usePipelinedLoop = false;
+        m_GameOptions.isFullscreen = false;
+        m_GameOptions.isFullscreenDesktop = false;
+    }
+
+    return true;
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 // BaseGameApp::InitializeEventMgr
 //---------------------------------------------------------------------------------------------------------------------
@@ -1234,7 +1561,7 @@ Point BaseGameApp::GetScale()
     uint32 windowFlags = GetWindowFlags();
     Point scale(1.0, 1.0);
 
-    SDL_RenderGetScale(m_pRenderer, &scaleX, &scaleY);
+    RenderCommands::GetScale(m_pRenderer, &scaleX, &scaleY);
     
     scale.Set((double)scaleX, (double)scaleY);
 
@@ -1243,7 +1570,7 @@ Point BaseGameApp::GetScale()
 
 void BaseGameApp::SetScale(Point scale)
 {
-    SDL_RenderSetScale(m_pRenderer, (float)scale.x, (float)scale.y);
+    RenderCommands::SetScale(m_pRenderer, (float)scale.x, (float)scale.y);
 }
 
 uint32 BaseGameApp::GetWindowFlags()
@@ -1251,6 +1578,17 @@ uint32 BaseGameApp::GetWindowFlags()
     return SDL_GetWindowFlags(m_pWindow);
 }
 
+void BaseGameApp::SetCurrentPalette(WapPal* palette)
+{
+    if (palette != m_pPalette)
+    {
+        // Previous palette can be freed and its address reused by the new one
+        Image::ReleaseSharedPalettes();
+    }
+
+    m_pPalette = palette;
+}
+
 class TiXmlMergeVisitor : public TiXmlVisitor
 {
 public:
@@ -1361,6 +1699,18 @@ TiXmlElement* BaseGameApp::GetActorPrototypeElem(ActorPrototype proto)
     }
     assert(findIt != m_ActorXmlPrototypeMap.end());
 
+    // Parents were merged in when the prototypes were loaded
+    TiXmlElement* pCopy = findIt->second->Clone()->ToElement();
+    assert(pCopy != NULL);
+
+    return pCopy;
+}
+
+TiXmlElement* BaseGameApp::ResolveActorPrototype(ActorPrototype proto, const ActorXmlPrototypeMap& sourcePrototypes)
+{
+    auto findIt = sourcePrototypes.find(proto);
+    assert(findIt != sourcePrototypes.end());
+
     TiXmlElement* pCopy = findIt->second->Clone()->ToElement();
     assert(pCopy != NULL);
 
@@ -1371,7 +1721,14 @@ TiXmlElement* BaseGameApp::GetActorPrototypeElem(ActorPrototype proto)
     if (pRootElem->Attribute("Parent") != NULL)
     {
         ActorPrototype parentProto = StringToEnum_ActorPrototype(pRootElem->Attribute("Parent"));
-        TiXmlElement* pParentRootElem = GetActorPrototypeElem(parentProto);
+        if (sourcePrototypes.find(parentProto) == sourcePrototypes.end())
+        {
+            LOG_ERROR("Parent of actor prototype " + EnumToString_ActorPrototype(proto) + " was not found: " +
+                pRootElem->Attribute("Parent"));
+            return pCopy;
+        }
+
+        TiXmlElement* pParentRootElem = ResolveActorPrototype(parentProto, sourcePrototypes);
         assert(pParentRootElem != NULL);
 
         // Merge changes from child to parent (child contains only delta changes)
@@ -1427,6 +1784,8 @@ TiXmlElement* CreateDefaultDisplayConfig()
     XML_ADD_2_PARAM_ELEMENT("Size", "width", ToStr(1280).c_str(), "height", ToStr(768).c_str(), display);
     XML_ADD_TEXT_ELEMENT("Scale", "1", display);
     XML_ADD_TEXT_ELEMENT("UseVerticalSync", "true", display);
+    XML_ADD_TEXT_ELEMENT("TargetFps", "0", display);
+    XML_ADD_TEXT_ELEMENT("PipelinedLoop", "false", display);
     XML_ADD_TEXT_ELEMENT("IsFullscreen", "false", display);
     XML_ADD_TEXT_ELEMENT("IsFullscreenDesktop", "false", display);
 
@@ -1466,6 +1825,8 @@ TiXmlElement* CreateDefaultAssetsConfig()
     XML_ADD_TEXT_ELEMENT("ResourceCacheSize", "50", assets);
     XML_ADD_TEXT_ELEMENT("TempDir", ".", assets);
     XML_ADD_TEXT_ELEMENT("SavesFile", "SAVES.XML", assets);
+    XML_ADD_TEXT_ELEMENT("PrototypeCacheFile", "PROTOTYPES.CACHE", assets);
+    XML_ADD_TEXT_ELEMENT("IndexedSprites", "false", assets);
 
     return assets;
 }
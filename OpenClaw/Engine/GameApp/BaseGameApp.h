@@ -8,6 +8,8 @@
 
 #include "../UserInterface/Console.h"
 #include "CommandHandler.h"
+#include "FramePacer.h"
+#include "PipelinedLoop.h"
 #include "../UserInterface/Touch/TouchManager.h"
 
 const int DEFAULT_SCREEN_WIDTH = 1280;
@@ -25,6 +27,8 @@ struct GameOptions
         windowHeight = 780;
         scale = 1.0f;
         useVerticalSync = true;
+        targetFps = 0;
+        usePipelinedLoop = false;
         isFullscreen = false;
         isFullscreenDesktop = false;
 
@@ -47,6 +51,8 @@ struct GameOptions
         resourceCacheSize = 50;
         tempDir = ".";
         savesFile = "SAVES.XML";
+        prototypeCacheFile = "PROTOTYPES.CACHE";
+        useIndexedSprites = false;
         userDirectory = "";
 
         startupCommandsFile = "startup_commands.txt";
@@ -64,6 +70,10 @@ struct GameOptions
     int windowHeight;
     double scale;
     bool useVerticalSync;
+    // Frame rate the main loop is paced to, 0 = unlimited (or vertical sync)
+    int targetFps;
+    // Simulate next frame on its own thread while the current one is drawn, see PipelinedLoop. Never in headless runs
+    bool usePipelinedLoop;
     bool isFullscreen;
     bool isFullscreenDesktop;
 
@@ -90,6 +100,12 @@ struct GameOptions
     unsigned resourceCacheSize;
     std::string tempDir;
     std::string savesFile;
+    // Compiled actor prototypes and level metadata, stored in user directory. Empty = always read XML
+    std::string prototypeCacheFile;
+    // PID sprites keep 8-bit palette indices and are uploaded to texture when first rendered.
+    // Palette variants (e.g. invisibility ghost) are exact only with this enabled, otherwise they are approximated
+    // by color and alpha modulation
+    bool useIndexedSprites;
     // For LINUX ONLY - this is generally ~/.config/openclaw/
     std::string userDirectory;
 
@@ -195,6 +211,9 @@ struct DebugOptions
         bSkipMenu = false;
         lastImplementedLevel = 7;
         skipMenuToLevel = 9;
+        logLevel = "info";
+        bAsyncLogging = true;
+        logRateLimit = 20;
     }
 
     int cpuDelayMs;
@@ -202,6 +221,12 @@ struct DebugOptions
     int lastImplementedLevel;
     int skipMenuToLevel;
     bool bSkipBossFightIntro;
+
+    // Logging
+    std::string logLevel;
+    std::string logFile;  // Empty = stderr
+    bool bAsyncLogging;
+    int logRateLimit;     // Identical messages per second, 0 = unlimited
 };
 
 struct LevelMetadata
@@ -267,7 +292,7 @@ public:
     inline SDL_Renderer* GetRenderer() const { return m_pRenderer; }
     // TODO: Memory leak most likely
     inline WapPal* GetCurrentPalette() const { return m_pPalette; }
-    void SetCurrentPalette(WapPal* palette) { m_pPalette = palette; }
+    void SetCurrentPalette(WapPal* palette);
     // Deprecated. Use GetResourceMgr()
     std::shared_ptr<ResourceCache> GetResourceCache() const;
     inline IResourceMgr* GetResourceMgr() const { return m_pResourceMgr; }
@@ -287,6 +312,8 @@ public:
 
     Audio* GetAudio() const { return m_pAudio; }
 
+    FramePacer* GetFramePacer() { return &m_FramePacer; }
+
     bool LoadGameOptions(const char* inConfigFile = "config.xml");
     void SaveGameOptions(const char* outConfigFile = "config.xml");
 
@@ -328,10 +355,23 @@ private:
     bool InitializeFont(GameOptions& gameOptions);
     bool InitializeLocalization(GameOptions& gameOptions);
     bool InitializeTouchManager(GameOptions& gameOptions);
-    bool InitializeEventMgr();
+    bool InitializeEventMgr();
+    bool InitializeLogger(DebugOptions& debugOptions);
+    bool InitializeBenchmark(int argc, char** argv);
+
+    // Main loop parts, simulation runs on its own thread with pipelined loop
+    void HandleInput();
+    void SimulateFrame(uint32 elapsedTime);
+    // Returns false when the benchmark is done
+    bool EndSimulatedFrame();
     bool ReadConsoleConfig();
+    bool ReadActorPrototypesAndLevelMetadata(GameOptions& gameOptions);
     bool ReadActorXmlPrototypes(GameOptions& gameOptions);
     bool ReadLevelMetadata(GameOptions& gameOptions);
+    // Merges parent prototypes into copy of the given one, source prototypes are unresolved XML
+    TiXmlElement* ResolveActorPrototype(ActorPrototype proto, const ActorXmlPrototypeMap& sourcePrototypes);
+    // Compares what was loaded and what gets loaded from freshly compiled cache with XML
+    bool VerifyPrototypeCache();
 
     void RegisterEngineEvents();
 
@@ -353,11 +393,15 @@ private:
 
     Point m_WindowSize;
 
+    FramePacer m_FramePacer;
+    PipelinedLoop m_PipelinedLoop;
+
     GameCheats m_GameCheats;
     GlobalOptions m_GlobalOptions;
     ControlOptions m_ControlOptions;
     DebugOptions m_DebugOptions;
 
+    // Prototypes are resolved, parents are already merged in
     ActorXmlPrototypeMap m_ActorXmlPrototypeMap;
     LevelMetadataMap m_LevelMetadataMap;
 };
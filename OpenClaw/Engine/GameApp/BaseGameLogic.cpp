@@ -7,6 +7,7 @@
 #include "../Resource/Loaders/PcxLoader.h"
 #include "../Events/EventMgr.h"
 #include "../Graphics2D/Image.h"
+#include "../Graphics2D/RenderCommands.h"
 #include "../Audio/Audio.h"
 
 #include "../Actor/Components/PositionComponent.h"
@@ -24,8 +25,10 @@
 #include "GameSaves.h"
 #include "BaseGameLogic.h"
 #include "GameSaves.h"
+#include "Benchmark.h"
 
 #include "../Physics/ClawPhysics.h"
+#include "../Physics/NavigationMap.h"
 
 #include <algorithm>
 #include <fstream>
@@ -177,9 +180,9 @@ void RenderLoadingScreen(shared_ptr<Image> pBackground, SDL_Rect& renderRect, Po
     }
 
     SDL_Renderer* pRenderer = g_pApp->GetRenderer();
-    SDL_RenderClear(pRenderer);
+    RenderCommands::Clear(pRenderer);
 
-    SDL_RenderCopy(pRenderer, pBackground->GetTexture(), &renderRect, NULL);
+    RenderCommands::Copy(pRenderer, pBackground->GetTexture(), &renderRect, NULL);
 
     // Progress bar
     int progressFullLength = renderRect.w / 2;
@@ -193,13 +196,13 @@ void RenderLoadingScreen(shared_ptr<Image> pBackground, SDL_Rect& renderRect, Po
     SDL_Texture* pRemainingProgressBar = Util::CreateSDLTextureRect(
         remainingProgressBarRect.w, remainingProgressBarRect.h, COLOR_RED, pRenderer);
 
-    SDL_RenderCopy(pRenderer, pTotalProgressBar, NULL, &totalProgressBarRect);
-    SDL_RenderCopy(pRenderer, pRemainingProgressBar, NULL, &remainingProgressBarRect);
+    RenderCommands::Copy(pRenderer, pTotalProgressBar, NULL, &totalProgressBarRect);
+    RenderCommands::Copy(pRenderer, pRemainingProgressBar, NULL, &remainingProgressBarRect);
 
     Util::RenderForcePresent(pRenderer);
 
-    SDL_DestroyTexture(pTotalProgressBar);
-    SDL_DestroyTexture(pRemainingProgressBar);
+    RenderCommands::DestroyTexture(pTotalProgressBar);
+    RenderCommands::DestroyTexture(pRemainingProgressBar);
 }
 
 bool BaseGameLogic::VLoadGame(const char* xmlLevelResource)
@@ -210,7 +213,10 @@ bool BaseGameLogic::VLoadGame(const char* xmlLevelResource)
     // Stop all audio
     g_pApp->GetAudio()->StopAllSounds();
 
+    // Prefabs were made with physics and palette of previous level
+    m_pActorFactory->ClearPrefabs();
     m_pPhysics.reset(CreateClawPhysics());
+    m_pNavigationMap.reset(new NavigationMap());
 
     float loadingProgress = 0.0f;
     float lastProgress = 0.0f;
@@ -718,6 +724,19 @@ StrongActorPtr BaseGameLogic::VCreateActor(TiXmlElement* pActorRoot, TiXmlElemen
     }
 }
 
+StrongActorPtr BaseGameLogic::CreateActorFromPrefab(ActorPrototype proto, const ActorPrefabOverrides& overrides)
+{
+    assert(m_pActorFactory);
+
+    StrongActorPtr pActor = m_pActorFactory->CreateActorFromPrefab(proto, overrides);
+    if (pActor)
+    {
+        m_ActorMap.insert(std::make_pair(pActor->GetGUID(), pActor));
+    }
+
+    return pActor;
+}
+
 void BaseGameLogic::VDestroyActor(const uint32 actorId)
 {
     // Trigger actor destroyed event prior removing it here
@@ -817,14 +836,21 @@ void BaseGameLogic::VOnUpdate(uint32 msDiff)
 
         case GameState_IngameRunning:
         {
+            if (m_pPhysics)
+            {
+                m_pPhysics->VOnFrameStart();
+            }
+
             if (m_pProcessMgr)
             {
+                BENCHMARK_SCOPE(BenchmarkSection_Processes);
                 m_pProcessMgr->UpdateProcesses(msDiff);
             }
             
             if (m_pPhysics)
             {
                 //PROFILE_CPU("PHYSICS");
+                BENCHMARK_SCOPE(BenchmarkSection_Physics);
                 // TODO: Add config to choose between fixed physics timestep and variable
                 if (true)
                 {
@@ -871,6 +897,8 @@ void BaseGameLogic::VOnUpdate(uint32 msDiff)
     msAccumulation += msDiff;
     if (msAccumulation >= 5)
     {
+        BENCHMARK_SCOPE(BenchmarkSection_Actors);
+
         // Update all game actors
         for (auto &actorIter : m_ActorMap)
         {
@@ -882,54 +910,59 @@ void BaseGameLogic::VOnUpdate(uint32 msDiff)
 
 void BaseGameLogic::VChangeState(GameState newState)
 {
-    if (newState == GameState_Menu)
+    // Loading polls events and draws loading screen directly, with pipelined loop it has to happen on the render
+    // thread while the simulation thread waits
+    RenderCommands::RunOnRenderThread([this, newState]()
     {
-        // Unload level if applicable
-        UnloadLevel();
-        if (!VEnterMenu("MENU.XML"))
+        if (newState == GameState_Menu)
         {
-            LOG_ERROR("Failed to enter menu");
-            g_pApp->Terminate();
-            exit(1);
+            // Unload level if applicable
+            UnloadLevel();
+            if (!VEnterMenu("MENU.XML"))
+            {
+                LOG_ERROR("Failed to enter menu");
+                g_pApp->Terminate();
+                exit(1);
+            }
         }
-    }
-    else if (newState == GameState_LoadingLevel)
-    {
-        // In case of debugging
-        if (m_pCurrentLevel == nullptr)
+        else if (newState == GameState_LoadingLevel)
         {
-            m_pCurrentLevel = ClawLevelUtil::GetDebugLoadLevelData();
-        }
+            // In case of debugging
+            if (m_pCurrentLevel == nullptr)
+            {
+                m_pCurrentLevel = ClawLevelUtil::GetDebugLoadLevelData();
+            }
 
-        int levelNumber = m_pCurrentLevel->GetLevelNumber();
-        assert(levelNumber >= 0 && levelNumber <= 14);
+            int levelNumber = m_pCurrentLevel->GetLevelNumber();
+            assert(levelNumber >= 0 && levelNumber <= 14);
 
-        std::string levelName = "LEVEL" + ToStr(levelNumber);
-        std::string wwdLevelPath = "/" + levelName + "/WORLDS/WORLD.WWD";
+            std::string levelName = "LEVEL" + ToStr(levelNumber);
+            std::string wwdLevelPath = "/" + levelName + "/WORLDS/WORLD.WWD";
 
-        // Load saved level file, e.g. LEVEL1.xml
-        if (!VLoadGame(wwdLevelPath.c_str()))
-        {
-            LOG_ERROR("Could not load level");
-            exit(1);
+            // Load saved level file, e.g. LEVEL1.xml
+            if (!VLoadGame(wwdLevelPath.c_str()))
+            {
+                LOG_ERROR("Could not load level");
+                exit(1);
+            }
         }
-    }
-    else if (newState == GameState_ScoreScreen)
-    {
-        // Dummy for testing
-        if (m_pCurrentLevel == nullptr)
+        else if (newState == GameState_ScoreScreen)
         {
-            m_pCurrentLevel.reset(new LevelData(1, false, 2));
-        }
+            // Dummy for testing
+            if (m_pCurrentLevel == nullptr)
+            {
+                m_pCurrentLevel.reset(new LevelData(1, false, 2));
+            }
 
-        std::string finishedLevelXmlDescPath = "/FINISHED_LEVEL_SCENES/LEVEL" + ToStr(m_pCurrentLevel->m_LeveNumber) + ".XML";
+            std::string finishedLevelXmlDescPath = "/FINISHED_LEVEL_SCENES/LEVEL" + ToStr(m_pCurrentLevel->m_LeveNumber) + ".XML";
 
-        if (!VLoadScoreScreen(finishedLevelXmlDescPath.c_str()))
-        {
-            LOG_ERROR("Could not load score screen");
-            exit(1);
+            if (!VLoadScoreScreen(finishedLevelXmlDescPath.c_str()))
+            {
+                LOG_ERROR("Could not load score screen");
+                exit(1);
+            }
         }
-    }
+    });
 
     LOG("Changing to: " + ToStr(newState));
     m_GameState = newState;
@@ -963,6 +996,21 @@ ActorFactory* BaseGameLogic::VCreateActorFactory()
 void BaseGameLogic::RequestDestroyActorDelegate(IEventDataPtr pEventData)
 {
     shared_ptr<EventData_Destroy_Actor> pCastEventData = static_pointer_cast<EventData_Destroy_Actor>(pEventData);
+
+    // Actors spawned from prefabs go back to their pool together with their physics body
+    auto findIt = m_ActorMap.find(pCastEventData->GetActorId());
+    StrongActorPtr pPooledActor = (findIt != m_ActorMap.end()) ?
+        m_pActorFactory->ReturnActorToPool(findIt->second) : nullptr;
+    if (pPooledActor)
+    {
+        m_ActorMap.erase(findIt);
+        if (m_pPhysics != nullptr)
+        {
+            m_pPhysics->VPoolActorBody(pCastEventData->GetActorId(), pPooledActor.get());
+        }
+        return;
+    }
+
     VDestroyActor(pCastEventData->GetActorId());
     if (m_pPhysics != nullptr)
     {
@@ -1006,6 +1054,17 @@ static FixtureType CollisonToFixtureType(CollisionType collisionType)
     return findIt->second;
 }
 
+// Tiles are also recorded in navigation map so that AI does not have to raycast against them
+void BaseGameLogic::AddStaticTileGeometry(const Point& position, const Point& size, CollisionType collisionType, FixtureType fixtureType)
+{
+    m_pPhysics->VAddStaticGeometry(position, size, collisionType, fixtureType);
+
+    if (m_pNavigationMap)
+    {
+        m_pNavigationMap->AddStaticGeometry(position, size, collisionType);
+    }
+}
+
 // Helper function
 void BaseGameLogic::CreateSinglePhysicsTile(int x, int y, const TileCollisionPrototype& proto)
 {
@@ -1015,7 +1074,7 @@ void BaseGameLogic::CreateSinglePhysicsTile(int x, int y, const TileCollisionPro
             y + tileCollisionRect.collisionRect.y);
         Point size = Point(tileCollisionRect.collisionRect.w, tileCollisionRect.collisionRect.h);
 
-        m_pPhysics->VAddStaticGeometry(
+        AddStaticTileGeometry(
             position, 
             size, 
             tileCollisionRect.collisionType, 
@@ -1028,7 +1087,7 @@ void BaseGameLogic::CreateSinglePhysicsTile(int x, int y, const TileCollisionPro
         Point position = Point(x, y) + topLadderOffset;
         Point size(64, 10);
 
-        m_pPhysics->VAddStaticGeometry(position, size, CollisionType_Ground, FixtureType_TopLadderGround);
+        AddStaticTileGeometry(position, size, CollisionType_Ground, FixtureType_TopLadderGround);
     }
 }
 
@@ -1102,7 +1161,7 @@ void BaseGameLogic::CollideableTileCreatedDelegate(IEventDataPtr pEventData)
             Point mergedPosition(tileX + mergedRect.collisionRect.x, tileY + mergedRect.collisionRect.y);
             Point mergedSize(tileProto.width * numTiles, mergedRect.collisionRect.h);
 
-            m_pPhysics->VAddStaticGeometry(
+            AddStaticTileGeometry(
                 mergedPosition, 
                 mergedSize, 
                 mergedRect.collisionType,
@@ -1137,6 +1196,8 @@ void BaseGameLogic::ItemPickedUpDelegate(IEventDataPtr pEventData)
 
 void BaseGameLogic::FinishedLevelDelegate(IEventDataPtr pEventData)
 {
+    // End level pickup pauses the game until the level is finished
+    m_bRunning = true;
     VChangeState(GameState_LoadingScoreScreen);
 }
 
@@ -1212,6 +1273,37 @@ StrongActorPtr BaseGameLogic::GetClawActor()
     return nullptr;
 }
 
+uint64 BaseGameLogic::ComputeWorldStateHash()
+{
+    uint64 stateHash = m_pPhysics ? m_pPhysics->VGetStateHash() : 0;
+
+    // Actor map is ordered by actor ID
+    for (auto &actorIter : m_ActorMap)
+    {
+        Actor* pActor = actorIter.second.get();
+
+        int32 actorState[3] = { (int32)actorIter.first, 0, 0 };
+        if (pActor->GetPositionComponent())
+        {
+            Point position = pActor->GetPositionComponent()->GetPosition();
+            stateHash = Util::CalcFNV1a64(&position.x, sizeof(position.x), stateHash);
+            stateHash = Util::CalcFNV1a64(&position.y, sizeof(position.y), stateHash);
+        }
+        if (HealthComponent* pHealthComponent = pActor->GetRawComponent<HealthComponent>())
+        {
+            actorState[1] = pHealthComponent->GetHealth();
+        }
+        if (ScoreComponent* pScoreComponent = pActor->GetRawComponent<ScoreComponent>())
+        {
+            actorState[2] = (int32)pScoreComponent->GetScore();
+        }
+
+        stateHash = Util::CalcFNV1a64(actorState, sizeof(actorState), stateHash);
+    }
+
+    return stateHash;
+}
+
 StrongActorPtr BaseGameLogic::FindActorByName(const std::string& name, bool bIsUnique)
 {
     StrongActorPtr pFoundActor = nullptr;
@@ -1271,7 +1363,9 @@ void BaseGameLogic::UnloadLevel()
 
     //m_pCurrentLevel.reset();
 
+    m_pActorFactory->ClearPrefabs();
     m_pPhysics.reset();
+    m_pNavigationMap.reset();
 }
 
 void BaseGameLogic::VResetLevel()
@@ -1292,6 +1386,7 @@ void BaseGameLogic::VResetLevel()
     IEventMgr::Get()->VUpdate(IEventMgr::kINFINITE);
 
     // Reset physics. TODO: is replacing pointer which is shared between multiple classes OK like this ?
+    m_pActorFactory->ClearPrefabs();
     m_pPhysics.reset(CreateClawPhysics());
 
     // Load new level
@@ -12,6 +12,7 @@ class GameSaveMgr;
 class LevelData;
 class ActorFactory;
 class BaseGameApp;
+class NavigationMap;
 class BaseGameLogic : public IGameLogic
 {
     // This is just to give game app access to game views
@@ -46,6 +47,8 @@ public:
     // Actor management
     virtual StrongActorPtr VCreateActor(const std::string& xmlActorResource, TiXmlElement* overrides);
     virtual StrongActorPtr VCreateActor(TiXmlElement* pActorRoot, TiXmlElement* overrides);
+    // NULL if the prototype can not be spawned from prefab, caller has to fall back to XML
+    StrongActorPtr CreateActorFromPrefab(ActorPrototype proto, const ActorPrefabOverrides& overrides);
     virtual void VDestroyActor(const uint32 actorId);
     virtual WeakActorPtr VGetActor(const uint32 actorId);
     virtual void VModifyActor(const uint32 actorId, TiXmlElement* overrides);
@@ -81,6 +84,8 @@ public:
 
     shared_ptr<LevelData> GetCurrentLevelData() { return m_pCurrentLevel; }
     shared_ptr<GameSaveMgr> GetGameSaveMgr() { return m_pGameSaveMgr; }
+    // Exists while a level is loaded
+    NavigationMap* GetNavigationMap() { return m_pNavigationMap.get(); }
 
     void UnloadLevel();
     void SetLevelData(shared_ptr<LevelData> pLevelData) { m_pCurrentLevel = pLevelData; }
@@ -90,6 +95,10 @@ public:
 
     StrongActorPtr GetClawActor();
 
+    // Hash of physics bodies, actor positions, health and score. Same input in deterministic (headless) runs
+    // has to produce the same sequence of hashes
+    uint64 ComputeWorldStateHash();
+
     StrongActorPtr FindActorByName(const std::string& name, bool bIsUnique);
     ActorList FindActorByName(const std::string& name);
 
@@ -128,6 +137,8 @@ protected:
 
     bool m_RenderDiagnostics;
     shared_ptr<IGamePhysics> m_pPhysics;
+    // Static tile geometry for AI queries, rebuilt with every level load
+    shared_ptr<NavigationMap> m_pNavigationMap;
     shared_ptr<LevelData> m_pCurrentLevel;
     shared_ptr<GameSaveMgr> m_pGameSaveMgr;
 
@@ -140,6 +151,7 @@ protected:
 private:
     void ExecuteStartupCommands(const std::string& startupCommandsFile);
     void CreateSinglePhysicsTile(int x, int y, const TileCollisionPrototype& proto);
+    void AddStaticTileGeometry(const Point& position, const Point& size, CollisionType collisionType, FixtureType fixtureType);
     //void LoadGameWorkerThread(const char* pXmlLevelPath, float* pProgress, bool* pRet);
 
     void RegisterAllDelegates();
@@ -0,0 +1,564 @@
+#include "Benchmark.h"
+#include "../Logger/Logger.h"
+#include "../Util/StringUtil.h"
+#include "../Util/Util.h"
+#include "../Util/Memory/AllocationTracker.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+struct ScriptedInputEvent
+{
+    uint32_t timeMs;
+    bool isKeyDown;
+    SDL_Keycode key;
+};
+
+struct BenchmarkState
+{
+    BenchmarkState()
+    {
+        isMeasuring = false;
+        isLevelRunning = false;
+        hasFailed = false;
+        numLoadFrames = 0;
+        numMeasuredFrames = 0;
+        nextInputEventIdx = 0;
+        pRecordFile = NULL;
+        recordStartTicks = 0;
+        initTimeMs = 0;
+        levelLoadTimeMs = 0;
+        loadAllocs = 0;
+    }
+
+    BenchmarkOptions options;
+
+    bool isMeasuring;
+    bool isLevelRunning;
+    bool hasFailed;
+    int numLoadFrames;
+    int numMeasuredFrames;
+
+    std::vector<ScriptedInputEvent> inputScript;
+    size_t nextInputEventIdx;
+
+    FILE* pRecordFile;
+    uint32_t recordStartTicks;
+
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point initializedTime;
+    std::chrono::steady_clock::time_point frameStartTime;
+    uint32_t initTimeMs;
+    uint32_t levelLoadTimeMs;
+    int64_t loadAllocs;
+
+    // Accumulated during current frame, sections may be entered more than once per frame
+    uint32_t frameSectionUs[BenchmarkSection_Max];
+    std::vector<uint32_t> sectionSamples[BenchmarkSection_Max];
+    std::vector<uint32_t> frameAllocSamples;
+    // Frame time if simulation (events + logic) of next frame overlapped with rendering of current one
+    std::vector<uint32_t> pipelinedFrameSamples;
+    std::vector<uint64_t> stateHashes;
+};
+
+static BenchmarkState g_BenchmarkState;
+
+static const char* g_BenchmarkSectionNames[BenchmarkSection_Max] =
+{
+    "frame",
+    "input",
+    "events",
+    "logic",
+    "processes",
+    "physics",
+    "actors",
+    "render"
+};
+
+static uint32_t GetElapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+static bool LoadInputScript(const std::string& scriptPath, std::vector<ScriptedInputEvent>& outEvents)
+{
+    std::ifstream scriptFile(scriptPath.c_str());
+    if (!scriptFile.is_open())
+    {
+        LOG_ERROR("Could not open input script: " + scriptPath);
+        return false;
+    }
+
+    std::string line;
+    int lineNum = 0;
+    while (std::getline(scriptFile, line))
+    {
+        lineNum++;
+
+        size_t commentPos = line.find('#');
+        if (commentPos != std::string::npos)
+        {
+            line.erase(commentPos);
+        }
+
+        std::istringstream lineStream(line);
+        uint32_t timeMs;
+        std::string action;
+        std::string keyName;
+        if (!(lineStream >> timeMs))
+        {
+            // Empty line
+            continue;
+        }
+
+        lineStream >> action;
+        // Key names may contain spaces, e.g. "Left Shift"
+        std::getline(lineStream >> std::ws, keyName);
+
+        ScriptedInputEvent inputEvent;
+        inputEvent.timeMs = timeMs;
+        inputEvent.isKeyDown = action == "down";
+        inputEvent.key = SDL_GetKeyFromName(keyName.c_str());
+        if ((action != "down" && action != "up") || inputEvent.key == SDLK_UNKNOWN)
+        {
+            LOG_ERROR("Malformed input script line " + ToStr(lineNum) + ": " + line);
+            return false;
+        }
+
+        outEvents.push_back(inputEvent);
+    }
+
+    std::stable_sort(outEvents.begin(), outEvents.end(),
+        [](const ScriptedInputEvent& lhs, const ScriptedInputEvent& rhs) { return lhs.timeMs < rhs.timeMs; });
+
+    return true;
+}
+
+static void WriteDistribution(FILE* pFile, const char* name, std::vector<uint32_t> samples, const char* unit, bool isLast)
+{
+    uint64_t sum = 0;
+    for (uint32_t sample : samples)
+    {
+        sum += sample;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) -> uint32_t
+    {
+        if (samples.empty())
+        {
+            return 0;
+        }
+        return samples[(size_t)(p * (samples.size() - 1) + 0.5)];
+    };
+
+    fprintf(pFile, "    \"%s\": { \"mean%s\": %.1f, \"p50%s\": %u, \"p90%s\": %u, \"p99%s\": %u, \"max%s\": %u }%s\n",
+        name,
+        unit, samples.empty() ? 0.0 : (double)sum / samples.size(),
+        unit, percentile(0.5),
+        unit, percentile(0.9),
+        unit, percentile(0.99),
+        unit, samples.empty() ? 0 : samples.back(),
+        isLast ? "" : ",");
+}
+
+namespace Benchmark
+{
+    bool ParseCommandLine(int argc, char** argv, BenchmarkOptions& outOptions)
+    {
+        for (int argIdx = 1; argIdx < argc; argIdx++)
+        {
+            std::string arg = argv[argIdx];
+            bool hasValue = argIdx + 1 < argc;
+
+            if (arg == "--benchmark")
+            {
+                outOptions.isHeadless = true;
+                continue;
+            }
+
+            if (arg == "--verify-prototype-cache")
+            {
+                outOptions.verifyPrototypeCache = true;
+                continue;
+            }
+
+            if (arg != "--level" && arg != "--frames" && arg != "--frame-time" && arg != "--input" &&
+                arg != "--output" && arg != "--record-input" && arg != "--seed" && arg != "--state-hash")
+            {
+                continue;
+            }
+
+            if (!hasValue)
+            {
+                LOG_ERROR("Missing value of command line argument: " + arg);
+                return false;
+            }
+
+            std::string value = argv[++argIdx];
+            if (arg == "--level")
+            {
+                outOptions.levelNumber = atoi(value.c_str());
+                if (outOptions.levelNumber < 1 || outOptions.levelNumber > 13)
+                {
+                    LOG_ERROR("Level number has to be between 1 and 13, got: " + value);
+                    return false;
+                }
+            }
+            else if (arg == "--frames")
+            {
+                outOptions.numFrames = atoi(value.c_str());
+                if (outOptions.numFrames <= 0)
+                {
+                    LOG_ERROR("Invalid number of frames: " + value);
+                    return false;
+                }
+            }
+            else if (arg == "--frame-time")
+            {
+                int frameTimeMs = atoi(value.c_str());
+                if (frameTimeMs <= 0)
+                {
+                    LOG_ERROR("Invalid frame time: " + value);
+                    return false;
+                }
+                outOptions.frameTimeMs = frameTimeMs;
+            }
+            else if (arg == "--input")
+            {
+                outOptions.inputScriptFile = value;
+            }
+            else if (arg == "--output")
+            {
+                outOptions.outputFile = value;
+            }
+            else if (arg == "--record-input")
+            {
+                outOptions.recordInputFile = value;
+            }
+            else if (arg == "--seed")
+            {
+                outOptions.randomSeed = (uint32_t)strtoul(value.c_str(), NULL, 10);
+            }
+            else if (arg == "--state-hash")
+            {
+                outOptions.stateHashFile = value;
+            }
+        }
+
+        return true;
+    }
+
+    bool Start(const BenchmarkOptions& options)
+    {
+        BenchmarkState& state = g_BenchmarkState;
+        state.options = options;
+        state.startTime = std::chrono::steady_clock::now();
+
+        if (!options.inputScriptFile.empty())
+        {
+            if (!LoadInputScript(options.inputScriptFile, state.inputScript))
+            {
+                return false;
+            }
+            LOG("Loaded " + ToStr((int)state.inputScript.size()) + " scripted input events from: " + options.inputScriptFile);
+        }
+
+        if (!options.recordInputFile.empty())
+        {
+            state.pRecordFile = fopen(options.recordInputFile.c_str(), "w");
+            if (state.pRecordFile == NULL)
+            {
+                LOG_ERROR("Could not open input record file: " + options.recordInputFile);
+                return false;
+            }
+            fprintf(state.pRecordFile, "# <ms since level start> <down|up> <key>\n");
+        }
+
+        if (options.isHeadless)
+        {
+            Util::SetRandomSeed(options.randomSeed);
+            Util::EnableSimulatedClock();
+
+            LOG("Running headless benchmark of level " + ToStr(options.levelNumber) + ", " +
+                ToStr(options.numFrames) + " frames, " + ToStr((int)options.frameTimeMs) + " ms per frame, seed " +
+                ToStr(options.randomSeed));
+        }
+
+        return true;
+    }
+
+    const BenchmarkOptions& GetOptions()
+    {
+        return g_BenchmarkState.options;
+    }
+
+    bool IsHeadless()
+    {
+        return g_BenchmarkState.options.isHeadless;
+    }
+
+    bool IsMeasuring()
+    {
+        return g_BenchmarkState.isMeasuring;
+    }
+
+    void OnInitialized()
+    {
+        BenchmarkState& state = g_BenchmarkState;
+        state.initializedTime = std::chrono::steady_clock::now();
+        state.initTimeMs = GetElapsedMs(state.startTime, state.initializedTime);
+    }
+
+    void OnLevelRunning()
+    {
+        BenchmarkState& state = g_BenchmarkState;
+        if (state.isLevelRunning)
+        {
+            return;
+        }
+
+        state.isLevelRunning = true;
+        state.recordStartTicks = SDL_GetTicks();
+        if (!state.options.isHeadless)
+        {
+            return;
+        }
+
+        state.levelLoadTimeMs = GetElapsedMs(state.initializedTime, std::chrono::steady_clock::now());
+        state.loadAllocs = AllocationTracker::GetTotalStats().totalAllocs;
+        state.isMeasuring = true;
+
+        for (int sectionIdx = 0; sectionIdx < BenchmarkSection_Max; sectionIdx++)
+        {
+            state.sectionSamples[sectionIdx].reserve(state.options.numFrames);
+        }
+        state.frameAllocSamples.reserve(state.options.numFrames);
+
+        LOG("Level " + ToStr(state.options.levelNumber) + " loaded in " + ToStr((int)state.levelLoadTimeMs) + " ms");
+    }
+
+    void InjectInput()
+    {
+        BenchmarkState& state = g_BenchmarkState;
+        if (!state.isMeasuring)
+        {
+            return;
+        }
+
+        // Simulated time of the frame which is about to be processed
+        uint32_t frameTimeMs = state.numMeasuredFrames * state.options.frameTimeMs;
+        while (state.nextInputEventIdx < state.inputScript.size() &&
+            state.inputScript[state.nextInputEventIdx].timeMs <= frameTimeMs)
+        {
+            const ScriptedInputEvent& inputEvent = state.inputScript[state.nextInputEventIdx++];
+
+            SDL_Event event;
+            memset(&event, 0, sizeof(event));
+            event.type = inputEvent.isKeyDown ? SDL_KEYDOWN : SDL_KEYUP;
+            event.key.state = inputEvent.isKeyDown ? SDL_PRESSED : SDL_RELEASED;
+            event.key.keysym.sym = inputEvent.key;
+            event.key.keysym.scancode = SDL_GetScancodeFromKey(inputEvent.key);
+            SDL_PushEvent(&event);
+        }
+    }
+
+    void RecordInput(const SDL_Event& event)
+    {
+        BenchmarkState& state = g_BenchmarkState;
+        if (state.pRecordFile == NULL || !state.isLevelRunning)
+        {
+            return;
+        }
+
+        if ((event.type != SDL_KEYDOWN && event.type != SDL_KEYUP) || event.key.repeat != 0)
+        {
+            return;
+        }
+
+        fprintf(state.pRecordFile, "%u %s %s\n",
+            SDL_GetTicks() - state.recordStartTicks,
+            event.type == SDL_KEYDOWN ? "down" : "up",
+            SDL_GetKeyName(event.key.keysym.sym));
+    }
+
+    void OnFrameBegin()
+    {
+        BenchmarkState& state = g_BenchmarkState;
+        if (!state.isMeasuring)
+        {
+            return;
+        }
+
+        state.frameStartTime = std::chrono::steady_clock::now();
+        memset(state.frameSectionUs, 0, sizeof(state.frameSectionUs));
+    }
+
+    bool OnFrameEnd()
+    {
+        BenchmarkState& state = g_BenchmarkState;
+        if (!state.options.isHeadless)
+        {
+            return true;
+        }
+
+        Util::AdvanceSimulatedClock(state.options.frameTimeMs);
+
+        if (!state.isMeasuring)
+        {
+            if (++state.numLoadFrames > state.options.maxLoadFrames)
+            {
+                LOG_ERROR("Level " + ToStr(state.options.levelNumber) + " did not start in " +
+                    ToStr(state.options.maxLoadFrames) + " frames");
+                state.hasFailed = true;
+                return false;
+            }
+            return true;
+        }
+
+        state.frameSectionUs[BenchmarkSection_Frame] = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - state.frameStartTime).count();
+        for (int sectionIdx = 0; sectionIdx < BenchmarkSection_Max; sectionIdx++)
+        {
+            state.sectionSamples[sectionIdx].push_back(state.frameSectionUs[sectionIdx]);
+        }
+        state.frameAllocSamples.push_back((uint32_t)AllocationTracker::GetTotalStats().frameAllocs);
+
+        uint32_t frameUs = state.frameSectionUs[BenchmarkSection_Frame];
+        uint32_t simulationUs = state.frameSectionUs[BenchmarkSection_Events] +
+            state.frameSectionUs[BenchmarkSection_Logic];
+        uint32_t overlapUs = std::min(std::min(simulationUs, state.frameSectionUs[BenchmarkSection_Render]), frameUs);
+        state.pipelinedFrameSamples.push_back(frameUs - overlapUs);
+
+        state.numMeasuredFrames++;
+        if (state.numMeasuredFrames >= state.options.numFrames)
+        {
+            state.isMeasuring = false;
+            return false;
+        }
+
+        return true;
+    }
+
+    void AddSample(BenchmarkSection section, uint32_t durationUs)
+    {
+        g_BenchmarkState.frameSectionUs[section] += durationUs;
+    }
+
+    bool IsStateHashRequested()
+    {
+        return g_BenchmarkState.isMeasuring && !g_BenchmarkState.options.stateHashFile.empty();
+    }
+
+    void AddStateHash(uint64_t stateHash)
+    {
+        g_BenchmarkState.stateHashes.push_back(stateHash);
+    }
+
+    bool Finish()
+    {
+        BenchmarkState& state = g_BenchmarkState;
+
+        if (state.pRecordFile != NULL)
+        {
+            fclose(state.pRecordFile);
+            state.pRecordFile = NULL;
+        }
+
+        if (!state.options.isHeadless)
+        {
+            return true;
+        }
+
+        FILE* pFile = fopen(state.options.outputFile.c_str(), "w");
+        if (pFile == NULL)
+        {
+            LOG_ERROR("Could not open benchmark output file: " + state.options.outputFile);
+            return false;
+        }
+
+        fprintf(pFile, "{\n");
+        fprintf(pFile, "  \"level\": %d,\n", state.options.levelNumber);
+        fprintf(pFile, "  \"success\": %s,\n", state.hasFailed ? "false" : "true");
+        fprintf(pFile, "  \"frames\": %d,\n", state.numMeasuredFrames);
+        fprintf(pFile, "  \"frameTimeMs\": %u,\n", state.options.frameTimeMs);
+        fprintf(pFile, "  \"initTimeMs\": %u,\n", state.initTimeMs);
+        fprintf(pFile, "  \"levelLoadTimeMs\": %u,\n", state.levelLoadTimeMs);
+        fprintf(pFile, "  \"totalTimeMs\": %u,\n", GetElapsedMs(state.startTime, std::chrono::steady_clock::now()));
+        fprintf(pFile, "  \"seed\": %u,\n", state.options.randomSeed);
+        if (!state.options.stateHashFile.empty())
+        {
+            uint64_t runHash = Util::CalcFNV1a64(state.stateHashes.data(), state.stateHashes.size() * sizeof(uint64_t));
+            fprintf(pFile, "  \"stateHash\": \"%016llx\",\n", (unsigned long long)runHash);
+        }
+
+        fprintf(pFile, "  \"sections\": {\n");
+        for (int sectionIdx = 0; sectionIdx < BenchmarkSection_Max; sectionIdx++)
+        {
+            WriteDistribution(pFile, g_BenchmarkSectionNames[sectionIdx], state.sectionSamples[sectionIdx], "Us",
+                sectionIdx == BenchmarkSection_Max - 1);
+        }
+        fprintf(pFile, "  },\n");
+
+        fprintf(pFile, "  \"pipelineEstimate\": {\n");
+        WriteDistribution(pFile, "serial", state.sectionSamples[BenchmarkSection_Frame], "Us", false);
+        WriteDistribution(pFile, "pipelined", state.pipelinedFrameSamples, "Us", true);
+        fprintf(pFile, "  },\n");
+
+        fprintf(pFile, "  \"allocations\": {\n");
+        fprintf(pFile, "    \"tracked\": %s,\n", AllocationTracker::IsEnabled() ? "true" : "false");
+        fprintf(pFile, "    \"load\": %lld,\n", (long long)state.loadAllocs);
+        WriteDistribution(pFile, "perFrame", state.frameAllocSamples, "", false);
+        fprintf(pFile, "    \"tags\": {\n");
+        for (int tagIdx = 0; tagIdx < AllocTag_Max; tagIdx++)
+        {
+            AllocTagStats stats = AllocationTracker::GetTagStats(AllocTag(tagIdx));
+            fprintf(pFile, "      \"%s\": { \"totalAllocs\": %lld, \"peakFrameAllocs\": %lld, \"peakBytes\": %lld }%s\n",
+                AllocationTracker::AllocTagToString(AllocTag(tagIdx)),
+                (long long)stats.totalAllocs,
+                (long long)stats.peakFrameAllocs,
+                (long long)stats.peakBytes,
+                tagIdx == AllocTag_Max - 1 ? "" : ",");
+        }
+        fprintf(pFile, "    }\n");
+        fprintf(pFile, "  }\n");
+        fprintf(pFile, "}\n");
+        fclose(pFile);
+
+        LOG("Benchmark results written to: " + state.options.outputFile);
+
+        if (!state.options.stateHashFile.empty())
+        {
+            FILE* pHashFile = fopen(state.options.stateHashFile.c_str(), "w");
+            if (pHashFile == NULL)
+            {
+                LOG_ERROR("Could not open state hash file: " + state.options.stateHashFile);
+                return false;
+            }
+
+            fprintf(pHashFile, "# <frame> <world state hash>\n");
+            for (size_t frameIdx = 0; frameIdx < state.stateHashes.size(); frameIdx++)
+            {
+                fprintf(pHashFile, "%u %016llx\n", (uint32_t)frameIdx, (unsigned long long)state.stateHashes[frameIdx]);
+            }
+            fclose(pHashFile);
+        }
+
+        return !state.hasFailed;
+    }
+
+    const char* BenchmarkSectionToString(BenchmarkSection section)
+    {
+        if (section < 0 || section >= BenchmarkSection_Max)
+        {
+            return "unknown";
+        }
+
+        return g_BenchmarkSectionNames[section];
+    }
+}
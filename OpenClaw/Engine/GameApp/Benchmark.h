@@ -0,0 +1,147 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <stdint.h>
+#include <string>
+#include <chrono>
+#include <SDL2/SDL.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Benchmark
+//
+// Headless benchmark mode, started from command line:
+//
+//   openclaw --benchmark --level 3 --frames 3000 [--frame-time 16] [--input input.txt] [--output result.json]
+//            [--seed 1] [--state-hash hashes.txt] [--verify-prototype-cache]
+//
+// SDL then runs with its dummy video and audio drivers and a software renderer so neither display nor sound device
+// is needed. The menu is skipped, the main loop advances by a fixed simulated frame time and scripted input is
+// injected as SDL keyboard events. When the requested number of in-game frames is done, load times, per-subsystem
+// frame time percentiles and allocation counts are written to the output file as JSON.
+//
+// Headless runs are deterministic: game clock (Util::GetTicks) is simulated and only moves by the frame time, the
+// session RNG is seeded with --seed. With --state-hash, world state hash of every measured frame is written to the
+// given file and a hash of the whole run is added to the JSON, two runs with the same input have to match.
+//
+// With --verify-prototype-cache, startup tests additionally check that compiled prototype cache yields the same actor
+// prototypes and level metadata as their XML files, the run fails before the level is loaded otherwise.
+//
+// The report also contains pipelineEstimate - frame time distribution as it would be if simulation (events and logic)
+// of the next frame ran on its own thread while the current frame is rendered, i.e. the frame time minus the shorter
+// of the two. It tells how much the pipelined loop (Display/PipelinedLoop, see PipelinedLoop) gains on given level,
+// headless runs themselves always use the serial loop.
+//
+// Input scripts contain one "<ms since level start> <down|up> <SDL key name>" entry per line, '#' starts a comment.
+// Running the game normally with --record-input <file> writes the keyboard input of the session in this format.
+//---------------------------------------------------------------------------------------------------------------------
+
+enum BenchmarkSection
+{
+    BenchmarkSection_Frame,
+    BenchmarkSection_Input,
+    BenchmarkSection_Events,
+    BenchmarkSection_Logic,     // Includes processes, physics and actors
+    BenchmarkSection_Processes,
+    BenchmarkSection_Physics,
+    BenchmarkSection_Actors,
+    BenchmarkSection_Render,
+    BenchmarkSection_Max
+};
+
+struct BenchmarkOptions
+{
+    BenchmarkOptions()
+    {
+        isHeadless = false;
+        levelNumber = 1;
+        numFrames = 1000;
+        frameTimeMs = 16;
+        maxLoadFrames = 1000;
+        randomSeed = 1;
+        outputFile = "benchmark.json";
+        verifyPrototypeCache = false;
+    }
+
+    bool isHeadless;
+    int levelNumber;
+    int numFrames;
+    uint32_t frameTimeMs;
+    // Run fails if level is not running after this many frames
+    int maxLoadFrames;
+    uint32_t randomSeed;
+    std::string inputScriptFile;
+    std::string outputFile;
+    std::string recordInputFile;
+    std::string stateHashFile;
+    bool verifyPrototypeCache;
+};
+
+namespace Benchmark
+{
+    // Unknown arguments are ignored, returns false only for malformed benchmark arguments
+    bool ParseCommandLine(int argc, char** argv, BenchmarkOptions& outOptions);
+
+    bool Start(const BenchmarkOptions& options);
+    const BenchmarkOptions& GetOptions();
+
+    bool IsHeadless();
+    // True while in-game frames of headless run are being sampled
+    bool IsMeasuring();
+
+    void OnInitialized();
+    // Called every frame the game is running a level, only the first call matters
+    void OnLevelRunning();
+
+    // Pushes scripted input events which are due in current frame to SDL event queue
+    void InjectInput();
+    void RecordInput(const SDL_Event& event);
+
+    void OnFrameBegin();
+    // Returns false when the benchmark run is over
+    bool OnFrameEnd();
+    void AddSample(BenchmarkSection section, uint32_t durationUs);
+
+    // True while measuring with --state-hash, world state hash of the frame is then expected every frame
+    bool IsStateHashRequested();
+    void AddStateHash(uint64_t stateHash);
+
+    // Writes the JSON report, returns false if the run failed
+    bool Finish();
+
+    const char* BenchmarkSectionToString(BenchmarkSection section);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// BenchmarkScope - measures its lifetime and accounts it to given section. Does nothing outside of benchmark runs
+//---------------------------------------------------------------------------------------------------------------------
+class BenchmarkScope
+{
+public:
+    explicit BenchmarkScope(BenchmarkSection section)
+    {
+        m_Section = section;
+        m_IsActive = Benchmark::IsMeasuring();
+        if (m_IsActive)
+        {
+            m_StartTime = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~BenchmarkScope()
+    {
+        if (m_IsActive)
+        {
+            Benchmark::AddSample(m_Section, (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - m_StartTime).count());
+        }
+    }
+
+private:
+    BenchmarkSection m_Section;
+    bool m_IsActive;
+    std::chrono::steady_clock::time_point m_StartTime;
+};
+
+#define BENCHMARK_SCOPE(section) BenchmarkScope _BENCHMARK_SCOPE_(section);
+
+#endif
@@ -1,6 +1,7 @@
 #include "BaseGameApp.h"
 #include "BaseGameLogic.h"
 #include "../UserInterface/Console.h"
+#include "../UserInterface/HumanView.h"
 
 #include "../Actor/Components/ControllerComponents/PowerupComponent.h"
 
@@ -175,6 +176,33 @@ void CommandHandler::HandleCommand(const char* command, void* userdata)
         wasCommandExecuted = true;
     }
 
+    if (commandStr.find("targetfps ") != std::string::npos && commandArgs.size() == 2)
+    {
+        g_pApp->m_GameOptions.targetFps = std::stoi(commandArgs[1]);
+        g_pApp->m_FramePacer.SetTargetFps(g_pApp->m_GameOptions.targetFps);
+        wasCommandExecuted = true;
+    }
+
+    if (commandStr == "framestats" || commandStr == "framestats reset")
+    {
+        if (commandStr == "framestats reset")
+        {
+            g_pApp->m_FramePacer.ResetStats();
+            pConsole->AddLine("Frame stats were reset.", COLOR_GREEN);
+        }
+        else
+        {
+            std::vector<std::string> statLines;
+            g_pApp->m_FramePacer.DumpStats(statLines);
+            for (const std::string& line : statLines)
+            {
+                pConsole->AddLine(line, COLOR_WHITE);
+                LOG(line);
+            }
+        }
+        wasCommandExecuted = true;
+    }
+
     if (commandStr == "reload levelmetadata")
     {
         g_pApp->ReadLevelMetadata(g_pApp->m_GameOptions);
@@ -192,6 +220,140 @@ void CommandHandler::HandleCommand(const char* command, void* userdata)
         wasCommandExecuted = true;
     }
 
+    if (commandStr == "memstats")
+    {
+        std::vector<std::string> statLines;
+        AllocationTracker::DumpStats(statLines);
+        for (const std::string& line : statLines)
+        {
+            pConsole->AddLine(line, COLOR_WHITE);
+            LOG(line);
+        }
+        wasCommandExecuted = true;
+    }
+    else if (commandStr == "memstats reset")
+    {
+        AllocationTracker::ResetPeaks();
+        pConsole->AddLine("Allocation peaks were reset.", COLOR_GREEN);
+        wasCommandExecuted = true;
+    }
+
+    // raycaststats [off] - first use enables the stats, they are shown from the next frame
+    if (commandStr == "raycaststats" || commandStr == "raycaststats off")
+    {
+        shared_ptr<IGamePhysics> pPhysics = g_pApp->GetGameLogic() ? g_pApp->GetGameLogic()->VGetGamePhysics() : nullptr;
+        if (commandStr == "raycaststats off")
+        {
+            if (pPhysics)
+            {
+                pPhysics->VSetRaycastStatsEnabled(false);
+            }
+            pConsole->AddLine("Raycast stats disabled", COLOR_WHITE);
+        }
+        else if (pPhysics && !pPhysics->VIsRaycastStatsEnabled())
+        {
+            pPhysics->VSetRaycastStatsEnabled(true);
+            pConsole->AddLine("Raycast stats enabled", COLOR_WHITE);
+        }
+        else if (pPhysics)
+        {
+            RaycastStats stats = pPhysics->VGetRaycastStats();
+            pConsole->AddLine("Raycasts last frame: " + ToStr(stats.numQueries) + " queries (" +
+                ToStr(stats.numStaticQueries) + " static), " + ToStr(stats.numCacheHits) + " cache hits, " +
+                ToStr(stats.numWorldRaycasts) + " world raycasts, " + ToStr(stats.totalTimeUs) + " us", COLOR_WHITE);
+        }
+        wasCommandExecuted = true;
+    }
+
+    // membudget <tag> <max allocations per frame>, 0 removes the budget
+    if (commandStr.find("membudget ") == 0 && commandArgs.size() == 3)
+    {
+        AllocTag tag = AllocationTracker::StringToAllocTag(commandArgs[1]);
+        if (tag == AllocTag_Max)
+        {
+            pConsole->AddLine("Unknown allocation tag: " + commandArgs[1], COLOR_RED);
+        }
+        else
+        {
+            AllocationTracker::SetFrameAllocBudget(tag, std::stoi(commandArgs[2]));
+            pConsole->AddLine("Allocation budget of " + commandArgs[1] + " set to " + commandArgs[2] + " per frame.", COLOR_GREEN);
+        }
+        wasCommandExecuted = true;
+    }
+
+    // loglevel <level> or loglevel <category> <level>
+    if (commandStr.find("loglevel ") == 0 && (commandArgs.size() == 2 || commandArgs.size() == 3))
+    {
+        LogCategory category = commandArgs.size() == 3 ? Logger::StringToLogCategory(commandArgs[1]) : LogCategory_Max;
+        LogLevel level = Logger::StringToLogLevel(commandArgs.back());
+        if (commandArgs.size() == 3 && category == LogCategory_Max)
+        {
+            pConsole->AddLine("Unknown log category: " + commandArgs[1], COLOR_RED);
+        }
+        else if (level == LogLevel_None && commandArgs.back() != "none")
+        {
+            pConsole->AddLine("Unknown log level: " + commandArgs.back(), COLOR_RED);
+        }
+        else if (commandArgs.size() == 3)
+        {
+            Logger::SetCategoryLevel(category, level);
+            pConsole->AddLine("Log level of " + commandArgs[1] + " set to " + commandArgs[2] + ".", COLOR_GREEN);
+        }
+        else
+        {
+            Logger::SetLevel(level);
+            pConsole->AddLine("Log level set to " + commandArgs[1] + ".", COLOR_GREEN);
+        }
+        wasCommandExecuted = true;
+    }
+
+    if (commandStr == "logstats")
+    {
+        LoggerStats stats = Logger::GetStats();
+        pConsole->AddLine("Written: " + ToStr((unsigned long)stats.numWritten) +
+            ", Dropped: " + ToStr((unsigned long)stats.numDropped) +
+            ", Suppressed: " + ToStr((unsigned long)stats.numSuppressed) +
+            ", Truncated: " + ToStr((unsigned long)stats.numTruncated), COLOR_WHITE);
+        wasCommandExecuted = true;
+    }
+
+    if (commandStr == "poolstats")
+    {
+        std::vector<std::string> statLines;
+        MemoryPoolMgr::DumpStats(statLines);
+        for (const std::string& line : statLines)
+        {
+            pConsole->AddLine(line, COLOR_WHITE);
+            LOG(line);
+        }
+        wasCommandExecuted = true;
+    }
+
+    if (commandStr == "processstats" || commandStr == "processstats reset")
+    {
+        ProcessMgr* pProcessMgr = g_pApp->GetHumanView() ? g_pApp->GetHumanView()->GetProcessMgr() : NULL;
+        if (pProcessMgr == NULL)
+        {
+            pConsole->AddLine("No process manager is running.", COLOR_RED);
+        }
+        else if (commandStr == "processstats reset")
+        {
+            pProcessMgr->ResetProcessTypeStats();
+            pConsole->AddLine("Process stats were reset.", COLOR_GREEN);
+        }
+        else
+        {
+            std::vector<std::string> statLines;
+            pProcessMgr->DumpProcessTypeStats(statLines);
+            for (const std::string& line : statLines)
+            {
+                pConsole->AddLine(line, COLOR_WHITE);
+                LOG(line);
+            }
+        }
+        wasCommandExecuted = true;
+    }
+
     if (commandStr.find("winresize ") != std::string::npos && commandArgs.size() == 4)
     {
         g_pApp->SetWindowSize(std::stoi(commandArgs[1]), std::stoi(commandArgs[2]), std::stod(commandArgs[3]));
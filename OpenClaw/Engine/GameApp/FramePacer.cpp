@@ -0,0 +1,202 @@
+#include "FramePacer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+
+// Below this much time left until the deadline the pacer spins instead of sleeping
+static const uint32_t SPIN_THRESHOLD_US = 2000;
+
+void FrameTimeStats::Reset()
+{
+    memset(histogram, 0, sizeof(histogram));
+    frameCount = 0;
+    totalFrameUs = 0;
+    maxFrameUs = 0;
+    missedVSyncCount = 0;
+    totalSleepUs = 0;
+    totalSpinUs = 0;
+}
+
+FramePacer::FramePacer()
+    :
+    m_CountsPerSecond(1),
+    m_LastFrameStart(0),
+    m_NextDeadline(0),
+    m_RemainderCounts(0),
+    m_LastFrameUs(0),
+    m_TargetFps(0),
+    m_TargetPeriodCounts(0),
+    m_IsVSyncEnabled(false),
+    m_RefreshPeriodUs(0)
+{
+
+}
+
+void FramePacer::Initialize(int targetFps, bool isVSyncEnabled, int displayRefreshRate)
+{
+    m_CountsPerSecond = SDL_GetPerformanceFrequency();
+    m_LastFrameStart = SDL_GetPerformanceCounter();
+    m_RemainderCounts = 0;
+    m_LastFrameUs = 0;
+
+    m_IsVSyncEnabled = isVSyncEnabled;
+    m_RefreshPeriodUs = displayRefreshRate > 0 ? 1000000 / displayRefreshRate : 0;
+
+    SetTargetFps(targetFps);
+    m_Stats.Reset();
+}
+
+void FramePacer::SetTargetFps(int targetFps)
+{
+    m_TargetFps = targetFps > 0 ? targetFps : 0;
+    m_TargetPeriodCounts = m_TargetFps > 0 ? m_CountsPerSecond / m_TargetFps : 0;
+    // Deadlines start again from the current frame
+    m_NextDeadline = 0;
+}
+
+uint32_t FramePacer::BeginFrame()
+{
+    uint64_t now = SDL_GetPerformanceCounter();
+    uint64_t elapsedCounts = now - m_LastFrameStart;
+    m_LastFrameStart = now;
+
+    m_LastFrameUs = (uint32_t)CountsToUs(elapsedCounts);
+    RecordFrame(m_LastFrameUs);
+
+    // Carry the part of millisecond which did not make it to this frame
+    elapsedCounts += m_RemainderCounts;
+    uint64_t elapsedMs = elapsedCounts * 1000 / m_CountsPerSecond;
+    m_RemainderCounts = elapsedCounts - elapsedMs * m_CountsPerSecond / 1000;
+
+    return (uint32_t)elapsedMs;
+}
+
+void FramePacer::EndFrame()
+{
+#ifndef __EMSCRIPTEN__
+    if (m_TargetPeriodCounts == 0)
+    {
+        return;
+    }
+
+    if (m_NextDeadline == 0)
+    {
+        m_NextDeadline = m_LastFrameStart + m_TargetPeriodCounts;
+    }
+
+    uint64_t now = SDL_GetPerformanceCounter();
+    if (now >= m_NextDeadline + m_TargetPeriodCounts)
+    {
+        // Too far behind, catching up would only produce burst of short frames
+        m_NextDeadline = now;
+    }
+    else
+    {
+        WaitUntil(m_NextDeadline);
+    }
+
+    m_NextDeadline += m_TargetPeriodCounts;
+#endif
+}
+
+void FramePacer::DumpStats(std::vector<std::string>& outLines) const
+{
+    char line[256];
+
+    double avgFrameMs = m_Stats.frameCount > 0 ? m_Stats.totalFrameUs / 1000.0 / m_Stats.frameCount : 0.0;
+    snprintf(line, sizeof(line), "Frames: %u, avg: %.2f ms (%.1f fps), max: %.2f ms",
+        m_Stats.frameCount,
+        avgFrameMs,
+        avgFrameMs > 0.0 ? 1000.0 / avgFrameMs : 0.0,
+        m_Stats.maxFrameUs / 1000.0);
+    outLines.push_back(line);
+
+    snprintf(line, sizeof(line), "Target fps: %d, vsync: %s, missed vsync intervals: %u",
+        m_TargetFps,
+        m_IsVSyncEnabled ? (m_RefreshPeriodUs > 0 ? "on" : "on (unknown refresh rate)") : "off",
+        m_Stats.missedVSyncCount);
+    outLines.push_back(line);
+
+    snprintf(line, sizeof(line), "Waiting: %llu ms sleeping, %llu ms spinning",
+        (unsigned long long)(m_Stats.totalSleepUs / 1000),
+        (unsigned long long)(m_Stats.totalSpinUs / 1000));
+    outLines.push_back(line);
+
+    for (uint32_t bucketIdx = 0; bucketIdx < FrameTimeStats::HISTOGRAM_BUCKET_COUNT; bucketIdx++)
+    {
+        uint32_t count = m_Stats.histogram[bucketIdx];
+        if (count == 0)
+        {
+            continue;
+        }
+
+        if (bucketIdx == FrameTimeStats::HISTOGRAM_BUCKET_COUNT - 1)
+        {
+            snprintf(line, sizeof(line), "  %3u+    ms: %8u (%5.1f%%)", bucketIdx, count,
+                100.0 * count / m_Stats.frameCount);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "  %3u-%-3u ms: %8u (%5.1f%%)", bucketIdx, bucketIdx + 1, count,
+                100.0 * count / m_Stats.frameCount);
+        }
+        outLines.push_back(line);
+    }
+}
+
+uint64_t FramePacer::CountsToUs(uint64_t counts) const
+{
+    return counts * 1000000 / m_CountsPerSecond;
+}
+
+void FramePacer::WaitUntil(uint64_t deadline)
+{
+    uint64_t waitStart = SDL_GetPerformanceCounter();
+    if (waitStart >= deadline)
+    {
+        return;
+    }
+
+    // Sleep only for the part which even imprecise sleep will not overshoot
+    uint64_t remainingUs = CountsToUs(deadline - waitStart);
+    if (remainingUs > SPIN_THRESHOLD_US)
+    {
+        SDL_Delay((Uint32)((remainingUs - SPIN_THRESHOLD_US) / 1000));
+    }
+
+    uint64_t spinStart = SDL_GetPerformanceCounter();
+    while (SDL_GetPerformanceCounter() < deadline)
+    {
+        // Spin
+    }
+
+    m_Stats.totalSleepUs += CountsToUs(spinStart - waitStart);
+    if (spinStart < deadline)
+    {
+        m_Stats.totalSpinUs += CountsToUs(deadline - spinStart);
+    }
+}
+
+void FramePacer::RecordFrame(uint32_t frameUs)
+{
+    uint32_t bucketIdx = frameUs / 1000;
+    if (bucketIdx >= FrameTimeStats::HISTOGRAM_BUCKET_COUNT)
+    {
+        bucketIdx = FrameTimeStats::HISTOGRAM_BUCKET_COUNT - 1;
+    }
+
+    m_Stats.histogram[bucketIdx]++;
+    m_Stats.frameCount++;
+    m_Stats.totalFrameUs += frameUs;
+    if (frameUs > m_Stats.maxFrameUs)
+    {
+        m_Stats.maxFrameUs = frameUs;
+    }
+
+    // Frame which took 2 refresh intervals missed 1 of them
+    if (m_IsVSyncEnabled && m_RefreshPeriodUs > 0 && frameUs > m_RefreshPeriodUs + m_RefreshPeriodUs / 2)
+    {
+        m_Stats.missedVSyncCount += (frameUs + m_RefreshPeriodUs / 2) / m_RefreshPeriodUs - 1;
+    }
+}
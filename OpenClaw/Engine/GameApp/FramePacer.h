@@ -0,0 +1,89 @@
+#ifndef __FRAME_PACER_H__
+#define __FRAME_PACER_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// FramePacer
+//
+// Measures frame time with SDL_GetPerformanceCounter and paces the main loop to target frame rate. Game still runs on
+// whole milliseconds, the fraction lost by truncation is carried over to the next frame so game time does not drift
+// away from real time.
+//
+// With target frame rate set, every frame has its deadline one period after the previous deadline (not after the
+// frame end), so frames that come too late are compensated by the following ones. Waiting sleeps while there is
+// enough time left and spins the rest, because SDL_Delay can oversleep by whole scheduler quantum. When the loop falls
+// behind by more than one period, deadlines are restarted from now instead of rushing to catch up.
+//
+// Without target frame rate, the loop runs as fast as it can or as vertical sync lets it. With vertical sync and
+// known display refresh rate, frames taking longer than 1.5 refresh intervals are counted as missed vsync intervals.
+//---------------------------------------------------------------------------------------------------------------------
+
+struct FrameTimeStats
+{
+    FrameTimeStats()
+    {
+        Reset();
+    }
+
+    void Reset();
+
+    // 1 ms wide buckets, last one holds everything above
+    static const uint32_t HISTOGRAM_BUCKET_COUNT = 50;
+
+    uint32_t histogram[HISTOGRAM_BUCKET_COUNT];
+    uint32_t frameCount;
+    uint64_t totalFrameUs;
+    uint32_t maxFrameUs;
+    // Sum of refresh intervals missed by frames which did not make it to the next vertical sync
+    uint32_t missedVSyncCount;
+    // Time spent waiting for frame deadline
+    uint64_t totalSleepUs;
+    uint64_t totalSpinUs;
+};
+
+class FramePacer
+{
+public:
+    FramePacer();
+
+    // 0 means no target - run as fast as possible / as vertical sync allows
+    // Refresh rate of 0 means unknown, missed vertical syncs are then not detected
+    void Initialize(int targetFps, bool isVSyncEnabled, int displayRefreshRate);
+    void SetTargetFps(int targetFps);
+    int GetTargetFps() const { return m_TargetFps; }
+
+    // Returns whole milliseconds since previous frame, sub-millisecond remainder is kept for the next frame
+    uint32_t BeginFrame();
+    // Waits until deadline of the frame if there is target frame rate
+    void EndFrame();
+
+    // Precise duration of the last frame, from one BeginFrame to the next
+    uint32_t GetLastFrameUs() const { return m_LastFrameUs; }
+
+    const FrameTimeStats& GetStats() const { return m_Stats; }
+    void ResetStats() { m_Stats.Reset(); }
+    void DumpStats(std::vector<std::string>& outLines) const;
+
+private:
+    uint64_t CountsToUs(uint64_t counts) const;
+    void WaitUntil(uint64_t deadline);
+    void RecordFrame(uint32_t frameUs);
+
+    uint64_t m_CountsPerSecond;
+    uint64_t m_LastFrameStart;
+    uint64_t m_NextDeadline;
+    uint64_t m_RemainderCounts;
+    uint32_t m_LastFrameUs;
+
+    int m_TargetFps;
+    uint64_t m_TargetPeriodCounts;
+    bool m_IsVSyncEnabled;
+    uint32_t m_RefreshPeriodUs;
+
+    FrameTimeStats m_Stats;
+};
+
+#endif
@@ -0,0 +1,165 @@
+#include "PipelinedLoop.h"
+#include "../SharedDefines.h"
+#include "../Util/Memory/PoolAllocator.h"
+
+// Browser updates the screen only when it gets control back (see Util::RenderForcePresent), render thread cannot
+// block on the simulation there
+#ifdef __EMSCRIPTEN__
+#define PIPELINED_LOOP_NO_THREADS
+#endif
+
+PipelinedLoop::PipelinedLoop()
+    :
+    m_pRenderer(NULL),
+    m_IsRunning(false),
+    m_IsSimulationRequested(false),
+    m_IsStopRequested(false),
+    m_SimulationMsDiff(0),
+    m_IsSimulating(false),
+    m_IsSimulationDone(false),
+    m_BackListIdx(0)
+{
+
+}
+
+PipelinedLoop::~PipelinedLoop()
+{
+    Stop();
+}
+
+bool PipelinedLoop::Start(SDL_Renderer* pRenderer, const SimulateFunction& simulate)
+{
+    assert(pRenderer != NULL);
+    assert(!m_IsRunning);
+
+#ifdef PIPELINED_LOOP_NO_THREADS
+    return false;
+#else
+    m_pRenderer = pRenderer;
+    m_Simulate = simulate;
+    m_IsSimulationRequested = false;
+    m_IsStopRequested = false;
+    m_IsSimulating = false;
+    m_CommandLists[0].Clear();
+    m_CommandLists[1].Clear();
+
+    RenderCommands::BeginPipelining(pRenderer);
+    MemoryPoolMgr::SetThreadSafe(true);
+    m_SimulationThread = std::thread(&PipelinedLoop::SimulationThreadMain, this);
+    m_IsRunning = true;
+
+    return true;
+#endif
+}
+
+void PipelinedLoop::Stop()
+{
+    if (!m_IsRunning)
+    {
+        return;
+    }
+
+    RenderCommands::EndRecording();
+
+    if (m_IsSimulating && RenderCommands::IsRunningTask())
+    {
+        // Fatal error inside a task of the simulation thread, which waits for it and cannot be joined
+        LOG_WARNING("Stopping pipelined loop from a task of the simulation thread");
+        m_SimulationThread.detach();
+    }
+    else
+    {
+        if (m_IsSimulating)
+        {
+            // Frame is dropped, there is nothing to show it on anymore
+            RenderCommands::RunTasksUntil(m_pRenderer, &m_CommandLists[m_BackListIdx],
+                [this]() { return m_IsSimulationDone.load(); });
+            m_IsSimulating = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_IsStopRequested = true;
+        }
+        m_Condition.notify_one();
+        m_SimulationThread.join();
+
+        // Detached simulation thread could still be using the pools
+        MemoryPoolMgr::SetThreadSafe(false);
+    }
+
+    RenderCommands::EndPipelining();
+    m_CommandLists[0].Clear();
+    m_CommandLists[1].Clear();
+    m_IsRunning = false;
+}
+
+void PipelinedLoop::FinishSimulation()
+{
+    assert(m_IsRunning);
+
+    if (m_IsSimulating)
+    {
+        RenderCommands::RunTasksUntil(m_pRenderer, &m_CommandLists[m_BackListIdx],
+            [this]() { return m_IsSimulationDone.load(); });
+        m_IsSimulating = false;
+
+        // Previous front list is drawn by now, textures it could use can go
+        RenderCommands::OnFrameHandedOff();
+        m_BackListIdx = 1 - m_BackListIdx;
+    }
+
+    m_CommandLists[m_BackListIdx].Clear();
+    RenderCommands::BeginRecording(&m_CommandLists[m_BackListIdx]);
+}
+
+void PipelinedLoop::StartSimulation(uint32_t msDiff)
+{
+    assert(m_IsRunning && !m_IsSimulating);
+
+    RenderCommands::EndRecording();
+
+    m_IsSimulationDone.store(false);
+    m_IsSimulating = true;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_SimulationMsDiff = msDiff;
+        m_IsSimulationRequested = true;
+    }
+    m_Condition.notify_one();
+}
+
+void PipelinedLoop::RenderFrame()
+{
+    RenderCommandList& frontList = m_CommandLists[1 - m_BackListIdx];
+    frontList.Replay(m_pRenderer);
+    frontList.Clear();
+}
+
+void PipelinedLoop::SimulationThreadMain()
+{
+    while (true)
+    {
+        uint32_t msDiff = 0;
+        int backListIdx = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]() { return m_IsSimulationRequested || m_IsStopRequested; });
+            if (m_IsStopRequested)
+            {
+                break;
+            }
+
+            m_IsSimulationRequested = false;
+            msDiff = m_SimulationMsDiff;
+            backListIdx = m_BackListIdx;
+        }
+
+        RenderCommands::BeginRecording(&m_CommandLists[backListIdx]);
+        m_Simulate(msDiff);
+        RenderCommands::EndRecording();
+
+        m_IsSimulationDone.store(true);
+        RenderCommands::WakeRenderThread();
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef __PIPELINED_LOOP_H__
+#define __PIPELINED_LOOP_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "../Graphics2D/RenderCommands.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// PipelinedLoop
+//
+// Optional split of the main loop into two threads. Simulation thread runs events, game logic, physics and views of
+// frame N+1 while the main (render) thread draws frame N. Views do not draw directly, everything they would send to
+// the renderer is recorded to a command list (see RenderCommands) - that list is the snapshot of the frame which is
+// handed off to the render thread at the frame boundary. There are two lists, one being recorded and one being drawn,
+// they swap every frame.
+//
+// Frame boundary is the only point where both threads are synchronized. Render thread waits there for the
+// simulation, then polls and dispatches input (recorded to the next frame as well) and starts the simulation again.
+// Whatever the simulation needs from the render thread in the meantime (creating textures, loading a level with its
+// loading screen) is run as a task when the render thread is done drawing.
+//
+// Game objects (actors, components, scene nodes, processes, events) are therefore touched by only one thread at a
+// time, but not always by the same one - input handling and tasks on the render thread create and free them too. Pools
+// serving them (MemoryPoolMgr) lock anyway while the loop runs, so that pooled allocation on the render thread
+// outside of that window (drawing and releasing the drawn frame) is not a data race.
+//
+// Frame is shown one frame later than it would be with the serial loop, which is the cost of the overlap. Game runs
+// the same code with the same frame times in both modes, but headless runs always use the serial loop so that their
+// results stay deterministic.
+//---------------------------------------------------------------------------------------------------------------------
+
+class PipelinedLoop
+{
+public:
+    typedef std::function<void(uint32_t msDiff)> SimulateFunction;
+
+    PipelinedLoop();
+    ~PipelinedLoop();
+
+    // Calling thread becomes the render thread. Returns false when not supported on the platform
+    bool Start(SDL_Renderer* pRenderer, const SimulateFunction& simulate);
+    void Stop();
+    bool IsRunning() const { return m_IsRunning; }
+
+    // Waits for the simulation started by StartSimulation and hands its frame off to RenderFrame. Until
+    // StartSimulation, whatever the render thread draws is recorded to the next frame
+    void FinishSimulation();
+    void StartSimulation(uint32_t msDiff);
+    // Draws the frame handed off by FinishSimulation
+    void RenderFrame();
+
+private:
+    void SimulationThreadMain();
+
+    SDL_Renderer* m_pRenderer;
+    SimulateFunction m_Simulate;
+    bool m_IsRunning;
+
+    std::thread m_SimulationThread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_IsSimulationRequested;
+    bool m_IsStopRequested;
+    uint32_t m_SimulationMsDiff;
+    // Render thread only
+    bool m_IsSimulating;
+    std::atomic<bool> m_IsSimulationDone;
+
+    // Simulation records to the back list, render thread draws the front list
+    RenderCommandList m_CommandLists[2];
+    int m_BackListIdx;
+};
+
+#endif
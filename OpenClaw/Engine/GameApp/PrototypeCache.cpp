@@ -0,0 +1,599 @@
+#include "PrototypeCache.h"
+#include "../Resource/ResourceMgr.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Bump whenever layout of the data or LevelMetadata changes
+const uint32 PROTOTYPE_CACHE_MAGIC = 0x4350434F; // "OCPC"
+const uint32 PROTOTYPE_CACHE_VERSION = 1;
+
+struct PrototypeCacheHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint64 sourceHash;
+    uint64 dataChecksum;
+    uint32 dataSize;
+    uint32 padding;
+};
+
+enum CachedNodeType
+{
+    CachedNodeType_Element,
+    CachedNodeType_Text,
+    CachedNodeType_CDataText,
+    CachedNodeType_Comment
+};
+
+//=====================================================================================================================
+// Binary writer / reader
+//=====================================================================================================================
+
+class CacheWriter
+{
+public:
+    CacheWriter(std::vector<char>& data) : m_Data(data) { }
+
+    void WriteBytes(const void* pBytes, uint32 size)
+    {
+        const char* pChars = (const char*)pBytes;
+        m_Data.insert(m_Data.end(), pChars, pChars + size);
+    }
+
+    void WriteUint8(uint8 value) { WriteBytes(&value, sizeof(value)); }
+    void WriteUint32(uint32 value) { WriteBytes(&value, sizeof(value)); }
+    void WriteInt32(int32 value) { WriteBytes(&value, sizeof(value)); }
+    void WriteDouble(double value) { WriteBytes(&value, sizeof(value)); }
+    void WritePoint(const Point& point) { WriteDouble(point.x); WriteDouble(point.y); }
+
+    void WriteString(const char* str)
+    {
+        uint32 length = strlen(str);
+        WriteUint32(length);
+        WriteBytes(str, length);
+    }
+
+    void WriteElement(const TiXmlElement* pElem)
+    {
+        WriteString(pElem->Value());
+
+        uint32 numAttributes = 0;
+        for (const TiXmlAttribute* pAttr = pElem->FirstAttribute(); pAttr != NULL; pAttr = pAttr->Next())
+        {
+            numAttributes++;
+        }
+        WriteUint32(numAttributes);
+        for (const TiXmlAttribute* pAttr = pElem->FirstAttribute(); pAttr != NULL; pAttr = pAttr->Next())
+        {
+            WriteString(pAttr->Name());
+            WriteString(pAttr->Value());
+        }
+
+        // Declarations and unknown nodes can not appear inside of elements
+        uint32 numChildren = 0;
+        for (const TiXmlNode* pNode = pElem->FirstChild(); pNode != NULL; pNode = pNode->NextSibling())
+        {
+            if (pNode->ToElement() || pNode->ToText() || pNode->ToComment())
+            {
+                numChildren++;
+            }
+        }
+        WriteUint32(numChildren);
+        for (const TiXmlNode* pNode = pElem->FirstChild(); pNode != NULL; pNode = pNode->NextSibling())
+        {
+            if (const TiXmlElement* pChildElem = pNode->ToElement())
+            {
+                WriteUint8(CachedNodeType_Element);
+                WriteElement(pChildElem);
+            }
+            else if (const TiXmlText* pText = pNode->ToText())
+            {
+                WriteUint8(pText->CDATA() ? CachedNodeType_CDataText : CachedNodeType_Text);
+                WriteString(pText->Value());
+            }
+            else if (const TiXmlComment* pComment = pNode->ToComment())
+            {
+                WriteUint8(CachedNodeType_Comment);
+                WriteString(pComment->Value());
+            }
+        }
+    }
+
+private:
+    std::vector<char>& m_Data;
+};
+
+// Every read is bounds checked, once it fails all following reads fail too
+class CacheReader
+{
+public:
+    CacheReader(const char* pData, uint32 size) : m_pData(pData), m_Size(size), m_Position(0), m_HasFailed(false) { }
+
+    bool HasFailed() const { return m_HasFailed; }
+    bool IsAtEnd() const { return m_Position == m_Size; }
+
+    bool ReadBytes(void* pOutBytes, uint32 size)
+    {
+        if (m_HasFailed || size > m_Size - m_Position)
+        {
+            m_HasFailed = true;
+            return false;
+        }
+
+        memcpy(pOutBytes, m_pData + m_Position, size);
+        m_Position += size;
+        return true;
+    }
+
+    uint8 ReadUint8() { uint8 value = 0; ReadBytes(&value, sizeof(value)); return value; }
+    uint32 ReadUint32() { uint32 value = 0; ReadBytes(&value, sizeof(value)); return value; }
+    int32 ReadInt32() { int32 value = 0; ReadBytes(&value, sizeof(value)); return value; }
+    double ReadDouble() { double value = 0; ReadBytes(&value, sizeof(value)); return value; }
+    Point ReadPoint() { double x = ReadDouble(); double y = ReadDouble(); return Point(x, y); }
+
+    std::string ReadString()
+    {
+        uint32 length = ReadUint32();
+        if (m_HasFailed || length > m_Size - m_Position)
+        {
+            m_HasFailed = true;
+            return std::string();
+        }
+
+        std::string str(m_pData + m_Position, length);
+        m_Position += length;
+        return str;
+    }
+
+    // Returns NULL on failure
+    TiXmlElement* ReadElement()
+    {
+        TiXmlElement* pElem = new TiXmlElement(ReadString().c_str());
+
+        uint32 numAttributes = ReadUint32();
+        for (uint32 attrIdx = 0; attrIdx < numAttributes && !m_HasFailed; attrIdx++)
+        {
+            std::string name = ReadString();
+            std::string value = ReadString();
+            pElem->SetAttribute(name.c_str(), value.c_str());
+        }
+
+        uint32 numChildren = ReadUint32();
+        for (uint32 childIdx = 0; childIdx < numChildren && !m_HasFailed; childIdx++)
+        {
+            uint8 nodeType = ReadUint8();
+            if (nodeType == CachedNodeType_Element)
+            {
+                if (TiXmlElement* pChildElem = ReadElement())
+                {
+                    pElem->LinkEndChild(pChildElem);
+                }
+            }
+            else if (nodeType == CachedNodeType_Text || nodeType == CachedNodeType_CDataText)
+            {
+                TiXmlText* pText = new TiXmlText(ReadString().c_str());
+                pText->SetCDATA(nodeType == CachedNodeType_CDataText);
+                pElem->LinkEndChild(pText);
+            }
+            else if (nodeType == CachedNodeType_Comment)
+            {
+                pElem->LinkEndChild(new TiXmlComment(ReadString().c_str()));
+            }
+            else
+            {
+                m_HasFailed = true;
+            }
+        }
+
+        if (m_HasFailed)
+        {
+            SAFE_DELETE(pElem);
+        }
+
+        return pElem;
+    }
+
+private:
+    const char* m_pData;
+    uint32 m_Size;
+    uint32 m_Position;
+    bool m_HasFailed;
+};
+
+//=====================================================================================================================
+// MappedFile - read only memory mapping of whole file
+//=====================================================================================================================
+
+class MappedFile
+{
+public:
+    MappedFile()
+    {
+        m_pData = NULL;
+        m_Size = 0;
+#ifdef _WIN32
+        m_hFile = INVALID_HANDLE_VALUE;
+        m_hMapping = NULL;
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (m_pData != NULL) UnmapViewOfFile(m_pData);
+        if (m_hMapping != NULL) CloseHandle(m_hMapping);
+        if (m_hFile != INVALID_HANDLE_VALUE) CloseHandle(m_hFile);
+#else
+        if (m_pData != NULL) munmap((void*)m_pData, m_Size);
+#endif
+    }
+
+    bool Open(const std::string& filePath)
+    {
+#ifdef _WIN32
+        m_hFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, NULL);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart == 0 || fileSize.QuadPart > UINT32_MAX)
+        {
+            return false;
+        }
+
+        m_hMapping = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m_hMapping == NULL)
+        {
+            return false;
+        }
+
+        m_pData = (const char*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+        m_Size = (uint32)fileSize.QuadPart;
+#else
+        int fd = open(filePath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0 || (uint64)fileStat.st_size > UINT32_MAX)
+        {
+            close(fd);
+            return false;
+        }
+
+        // Mapping stays valid after the descriptor is closed
+        void* pMapped = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (pMapped == MAP_FAILED)
+        {
+            return false;
+        }
+
+        m_pData = (const char*)pMapped;
+        m_Size = (uint32)fileStat.st_size;
+#endif
+
+        return m_pData != NULL;
+    }
+
+    const char* GetData() const { return m_pData; }
+    uint32 GetSize() const { return m_Size; }
+
+private:
+    const char* m_pData;
+    uint32 m_Size;
+#ifdef _WIN32
+    HANDLE m_hFile;
+    HANDLE m_hMapping;
+#endif
+};
+
+//=====================================================================================================================
+// PrototypeCache
+//=====================================================================================================================
+
+static void DeletePrototypes(ActorXmlPrototypeMap& prototypes)
+{
+    for (auto& protoPair : prototypes)
+    {
+        delete protoPair.second;
+    }
+    prototypes.clear();
+}
+
+static std::string PrintElement(const TiXmlElement* pElem)
+{
+    TiXmlPrinter printer;
+    pElem->Accept(&printer);
+    return printer.CStr();
+}
+
+namespace PrototypeCache
+{
+    bool CalcSourceHash(IResourceMgr* pResourceMgr, const std::vector<std::string>& sourceFiles, uint64& outHash)
+    {
+        // Matched file order depends on the archive, hash has to not
+        std::vector<std::string> sortedFiles = sourceFiles;
+        std::sort(sortedFiles.begin(), sortedFiles.end());
+
+        uint64 hash = Util::CalcFNV1a64(&PROTOTYPE_CACHE_VERSION, sizeof(PROTOTYPE_CACHE_VERSION));
+        for (const std::string& sourceFile : sortedFiles)
+        {
+            uint64 checksum;
+            if (!pResourceMgr->VGetRawResourceChecksum(sourceFile, checksum))
+            {
+                LOG_WARNING("Could not get checksum of: " + sourceFile);
+                return false;
+            }
+
+            // Including the terminating zero so that names can not run into each other
+            hash = Util::CalcFNV1a64(sourceFile.c_str(), sourceFile.length() + 1, hash);
+            hash = Util::CalcFNV1a64(&checksum, sizeof(checksum), hash);
+        }
+
+        outHash = hash;
+        return true;
+    }
+
+    void Serialize(uint64 sourceHash, const ActorXmlPrototypeMap& prototypes, const LevelMetadataMap& levelMetadata,
+        std::vector<char>& outData)
+    {
+        outData.assign(sizeof(PrototypeCacheHeader), 0);
+        CacheWriter writer(outData);
+
+        writer.WriteUint32(prototypes.size());
+        for (const auto& protoPair : prototypes)
+        {
+            writer.WriteInt32(protoPair.first);
+            writer.WriteElement(protoPair.second);
+        }
+
+        writer.WriteUint32(levelMetadata.size());
+        for (const auto& metadataPair : levelMetadata)
+        {
+            const LevelMetadata* pMetadata = metadataPair.second.get();
+
+            writer.WriteInt32(pMetadata->levelNumber);
+            writer.WriteString(pMetadata->levelName.c_str());
+
+            writer.WriteUint32(pMetadata->logicToActorPrototypeMap.size());
+            for (const auto& logicPair : pMetadata->logicToActorPrototypeMap)
+            {
+                writer.WriteString(logicPair.first.c_str());
+                writer.WriteInt32(logicPair.second);
+            }
+
+            writer.WriteUint32(pMetadata->checkpointNumberToSpawnPositionMap.size());
+            for (const auto& spawnPair : pMetadata->checkpointNumberToSpawnPositionMap)
+            {
+                writer.WriteInt32(spawnPair.first);
+                writer.WritePoint(spawnPair.second);
+            }
+
+            writer.WriteUint32(pMetadata->tileIdToTopLadderEndMap.size());
+            for (const auto& ladderPair : pMetadata->tileIdToTopLadderEndMap)
+            {
+                writer.WriteInt32(ladderPair.first);
+                writer.WritePoint(ladderPair.second);
+            }
+
+            writer.WriteString(pMetadata->tileDeathEffectType.c_str());
+            writer.WritePoint(pMetadata->tileDeathEffectOffset);
+        }
+
+        PrototypeCacheHeader header;
+        header.magic = PROTOTYPE_CACHE_MAGIC;
+        header.version = PROTOTYPE_CACHE_VERSION;
+        header.sourceHash = sourceHash;
+        header.dataSize = outData.size() - sizeof(PrototypeCacheHeader);
+        header.dataChecksum = Util::CalcFNV1a64(outData.data() + sizeof(PrototypeCacheHeader), header.dataSize);
+        header.padding = 0;
+        memcpy(outData.data(), &header, sizeof(header));
+    }
+
+    bool Deserialize(const char* pData, uint32 dataSize, uint64 sourceHash, ActorXmlPrototypeMap& outPrototypes,
+        LevelMetadataMap& outLevelMetadata)
+    {
+        PrototypeCacheHeader header;
+        if (dataSize < sizeof(header))
+        {
+            LOG_WARNING("Prototype cache is truncated");
+            return false;
+        }
+
+        memcpy(&header, pData, sizeof(header));
+        if (header.magic != PROTOTYPE_CACHE_MAGIC || header.version != PROTOTYPE_CACHE_VERSION)
+        {
+            LOG("Prototype cache has different format version");
+            return false;
+        }
+        if (header.sourceHash != sourceHash)
+        {
+            LOG("Prototype cache is stale");
+            return false;
+        }
+        if (header.dataSize != dataSize - sizeof(header) ||
+            header.dataChecksum != Util::CalcFNV1a64(pData + sizeof(header), header.dataSize))
+        {
+            LOG_WARNING("Prototype cache is corrupted");
+            return false;
+        }
+
+        CacheReader reader(pData + sizeof(header), header.dataSize);
+        ActorXmlPrototypeMap prototypes;
+        LevelMetadataMap levelMetadata;
+
+        uint32 numPrototypes = reader.ReadUint32();
+        for (uint32 protoIdx = 0; protoIdx < numPrototypes && !reader.HasFailed(); protoIdx++)
+        {
+            ActorPrototype proto = ActorPrototype(reader.ReadInt32());
+            if (TiXmlElement* pProtoElem = reader.ReadElement())
+            {
+                prototypes.insert(std::make_pair(proto, pProtoElem));
+            }
+        }
+
+        uint32 numLevelMetadata = reader.ReadUint32();
+        for (uint32 metadataIdx = 0; metadataIdx < numLevelMetadata && !reader.HasFailed(); metadataIdx++)
+        {
+            shared_ptr<LevelMetadata> pMetadata(new LevelMetadata);
+
+            pMetadata->levelNumber = reader.ReadInt32();
+            pMetadata->levelName = reader.ReadString();
+
+            uint32 numLogics = reader.ReadUint32();
+            for (uint32 logicIdx = 0; logicIdx < numLogics && !reader.HasFailed(); logicIdx++)
+            {
+                std::string logic = reader.ReadString();
+                ActorPrototype proto = ActorPrototype(reader.ReadInt32());
+                pMetadata->logicToActorPrototypeMap.insert(std::make_pair(logic, proto));
+            }
+
+            uint32 numSpawnPositions = reader.ReadUint32();
+            for (uint32 spawnIdx = 0; spawnIdx < numSpawnPositions && !reader.HasFailed(); spawnIdx++)
+            {
+                int spawnNumber = reader.ReadInt32();
+                pMetadata->checkpointNumberToSpawnPositionMap.insert(std::make_pair(spawnNumber, reader.ReadPoint()));
+            }
+
+            uint32 numLadderEnds = reader.ReadUint32();
+            for (uint32 ladderIdx = 0; ladderIdx < numLadderEnds && !reader.HasFailed(); ladderIdx++)
+            {
+                int tileId = reader.ReadInt32();
+                pMetadata->tileIdToTopLadderEndMap.insert(std::make_pair(tileId, reader.ReadPoint()));
+            }
+
+            pMetadata->tileDeathEffectType = reader.ReadString();
+            pMetadata->tileDeathEffectOffset = reader.ReadPoint();
+
+            levelMetadata.insert(std::make_pair(pMetadata->levelNumber, pMetadata));
+        }
+
+        if (reader.HasFailed() || !reader.IsAtEnd())
+        {
+            LOG_WARNING("Prototype cache is corrupted");
+            DeletePrototypes(prototypes);
+            return false;
+        }
+
+        outPrototypes.swap(prototypes);
+        outLevelMetadata.swap(levelMetadata);
+
+        return true;
+    }
+
+    bool Write(const std::string& filePath, uint64 sourceHash, const ActorXmlPrototypeMap& prototypes,
+        const LevelMetadataMap& levelMetadata)
+    {
+        std::vector<char> data;
+        Serialize(sourceHash, prototypes, levelMetadata, data);
+
+        FILE* pFile = fopen(filePath.c_str(), "wb");
+        if (pFile == NULL)
+        {
+            LOG_WARNING("Could not open prototype cache for writing: " + filePath);
+            return false;
+        }
+
+        bool success = fwrite(data.data(), 1, data.size(), pFile) == data.size();
+        success &= fclose(pFile) == 0;
+        if (!success)
+        {
+            LOG_WARNING("Failed to write prototype cache: " + filePath);
+            // Checksum would catch it anyway, do not leave garbage around
+            remove(filePath.c_str());
+        }
+
+        return success;
+    }
+
+    bool Read(const std::string& filePath, uint64 sourceHash, ActorXmlPrototypeMap& outPrototypes,
+        LevelMetadataMap& outLevelMetadata)
+    {
+        MappedFile mappedFile;
+        if (!mappedFile.Open(filePath))
+        {
+            return false;
+        }
+
+        return Deserialize(mappedFile.GetData(), mappedFile.GetSize(), sourceHash, outPrototypes, outLevelMetadata);
+    }
+
+    bool Compare(const ActorXmlPrototypeMap& expectedPrototypes, const LevelMetadataMap& expectedLevelMetadata,
+        const ActorXmlPrototypeMap& prototypes, const LevelMetadataMap& levelMetadata)
+    {
+        bool isSame = true;
+
+        if (prototypes.size() != expectedPrototypes.size())
+        {
+            LOG_ERROR("Expected " + ToStr((int)expectedPrototypes.size()) + " actor prototypes, got: " +
+                ToStr((int)prototypes.size()));
+            isSame = false;
+        }
+
+        for (const auto& expectedPair : expectedPrototypes)
+        {
+            std::string protoName = EnumToString_ActorPrototype(expectedPair.first);
+            auto findIt = prototypes.find(expectedPair.first);
+            if (findIt == prototypes.end())
+            {
+                LOG_ERROR("Missing actor prototype: " + protoName);
+                isSame = false;
+            }
+            else if (PrintElement(findIt->second) != PrintElement(expectedPair.second))
+            {
+                LOG_ERROR("Actor prototype differs: " + protoName);
+                isSame = false;
+            }
+        }
+
+        if (levelMetadata.size() != expectedLevelMetadata.size())
+        {
+            LOG_ERROR("Expected " + ToStr((int)expectedLevelMetadata.size()) + " level metadata, got: " +
+                ToStr((int)levelMetadata.size()));
+            isSame = false;
+        }
+
+        for (const auto& expectedPair : expectedLevelMetadata)
+        {
+            auto findIt = levelMetadata.find(expectedPair.first);
+            if (findIt == levelMetadata.end())
+            {
+                LOG_ERROR("Missing level metadata of level: " + ToStr(expectedPair.first));
+                isSame = false;
+                continue;
+            }
+
+            const LevelMetadata& expected = *expectedPair.second;
+            const LevelMetadata& actual = *findIt->second;
+            if (actual.levelNumber != expected.levelNumber ||
+                actual.levelName != expected.levelName ||
+                actual.logicToActorPrototypeMap != expected.logicToActorPrototypeMap ||
+                actual.checkpointNumberToSpawnPositionMap != expected.checkpointNumberToSpawnPositionMap ||
+                actual.tileIdToTopLadderEndMap != expected.tileIdToTopLadderEndMap ||
+                actual.tileDeathEffectType != expected.tileDeathEffectType ||
+                !(actual.tileDeathEffectOffset == expected.tileDeathEffectOffset))
+            {
+                LOG_ERROR("Level metadata differs for level: " + ToStr(expectedPair.first));
+                isSame = false;
+            }
+        }
+
+        return isSame;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef __PROTOTYPE_CACHE_H__
+#define __PROTOTYPE_CACHE_H__
+
+#include "BaseGameApp.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// PrototypeCache
+//
+// Resolved actor prototypes (with their parent prototypes already merged in) and level metadata compiled into a binary
+// file, so that startup does not have to parse and merge the same XML files every time.
+//
+// The file starts with a header containing magic, format version, hash of the source XML files it was compiled from
+// and checksum of the data. Source hash covers names and checksums of the files as stored in the archives, so it is
+// cheap to calculate. Cache with different version or source hash is stale and is compiled again from XML.
+//
+// The file is memory mapped and element trees are rebuilt straight from the mapped data. Data is written in native
+// byte order, the cache is meant to be compiled on the machine which uses it.
+//---------------------------------------------------------------------------------------------------------------------
+
+class IResourceMgr;
+
+namespace PrototypeCache
+{
+    // Returns false if checksum of any of the files could not be obtained
+    bool CalcSourceHash(IResourceMgr* pResourceMgr, const std::vector<std::string>& sourceFiles, uint64& outHash);
+
+    void Serialize(uint64 sourceHash, const ActorXmlPrototypeMap& prototypes, const LevelMetadataMap& levelMetadata,
+        std::vector<char>& outData);
+    // Returns false for stale or corrupted data, output maps are left untouched then
+    bool Deserialize(const char* pData, uint32 dataSize, uint64 sourceHash, ActorXmlPrototypeMap& outPrototypes,
+        LevelMetadataMap& outLevelMetadata);
+
+    bool Write(const std::string& filePath, uint64 sourceHash, const ActorXmlPrototypeMap& prototypes,
+        const LevelMetadataMap& levelMetadata);
+    bool Read(const std::string& filePath, uint64 sourceHash, ActorXmlPrototypeMap& outPrototypes,
+        LevelMetadataMap& outLevelMetadata);
+
+    // Logs every difference, prototypes are compared by their printed XML
+    bool Compare(const ActorXmlPrototypeMap& expectedPrototypes, const LevelMetadataMap& expectedLevelMetadata,
+        const ActorXmlPrototypeMap& prototypes, const LevelMetadataMap& levelMetadata);
+}
+
+#endif
@@ -1,35 +1,50 @@
 #include <assert.h>
 #include <SDL2/SDL_image.h>
 #include "Image.h"
+#include "RenderCommands.h"
 #include "../SharedDefines.h"
 
+#include <unordered_map>
+
 Image::Image()
     :
     m_Width(0),
     m_Height(0),
     m_OffsetX(0),
     m_OffsetY(0),
-    m_pTexture(NULL)
+    m_pTexture(NULL),
+    m_pRenderer(NULL)
 {
-    
+    memset(m_pVariantTextures, 0, sizeof(m_pVariantTextures));
 }
 
 Image::Image(SDL_Texture* pSDLTexture)
     :
     m_pTexture(pSDLTexture),
     m_OffsetX(0),
-    m_OffsetY(0)
+    m_OffsetY(0),
+    m_pRenderer(NULL)
 {
     assert(pSDLTexture != NULL);
     SDL_QueryTexture(pSDLTexture, NULL, NULL, &m_Width, &m_Height);
+    memset(m_pVariantTextures, 0, sizeof(m_pVariantTextures));
 }
 
 Image::~Image()
 {
     if (m_pTexture) {
-        SDL_DestroyTexture(m_pTexture);
+        RenderCommands::DestroyTexture(m_pTexture);
         m_pTexture = NULL;
     }
+
+    for (SDL_Texture*& pVariantTexture : m_pVariantTextures)
+    {
+        if (pVariantTexture)
+        {
+            RenderCommands::DestroyTexture(pVariantTexture);
+            pVariantTexture = NULL;
+        }
+    }
 }
 
 SDL_Rect Image::GetPositonRect(int32_t x, int32_t y)
@@ -42,38 +57,168 @@ SDL_Rect Image::GetPositonRect(int32_t x, int32_t y)
     return rect;
 }
 
-static void PutPixel(SDL_Surface *surface, int x, int y, Uint32 pixel)
+//---------------------------------------------------------------------------------------------------------------------
+// PID upload
+//
+// PID pixels are converted straight to 32 bit format the renderer supports natively and uploaded with
+// SDL_UpdateTexture, so there is no intermediate surface and SDL does not convert the pixels once more. The format is
+// queried once per renderer and pixels are staged in one buffer reused by all uploads.
+//
+// Indexed images keep only palette indices of their pixels, 1 byte per pixel, and a palette shared by all images
+// loaded with the same palette. Their texture is uploaded when it is first needed, so images which are loaded but
+// never shown take no texture memory. Palette variants are uploaded the same way from a recolored palette.
+//---------------------------------------------------------------------------------------------------------------------
+
+struct PidUploadFormat
 {
-    int bpp = surface->format->BytesPerPixel;
-    /* Here p is the address to the pixel we want to set */
-    Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch + x * bpp;
+    SDL_Renderer* pRenderer;
+    Uint32 format;
+    SDL_PixelFormat* pPixelFormat;
+};
 
-    switch (bpp) {
-    case 1:
-        *p = pixel;
-        break;
+static PidUploadFormat s_PidUploadFormat = { NULL, SDL_PIXELFORMAT_UNKNOWN, NULL };
+static std::vector<Uint32> s_PidStagingBuffer;
 
-    case 2:
-        *(Uint16 *)p = pixel;
-        break;
+static bool IsPidUploadFormat(Uint32 format)
+{
+    return format == SDL_PIXELFORMAT_ARGB8888 ||
+        format == SDL_PIXELFORMAT_ABGR8888 ||
+        format == SDL_PIXELFORMAT_RGBA8888 ||
+        format == SDL_PIXELFORMAT_BGRA8888;
+}
 
-    case 3:
-        if (SDL_BYTEORDER == SDL_BIG_ENDIAN) {
-            p[0] = (pixel >> 16) & 0xff;
-            p[1] = (pixel >> 8) & 0xff;
-            p[2] = pixel & 0xff;
+static const PidUploadFormat& GetPidUploadFormat(SDL_Renderer* pRenderer)
+{
+    if (s_PidUploadFormat.pRenderer == pRenderer)
+    {
+        return s_PidUploadFormat;
+    }
+
+    // Renderers without any 32 bit alpha format still accept ARGB8888, they just convert it
+    Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+    SDL_RendererInfo rendererInfo;
+    if (SDL_GetRendererInfo(pRenderer, &rendererInfo) == 0)
+    {
+        for (Uint32 formatIdx = 0; formatIdx < rendererInfo.num_texture_formats; formatIdx++)
+        {
+            if (IsPidUploadFormat(rendererInfo.texture_formats[formatIdx]))
+            {
+                format = rendererInfo.texture_formats[formatIdx];
+                break;
+            }
         }
-        else {
-            p[0] = pixel & 0xff;
-            p[1] = (pixel >> 8) & 0xff;
-            p[2] = (pixel >> 16) & 0xff;
+    }
+
+    if (s_PidUploadFormat.pPixelFormat != NULL)
+    {
+        SDL_FreeFormat(s_PidUploadFormat.pPixelFormat);
+    }
+
+    s_PidUploadFormat.pRenderer = pRenderer;
+    s_PidUploadFormat.format = format;
+    s_PidUploadFormat.pPixelFormat = SDL_AllocFormat(format);
+    assert(s_PidUploadFormat.pPixelFormat != NULL);
+
+    LOG("PID images are uploaded in format: " + std::string(SDL_GetPixelFormatName(format)));
+
+    return s_PidUploadFormat;
+}
+
+static inline Uint32 PackColor(const SDL_PixelFormat* pFormat, const WAP_ColorRGBA& color)
+{
+    // Channels of 32 bit formats are not truncated
+    return ((Uint32)color.r << pFormat->Rshift) |
+        ((Uint32)color.g << pFormat->Gshift) |
+        ((Uint32)color.b << pFormat->Bshift) |
+        ((Uint32)color.a << pFormat->Ashift);
+}
+
+static Uint32* GetPidStagingBuffer(uint32_t pixelCount)
+{
+    if (s_PidStagingBuffer.size() < pixelCount)
+    {
+        s_PidStagingBuffer.resize(pixelCount);
+    }
+    return s_PidStagingBuffer.data();
+}
+
+static SDL_Texture* UploadPidPixels(const Uint32* pPixels, int width, int height, const PidUploadFormat& uploadFormat,
+    SDL_Renderer* pRenderer)
+{
+    SDL_Texture* pTexture = NULL;
+    RenderCommands::RunOnRenderThread([&]()
+    {
+        pTexture = SDL_CreateTexture(pRenderer, uploadFormat.format, SDL_TEXTUREACCESS_STATIC, width, height);
+        if (pTexture == NULL)
+        {
+            LOG_ERROR("Failed to create PID texture: " + std::string(SDL_GetError()));
+            return;
         }
-        break;
 
-    case 4:
-        *(Uint32 *)p = pixel;
-        break;
+        SDL_UpdateTexture(pTexture, NULL, pPixels, width * sizeof(Uint32));
+        SDL_SetTextureBlendMode(pTexture, SDL_BLENDMODE_BLEND);
+    });
+
+    return pTexture;
+}
+
+// Images loaded with the same palette share one copy of it. Copies are only weakly referenced here so they are
+// freed together with the last image using them
+typedef std::unordered_map<const WapPal*, std::weak_ptr<const WapPal>> SharedPaletteMap;
+static SharedPaletteMap s_SharedPalettes;
+
+static std::shared_ptr<const WapPal> GetSharedPalette(const WapPal* pPalette)
+{
+    std::weak_ptr<const WapPal>& pWeakPalette = s_SharedPalettes[pPalette];
+
+    std::shared_ptr<const WapPal> pSharedPalette = pWeakPalette.lock();
+    if (!pSharedPalette)
+    {
+        pSharedPalette.reset(new WapPal(*pPalette));
+        pWeakPalette = pSharedPalette;
     }
+
+    return pSharedPalette;
+}
+
+void Image::ReleaseSharedPalettes()
+{
+    s_SharedPalettes.clear();
+}
+
+static WAP_ColorRGBA GetPaletteVariantColor(WAP_ColorRGBA color, ImagePaletteVariant variant)
+{
+    // Transparent color stays transparent
+    if (color.a <= 1)
+    {
+        return color;
+    }
+
+    const uint8_t luminance = (uint8_t)((color.r * 30 + color.g * 59 + color.b * 11) / 100);
+    switch (variant)
+    {
+        case ImagePaletteVariant_Flash:
+            color.r = color.g = color.b = 255;
+            break;
+
+        case ImagePaletteVariant_Frozen:
+            color.r = luminance / 2;
+            color.g = (uint8_t)min(255, luminance * 3 / 4 + 48);
+            color.b = (uint8_t)min(255, luminance + 96);
+            break;
+
+        case ImagePaletteVariant_Ghost:
+            color.r = color.r / 4;
+            color.g = color.g / 4;
+            color.b = color.b / 3;
+            color.a = 160;
+            break;
+
+        default:
+            break;
+    }
+
+    return color;
 }
 
 SDL_Texture* Image::GetTextureFromPid(WapPid* pid, SDL_Renderer* renderer)
@@ -83,27 +228,82 @@ SDL_Texture* Image::GetTextureFromPid(WapPid* pid, SDL_Renderer* renderer)
     
     uint32_t width = pid->width;
     uint32_t height = pid->height;
+    uint32_t pixelCount = width * height;
+
+    const PidUploadFormat& uploadFormat = GetPidUploadFormat(renderer);
+    Uint32* pPixels = GetPidStagingBuffer(pixelCount);
+
+    // Transparency of the PID is already in alpha of its colors
+    uint32_t colorsCount = min(pid->colorsCount, pixelCount);
+    for (uint32_t colorIdx = 0; colorIdx < colorsCount; colorIdx++)
+    {
+        pPixels[colorIdx] = PackColor(uploadFormat.pPixelFormat, pid->colors[colorIdx]);
+    }
+    // Pixels without color stay transparent
+    memset(pPixels + colorsCount, 0, (pixelCount - colorsCount) * sizeof(Uint32));
+
+    return UploadPidPixels(pPixels, width, height, uploadFormat, renderer);
+}
 
-    SDL_Surface* surface = Util::CreateRGBSurface(0, width, height, 32);
-    assert(surface != NULL);
+SDL_Texture* Image::CreateVariantTexture(ImagePaletteVariant variant)
+{
+    assert(IsIndexed());
+    assert(m_pRenderer != NULL);
+
+    const PidUploadFormat& uploadFormat = GetPidUploadFormat(m_pRenderer);
 
-    uint32_t colorIdx;
-    uint32_t colorsCount = pid->colorsCount;
-    for (colorIdx = 0; colorIdx < colorsCount; colorIdx++)
+    Uint32 packedPalette[256];
+    for (int colorIdx = 0; colorIdx < 256; colorIdx++)
     {
-        WAP_ColorRGBA color = pid->colors[colorIdx];
-        uint32_t x = colorIdx % width;
-        uint32_t y = colorIdx / width;
+        packedPalette[colorIdx] = PackColor(uploadFormat.pPixelFormat,
+            GetPaletteVariantColor(m_pPalette->colors[colorIdx], variant));
+    }
+
+    const uint32_t pixelCount = m_ColorIndices.size();
+    Uint32* pPixels = GetPidStagingBuffer(pixelCount);
+    for (uint32_t pixelIdx = 0; pixelIdx < pixelCount; pixelIdx++)
+    {
+        pPixels[pixelIdx] = packedPalette[m_ColorIndices[pixelIdx]];
+    }
+
+    return UploadPidPixels(pPixels, m_Width, m_Height, uploadFormat, m_pRenderer);
+}
 
-        PutPixel(surface, x, y, SDL_MapRGBA(surface->format, color.r, color.g, color.b, color.a));
+SDL_Texture* Image::GetVariantTexture(ImagePaletteVariant variant)
+{
+    if (variant == ImagePaletteVariant_None || variant >= ImagePaletteVariant_Max || !IsIndexed())
+    {
+        return GetTexture();
     }
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    assert(texture != NULL);
+    if (m_pVariantTextures[variant] == NULL)
+    {
+        m_pVariantTextures[variant] = CreateVariantTexture(variant);
+    }
 
-    SDL_FreeSurface(surface);
+    return m_pVariantTextures[variant];
+}
 
-    return texture;
+void Image::ApplyVariantModulation(ImagePaletteVariant variant, SDL_Color& colorMod, int& alpha)
+{
+    switch (variant)
+    {
+        case ImagePaletteVariant_Frozen:
+            colorMod.r = colorMod.r / 2;
+            colorMod.g = colorMod.g * 3 / 4;
+            break;
+
+        // Same as GetPaletteVariantColor
+        case ImagePaletteVariant_Ghost:
+            colorMod.r = colorMod.r / 4;
+            colorMod.g = colorMod.g / 4;
+            colorMod.b = colorMod.b / 3;
+            alpha = alpha * 160 / 255;
+            break;
+
+        default:
+            break;
+    }
 }
 
 Image* Image::CreateImage(WapPid* pid, SDL_Renderer* renderer)
@@ -118,6 +318,34 @@ Image* Image::CreateImage(WapPid* pid, SDL_Renderer* renderer)
     return image;
 }
 
+Image* Image::CreateIndexedImage(WapPid* pid, WapPal* palette, SDL_Renderer* renderer)
+{
+    if (pid == NULL || palette == NULL || renderer == NULL || pid->colorIndices == NULL)
+    {
+        return NULL;
+    }
+
+    // Pixels which the PID has no color for are transparent
+    const uint32_t pixelCount = pid->width * pid->height;
+    const uint32_t colorsCount = min(pid->colorsCount, pixelCount);
+    if (pixelCount == 0)
+    {
+        return NULL;
+    }
+
+    Image* pImage = new Image();
+    pImage->m_Width = pid->width;
+    pImage->m_Height = pid->height;
+    pImage->m_OffsetX = pid->offsetX;
+    pImage->m_OffsetY = pid->offsetY;
+    pImage->m_ColorIndices.assign(pid->colorIndices, pid->colorIndices + colorsCount);
+    pImage->m_ColorIndices.resize(pixelCount, 0);
+    pImage->m_pPalette = GetSharedPalette(palette);
+    pImage->m_pRenderer = renderer;
+
+    return pImage;
+}
+
 Image* Image::CreatePcxImage(char* rawBuffer, uint32_t size, SDL_Renderer* renderer, bool useColorKey, SDL_Color colorKey)
 {
     Image* pImage = new Image();
@@ -135,7 +363,7 @@ Image* Image::CreatePcxImage(char* rawBuffer, uint32_t size, SDL_Renderer* rende
         SDL_SetColorKey(pSurface, SDL_TRUE, SDL_MapRGB(pSurface->format, colorKey.r, colorKey.g, colorKey.b));
     }
 
-    SDL_Texture* pTexture = SDL_CreateTextureFromSurface(renderer, pSurface);
+    SDL_Texture* pTexture = RenderCommands::CreateTextureFromSurface(renderer, pSurface);
     SDL_FreeSurface(pSurface);
 
     if (pTexture == NULL)
@@ -149,7 +377,7 @@ Image* Image::CreatePcxImage(char* rawBuffer, uint32_t size, SDL_Renderer* rende
     {
         LOG_ERROR(IMG_GetError());
         delete pImage;
-        SDL_DestroyTexture(pTexture);
+        RenderCommands::DestroyTexture(pTexture);
         return NULL;
     }
 
@@ -168,7 +396,7 @@ Image* Image::CreatePngImage(char* rawBuffer, uint32_t size, SDL_Renderer* rende
         return NULL;
     }
 
-    SDL_Texture* pTexture = SDL_CreateTextureFromSurface(renderer, pSurface);
+    SDL_Texture* pTexture = RenderCommands::CreateTextureFromSurface(renderer, pSurface);
     SDL_FreeSurface(pSurface);
 
     if (pTexture == NULL)
@@ -182,7 +410,7 @@ Image* Image::CreatePngImage(char* rawBuffer, uint32_t size, SDL_Renderer* rende
     {
         LOG_ERROR(IMG_GetError());
         delete pImage;
-        SDL_DestroyTexture(pTexture);
+        RenderCommands::DestroyTexture(pTexture);
         return NULL;
     }
 
@@ -195,7 +423,7 @@ Image* Image::CreateImageFromColor(SDL_Color color, int w, int h, SDL_Renderer*
 
     SDL_Surface* pSurface = SDL_CreateRGBSurface(0, w, h, 32, 0, 0, 0, 0);
     SDL_FillRect(pSurface, NULL, SDL_MapRGB(pSurface->format, color.r, color.g, color.b));
-    SDL_Texture* pTextureRect = SDL_CreateTextureFromSurface(pRenderer, pSurface);
+    SDL_Texture* pTextureRect = RenderCommands::CreateTextureFromSurface(pRenderer, pSurface);
 
     SDL_FreeSurface(pSurface);
 
@@ -210,7 +438,7 @@ Image* Image::CreateImageFromColor(SDL_Color color, int w, int h, SDL_Renderer*
     {
         LOG_ERROR(IMG_GetError());
         delete pImage;
-        SDL_DestroyTexture(pTextureRect);
+        RenderCommands::DestroyTexture(pTextureRect);
         return NULL;
     }
 
@@ -4,6 +4,18 @@
 #include <libwap.h>
 #include <SDL2/SDL.h>
 #include <stdint.h>
+#include <memory>
+#include <vector>
+
+// Recolored versions of indexed images, made by changing their palette
+enum ImagePaletteVariant
+{
+    ImagePaletteVariant_None,
+    ImagePaletteVariant_Flash,      // Solid white, e.g. when hit
+    ImagePaletteVariant_Frozen,     // Icy blue
+    ImagePaletteVariant_Ghost,      // Dark and translucent, e.g. invisibility
+    ImagePaletteVariant_Max
+};
 
 class Image
 {
@@ -14,11 +26,32 @@ public:
 
     static SDL_Texture* GetTextureFromPid(WapPid* pid, SDL_Renderer* renderer);
     static Image* CreateImage(WapPid* pid, SDL_Renderer* renderer);
+    // PID has to be loaded with color indices. Only the indices are kept, texture is uploaded on first use and palette
+    // variants are created from the indices on demand
+    static Image* CreateIndexedImage(WapPid* pid, WapPal* palette, SDL_Renderer* renderer);
     static Image* CreatePcxImage(char* rawBuffer, uint32_t size, SDL_Renderer* renderer, bool useColorKey = false, SDL_Color colorKey = { 0, 0, 0, 0 });
     static Image* CreatePngImage(char* rawBuffer, uint32_t size, SDL_Renderer* renderer);
     static Image* CreateImageFromColor(SDL_Color color, int w, int h, SDL_Renderer* pRenderer);
 
-    inline SDL_Texture* GetTexture() { return m_pTexture; }
+    // Indexed images created afterwards will no longer share palette with the already created ones.
+    // Has to be called when current palette changes
+    static void ReleaseSharedPalettes();
+
+    inline SDL_Texture* GetTexture()
+    {
+        if (m_pTexture == NULL && IsIndexed())
+        {
+            m_pTexture = CreateVariantTexture(ImagePaletteVariant_None);
+        }
+        return m_pTexture;
+    }
+    // Images without color indices have no variants, their regular texture is returned
+    SDL_Texture* GetVariantTexture(ImagePaletteVariant variant);
+    // Approximates palette variant by texture color and alpha modulation, used for images without color indices.
+    // Modulation can only darken, so Flash has no approximation
+    static void ApplyVariantModulation(ImagePaletteVariant variant, SDL_Color& colorMod, int& alpha);
+    inline bool IsIndexed() const { return !m_ColorIndices.empty(); }
+
     inline int GetWidth() { return m_Width; }
     inline int GetHeight() { return m_Height; }
     inline int GetOffsetX() { return m_OffsetX; }
@@ -31,12 +64,19 @@ public:
 private:
     bool Initialize(WapPid* pid, SDL_Renderer* renderer);
     bool Initialize(SDL_Texture* pTexture);
+    SDL_Texture* CreateVariantTexture(ImagePaletteVariant variant);
 
     SDL_Texture* m_pTexture;
     int m_Width;
     int m_Height;
     int m_OffsetX;
     int m_OffsetY;
+
+    // Indexed images only
+    std::vector<uint8_t> m_ColorIndices;
+    std::shared_ptr<const WapPal> m_pPalette;
+    SDL_Renderer* m_pRenderer;
+    SDL_Texture* m_pVariantTextures[ImagePaletteVariant_Max];
 };
 
 #endif
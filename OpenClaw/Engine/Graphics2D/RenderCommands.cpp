@@ -0,0 +1,549 @@
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+#include "RenderCommands.h"
+#include "../SharedDefines.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// RenderCommandList
+//---------------------------------------------------------------------------------------------------------------------
+
+void RenderCommandList::Clear()
+{
+    m_Commands.clear();
+    m_Rects.clear();
+    m_Points.clear();
+}
+
+RenderCommand& RenderCommandList::AddCommand(RenderCommandType type)
+{
+    m_Commands.push_back(RenderCommand());
+
+    RenderCommand& command = m_Commands.back();
+    memset(&command, 0, sizeof(command));
+    command.type = type;
+
+    return command;
+}
+
+void RenderCommandList::AddRects(RenderCommand& command, const SDL_Rect* pRects, int count)
+{
+    command.firstItem = m_Rects.size();
+    command.itemCount = count;
+    m_Rects.insert(m_Rects.end(), pRects, pRects + count);
+}
+
+void RenderCommandList::AddPoints(RenderCommand& command, const SDL_Point* pPoints, int count)
+{
+    command.firstItem = m_Points.size();
+    command.itemCount = count;
+    m_Points.insert(m_Points.end(), pPoints, pPoints + count);
+}
+
+void RenderCommandList::Replay(SDL_Renderer* pRenderer) const
+{
+    for (const RenderCommand& command : m_Commands)
+    {
+        switch (command.type)
+        {
+            case RenderCommandType_SetDrawColor:
+                SDL_SetRenderDrawColor(pRenderer, command.color.r, command.color.g, command.color.b, command.color.a);
+                break;
+
+            case RenderCommandType_SetDrawBlendMode:
+                SDL_SetRenderDrawBlendMode(pRenderer, command.blendMode);
+                break;
+
+            case RenderCommandType_SetTarget:
+                SDL_SetRenderTarget(pRenderer, command.pTexture);
+                break;
+
+            case RenderCommandType_SetScale:
+                SDL_RenderSetScale(pRenderer, command.scaleX, command.scaleY);
+                break;
+
+            case RenderCommandType_SetTextureAlphaMod:
+                SDL_SetTextureAlphaMod(command.pTexture, command.color.a);
+                break;
+
+            case RenderCommandType_SetTextureColorMod:
+                SDL_SetTextureColorMod(command.pTexture, command.color.r, command.color.g, command.color.b);
+                break;
+
+            case RenderCommandType_Clear:
+                SDL_RenderClear(pRenderer);
+                break;
+
+            case RenderCommandType_Copy:
+                SDL_RenderCopyEx(pRenderer, command.pTexture,
+                    command.hasSrcRect ? &command.srcRect : NULL,
+                    command.hasDstRect ? &command.dstRect : NULL,
+                    0, NULL, command.flip);
+                break;
+
+            case RenderCommandType_FillRects:
+                SDL_RenderFillRects(pRenderer, m_Rects.data() + command.firstItem, command.itemCount);
+                break;
+
+            case RenderCommandType_DrawPoints:
+                SDL_RenderDrawPoints(pRenderer, m_Points.data() + command.firstItem, command.itemCount);
+                break;
+
+            case RenderCommandType_DrawLines:
+                SDL_RenderDrawLines(pRenderer, m_Points.data() + command.firstItem, command.itemCount);
+                break;
+
+            case RenderCommandType_Present:
+                SDL_RenderPresent(pRenderer);
+                break;
+
+            default:
+                LOG_ERROR("Unknown render command: " + ToStr((int)command.type));
+                break;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// RenderCommands
+//---------------------------------------------------------------------------------------------------------------------
+
+static thread_local RenderCommandList* t_pRecordingList = NULL;
+
+static bool s_IsPipelined = false;
+static std::thread::id s_RenderThreadId;
+// Renderer state in program order, valid while pipelined. Threads take turns using it, never at the same time
+static RenderState s_State;
+
+// Tasks of the simulation thread waiting for the render thread
+static std::mutex s_TaskMutex;
+static std::condition_variable s_TaskCondition;
+static std::deque<std::function<void()>> s_PendingTasks;
+static uint64_t s_NumQueuedTasks = 0;
+static uint64_t s_NumFinishedTasks = 0;
+static bool s_IsRunningTask = false;
+
+static std::mutex s_DestroyMutex;
+// Destroyed since the last frame hand off / before that
+static std::vector<SDL_Texture*> s_DestroyedTextures;
+static std::vector<SDL_Texture*> s_PrevDestroyedTextures;
+
+static void DestroyTextures(std::vector<SDL_Texture*>& textures)
+{
+    for (SDL_Texture* pTexture : textures)
+    {
+        SDL_DestroyTexture(pTexture);
+    }
+    textures.clear();
+}
+
+void RenderCommands::SetDrawColor(SDL_Renderer* pRenderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    s_State.drawColor = { r, g, b, a };
+
+    if (t_pRecordingList == NULL)
+    {
+        SDL_SetRenderDrawColor(pRenderer, r, g, b, a);
+        return;
+    }
+
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_SetDrawColor);
+    command.color = s_State.drawColor;
+}
+
+void RenderCommands::GetDrawColor(SDL_Renderer* pRenderer, Uint8* r, Uint8* g, Uint8* b, Uint8* a)
+{
+    if (!s_IsPipelined)
+    {
+        SDL_GetRenderDrawColor(pRenderer, r, g, b, a);
+        return;
+    }
+
+    *r = s_State.drawColor.r;
+    *g = s_State.drawColor.g;
+    *b = s_State.drawColor.b;
+    *a = s_State.drawColor.a;
+}
+
+void RenderCommands::SetDrawBlendMode(SDL_Renderer* pRenderer, SDL_BlendMode blendMode)
+{
+    s_State.drawBlendMode = blendMode;
+
+    if (t_pRecordingList == NULL)
+    {
+        SDL_SetRenderDrawBlendMode(pRenderer, blendMode);
+        return;
+    }
+
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_SetDrawBlendMode);
+    command.blendMode = blendMode;
+}
+
+void RenderCommands::GetDrawBlendMode(SDL_Renderer* pRenderer, SDL_BlendMode* pBlendMode)
+{
+    if (!s_IsPipelined)
+    {
+        SDL_GetRenderDrawBlendMode(pRenderer, pBlendMode);
+        return;
+    }
+
+    *pBlendMode = s_State.drawBlendMode;
+}
+
+int RenderCommands::SetTarget(SDL_Renderer* pRenderer, SDL_Texture* pTexture)
+{
+    if (t_pRecordingList == NULL)
+    {
+        int result = SDL_SetRenderTarget(pRenderer, pTexture);
+        if (result == 0)
+        {
+            s_State.pTarget = pTexture;
+        }
+
+        return result;
+    }
+
+    // Texture access is known right away, other failures show up on replay only
+    if (pTexture != NULL)
+    {
+        int access = 0;
+        if (SDL_QueryTexture(pTexture, NULL, &access, NULL, NULL) != 0 || access != SDL_TEXTUREACCESS_TARGET)
+        {
+            return -1;
+        }
+    }
+
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_SetTarget);
+    command.pTexture = pTexture;
+    s_State.pTarget = pTexture;
+
+    return 0;
+}
+
+SDL_Texture* RenderCommands::GetTarget(SDL_Renderer* pRenderer)
+{
+    if (!s_IsPipelined)
+    {
+        return SDL_GetRenderTarget(pRenderer);
+    }
+
+    return s_State.pTarget;
+}
+
+void RenderCommands::SetScale(SDL_Renderer* pRenderer, float scaleX, float scaleY)
+{
+    s_State.scaleX = scaleX;
+    s_State.scaleY = scaleY;
+
+    if (t_pRecordingList == NULL)
+    {
+        SDL_RenderSetScale(pRenderer, scaleX, scaleY);
+        return;
+    }
+
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_SetScale);
+    command.scaleX = scaleX;
+    command.scaleY = scaleY;
+}
+
+void RenderCommands::GetScale(SDL_Renderer* pRenderer, float* pScaleX, float* pScaleY)
+{
+    if (!s_IsPipelined)
+    {
+        SDL_RenderGetScale(pRenderer, pScaleX, pScaleY);
+        return;
+    }
+
+    *pScaleX = s_State.scaleX;
+    *pScaleY = s_State.scaleY;
+}
+
+void RenderCommands::SetTextureAlphaMod(SDL_Texture* pTexture, Uint8 alpha)
+{
+    if (t_pRecordingList == NULL)
+    {
+        SDL_SetTextureAlphaMod(pTexture, alpha);
+        return;
+    }
+
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_SetTextureAlphaMod);
+    command.pTexture = pTexture;
+    command.color.a = alpha;
+}
+
+void RenderCommands::SetTextureColorMod(SDL_Texture* pTexture, Uint8 r, Uint8 g, Uint8 b)
+{
+    if (t_pRecordingList == NULL)
+    {
+        SDL_SetTextureColorMod(pTexture, r, g, b);
+        return;
+    }
+
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_SetTextureColorMod);
+    command.pTexture = pTexture;
+    command.color = { r, g, b, 255 };
+}
+
+void RenderCommands::Clear(SDL_Renderer* pRenderer)
+{
+    if (t_pRecordingList == NULL)
+    {
+        SDL_RenderClear(pRenderer);
+        return;
+    }
+
+    t_pRecordingList->AddCommand(RenderCommandType_Clear);
+}
+
+void RenderCommands::Copy(SDL_Renderer* pRenderer, SDL_Texture* pTexture, const SDL_Rect* pSrcRect,
+    const SDL_Rect* pDstRect, SDL_RendererFlip flip)
+{
+    if (t_pRecordingList == NULL)
+    {
+        if (flip == SDL_FLIP_NONE)
+        {
+            SDL_RenderCopy(pRenderer, pTexture, pSrcRect, pDstRect);
+        }
+        else
+        {
+            SDL_RenderCopyEx(pRenderer, pTexture, pSrcRect, pDstRect, 0, NULL, flip);
+        }
+        return;
+    }
+
+    if (pTexture == NULL)
+    {
+        return;
+    }
+
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_Copy);
+    command.pTexture = pTexture;
+    command.flip = flip;
+    if (pSrcRect != NULL)
+    {
+        command.srcRect = *pSrcRect;
+        command.hasSrcRect = true;
+    }
+    if (pDstRect != NULL)
+    {
+        command.dstRect = *pDstRect;
+        command.hasDstRect = true;
+    }
+}
+
+void RenderCommands::FillRect(SDL_Renderer* pRenderer, const SDL_Rect* pRect)
+{
+    // Size of whole target is only known on replay
+    assert(pRect != NULL && "Use Clear to fill whole target");
+
+    FillRects(pRenderer, pRect, 1);
+}
+
+void RenderCommands::FillRects(SDL_Renderer* pRenderer, const SDL_Rect* pRects, int count)
+{
+    if (t_pRecordingList == NULL)
+    {
+        SDL_RenderFillRects(pRenderer, pRects, count);
+        return;
+    }
+
+    if (count <= 0)
+    {
+        return;
+    }
+
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_FillRects);
+    t_pRecordingList->AddRects(command, pRects, count);
+}
+
+void RenderCommands::DrawPoint(SDL_Renderer* pRenderer, int x, int y)
+{
+    if (t_pRecordingList == NULL)
+    {
+        SDL_RenderDrawPoint(pRenderer, x, y);
+        return;
+    }
+
+    SDL_Point point = { x, y };
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_DrawPoints);
+    t_pRecordingList->AddPoints(command, &point, 1);
+}
+
+void RenderCommands::DrawLines(SDL_Renderer* pRenderer, const SDL_Point* pPoints, int count)
+{
+    if (t_pRecordingList == NULL)
+    {
+        SDL_RenderDrawLines(pRenderer, pPoints, count);
+        return;
+    }
+
+    if (count <= 0)
+    {
+        return;
+    }
+
+    RenderCommand& command = t_pRecordingList->AddCommand(RenderCommandType_DrawLines);
+    t_pRecordingList->AddPoints(command, pPoints, count);
+}
+
+void RenderCommands::Present(SDL_Renderer* pRenderer)
+{
+    if (t_pRecordingList == NULL)
+    {
+        SDL_RenderPresent(pRenderer);
+        return;
+    }
+
+    t_pRecordingList->AddCommand(RenderCommandType_Present);
+}
+
+SDL_Texture* RenderCommands::CreateTextureFromSurface(SDL_Renderer* pRenderer, SDL_Surface* pSurface)
+{
+    SDL_Texture* pTexture = NULL;
+    RunOnRenderThread([&]() { pTexture = SDL_CreateTextureFromSurface(pRenderer, pSurface); });
+
+    return pTexture;
+}
+
+void RenderCommands::DestroyTexture(SDL_Texture* pTexture)
+{
+    if (pTexture == NULL)
+    {
+        return;
+    }
+
+    if (!s_IsPipelined)
+    {
+        SDL_DestroyTexture(pTexture);
+        return;
+    }
+
+    // Command lists which were not replayed yet can still use it
+    std::lock_guard<std::mutex> lock(s_DestroyMutex);
+    s_DestroyedTextures.push_back(pTexture);
+}
+
+void RenderCommands::RunOnRenderThread(const std::function<void()>& task)
+{
+    if (!s_IsPipelined)
+    {
+        task();
+        return;
+    }
+
+    if (std::this_thread::get_id() == s_RenderThreadId)
+    {
+        // Render thread records only input handling at the frame boundary. Task runs directly, before the frame which
+        // was handed off is drawn
+        RenderCommandList* pRecordingList = t_pRecordingList;
+        t_pRecordingList = NULL;
+        task();
+        t_pRecordingList = pRecordingList;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(s_TaskMutex);
+    s_PendingTasks.push_back(task);
+    const uint64_t taskNumber = ++s_NumQueuedTasks;
+    s_TaskCondition.notify_all();
+
+    s_TaskCondition.wait(lock, [taskNumber]() { return s_NumFinishedTasks >= taskNumber; });
+}
+
+void RenderCommands::BeginPipelining(SDL_Renderer* pRenderer)
+{
+    assert(!s_IsPipelined);
+
+    GetDrawColor(pRenderer, &s_State.drawColor.r, &s_State.drawColor.g, &s_State.drawColor.b, &s_State.drawColor.a);
+    GetDrawBlendMode(pRenderer, &s_State.drawBlendMode);
+    s_State.pTarget = GetTarget(pRenderer);
+    GetScale(pRenderer, &s_State.scaleX, &s_State.scaleY);
+
+    s_RenderThreadId = std::this_thread::get_id();
+    s_IsPipelined = true;
+}
+
+void RenderCommands::EndPipelining()
+{
+    assert(std::this_thread::get_id() == s_RenderThreadId);
+
+    s_IsPipelined = false;
+
+    std::lock_guard<std::mutex> lock(s_DestroyMutex);
+    DestroyTextures(s_PrevDestroyedTextures);
+    DestroyTextures(s_DestroyedTextures);
+}
+
+bool RenderCommands::IsPipelined()
+{
+    return s_IsPipelined;
+}
+
+void RenderCommands::BeginRecording(RenderCommandList* pList)
+{
+    assert(pList != NULL);
+    t_pRecordingList = pList;
+}
+
+void RenderCommands::EndRecording()
+{
+    t_pRecordingList = NULL;
+}
+
+void RenderCommands::RunTasksUntil(SDL_Renderer* pRenderer, RenderCommandList* pRecordingList,
+    const std::function<bool()>& isDone)
+{
+    std::unique_lock<std::mutex> lock(s_TaskMutex);
+    while (true)
+    {
+        if (!s_PendingTasks.empty())
+        {
+            std::function<void()> task = s_PendingTasks.front();
+            s_PendingTasks.pop_front();
+            lock.unlock();
+
+            // Simulation thread waits for the task, so its list can be touched. Task draws directly and has to come
+            // after what was recorded before it
+            if (pRecordingList != NULL && !pRecordingList->IsEmpty())
+            {
+                pRecordingList->Replay(pRenderer);
+                pRecordingList->Clear();
+            }
+            s_IsRunningTask = true;
+            task();
+            s_IsRunningTask = false;
+
+            lock.lock();
+            s_NumFinishedTasks++;
+            s_TaskCondition.notify_all();
+        }
+        else if (isDone())
+        {
+            break;
+        }
+        else
+        {
+            s_TaskCondition.wait(lock);
+        }
+    }
+}
+
+bool RenderCommands::IsRunningTask()
+{
+    return s_IsRunningTask;
+}
+
+void RenderCommands::WakeRenderThread()
+{
+    std::lock_guard<std::mutex> lock(s_TaskMutex);
+    s_TaskCondition.notify_all();
+}
+
+void RenderCommands::OnFrameHandedOff()
+{
+    std::lock_guard<std::mutex> lock(s_DestroyMutex);
+    DestroyTextures(s_PrevDestroyedTextures);
+    s_PrevDestroyedTextures.swap(s_DestroyedTextures);
+}
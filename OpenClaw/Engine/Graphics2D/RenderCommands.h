@@ -0,0 +1,153 @@
+#ifndef __RENDER_COMMANDS_H__
+#define __RENDER_COMMANDS_H__
+
+#include <SDL2/SDL.h>
+#include <stdint.h>
+#include <vector>
+#include <functional>
+
+//---------------------------------------------------------------------------------------------------------------------
+// RenderCommands
+//
+// SDL renderer and its textures can only be used from the thread which created them - the render (main) thread.
+// With the pipelined main loop (see PipelinedLoop) game logic and rendering code run on the simulation thread, so
+// everything which draws, changes renderer state or creates / destroys textures goes through the functions below:
+//
+// - Without recording they call SDL right away.
+// - While a thread records, draw calls and renderer state changes are appended to the command list of the frame.
+//   The list is the snapshot of what the frame looks like (textures, rectangles, colors, alpha, ...) and it is
+//   replayed on the render thread later, while the simulation thread already works on the next frame.
+// - While pipelined, renderer state queries return the state set by the last call in program order, no matter if it
+//   was recorded or not, so they never have to look at the renderer the render thread is drawing with.
+// - Texture creation requested by the simulation thread runs on the render thread, the simulation thread waits for
+//   it. Render thread runs such tasks only when it is not drawing a frame.
+// - While pipelined, destroyed textures are kept alive until command lists which could reference them are replayed.
+//---------------------------------------------------------------------------------------------------------------------
+
+struct RenderState
+{
+    SDL_Color drawColor;
+    SDL_BlendMode drawBlendMode;
+    SDL_Texture* pTarget;
+    float scaleX;
+    float scaleY;
+};
+
+enum RenderCommandType
+{
+    RenderCommandType_SetDrawColor,
+    RenderCommandType_SetDrawBlendMode,
+    RenderCommandType_SetTarget,
+    RenderCommandType_SetScale,
+    RenderCommandType_SetTextureAlphaMod,
+    RenderCommandType_SetTextureColorMod,
+    RenderCommandType_Clear,
+    RenderCommandType_Copy,
+    RenderCommandType_FillRects,
+    RenderCommandType_DrawPoints,
+    RenderCommandType_DrawLines,
+    RenderCommandType_Present
+};
+
+struct RenderCommand
+{
+    RenderCommandType type;
+    SDL_Texture* pTexture;
+    SDL_Rect srcRect;
+    SDL_Rect dstRect;
+    bool hasSrcRect;
+    bool hasDstRect;
+    SDL_RendererFlip flip;
+    // Draw color, texture color mod or alpha mod (in a)
+    SDL_Color color;
+    SDL_BlendMode blendMode;
+    float scaleX;
+    float scaleY;
+    // Range in rectangles or points of the list
+    uint32_t firstItem;
+    uint32_t itemCount;
+};
+
+class RenderCommandList
+{
+public:
+    void Clear();
+    bool IsEmpty() const { return m_Commands.empty(); }
+    uint32_t GetCommandCount() const { return m_Commands.size(); }
+
+    RenderCommand& AddCommand(RenderCommandType type);
+    void AddRects(RenderCommand& command, const SDL_Rect* pRects, int count);
+    void AddPoints(RenderCommand& command, const SDL_Point* pPoints, int count);
+
+    // Render thread only
+    void Replay(SDL_Renderer* pRenderer) const;
+
+private:
+    std::vector<RenderCommand> m_Commands;
+    std::vector<SDL_Rect> m_Rects;
+    std::vector<SDL_Point> m_Points;
+};
+
+namespace RenderCommands
+{
+    // Renderer state
+
+    void SetDrawColor(SDL_Renderer* pRenderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+    void GetDrawColor(SDL_Renderer* pRenderer, Uint8* r, Uint8* g, Uint8* b, Uint8* a);
+    void SetDrawBlendMode(SDL_Renderer* pRenderer, SDL_BlendMode blendMode);
+    void GetDrawBlendMode(SDL_Renderer* pRenderer, SDL_BlendMode* pBlendMode);
+    // Returns 0 on success like SDL_SetRenderTarget
+    int SetTarget(SDL_Renderer* pRenderer, SDL_Texture* pTexture);
+    SDL_Texture* GetTarget(SDL_Renderer* pRenderer);
+    void SetScale(SDL_Renderer* pRenderer, float scaleX, float scaleY);
+    void GetScale(SDL_Renderer* pRenderer, float* pScaleX, float* pScaleY);
+
+    void SetTextureAlphaMod(SDL_Texture* pTexture, Uint8 alpha);
+    void SetTextureColorMod(SDL_Texture* pTexture, Uint8 r, Uint8 g, Uint8 b);
+
+    // Drawing
+
+    void Clear(SDL_Renderer* pRenderer);
+    void Copy(SDL_Renderer* pRenderer, SDL_Texture* pTexture, const SDL_Rect* pSrcRect, const SDL_Rect* pDstRect,
+        SDL_RendererFlip flip = SDL_FLIP_NONE);
+    // Unlike SDL_RenderFillRect, rectangle cannot be NULL
+    void FillRect(SDL_Renderer* pRenderer, const SDL_Rect* pRect);
+    void FillRects(SDL_Renderer* pRenderer, const SDL_Rect* pRects, int count);
+    void DrawPoint(SDL_Renderer* pRenderer, int x, int y);
+    void DrawLines(SDL_Renderer* pRenderer, const SDL_Point* pPoints, int count);
+    void Present(SDL_Renderer* pRenderer);
+
+    // Textures
+
+    SDL_Texture* CreateTextureFromSurface(SDL_Renderer* pRenderer, SDL_Surface* pSurface);
+    void DestroyTexture(SDL_Texture* pTexture);
+    // Runs task on the render thread, from other threads waits until it is done
+    void RunOnRenderThread(const std::function<void()>& task);
+
+    // Pipelining, used by PipelinedLoop
+
+    // Calling thread becomes the render thread
+    void BeginPipelining(SDL_Renderer* pRenderer);
+    // Destroys all textures kept alive so far
+    void EndPipelining();
+    bool IsPipelined();
+
+    // Calling thread records to given list until EndRecording
+    void BeginRecording(RenderCommandList* pList);
+    void EndRecording();
+
+    // Render thread. Runs tasks of the simulation thread until isDone returns true. Whatever the simulation thread
+    // recorded to pRecordingList before asking for a task is replayed first, so the task draws after it.
+    // WakeRenderThread has to be called after whatever isDone checks changes
+    void RunTasksUntil(SDL_Renderer* pRenderer, RenderCommandList* pRecordingList,
+        const std::function<bool()>& isDone);
+    void WakeRenderThread();
+    // True inside a task run by RunTasksUntil
+    bool IsRunningTask();
+
+    // Render thread. Destroys textures which were destroyed before the previous call, all command lists recorded
+    // until then have to be replayed already
+    void OnFrameHandedOff();
+}
+
+#endif
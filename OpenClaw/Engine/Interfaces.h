@@ -13,6 +13,7 @@
 #include <vector>
 #include <assert.h>
 #include "Util/EnumString.h"
+#include "Util/Point.h"
 #include "UserInterface/Touch/TouchEvents.h"
 #include "UserInterface/Touch/TouchRecognizers/AbstractRecognizer.h"
 
@@ -535,6 +536,49 @@ struct RaycastResult
     float deltaY;
 };
 
+struct RaycastQuery
+{
+    RaycastQuery()
+    {
+        filterMask = 0;
+        isStaticOnly = false;
+    }
+
+    RaycastQuery(const Point& from, const Point& to, uint32_t mask, bool staticOnly = false)
+    {
+        fromPoint = from;
+        toPoint = to;
+        filterMask = mask;
+        isStaticOnly = staticOnly;
+    }
+
+    Point fromPoint;
+    Point toPoint;
+    uint32_t filterMask;
+    // Only level tiles are hit, actor bodies are ignored. These queries are cached
+    bool isStaticOnly;
+};
+
+// Raycast queries issued during one frame
+struct RaycastStats
+{
+    RaycastStats()
+    {
+        numQueries = 0;
+        numStaticQueries = 0;
+        numCacheHits = 0;
+        numWorldRaycasts = 0;
+        totalTimeUs = 0;
+    }
+
+    uint32_t numQueries;
+    uint32_t numStaticQueries;
+    uint32_t numCacheHits;
+    // Queries which had to be raycast against Box2D world
+    uint32_t numWorldRaycasts;
+    uint32_t totalTimeUs;
+};
+
 class Point;
 struct ActorBodyDef;
 struct ActorFixtureDef;
@@ -558,6 +602,9 @@ public:
     virtual void VAddKinematicBody(WeakActorPtr pActor) = 0;
     virtual void VAddStaticBody(WeakActorPtr pActor, const Point& bodySize, CollisionType collisionType) = 0;
     virtual void VRemoveActor(uint32_t actorId) = 0;
+    // Body of actor returned to prefab pool is deactivated and kept, VAddActorBody of the pooled actor
+    // (under new ID) reactivates it instead of creating new body
+    virtual void VPoolActorBody(uint32_t actorId, const Actor* pPooledActor) = 0;
 
     virtual void VAddActorBody(const ActorBodyDef* actorBodyDef) = 0;
     virtual void VAddActorFixtureToBody(uint32_t actorId, const ActorFixtureDef* pFixtureDef) = 0;
@@ -596,6 +643,20 @@ public:
     virtual bool VIsActorOverlap(uint32_t actorId, FixtureType overlapType) = 0;
 
     virtual RaycastResult VRayCast(const Point& fromPoint, const Point& toPoint, uint32_t filterMask) = 0;
+    // Raycast against level tiles only. Tiles never change during level so results are cached by endpoints
+    // rounded to whole pixels
+    virtual RaycastResult VRayCastStatic(const Point& fromPoint, const Point& toPoint, uint32_t filterMask) = 0;
+    // Identical queries within the batch are raycast only once
+    virtual void VRayCastBatch(const std::vector<RaycastQuery>& queries, std::vector<RaycastResult>& outResults) = 0;
+    // Stats of the last finished frame. Raycasts are timed only while stats are enabled
+    virtual RaycastStats VGetRaycastStats() const = 0;
+    virtual void VSetRaycastStatsEnabled(bool enabled) = 0;
+    virtual bool VIsRaycastStatsEnabled() const = 0;
+    // Called before anything in the frame can raycast, finishes stats of the previous frame
+    virtual void VOnFrameStart() = 0;
+
+    // Hash of positions and velocities of all bodies, used to compare deterministic runs
+    virtual uint64_t VGetStateHash() = 0;
 
     virtual void VScaleActor(uint32_t actorId, double scale) = 0;
 };
@@ -1,7 +1,595 @@
 #include "Logger.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define LOGGER_NO_THREADS
+#endif
+
 namespace Logger
 {
+    // Zero initialized = LogLevel_Trace, usable before any static constructor runs
+    std::atomic<int> g_CategoryLevels[LogCategory_Max];
+}
+
+//=====================================================================================================================
+// Fixed size records and the ring buffer
+//=====================================================================================================================
+
+static const size_t LOG_RECORD_MESSAGE_SIZE = 224;
+static const char LOG_TRUNCATION_MARKER[] = "...";
+static const size_t LOG_RING_BUFFER_SIZE = 1024; // Has to be power of 2
+
+struct LogRecord
+{
+    uint32_t timeMs;
+    uint8_t level;
+    uint8_t category;
+    uint16_t messageLength;
+    uint32_t lineNum;
+    uint32_t numSuppressed;
+    const char* funcName;
+    // Messages which do not fit are copied to the heap, the record owns the copy until it is written
+    char* pLongMessage;
+    char message[LOG_RECORD_MESSAGE_SIZE];
+};
+
+// Bounded multi producer queue, one consumer (the writer thread). Each cell carries a sequence number which tells
+// whether it is free for the producer at given position or filled for the consumer.
+struct LogRingCell
+{
+    std::atomic<size_t> sequence;
+    LogRecord record;
+};
+
+static LogRingCell g_RingBuffer[LOG_RING_BUFFER_SIZE];
+static std::atomic<size_t> g_EnqueuePos;
+static std::atomic<size_t> g_DequeuePos;
+
+static void InitRingBuffer()
+{
+    for (size_t i = 0; i < LOG_RING_BUFFER_SIZE; i++)
+    {
+        g_RingBuffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    g_EnqueuePos.store(0, std::memory_order_relaxed);
+    g_DequeuePos.store(0, std::memory_order_relaxed);
+}
+
+static bool TryPushRecord(const LogRecord& record)
+{
+    LogRingCell* pCell;
+    size_t pos = g_EnqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        pCell = &g_RingBuffer[pos & (LOG_RING_BUFFER_SIZE - 1)];
+        size_t sequence = pCell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0)
+        {
+            if (g_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Full
+            return false;
+        }
+        else
+        {
+            pos = g_EnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Copy only the used part of the message
+    memcpy(&pCell->record, &record, offsetof(LogRecord, message) + record.messageLength + 1);
+    pCell->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+static bool TryPopRecord(LogRecord& outRecord)
+{
+    size_t pos = g_DequeuePos.load(std::memory_order_relaxed);
+    LogRingCell* pCell = &g_RingBuffer[pos & (LOG_RING_BUFFER_SIZE - 1)];
+    size_t sequence = pCell->sequence.load(std::memory_order_acquire);
+    if ((intptr_t)sequence - (intptr_t)(pos + 1) < 0)
+    {
+        // Empty
+        return false;
+    }
+
+    memcpy(&outRecord, &pCell->record, offsetof(LogRecord, message) + pCell->record.messageLength + 1);
+    pCell->sequence.store(pos + LOG_RING_BUFFER_SIZE, std::memory_order_release);
+    g_DequeuePos.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+//=====================================================================================================================
+// Rate limiting
+//=====================================================================================================================
+
+static const size_t RATE_LIMIT_TABLE_SIZE = 1024; // Has to be power of 2
+static const uint32_t RATE_LIMIT_WINDOW_MS = 1000;
+
+struct RateLimitSlot
+{
+    // Message hash in upper 32 bits, number of messages in current window in lower 32 bits
+    std::atomic<uint64_t> state;
+    std::atomic<uint32_t> windowStartMs;
+    std::atomic<uint32_t> numSuppressed;
+};
+
+static RateLimitSlot g_RateLimitTable[RATE_LIMIT_TABLE_SIZE];
+static std::atomic<uint32_t> g_MaxRepeatsPerSecond(20);
+
+static uint32_t HashMessage(const std::string& message, const char* funcName, unsigned int lineNum)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (char c : message)
+    {
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+    }
+    hash = (hash ^ lineNum) * 16777619u;
+    hash = (hash ^ (uint32_t)(uintptr_t)funcName) * 16777619u;
+
+    return hash;
+}
+
+// Counting is not exact when several threads log the same message at once, which is fine for this purpose
+static bool PassesRateLimit(uint32_t hash, uint32_t timeMs, uint32_t& outNumSuppressed)
+{
+    outNumSuppressed = 0;
+
+    uint32_t maxRepeats = g_MaxRepeatsPerSecond.load(std::memory_order_relaxed);
+    if (maxRepeats == 0)
+    {
+        return true;
+    }
+
+    RateLimitSlot& slot = g_RateLimitTable[hash & (RATE_LIMIT_TABLE_SIZE - 1)];
+    uint64_t state = slot.state.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        bool isSameMessage = (uint32_t)(state >> 32) == hash;
+        bool isNewWindow = !isSameMessage ||
+            (timeMs - slot.windowStartMs.load(std::memory_order_relaxed)) >= RATE_LIMIT_WINDOW_MS;
+        uint64_t newState = isNewWindow ? (((uint64_t)hash << 32) | 1) : state + 1;
+        if (!slot.state.compare_exchange_weak(state, newState, std::memory_order_relaxed))
+        {
+            continue;
+        }
+
+        if (isNewWindow)
+        {
+            // Report how many were swallowed during the last window of this message
+            slot.windowStartMs.store(timeMs, std::memory_order_relaxed);
+            uint32_t numSuppressed = slot.numSuppressed.exchange(0, std::memory_order_relaxed);
+            if (isSameMessage)
+            {
+                outNumSuppressed = numSuppressed;
+            }
+            return true;
+        }
+
+        if ((uint32_t)state < maxRepeats)
+        {
+            return true;
+        }
+
+        slot.numSuppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+}
+
+//=====================================================================================================================
+// Output
+//=====================================================================================================================
+
+static std::mutex g_OutputMutex;
+static FILE* g_pLogFile = NULL;
+
+static std::atomic<bool> g_IsAsync(false);
+static std::atomic<bool> g_IsWriterRunning(false);
+static std::thread g_WriterThread;
+static std::mutex g_WakeMutex;
+static std::condition_variable g_WakeCondition;
+
+static std::atomic<uint64_t> g_NumWritten(0);
+static std::atomic<uint64_t> g_NumDropped(0);
+static std::atomic<uint64_t> g_NumDroppedUnreported(0);
+static std::atomic<uint64_t> g_NumSuppressed(0);
+static std::atomic<uint64_t> g_NumTruncated(0);
+// Writes which passed the async check and may still be pushing to the ring buffer
+static std::atomic<int> g_NumWritesInFlight(0);
+
+static const char* g_LogLevelNames[LogLevel_None + 1] =
+{
+    "trace",
+    "info",
+    "warning",
+    "error",
+    "none"
+};
+
+static const char* g_LogCategoryNames[LogCategory_Max] =
+{
+    "general",
+    "events",
+    "actors",
+    "ai",
+    "physics",
+    "render",
+    "audio",
+    "resources"
+};
+
+static uint32_t GetTimeMs()
+{
+    static const std::chrono::steady_clock::time_point s_StartTime = std::chrono::steady_clock::now();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - s_StartTime).count();
+}
+
+// Caller has to hold g_OutputMutex
+static void OutputRecord(const LogRecord& record)
+{
+    char prefix[128];
+    int length = snprintf(prefix, sizeof(prefix), "[%u.%03u] %s [%s] ",
+        record.timeMs / 1000, record.timeMs % 1000,
+        g_LogLevelNames[record.level],
+        g_LogCategoryNames[record.category]);
+
+    if (record.funcName != NULL && length < (int)sizeof(prefix))
+    {
+        snprintf(prefix + length, sizeof(prefix) - length, "[%s] ", record.funcName);
+    }
+
+    char suffix[64] = "";
+    if (record.numSuppressed > 0)
+    {
+        snprintf(suffix, sizeof(suffix), " (%u identical messages suppressed)", record.numSuppressed);
+    }
+
+    const char* message = (record.pLongMessage != NULL) ? record.pLongMessage : record.message;
+
+#if defined(_WIN32) || defined(__ANDROID__)
+    if (g_pLogFile == NULL)
+    {
+        // stderr is not visible on these platforms
+        static const SDL_LogPriority s_Priorities[] =
+            { SDL_LOG_PRIORITY_VERBOSE, SDL_LOG_PRIORITY_INFO, SDL_LOG_PRIORITY_WARN, SDL_LOG_PRIORITY_ERROR };
+        SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, s_Priorities[record.level], "%s%s%s", prefix, message, suffix);
+        g_NumWritten.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+#endif
+
+    FILE* pOutput = (g_pLogFile != NULL) ? g_pLogFile : stderr;
+    fputs(prefix, pOutput);
+    fputs(message, pOutput);
+    fputs(suffix, pOutput);
+    fputc('\n', pOutput);
+
+    g_NumWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void ReleaseRecord(LogRecord& record)
+{
+    free(record.pLongMessage);
+    record.pLongMessage = NULL;
+}
+
+static void DrainRecords()
+{
+    LogRecord record;
+    bool wroteAny = false;
+
+    std::lock_guard<std::mutex> lock(g_OutputMutex);
+    while (TryPopRecord(record))
+    {
+        OutputRecord(record);
+        ReleaseRecord(record);
+        wroteAny = true;
+    }
+
+    uint64_t numDropped = g_NumDroppedUnreported.exchange(0, std::memory_order_relaxed);
+    if (numDropped > 0)
+    {
+        LogRecord droppedRecord;
+        memset(&droppedRecord, 0, offsetof(LogRecord, message));
+        droppedRecord.timeMs = GetTimeMs();
+        droppedRecord.level = LogLevel_Warning;
+        droppedRecord.messageLength = (uint16_t)snprintf(droppedRecord.message, sizeof(droppedRecord.message),
+            "Log buffer was full, %llu messages were dropped", (unsigned long long)numDropped);
+        OutputRecord(droppedRecord);
+        wroteAny = true;
+    }
+
+    if (wroteAny && g_pLogFile != NULL)
+    {
+        fflush(g_pLogFile);
+    }
+}
+
+static void WriterThreadMain()
+{
+    while (g_IsWriterRunning.load(std::memory_order_acquire))
+    {
+        {
+            std::unique_lock<std::mutex> lock(g_WakeMutex);
+            g_WakeCondition.wait_for(lock, std::chrono::milliseconds(10));
+        }
+
+        DrainRecords();
+    }
+
+    DrainRecords();
+}
+
+// Stops the writer if running at static destruction time
+struct LoggerShutdownGuard
+{
+    ~LoggerShutdownGuard() { Logger::Shutdown(); }
+};
+static LoggerShutdownGuard g_LoggerShutdownGuard;
+
+namespace Logger
+{
+    bool Init(const std::string& logFilePath, bool isAsync)
+    {
+        Shutdown();
+
+        if (!logFilePath.empty())
+        {
+            std::lock_guard<std::mutex> lock(g_OutputMutex);
+            g_pLogFile = fopen(logFilePath.c_str(), "w");
+            if (g_pLogFile == NULL)
+            {
+                fprintf(stderr, "Failed to open log file: %s\n", logFilePath.c_str());
+            }
+        }
+
+#ifdef LOGGER_NO_THREADS
+        isAsync = false;
+#endif
+
+        if (isAsync)
+        {
+            InitRingBuffer();
+            g_IsWriterRunning.store(true, std::memory_order_release);
+            g_WriterThread = std::thread(WriterThreadMain);
+            g_IsAsync.store(true, std::memory_order_release);
+        }
+
+        return g_pLogFile != NULL || logFilePath.empty();
+    }
+
+    void Shutdown()
+    {
+        if (g_IsAsync.exchange(false))
+        {
+            // New writes are synchronous now, wait for the ones which already passed the async check so that the
+            // writer drains everything on exit
+            while (g_NumWritesInFlight.load() > 0)
+            {
+                std::this_thread::yield();
+            }
+
+            g_IsWriterRunning.store(false, std::memory_order_release);
+            g_WakeCondition.notify_one();
+            g_WriterThread.join();
+        }
+
+        std::lock_guard<std::mutex> lock(g_OutputMutex);
+        if (g_pLogFile != NULL)
+        {
+            fclose(g_pLogFile);
+            g_pLogFile = NULL;
+        }
+    }
+
+    void Flush()
+    {
+        if (!g_IsAsync.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        if (std::this_thread::get_id() == g_WriterThread.get_id())
+        {
+            return;
+        }
+
+        size_t targetPos = g_EnqueuePos.load(std::memory_order_acquire);
+        g_WakeCondition.notify_one();
+        for (int waitMs = 0; waitMs < 1000; waitMs++)
+        {
+            if ((intptr_t)g_DequeuePos.load(std::memory_order_acquire) - (intptr_t)targetPos >= 0)
+            {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // Make sure the last drained batch also got to the output
+        std::lock_guard<std::mutex> lock(g_OutputMutex);
+    }
+
+    void Write(LogLevel level, LogCategory category, const std::string& message, const char* funcName, unsigned int lineNum)
+    {
+        uint32_t timeMs = GetTimeMs();
+
+        uint32_t numSuppressed;
+        if (!PassesRateLimit(HashMessage(message, funcName, lineNum), timeMs, numSuppressed))
+        {
+            g_NumSuppressed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        LogRecord record;
+        record.timeMs = timeMs;
+        record.level = (uint8_t)level;
+        record.category = (uint8_t)category;
+        record.lineNum = lineNum;
+        record.numSuppressed = numSuppressed;
+        record.funcName = funcName;
+        record.pLongMessage = NULL;
+
+        size_t messageLength = message.length();
+        // Trailing newlines would only produce empty lines
+        while (messageLength > 0 && message[messageLength - 1] == '\n')
+        {
+            messageLength--;
+        }
+        // Longer messages are kept whole on the heap, only if that fails they are truncated and marked so
+        if (messageLength >= LOG_RECORD_MESSAGE_SIZE)
+        {
+            record.pLongMessage = (char*)malloc(messageLength + 1);
+        }
+
+        if (record.pLongMessage != NULL)
+        {
+            memcpy(record.pLongMessage, message.c_str(), messageLength);
+            record.pLongMessage[messageLength] = '\0';
+            messageLength = 0;
+        }
+        else if (messageLength >= LOG_RECORD_MESSAGE_SIZE)
+        {
+            const size_t markerLength = sizeof(LOG_TRUNCATION_MARKER) - 1;
+            messageLength = LOG_RECORD_MESSAGE_SIZE - 1 - markerLength;
+            memcpy(record.message, message.c_str(), messageLength);
+            memcpy(record.message + messageLength, LOG_TRUNCATION_MARKER, markerLength);
+            messageLength += markerLength;
+            g_NumTruncated.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            memcpy(record.message, message.c_str(), messageLength);
+        }
+        record.message[messageLength] = '\0';
+        record.messageLength = (uint16_t)messageLength;
+
+        // Has to be counted before the async check, see Shutdown()
+        g_NumWritesInFlight.fetch_add(1);
+        if (!g_IsAsync.load())
+        {
+            g_NumWritesInFlight.fetch_sub(1);
+
+            std::lock_guard<std::mutex> lock(g_OutputMutex);
+            OutputRecord(record);
+            ReleaseRecord(record);
+            return;
+        }
+
+        if (!TryPushRecord(record))
+        {
+            ReleaseRecord(record);
+            g_NumDropped.fetch_add(1, std::memory_order_relaxed);
+            g_NumDroppedUnreported.fetch_add(1, std::memory_order_relaxed);
+        }
+        g_NumWritesInFlight.fetch_sub(1, std::memory_order_release);
+
+        // Errors usually come right before something goes wrong, get them out quickly
+        if (level >= LogLevel_Error)
+        {
+            g_WakeCondition.notify_one();
+        }
+    }
+
+    void SetLevel(LogLevel level)
+    {
+        for (int categoryIdx = 0; categoryIdx < LogCategory_Max; categoryIdx++)
+        {
+            g_CategoryLevels[categoryIdx].store(level, std::memory_order_relaxed);
+        }
+    }
+
+    void SetCategoryLevel(LogCategory category, LogLevel level)
+    {
+        assert(category >= 0 && category < LogCategory_Max);
+        g_CategoryLevels[category].store(level, std::memory_order_relaxed);
+    }
+
+    LogLevel GetCategoryLevel(LogCategory category)
+    {
+        assert(category >= 0 && category < LogCategory_Max);
+        return LogLevel(g_CategoryLevels[category].load(std::memory_order_relaxed));
+    }
+
+    void SetRateLimit(unsigned int maxRepeatsPerSecond)
+    {
+        g_MaxRepeatsPerSecond.store(maxRepeatsPerSecond, std::memory_order_relaxed);
+    }
+
+    LoggerStats GetStats()
+    {
+        LoggerStats stats;
+        stats.numWritten = g_NumWritten.load(std::memory_order_relaxed);
+        stats.numDropped = g_NumDropped.load(std::memory_order_relaxed);
+        stats.numSuppressed = g_NumSuppressed.load(std::memory_order_relaxed);
+        stats.numTruncated = g_NumTruncated.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    const char* LogLevelToString(LogLevel level)
+    {
+        if (level < 0 || level > LogLevel_None)
+        {
+            return "unknown";
+        }
+
+        return g_LogLevelNames[level];
+    }
+
+    LogLevel StringToLogLevel(const std::string& levelStr)
+    {
+        for (int levelIdx = 0; levelIdx < LogLevel_None; levelIdx++)
+        {
+            if (levelStr == g_LogLevelNames[levelIdx])
+            {
+                return LogLevel(levelIdx);
+            }
+        }
+
+        return LogLevel_None;
+    }
+
+    const char* LogCategoryToString(LogCategory category)
+    {
+        if (category < 0 || category >= LogCategory_Max)
+        {
+            return "unknown";
+        }
+
+        return g_LogCategoryNames[category];
+    }
+
+    LogCategory StringToLogCategory(const std::string& categoryStr)
+    {
+        for (int categoryIdx = 0; categoryIdx < LogCategory_Max; categoryIdx++)
+        {
+            if (categoryStr == g_LogCategoryNames[categoryIdx])
+            {
+                return LogCategory(categoryIdx);
+            }
+        }
+
+        return LogCategory_Max;
+    }
+
     void GetOutputString(std::string& outOutputBuffer, const std::string& tag, const std::string& message, const char* funcName, const char* sourceFile, unsigned int lineNum)
     {
         if (funcName != NULL && sourceFile != NULL)
@@ -3,78 +3,142 @@
 
 #include <SDL2/SDL.h>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <assert.h>
 #include <memory.h>
 
+//---------------------------------------------------------------------------------------------------------------------
+// Logger
+//
+// Log calls are filtered by level and category before the message is even built. Messages which pass the filters
+// are copied into fixed-size records in a lock-free ring buffer (messages longer than a record are copied to the
+// heap) and a background thread formats them and writes them to stderr or to a log file. Until Logger::Init() is
+// called (and on platforms without threads) records are written synchronously on the calling thread.
+//
+// LOG_COMPILE_LEVEL removes all calls below given level at compile time. Identical messages are rate limited,
+// see Logger::SetRateLimit().
+//---------------------------------------------------------------------------------------------------------------------
+
+#define LOG_LEVEL_TRACE   0
+#define LOG_LEVEL_INFO    1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_ERROR   3
+#define LOG_LEVEL_NONE    4
+
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+#endif
+#endif
+
+enum LogLevel
+{
+    LogLevel_Trace = LOG_LEVEL_TRACE,
+    LogLevel_Info = LOG_LEVEL_INFO,
+    LogLevel_Warning = LOG_LEVEL_WARNING,
+    LogLevel_Error = LOG_LEVEL_ERROR,
+    LogLevel_None = LOG_LEVEL_NONE
+};
+
+enum LogCategory
+{
+    LogCategory_General,
+    LogCategory_Events,
+    LogCategory_Actors,
+    LogCategory_AI,
+    LogCategory_Physics,
+    LogCategory_Render,
+    LogCategory_Audio,
+    LogCategory_Resources,
+    LogCategory_Max
+};
+
+struct LoggerStats
+{
+    uint64_t numWritten;
+    uint64_t numDropped;     // ring buffer was full
+    uint64_t numSuppressed;  // rate limited
+    uint64_t numTruncated;   // longer than a record and could not be allocated, written cut off with "..." at the end
+};
+
 namespace Logger
 {
+    // Starts the background writer. Empty logFilePath means stderr
+    bool Init(const std::string& logFilePath, bool isAsync);
+    // Writes all pending records and stops the background writer
+    void Shutdown();
+    // Blocks until all records queued so far are written
+    void Flush();
+
+    inline bool IsEnabled(LogLevel level, LogCategory category);
+    void Write(LogLevel level, LogCategory category, const std::string& message, const char* funcName, unsigned int lineNum);
+
+    void SetLevel(LogLevel level);
+    void SetCategoryLevel(LogCategory category, LogLevel level);
+    LogLevel GetCategoryLevel(LogCategory category);
+    // Maximum number of identical messages per second, 0 = unlimited
+    void SetRateLimit(unsigned int maxRepeatsPerSecond);
+
+    LoggerStats GetStats();
+
+    const char* LogLevelToString(LogLevel level);
+    // Returns LogLevel_None if no such level exists
+    LogLevel StringToLogLevel(const std::string& levelStr);
+    const char* LogCategoryToString(LogCategory category);
+    // Returns LogCategory_Max if no such category exists
+    LogCategory StringToLogCategory(const std::string& categoryStr);
+
     void GetOutputString(std::string& outOutputBuffer, const std::string& tag, const std::string& message, const char* funcName, const char* sourceFile, unsigned int lineNum);
-}
 
+    // Minimum enabled level of each category. Read on every log call so it is kept inline
+    extern std::atomic<int> g_CategoryLevels[LogCategory_Max];
+
+    inline bool IsEnabled(LogLevel level, LogCategory category)
+    {
+        return level >= g_CategoryLevels[category].load(std::memory_order_relaxed);
+    }
+}
 
-// Errors are bad and potentially fatal.  They are presented as a dialog with Abort, Retry, and Ignore.  Abort will
-// break into the debugger, retry will continue the game, and ignore will continue the game and ignore every subsequent 
-// call to this specific error.  They are ignored completely in release mode.
-#define LOG_ERROR(str) \
+// Core macro. Compile time check is constant so the whole call disappears when level is below LOG_COMPILE_LEVEL,
+// the message expression is evaluated only when the runtime filter passes.
+#define LOG_CATEGORY_IMPL(category, level, str, funcName, lineNum) \
 do \
 { \
-    std::string s((str)); \
-    std::string out; \
-    Logger::GetOutputString(out, "", s, __FUNCTION__, NULL, __LINE__); \
-    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s", out.c_str()); \
+    if ((level) >= LOG_COMPILE_LEVEL && Logger::IsEnabled((level), (category))) \
+    { \
+        Logger::Write((level), (category), (str), (funcName), (lineNum)); \
+    } \
 } \
 while (0); \
 
+#define LOG_CATEGORY(category, level, str) LOG_CATEGORY_IMPL(category, level, str, __FUNCTION__, __LINE__)
+
+// Errors are bad and potentially fatal. They are logged like any other message, only the background writer is woken
+// up right away so that they get out before whatever goes wrong next. Compiled in even in release mode.
+#define LOG_ERROR(str) LOG_CATEGORY_IMPL(LogCategory_General, LogLevel_Error, str, __FUNCTION__, __LINE__)
+
 #define LOG_ASSERT(str) \
 do \
 { \
-    std::string s((str)); \
-    std::string out; \
-    Logger::GetOutputString(out, "", s, __FUNCTION__, NULL, __LINE__); \
-    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s", out.c_str()); \
+    Logger::Write(LogLevel_Error, LogCategory_General, (str), __FUNCTION__, __LINE__); \
+    Logger::Flush(); \
     assert(false); \
 } \
 while (0); \
 
 // Warnings are recoverable.  They are just logs with the "WARNING" tag that displays calling information.  The flags
 // are initially set to WARNINGFLAG_DEFAULT (defined in debugger.cpp), but they can be overridden normally.
-#define LOG_WARNING(str) \
-do \
-{ \
-    std::string s((str)); \
-    std::string out; \
-    Logger::GetOutputString(out, std::string(""), s, __FUNCTION__, NULL, __LINE__); \
-    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s", out.c_str()); \
-} \
-while (0);\
+#define LOG_WARNING(str) LOG_CATEGORY_IMPL(LogCategory_General, LogLevel_Warning, str, __FUNCTION__, __LINE__)
 
+// Tag is prefixed to the message, e.g. "[EventLoop] ..."
 #define LOG_TAG(tag, str) \
-do \
-{ \
-    std::string s((str)); \
-    std::string out; \
-    Logger::GetOutputString(out, tag, s, NULL, NULL, 0); \
-    SDL_Log("%s", out.c_str()); \
-} \
-    while (0);\
+    LOG_CATEGORY_IMPL(LogCategory_General, LogLevel_Info, std::string("[") + (tag) + "] " + (str), __FUNCTION__, __LINE__)
 
-#define LOG(str) \
-do \
-{ \
-    std::string s((str)); \
-    std::string out; \
-    Logger::GetOutputString(out, "", s, NULL, NULL, 0); \
-    SDL_Log("%s", out.c_str()); \
-} \
-while (0);\
+#define LOG(str) LOG_CATEGORY_IMPL(LogCategory_General, LogLevel_Info, str, NULL, 0)
 
-#define LOG_TRACE(str) \
-do \
-{ \
-    std::string s((str)); \
-    std::string out; \
-    Logger::GetOutputString(out, "", s, __FUNCTION__, NULL, __LINE__); \
-    SDL_Log("%s", out.c_str()); \
-} \
-while (0); \
+#define LOG_TRACE(str) LOG_CATEGORY_IMPL(LogCategory_General, LogLevel_Trace, str, __FUNCTION__, __LINE__)
 
 #endif
\ No newline at end of file
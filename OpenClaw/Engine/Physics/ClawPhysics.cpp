@@ -20,6 +20,11 @@
 #include "PhysicsContactListener.h"
 #include "../UserInterface/HumanView.h"
 
+#include <chrono>
+
+// Cache is simply dropped when it grows over this, static queries of one level are mostly repeating anyway
+const uint32 MAX_CACHED_STATIC_RAYCASTS = 16384;
+
 //=====================================================================================================================
 // ClawPhysics implementation
 //=====================================================================================================================
@@ -203,6 +208,7 @@ bool ClawPhysics::VInitialize()
     b2BodyDef bodyDef;
     bodyDef.type = b2_staticBody;
     m_pTiles = m_pWorld->CreateBody(&bodyDef);
+    m_StaticGeometryBodies.insert(m_pTiles);
 
     return true;
 }
@@ -217,13 +223,9 @@ void ClawPhysics::VSyncVisibleScene()
     // check all the existing actor's bodies for changes. 
     //  If there is a change, send the appropriate event for the game system.
 
-    // Iterating vector or list has lower overhead
-    /*for (ActorIDToBox2DBodyMap::const_iterator it = m_ActorToBodyMap.begin();
-        it != m_ActorToBodyMap.end();
-        ++it)*/
-    for (const std::pair<uint32, b2Body*>& it : m_ActorIdAndBodyList)
+    for (const PhysicsBodyEntry& entry : m_BodyRegistry.GetBodies())
     {
-        b2Body* pActorBody = it.second;
+        b2Body* pActorBody = entry.pBody;
         assert(pActorBody);
 
         if (pActorBody->GetType() == b2_staticBody)
@@ -231,7 +233,7 @@ void ClawPhysics::VSyncVisibleScene()
             continue;
         }
 
-        uint32 actorId = it.first;
+        uint32 actorId = entry.actorId;
 
         //StrongActorPtr pGameActor = MakeStrongPtr(g_pApp->GetGameLogic()->VGetActor(actorId));
         //assert(pGameActor);
@@ -394,33 +396,28 @@ void ClawPhysics::VSyncVisibleScene()
 void ClawPhysics::VOnUpdate(const uint32 msDiff)
 {
     //PROFILE_CPU("ClawPhysics::VOnUpdate");
+    TRACK_ALLOCATIONS(AllocTag_Physics);
 
     m_pWorld->Step(msDiff / 1000.0f, 10, 8);
 
     // Remove actors form physics simulation which are scheduled to be destroyed
-    for (uint32 actorId : m_ActorsToBeDestroyed)
+    // Stale handles (actor removed more than once) resolve to NULL
+    for (PhysicsBodyHandle bodyHandle : m_ActorsToBeDestroyed)
     {
-        if (b2Body* pBody = FindBox2DBody(actorId))
+        if (b2Body* pBody = m_BodyRegistry.GetBody(bodyHandle))
         {
             assert(m_pWorld->IsLocked() == false);
 
             pBody->SetActive(false);
             pBody->SetUserData(NULL);
             m_pWorld->DestroyBody(pBody);
-            m_ActorToBodyMap.erase(actorId);
-            m_BodyToActorMap.erase(pBody);
-            for (auto iter = m_ActorIdAndBodyList.begin(); iter != m_ActorIdAndBodyList.end(); iter++)
-            {
-                if (iter->first == actorId)
-                {
-                    m_ActorIdAndBodyList.erase(iter);
-                    break;
-                }
-            }
+            m_BodyRegistry.Remove(bodyHandle);
         }
     }
     m_ActorsToBeDestroyed.clear();
 
+    DeactivatePooledBodies();
+
     // Create any pending actors
     for (const ActorBodyDef* pActorBodyDef : m_ActorBodiesToBeCreated)
     {
@@ -480,11 +477,15 @@ void ClawPhysics::VAddLine(Point from, Point to, uint32_t thickness)
 //
 void ClawPhysics::VAddStaticGeometry(const Point& position, const Point& size, CollisionType collisionType, FixtureType fixtureType)
 {
+    TRACK_ALLOCATIONS(AllocTag_Physics);
+
     if (collisionType == CollisionType_None)
     {
         return;
     }
 
+    m_StaticRaycastCache.clear();
+
     // Convert pixel position and size to Box2D meters
     b2Vec2 b2Position = PixelsToMeters(PointToB2Vec2(position));
     b2Vec2 b2Size = PixelsToMeters(PointToB2Vec2(size));
@@ -546,6 +547,8 @@ void ClawPhysics::VAddStaticGeometry(const Point& position, const Point& size, C
         fixtureDef.userData = (void*)fixtureType;
         fixtureDef.isSensor = false;
         pBody->CreateFixture(&fixtureDef);
+
+        m_StaticGeometryBodies.insert(pBody);
     }
     else
     {
@@ -622,9 +625,7 @@ void ClawPhysics::VAddDynamicActor(WeakActorPtr pActor)
     fixtureDef.userData = (void*)FixtureType_FootSensor;
     pBody->CreateFixture(&fixtureDef);
 
-    m_ActorToBodyMap.insert(std::make_pair(pStrongActor->GetGUID(), pBody));
-    m_BodyToActorMap.insert(std::make_pair(pBody, pStrongActor->GetGUID()));
-    m_ActorIdAndBodyList.push_back(std::make_pair(pStrongActor->GetGUID(), pBody));
+    RegisterActorBody(pStrongActor->GetGUID(), pBody);
 }
 
 //-----------------------------------------------------------------------------
@@ -676,13 +677,13 @@ void ClawPhysics::VAddStaticBody(WeakActorPtr pActor, const Point& bodySize, Col
     fixtureDef.isSensor = false;
     pBody->CreateFixture(&fixtureDef);
 
-    m_ActorToBodyMap.insert(std::make_pair(pStrongActor->GetGUID(), pBody));
-    m_BodyToActorMap.insert(std::make_pair(pBody, pStrongActor->GetGUID()));
-    m_ActorIdAndBodyList.push_back(std::make_pair(pStrongActor->GetGUID(), pBody));
+    RegisterActorBody(pStrongActor->GetGUID(), pBody);
 }
 
 void ClawPhysics::VAddActorBody(const ActorBodyDef* actorBodyDef)
 {
+    TRACK_ALLOCATIONS(AllocTag_Physics);
+
     //assert(actorBodyDef->collisionMask != 0x0);
     if (actorBodyDef->collisionMask == 0x0)
     {
@@ -707,6 +708,22 @@ void ClawPhysics::VAddActorBody(const ActorBodyDef* actorBodyDef)
         return;
     }
 
+    // Pooled actor gets its previous body back, it has the same fixtures since it comes from the same prefab
+    if (b2Body* pPooledBody = TakePooledBody(pStrongActor.get()))
+    {
+        pPooledBody->SetType(actorBodyDef->bodyType);
+        pPooledBody->SetTransform(PixelsToMeters(PointToB2Vec2(actorBodyDef->position)), 0);
+        pPooledBody->SetLinearVelocity(b2Vec2(0, 0));
+        pPooledBody->SetGravityScale(actorBodyDef->gravityScale);
+        pPooledBody->SetUserData(pStrongActor.get());
+        pPooledBody->SetActive(true);
+        pPooledBody->SetAwake(true);
+
+        RegisterActorBody(pStrongActor->GetGUID(), pPooledBody);
+        SetInitialSpeed(pStrongActor->GetGUID(), actorBodyDef);
+        return;
+    }
+
     // Convert pixel position and size to Box2D meters
     b2Vec2 b2Position = PixelsToMeters(PointToB2Vec2(actorBodyDef->position));
     b2Vec2 b2BodySize = PixelsToMeters(PointToB2Vec2(actorBodyDef->size));
@@ -809,18 +826,8 @@ void ClawPhysics::VAddActorBody(const ActorBodyDef* actorBodyDef)
         AddActorFixtureToBody(pBody, &actorFixtureDef);
     }
 
-    m_ActorToBodyMap.insert(std::make_pair(pStrongActor->GetGUID(), pBody));
-    m_BodyToActorMap.insert(std::make_pair(pBody, pStrongActor->GetGUID()));
-    m_ActorIdAndBodyList.push_back(std::make_pair(pStrongActor->GetGUID(), pBody));
-
-    if (actorBodyDef->setInitialSpeed)
-    {
-        VSetLinearSpeed(pStrongActor->GetGUID(), actorBodyDef->initialSpeed);
-    }
-    else if (actorBodyDef->setInitialImpulse)
-    {
-        VApplyLinearImpulse(pStrongActor->GetGUID(), actorBodyDef->initialSpeed);
-    }
+    RegisterActorBody(pStrongActor->GetGUID(), pBody);
+    SetInitialSpeed(pStrongActor->GetGUID(), actorBodyDef);
 }
 
 void ClawPhysics::AddActorFixtureToBody(b2Body* pBody, const ActorFixtureDef* pFixtureDef)
@@ -877,7 +884,7 @@ void ClawPhysics::VAddActorFixtureToBody(uint32_t actorId, const ActorFixtureDef
     }
     else
     {
-        LOG_WARNING("Failed to add fixture to body. Is Physics world updating: " + ToStr(m_pWorld->IsLocked()));
+        LOG_CATEGORY(LogCategory_Physics, LogLevel_Warning, "Failed to add fixture to body. Is Physics world updating: " + ToStr(m_pWorld->IsLocked()));
     }
 }
 
@@ -888,15 +895,64 @@ void ClawPhysics::VAddActorFixtureToBody(uint32_t actorId, const ActorFixtureDef
 //
 void ClawPhysics::VRemoveActor(uint32_t actorId)
 {
+    // Pooled actor is being destroyed, its body is registered again to be destroyed the same way
+    for (auto pooledIt = m_PooledBodies.begin(); pooledIt != m_PooledBodies.end(); ++pooledIt)
+    {
+        if (pooledIt->actorId == actorId)
+        {
+            RegisterActorBody(actorId, pooledIt->pBody);
+            CancelBodyDeactivation(pooledIt->pBody);
+            m_PooledBodies.erase(pooledIt);
+            break;
+        }
+    }
+
     // Clear any user data
     if (b2Body* pBody = FindBox2DBody(actorId))
     {
+        m_pPhysicsContactListener->OnActorRemoved(static_cast<Actor*>(pBody->GetUserData()));
         pBody->SetUserData(NULL);
     }
 
     ScheduleActorForRemoval(actorId);
 }
 
+//-----------------------------------------------------------------------------
+// ClawPhysics::VPoolActorBody
+//
+//    Keeps body of actor which was returned to prefab pool for its next spawn.
+//
+void ClawPhysics::VPoolActorBody(uint32_t actorId, const Actor* pPooledActor)
+{
+    PhysicsBodyHandle handle = m_BodyRegistry.FindHandle(actorId);
+    b2Body* pBody = m_BodyRegistry.GetBody(handle);
+    if (pBody == NULL)
+    {
+        return;
+    }
+
+    const Actor* pActor = static_cast<Actor*>(pBody->GetUserData());
+    if (pActor == NULL)
+    {
+        // Already removed
+        return;
+    }
+
+    // Pooled body does not take part in any contacts, nor in scene sync and state hash of registered bodies
+    m_pPhysicsContactListener->OnActorRemoved(pActor);
+    pBody->SetUserData(NULL);
+    m_BodyRegistry.Remove(handle);
+
+    PooledBody pooledBody = { pPooledActor, actorId, pBody };
+    m_PooledBodies.push_back(pooledBody);
+
+    m_BodiesToBeDeactivated.push_back(pBody);
+    if (!m_pWorld->IsLocked())
+    {
+        DeactivatePooledBodies();
+    }
+}
+
 //-----------------------------------------------------------------------------
 // ClawPhysics::VRenderDiagnostics
 //
@@ -967,9 +1023,7 @@ void ClawPhysics::VCreateTrigger(WeakActorPtr pActor, const Point& pos, Point& s
     fixtureDef.isSensor = true;
     pBody->CreateFixture(&fixtureDef);
 
-    m_ActorToBodyMap.insert(std::make_pair(pStrongActor->GetGUID(), pBody));
-    m_BodyToActorMap.insert(std::make_pair(pBody, pStrongActor->GetGUID()));
-    m_ActorIdAndBodyList.push_back(std::make_pair(pStrongActor->GetGUID(), pBody));
+    RegisterActorBody(pStrongActor->GetGUID(), pBody);
 }
 
 //-----------------------------------------------------------------------------
@@ -991,7 +1045,7 @@ void ClawPhysics::VApplyForce(uint32_t actorId, const Point& force)
     }
     else
     {
-        LOG_WARNING("Failed to find actor's body");
+        LOG_CATEGORY(LogCategory_Physics, LogLevel_Warning, "Failed to find actor's body");
     }
 }
 
@@ -1290,9 +1344,11 @@ bool ClawPhysics::VIsActorOverlap(uint32_t actorId, FixtureType overlapType)
 class RayCastCallback_Filtered : public b2RayCastCallback
 {
 public:
-    RayCastCallback_Filtered(const Point& p1, const Point& p2, uint32 filter)
+    RayCastCallback_Filtered(const Point& p1, const Point& p2, uint32 filter,
+        const std::unordered_set<const b2Body*>* pOnlyBodies = NULL)
     {
         m_Filter = filter;
+        m_pOnlyBodies = pOnlyBodies;
         m_Fraction = 1.0f;
         
         float diffX = fabs(p1.x - p2.x);
@@ -1310,6 +1366,11 @@ public:
             return 1.0f;
         }
 
+        if (m_pOnlyBodies != NULL && m_pOnlyBodies->count(fixture->GetBody()) == 0)
+        {
+            return 1.0f;
+        }
+
         if (fabs(fraction) < m_Fraction)
         {
             m_Fraction = fraction;
@@ -1330,23 +1391,199 @@ public:
 
 private:
     uint32 m_Filter;
+    const std::unordered_set<const b2Body*>* m_pOnlyBodies;
     float32 m_Fraction;
     float m_MaxDistance;
     RaycastResult m_RaycastResult;
 };
 
-RaycastResult ClawPhysics::VRayCast(const Point& fromPoint, const Point& toPoint, uint32 filterMask)
+size_t ClawPhysics::RaycastCacheKeyHash::operator()(const RaycastCacheKey& key) const
 {
-    RayCastCallback_Filtered callback(fromPoint, toPoint, filterMask);
+    // FNV-1a over the key members
+    const uint32 values[] = { (uint32)key.fromX, (uint32)key.fromY, (uint32)key.toX, (uint32)key.toY, key.filterMask };
+
+    uint64 hash = 14695981039346656037ULL;
+    for (uint32 value : values)
+    {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    }
+
+    return (size_t)hash;
+}
+
+RaycastResult ClawPhysics::RayCastWorld(const Point& fromPoint, const Point& toPoint, uint32 filterMask, bool isStaticOnly)
+{
+    RayCastCallback_Filtered callback(fromPoint, toPoint, filterMask, isStaticOnly ? &m_StaticGeometryBodies : NULL);
 
     b2Vec2 b2fromPoint = PixelsToMeters(PointToB2Vec2(fromPoint));
     b2Vec2 b2toPoint = PixelsToMeters(PointToB2Vec2(toPoint));
 
     m_pWorld->RayCast(&callback, b2fromPoint, b2toPoint);
+    m_RaycastStats.numWorldRaycasts++;
 
     return callback.GetRaycastResult();
 }
 
+// Kept across levels, physics is recreated for every level
+static bool s_IsRaycastStatsEnabled = false;
+
+void ClawPhysics::VSetRaycastStatsEnabled(bool enabled)
+{
+    s_IsRaycastStatsEnabled = enabled;
+    m_RaycastStats = RaycastStats();
+    m_LastFrameRaycastStats = RaycastStats();
+}
+
+bool ClawPhysics::VIsRaycastStatsEnabled() const
+{
+    return s_IsRaycastStatsEnabled;
+}
+
+void ClawPhysics::VOnFrameStart()
+{
+    if (s_IsRaycastStatsEnabled)
+    {
+        m_LastFrameRaycastStats = m_RaycastStats;
+        m_RaycastStats = RaycastStats();
+    }
+}
+
+// Measures the time only when raycast stats are enabled
+class RaycastTimer
+{
+public:
+    explicit RaycastTimer(RaycastStats& stats)
+        :
+        m_pStats(s_IsRaycastStatsEnabled ? &stats : NULL)
+    {
+        if (m_pStats)
+        {
+            m_StartTime = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~RaycastTimer()
+    {
+        if (m_pStats)
+        {
+            m_pStats->totalTimeUs += (uint32)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - m_StartTime).count();
+        }
+    }
+
+private:
+    RaycastStats* m_pStats;
+    std::chrono::steady_clock::time_point m_StartTime;
+};
+
+RaycastResult ClawPhysics::VRayCast(const Point& fromPoint, const Point& toPoint, uint32 filterMask)
+{
+    RaycastTimer timer(m_RaycastStats);
+    m_RaycastStats.numQueries++;
+
+    return RayCastWorld(fromPoint, toPoint, filterMask, false);
+}
+
+//-----------------------------------------------------------------------------
+// ClawPhysics::VRayCastStatic
+//
+//    Raycasts against level tiles only. Endpoints are rounded to whole pixels
+//    so that nearly identical queries of different actors share one cache entry.
+//
+RaycastResult ClawPhysics::VRayCastStatic(const Point& fromPoint, const Point& toPoint, uint32 filterMask)
+{
+    RaycastTimer timer(m_RaycastStats);
+
+    RaycastCacheKey key;
+    key.fromX = (int32)floor(fromPoint.x + 0.5);
+    key.fromY = (int32)floor(fromPoint.y + 0.5);
+    key.toX = (int32)floor(toPoint.x + 0.5);
+    key.toY = (int32)floor(toPoint.y + 0.5);
+    key.filterMask = filterMask;
+
+    RaycastResult result;
+    auto findIt = m_StaticRaycastCache.find(key);
+    if (findIt != m_StaticRaycastCache.end())
+    {
+        result = findIt->second;
+        m_RaycastStats.numCacheHits++;
+    }
+    else
+    {
+        result = RayCastWorld(Point(key.fromX, key.fromY), Point(key.toX, key.toY), filterMask, true);
+
+        if (m_StaticRaycastCache.size() >= MAX_CACHED_STATIC_RAYCASTS)
+        {
+            m_StaticRaycastCache.clear();
+        }
+        m_StaticRaycastCache.insert(std::make_pair(key, result));
+    }
+
+    m_RaycastStats.numQueries++;
+    m_RaycastStats.numStaticQueries++;
+
+    return result;
+}
+
+void ClawPhysics::VRayCastBatch(const std::vector<RaycastQuery>& queries, std::vector<RaycastResult>& outResults)
+{
+    outResults.resize(queries.size());
+
+    for (size_t queryIdx = 0; queryIdx < queries.size(); queryIdx++)
+    {
+        const RaycastQuery& query = queries[queryIdx];
+        if (query.isStaticOnly)
+        {
+            outResults[queryIdx] = VRayCastStatic(query.fromPoint, query.toPoint, query.filterMask);
+            continue;
+        }
+
+        // Batches are small, linear search for already answered identical query is enough
+        size_t sameQueryIdx = 0;
+        for (; sameQueryIdx < queryIdx; sameQueryIdx++)
+        {
+            const RaycastQuery& otherQuery = queries[sameQueryIdx];
+            if (!otherQuery.isStaticOnly &&
+                otherQuery.filterMask == query.filterMask &&
+                otherQuery.fromPoint == query.fromPoint &&
+                otherQuery.toPoint == query.toPoint)
+            {
+                break;
+            }
+        }
+
+        if (sameQueryIdx < queryIdx)
+        {
+            outResults[queryIdx] = outResults[sameQueryIdx];
+            m_RaycastStats.numQueries++;
+            m_RaycastStats.numCacheHits++;
+        }
+        else
+        {
+            outResults[queryIdx] = VRayCast(query.fromPoint, query.toPoint, query.filterMask);
+        }
+    }
+}
+
+uint64_t ClawPhysics::VGetStateHash()
+{
+    // Bodies are hashed separately and summed so that order of the registry does not matter
+    uint64_t stateHash = 0;
+    for (const PhysicsBodyEntry& entry : m_BodyRegistry.GetBodies())
+    {
+        const b2Vec2& position = entry.pBody->GetPosition();
+        const b2Vec2& velocity = entry.pBody->GetLinearVelocity();
+        const float32 bodyState[] = { position.x, position.y, velocity.x, velocity.y };
+
+        uint64_t bodyHash = Util::CalcFNV1a64(&entry.actorId, sizeof(entry.actorId));
+        bodyHash = Util::CalcFNV1a64(bodyState, sizeof(bodyState), bodyHash);
+        stateHash += bodyHash;
+    }
+
+    return stateHash;
+}
+
 // HACK: THIS WHOLE METHOD IS A HACK AND IT DOES NOT DO WHAT IT SHOULD DO
 // THIS IS TIGHTLY COUPLED TO CLAW'S CROUCHING
 void ClawPhysics::VScaleActor(uint32_t actorId, double scale)
@@ -1431,22 +1668,62 @@ void ClawPhysics::VScaleActor(uint32_t actorId, double scale)
 // Private implementations
 //=====================================================================================================================
 
-b2Body* ClawPhysics::FindBox2DBody(uint32 actorId)
+void ClawPhysics::RegisterActorBody(uint32 actorId, b2Body* pBody)
 {
-    ActorIDToBox2DBodyMap::const_iterator found = m_ActorToBodyMap.find(actorId);
-    if (found != m_ActorToBodyMap.end())
-        return found->second;
+    if (!m_BodyRegistry.Add(actorId, pBody).IsValid())
+    {
+        LOG_CATEGORY(LogCategory_Physics, LogLevel_Warning, "Actor " + ToStr(actorId) + " already has physics body registered");
+    }
+}
 
-    return NULL;
+void ClawPhysics::SetInitialSpeed(uint32 actorId, const ActorBodyDef* actorBodyDef)
+{
+    if (actorBodyDef->setInitialSpeed)
+    {
+        VSetLinearSpeed(actorId, actorBodyDef->initialSpeed);
+    }
+    else if (actorBodyDef->setInitialImpulse)
+    {
+        VApplyLinearImpulse(actorId, actorBodyDef->initialSpeed);
+    }
 }
 
-uint32 ClawPhysics::FindActorId(b2Body* pBody)
+void ClawPhysics::DeactivatePooledBodies()
 {
-    Box2DBodyToActorIDMap::const_iterator found = m_BodyToActorMap.find(pBody);
-    if (found != m_BodyToActorMap.end())
-        return found->second;
+    assert(m_pWorld->IsLocked() == false);
+
+    // Bodies reused or destroyed in the meantime were already taken out of the list
+    for (b2Body* pBody : m_BodiesToBeDeactivated)
+    {
+        pBody->SetActive(false);
+    }
+    m_BodiesToBeDeactivated.clear();
+}
 
-    return 0;
+b2Body* ClawPhysics::TakePooledBody(const Actor* pActor)
+{
+    for (auto pooledIt = m_PooledBodies.begin(); pooledIt != m_PooledBodies.end(); ++pooledIt)
+    {
+        if (pooledIt->pActor != pActor)
+        {
+            continue;
+        }
+
+        // Caller registers it again under the new actor ID
+        b2Body* pBody = pooledIt->pBody;
+        CancelBodyDeactivation(pBody);
+        m_PooledBodies.erase(pooledIt);
+
+        return pBody;
+    }
+
+    return NULL;
+}
+
+void ClawPhysics::CancelBodyDeactivation(b2Body* pBody)
+{
+    m_BodiesToBeDeactivated.erase(std::remove(m_BodiesToBeDeactivated.begin(), m_BodiesToBeDeactivated.end(), pBody),
+        m_BodiesToBeDeactivated.end());
 }
 
 //=====================================================================================================================
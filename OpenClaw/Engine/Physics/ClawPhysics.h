@@ -6,9 +6,7 @@
 
 #include <Box2D/Box2D.h>
 
-typedef std::map<uint32, b2Body*> ActorIDToBox2DBodyMap;
-typedef std::map<b2Body*, uint32> Box2DBodyToActorIDMap;
-typedef std::vector<std::pair<uint32, b2Body*>> ActorIdAndBodyList;
+#include "PhysicsBodyRegistry.h"
 
 class PhysicsContactListener;
 class PhysicsDebugDrawer;
@@ -33,6 +31,7 @@ public:
     virtual void VAddKinematicBody(WeakActorPtr pActor) override;
     virtual void VAddStaticBody(WeakActorPtr pActor, const Point& bodySize, CollisionType collisionType) override;
     virtual void VRemoveActor(uint32_t actorId) override;
+    virtual void VPoolActorBody(uint32_t actorId, const Actor* pPooledActor) override;
 
     virtual void VAddActorBody(const ActorBodyDef* actorBodyDef) override;
     virtual void VAddActorFixtureToBody(uint32_t actorId, const ActorFixtureDef* pFixtureDef) override;
@@ -71,13 +70,49 @@ public:
     virtual bool VIsActorOverlap(uint32_t actorId, FixtureType overlapType) override;
 
     virtual RaycastResult VRayCast(const Point& fromPoint, const Point& toPoint, uint32 filterMask) override;
+    virtual RaycastResult VRayCastStatic(const Point& fromPoint, const Point& toPoint, uint32 filterMask) override;
+    virtual void VRayCastBatch(const std::vector<RaycastQuery>& queries, std::vector<RaycastResult>& outResults) override;
+    virtual RaycastStats VGetRaycastStats() const override { return m_LastFrameRaycastStats; }
+    virtual void VSetRaycastStatsEnabled(bool enabled) override;
+    virtual bool VIsRaycastStatsEnabled() const override;
+    virtual void VOnFrameStart() override;
+
+    virtual uint64_t VGetStateHash() override;
 
     virtual void VScaleActor(uint32_t actorId, double scale) override;
 
 private:
-    b2Body* FindBox2DBody(uint32 actorId);
-    uint32 FindActorId(b2Body* pBody);
-    void ScheduleActorForRemoval(uint32 actorId) { m_ActorsToBeDestroyed.push_back(actorId); }
+    struct RaycastCacheKey
+    {
+        bool operator==(const RaycastCacheKey& other) const
+        {
+            return fromX == other.fromX && fromY == other.fromY &&
+                toX == other.toX && toY == other.toY && filterMask == other.filterMask;
+        }
+
+        int32 fromX;
+        int32 fromY;
+        int32 toX;
+        int32 toY;
+        uint32 filterMask;
+    };
+
+    struct RaycastCacheKeyHash
+    {
+        size_t operator()(const RaycastCacheKey& key) const;
+    };
+
+    typedef std::unordered_map<RaycastCacheKey, RaycastResult, RaycastCacheKeyHash> RaycastCache;
+
+    RaycastResult RayCastWorld(const Point& fromPoint, const Point& toPoint, uint32 filterMask, bool isStaticOnly);
+
+    b2Body* FindBox2DBody(uint32 actorId) { return m_BodyRegistry.FindBody(actorId); }
+    void ScheduleActorForRemoval(uint32 actorId) { m_ActorsToBeDestroyed.push_back(m_BodyRegistry.FindHandle(actorId)); }
+    void RegisterActorBody(uint32 actorId, b2Body* pBody);
+    void SetInitialSpeed(uint32 actorId, const ActorBodyDef* actorBodyDef);
+    void DeactivatePooledBodies();
+    b2Body* TakePooledBody(const Actor* pActor);
+    void CancelBodyDeactivation(b2Body* pBody);
     void AddActorFixtureToBody(b2Body* pBody, const ActorFixtureDef* pFixtureDef);
     
     unique_ptr<b2World> m_pWorld;
@@ -85,15 +120,30 @@ private:
     unique_ptr<PhysicsContactListener> m_pPhysicsContactListener;
 
     b2Body* m_pTiles;
+    // m_pTiles and bodies of ground tiles
+    std::unordered_set<const b2Body*> m_StaticGeometryBodies;
+
+    RaycastCache m_StaticRaycastCache;
+    RaycastStats m_RaycastStats;
+    RaycastStats m_LastFrameRaycastStats;
 
-    std::vector<uint32> m_ActorsToBeDestroyed;
+    std::vector<PhysicsBodyHandle> m_ActorsToBeDestroyed;
     std::vector<const ActorBodyDef*> m_ActorBodiesToBeCreated;
     std::vector<std::pair<uint32, const ActorFixtureDef*>> m_FixturesToBeCreated;
     std::vector<std::pair<uint32, const Point>> m_DeferredAppliedForce;
-    
-    ActorIDToBox2DBodyMap m_ActorToBodyMap;
-    Box2DBodyToActorIDMap m_BodyToActorMap;
-    ActorIdAndBodyList m_ActorIdAndBodyList;
+
+    PhysicsBodyRegistry m_BodyRegistry;
+
+    // Bodies of pooled actors are not registered until they are reused, they are kept under their last actor ID
+    struct PooledBody
+    {
+        const Actor* pActor;
+        uint32 actorId;
+        b2Body* pBody;
+    };
+    std::vector<PooledBody> m_PooledBodies;
+    // Bodies can not be deactivated while the world is stepping
+    std::vector<b2Body*> m_BodiesToBeDeactivated;
 };
 
 class KinematicComponent;
@@ -169,6 +219,7 @@ public:
     virtual void VAddKinematicBody(WeakActorPtr pActor) override { }
     virtual void VAddStaticBody(WeakActorPtr pActor, const Point& bodySize, CollisionType collisionType) override { }
     virtual void VRemoveActor(uint32_t actorId) override { }
+    virtual void VPoolActorBody(uint32_t actorId, const Actor* pPooledActor) override { }
 
     virtual void VAddActorBody(const ActorBodyDef* actorBodyDef) override { }
     virtual void VAddActorFixtureToBody(uint32_t actorId, const ActorFixtureDef* pFixtureDef) override { }
@@ -207,6 +258,14 @@ public:
     virtual bool VIsActorOverlap(uint32_t actorId, FixtureType overlapType) { return false; }
 
     virtual RaycastResult VRayCast(const Point& fromPoint, const Point& toPoint, uint32 filterMask) override { return RaycastResult(); }
+    virtual RaycastResult VRayCastStatic(const Point& fromPoint, const Point& toPoint, uint32 filterMask) override { return RaycastResult(); }
+    virtual void VRayCastBatch(const std::vector<RaycastQuery>& queries, std::vector<RaycastResult>& outResults) override { outResults.assign(queries.size(), RaycastResult()); }
+    virtual RaycastStats VGetRaycastStats() const override { return RaycastStats(); }
+    virtual void VSetRaycastStatsEnabled(bool enabled) override { }
+    virtual bool VIsRaycastStatsEnabled() const override { return false; }
+    virtual void VOnFrameStart() override { }
+
+    virtual uint64_t VGetStateHash() override { return 0; }
 
     virtual void VScaleActor(uint32_t actorId, double scale) override { }
 };
@@ -0,0 +1,260 @@
+#include "NavigationMap.h"
+
+#include <cfloat>
+#include <climits>
+
+static uint32 CollisionTypeToFlag(CollisionType collisionType)
+{
+    switch (collisionType)
+    {
+        case CollisionType_Solid: return CollisionFlag_Solid;
+        case CollisionType_Ground: return CollisionFlag_Ground;
+        case CollisionType_Climb: return CollisionFlag_Ladder;
+        case CollisionType_Death: return CollisionFlag_Death;
+        default: return CollisionFlag_None;
+    }
+}
+
+// Slab test of segment against axis aligned rectangle
+static bool SegmentIntersectsRect(const Point& fromPoint, const Point& toPoint, const NavigationRect& rect)
+{
+    const double origin[2] = { fromPoint.x, fromPoint.y };
+    const double delta[2] = { toPoint.x - fromPoint.x, toPoint.y - fromPoint.y };
+    const double rectMin[2] = { (double)rect.left, (double)rect.top };
+    const double rectMax[2] = { (double)rect.right, (double)rect.bottom };
+
+    double tMin = 0.0;
+    double tMax = 1.0;
+    for (int axis = 0; axis < 2; axis++)
+    {
+        if (fabs(delta[axis]) < DBL_EPSILON)
+        {
+            if (origin[axis] < rectMin[axis] || origin[axis] > rectMax[axis])
+            {
+                return false;
+            }
+            continue;
+        }
+
+        double t1 = (rectMin[axis] - origin[axis]) / delta[axis];
+        double t2 = (rectMax[axis] - origin[axis]) / delta[axis];
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+        }
+
+        tMin = max(tMin, t1);
+        tMax = min(tMax, t2);
+        if (tMin > tMax)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+NavigationMap::NavigationMap(int columnWidth)
+    :
+    m_ColumnWidth(columnWidth)
+{
+    assert(m_ColumnWidth > 0);
+}
+
+void NavigationMap::Clear()
+{
+    m_Rects.clear();
+    m_Columns.clear();
+}
+
+void NavigationMap::AddStaticGeometry(const Point& position, const Point& size, CollisionType collisionType)
+{
+    uint32 collisionFlag = CollisionTypeToFlag(collisionType);
+    if (collisionFlag == CollisionFlag_None || size.x <= 0 || size.y <= 0)
+    {
+        return;
+    }
+
+    NavigationRect rect;
+    rect.left = (int)floor(position.x);
+    rect.top = (int)floor(position.y);
+    rect.right = rect.left + (int)ceil(size.x);
+    rect.bottom = rect.top + (int)ceil(size.y);
+    rect.collisionFlag = collisionFlag;
+
+    if (rect.right <= 0)
+    {
+        return;
+    }
+
+    const uint32 rectIdx = m_Rects.size();
+    m_Rects.push_back(rect);
+
+    int fromColumnIdx = max(0, GetColumnIdx(rect.left));
+    int toColumnIdx = GetColumnIdx(rect.right - 1);
+    if (toColumnIdx >= (int)m_Columns.size())
+    {
+        m_Columns.resize(toColumnIdx + 1);
+    }
+
+    for (int columnIdx = fromColumnIdx; columnIdx <= toColumnIdx; columnIdx++)
+    {
+        m_Columns[columnIdx].push_back(rectIdx);
+    }
+}
+
+const NavigationMap::RectIndexList* NavigationMap::GetColumn(int columnIdx) const
+{
+    if (columnIdx < 0 || columnIdx >= (int)m_Columns.size())
+    {
+        return NULL;
+    }
+
+    return &m_Columns[columnIdx];
+}
+
+const NavigationRect* NavigationMap::FindCoveringRect(int x, int fromY, int toY, uint32 collisionMask, int direction) const
+{
+    const RectIndexList* pColumn = GetColumn(GetColumnIdx(x));
+    if (pColumn == NULL)
+    {
+        return NULL;
+    }
+
+    const NavigationRect* pBestRect = NULL;
+    for (uint32 rectIdx : *pColumn)
+    {
+        const NavigationRect& rect = m_Rects[rectIdx];
+        if (!(rect.collisionFlag & collisionMask) ||
+            x < rect.left || x >= rect.right ||
+            rect.top > toY || rect.bottom <= fromY)
+        {
+            continue;
+        }
+
+        if (pBestRect == NULL ||
+            (direction > 0 && rect.right > pBestRect->right) ||
+            (direction < 0 && rect.left < pBestRect->left))
+        {
+            pBestRect = &rect;
+        }
+    }
+
+    return pBestRect;
+}
+
+bool NavigationMap::HasFloor(int x, int fromY, int toY, uint32 collisionMask) const
+{
+    return FindCoveringRect(x, min(fromY, toY), max(fromY, toY), collisionMask, 1) != NULL;
+}
+
+bool NavigationMap::FindClosestHole(int x, int fromY, int toY, int maxDistance, uint32 collisionMask, int& outOffset) const
+{
+    const int direction = maxDistance < 0 ? -1 : 1;
+    const int searchDistance = abs(maxDistance);
+
+    // Skip whole rectangles instead of probing every pixel
+    int currentX = x;
+    while (abs(currentX - x) < searchDistance)
+    {
+        const NavigationRect* pRect = FindCoveringRect(currentX, fromY, toY, collisionMask, direction);
+        if (pRect == NULL)
+        {
+            outOffset = currentX - x;
+            return true;
+        }
+
+        currentX = (direction > 0) ? pRect->right : pRect->left - 1;
+    }
+
+    return false;
+}
+
+bool NavigationMap::GetFloorSpan(int x, int fromY, int toY, uint32 collisionMask, int& outLeft, int& outRight) const
+{
+    if (FindCoveringRect(x, fromY, toY, collisionMask, 1) == NULL)
+    {
+        return false;
+    }
+
+    int rightX = x;
+    while (const NavigationRect* pRect = FindCoveringRect(rightX, fromY, toY, collisionMask, 1))
+    {
+        rightX = pRect->right;
+    }
+
+    int leftX = x;
+    while (const NavigationRect* pRect = FindCoveringRect(leftX, fromY, toY, collisionMask, -1))
+    {
+        leftX = pRect->left - 1;
+    }
+
+    outLeft = leftX + 1;
+    outRight = rightX;
+
+    return true;
+}
+
+bool NavigationMap::FindClosestWall(int x, int y, int maxDistance, uint32 collisionMask, int& outOffset) const
+{
+    const int direction = maxDistance < 0 ? -1 : 1;
+    const int searchDistance = abs(maxDistance);
+    const int lastColumnIdx = min(GetColumnIdx(max(0, x + maxDistance)), (int)m_Columns.size() - 1);
+
+    // Rectangles spanning multiple columns are listed in all of them, so the first column with any hit
+    // contains the closest one
+    for (int columnIdx = min(GetColumnIdx(x), (int)m_Columns.size() - 1);
+        columnIdx >= 0 && (direction > 0 ? columnIdx <= lastColumnIdx : columnIdx >= lastColumnIdx);
+        columnIdx += direction)
+    {
+        int closestDistance = INT_MAX;
+        for (uint32 rectIdx : m_Columns[columnIdx])
+        {
+            const NavigationRect& rect = m_Rects[rectIdx];
+            if (!(rect.collisionFlag & collisionMask) || y < rect.top || y >= rect.bottom)
+            {
+                continue;
+            }
+
+            // Offset to the first solid pixel, right is exclusive so that is right - 1 when going left
+            int distance = (direction > 0) ? rect.left - x : x - (rect.right - 1);
+            if (distance >= 0 && distance < closestDistance)
+            {
+                closestDistance = distance;
+            }
+        }
+
+        if (closestDistance != INT_MAX)
+        {
+            if (closestDistance > searchDistance)
+            {
+                return false;
+            }
+
+            outOffset = closestDistance * direction;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool NavigationMap::IsLineOfSight(const Point& fromPoint, const Point& toPoint, uint32 collisionMask) const
+{
+    int fromColumnIdx = max(0, GetColumnIdx((int)floor(min(fromPoint.x, toPoint.x))));
+    int toColumnIdx = min((int)m_Columns.size() - 1, GetColumnIdx((int)floor(max(fromPoint.x, toPoint.x))));
+
+    for (int columnIdx = fromColumnIdx; columnIdx <= toColumnIdx; columnIdx++)
+    {
+        for (uint32 rectIdx : m_Columns[columnIdx])
+        {
+            const NavigationRect& rect = m_Rects[rectIdx];
+            if ((rect.collisionFlag & collisionMask) && SegmentIntersectsRect(fromPoint, toPoint, rect))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
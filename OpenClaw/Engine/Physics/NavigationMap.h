@@ -0,0 +1,71 @@
+#ifndef __NAVIGATION_MAP_H__
+#define __NAVIGATION_MAP_H__
+
+#include "../SharedDefines.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// NavigationMap
+//
+// Static level geometry bucketed into fixed width columns. It is filled at level load with the same (merged) tile
+// rectangles which are added to physics world as static geometry and answers AI queries which would otherwise
+// need many Box2D raycasts - closest ledge / hole, floor span under a point, closest wall and line of sight.
+//
+// Queries take CollisionFlag_ mask like IGamePhysics::VRayCast does. Only static tile geometry is known to the map,
+// bodies of actors (elevators, crates, ...) are not, callers which care about them have to fall back to raycasts.
+// Queries only touch columns between the start and the answer, each column holds just few rectangles.
+//---------------------------------------------------------------------------------------------------------------------
+
+struct NavigationRect
+{
+    // Pixels, right and bottom are exclusive
+    int left;
+    int top;
+    int right;
+    int bottom;
+    uint32 collisionFlag;
+};
+
+class NavigationMap
+{
+public:
+    NavigationMap(int columnWidth = 64);
+
+    void Clear();
+    void AddStaticGeometry(const Point& position, const Point& size, CollisionType collisionType);
+
+    bool IsEmpty() const { return m_Rects.empty(); }
+    uint32 GetRectsCount() const { return m_Rects.size(); }
+
+    // True if vertical line at x between fromY and toY intersects geometry, same as raycast down from (x, fromY)
+    bool HasFloor(int x, int fromY, int toY, uint32 collisionMask) const;
+
+    // Searches from x towards sign of maxDistance for the closest x without floor between fromY and toY.
+    // Returns false if floor is continuous up to maxDistance, outOffset is signed offset from x otherwise
+    bool FindClosestHole(int x, int fromY, int toY, int maxDistance, uint32 collisionMask, int& outOffset) const;
+
+    // Continuous floor under x between fromY and toY, outRight is exclusive. Returns false if there is no floor at x
+    bool GetFloorSpan(int x, int fromY, int toY, uint32 collisionMask, int& outLeft, int& outRight) const;
+
+    // Horizontal raycast from (x, y) towards sign of maxDistance. Geometry containing the starting point
+    // is ignored the same way Box2D ignores fixtures containing origin of the ray
+    bool FindClosestWall(int x, int y, int maxDistance, uint32 collisionMask, int& outOffset) const;
+
+    // True if segment between the points does not intersect any geometry matching the mask
+    bool IsLineOfSight(const Point& fromPoint, const Point& toPoint, uint32 collisionMask) const;
+
+private:
+    typedef std::vector<uint32> RectIndexList;
+
+    int GetColumnIdx(int x) const { return x < 0 ? -1 : x / m_ColumnWidth; }
+    const RectIndexList* GetColumn(int columnIdx) const;
+
+    // Rect in column of x which covers x and vertical range, if there are more, the one reaching furthest
+    // in given direction is returned
+    const NavigationRect* FindCoveringRect(int x, int fromY, int toY, uint32 collisionMask, int direction) const;
+
+    int m_ColumnWidth;
+    std::vector<NavigationRect> m_Rects;
+    std::vector<RectIndexList> m_Columns;
+};
+
+#endif
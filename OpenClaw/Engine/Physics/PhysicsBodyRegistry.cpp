@@ -0,0 +1,200 @@
+#include "PhysicsBodyRegistry.h"
+
+const uint32 INITIAL_INDEX_SIZE = 256;
+
+static inline uint32 HashActorId(uint32 actorId)
+{
+    // Actor IDs are sequential, scatter them over the table
+    return actorId * 2654435761U;
+}
+
+PhysicsBodyRegistry::PhysicsBodyRegistry()
+{
+    Clear();
+}
+
+void PhysicsBodyRegistry::Clear()
+{
+    m_Slots.clear();
+    m_FirstFreeSlot = UINT32_MAX;
+
+    IndexEntry emptyEntry = { INVALID_ACTOR_ID, 0 };
+    m_Index.assign(INITIAL_INDEX_SIZE, emptyEntry);
+    m_IndexCount = 0;
+
+    m_DenseBodies.clear();
+    m_DenseToSlot.clear();
+}
+
+PhysicsBodyHandle PhysicsBodyRegistry::Add(uint32 actorId, b2Body* pBody)
+{
+    assert(actorId != INVALID_ACTOR_ID);
+    assert(pBody != NULL);
+
+    if (FindHandle(actorId).IsValid())
+    {
+        return PhysicsBodyHandle();
+    }
+
+    uint32 slotIdx = m_FirstFreeSlot;
+    if (slotIdx != UINT32_MAX)
+    {
+        m_FirstFreeSlot = m_Slots[slotIdx].denseIdxOrNextFree;
+    }
+    else
+    {
+        slotIdx = m_Slots.size();
+        Slot newSlot = { NULL, INVALID_ACTOR_ID, 0, 0 };
+        m_Slots.push_back(newSlot);
+    }
+
+    Slot& slot = m_Slots[slotIdx];
+    slot.pBody = pBody;
+    slot.actorId = actorId;
+    slot.denseIdxOrNextFree = m_DenseBodies.size();
+
+    PhysicsBodyEntry entry = { actorId, pBody };
+    m_DenseBodies.push_back(entry);
+    m_DenseToSlot.push_back(slotIdx);
+
+    InsertToIndex(actorId, slotIdx);
+
+    PhysicsBodyHandle handle;
+    handle.slotIdx = slotIdx;
+    handle.generation = slot.generation;
+
+    return handle;
+}
+
+bool PhysicsBodyRegistry::Remove(PhysicsBodyHandle handle)
+{
+    if (GetBody(handle) == NULL)
+    {
+        return false;
+    }
+
+    Slot& slot = m_Slots[handle.slotIdx];
+    RemoveFromIndex(slot.actorId);
+
+    // Swap-remove from dense array and patch the slot of moved body
+    uint32 denseIdx = slot.denseIdxOrNextFree;
+    uint32 lastDenseIdx = m_DenseBodies.size() - 1;
+    if (denseIdx != lastDenseIdx)
+    {
+        m_DenseBodies[denseIdx] = m_DenseBodies[lastDenseIdx];
+        m_DenseToSlot[denseIdx] = m_DenseToSlot[lastDenseIdx];
+        m_Slots[m_DenseToSlot[denseIdx]].denseIdxOrNextFree = denseIdx;
+    }
+    m_DenseBodies.pop_back();
+    m_DenseToSlot.pop_back();
+
+    slot.pBody = NULL;
+    slot.actorId = INVALID_ACTOR_ID;
+    slot.generation++;
+    slot.denseIdxOrNextFree = m_FirstFreeSlot;
+    m_FirstFreeSlot = handle.slotIdx;
+
+    return true;
+}
+
+PhysicsBodyHandle PhysicsBodyRegistry::FindHandle(uint32 actorId) const
+{
+    PhysicsBodyHandle handle;
+
+    uint32 position = FindIndexPosition(actorId);
+    if (m_Index[position].actorId == actorId && actorId != INVALID_ACTOR_ID)
+    {
+        handle.slotIdx = m_Index[position].slotIdx;
+        handle.generation = m_Slots[handle.slotIdx].generation;
+    }
+
+    return handle;
+}
+
+b2Body* PhysicsBodyRegistry::GetBody(PhysicsBodyHandle handle) const
+{
+    if (handle.slotIdx >= m_Slots.size() || m_Slots[handle.slotIdx].generation != handle.generation)
+    {
+        return NULL;
+    }
+
+    return m_Slots[handle.slotIdx].pBody;
+}
+
+// Position of actorId in the index or of the empty entry where it would be inserted
+uint32 PhysicsBodyRegistry::FindIndexPosition(uint32 actorId) const
+{
+    const uint32 mask = m_Index.size() - 1;
+
+    uint32 position = HashActorId(actorId) & mask;
+    while (m_Index[position].actorId != INVALID_ACTOR_ID && m_Index[position].actorId != actorId)
+    {
+        position = (position + 1) & mask;
+    }
+
+    return position;
+}
+
+void PhysicsBodyRegistry::InsertToIndex(uint32 actorId, uint32 slotIdx)
+{
+    // Keep load factor under 1/2 so that probe sequences stay short
+    if ((m_IndexCount + 1) * 2 > m_Index.size())
+    {
+        GrowIndex();
+    }
+
+    uint32 position = FindIndexPosition(actorId);
+    m_Index[position].actorId = actorId;
+    m_Index[position].slotIdx = slotIdx;
+    m_IndexCount++;
+}
+
+void PhysicsBodyRegistry::RemoveFromIndex(uint32 actorId)
+{
+    const uint32 mask = m_Index.size() - 1;
+
+    uint32 position = FindIndexPosition(actorId);
+    if (m_Index[position].actorId != actorId)
+    {
+        return;
+    }
+
+    // Backward shift deletion - move following entries of the probe sequence into the hole so that no tombstones
+    // are needed
+    uint32 holePosition = position;
+    uint32 nextPosition = (position + 1) & mask;
+    while (m_Index[nextPosition].actorId != INVALID_ACTOR_ID)
+    {
+        uint32 homePosition = HashActorId(m_Index[nextPosition].actorId) & mask;
+        // Entry can move to the hole only if its home position is not cyclically within (hole, next]
+        bool isHomeBetween = (holePosition <= nextPosition) ?
+            (holePosition < homePosition && homePosition <= nextPosition) :
+            (holePosition < homePosition || homePosition <= nextPosition);
+        if (!isHomeBetween)
+        {
+            m_Index[holePosition] = m_Index[nextPosition];
+            holePosition = nextPosition;
+        }
+        nextPosition = (nextPosition + 1) & mask;
+    }
+
+    m_Index[holePosition].actorId = INVALID_ACTOR_ID;
+    m_IndexCount--;
+}
+
+void PhysicsBodyRegistry::GrowIndex()
+{
+    std::vector<IndexEntry> oldIndex;
+    oldIndex.swap(m_Index);
+
+    IndexEntry emptyEntry = { INVALID_ACTOR_ID, 0 };
+    m_Index.assign(oldIndex.size() * 2, emptyEntry);
+
+    for (const IndexEntry& entry : oldIndex)
+    {
+        if (entry.actorId != INVALID_ACTOR_ID)
+        {
+            m_Index[FindIndexPosition(entry.actorId)] = entry;
+        }
+    }
+}
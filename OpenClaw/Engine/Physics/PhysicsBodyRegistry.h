@@ -0,0 +1,87 @@
+#ifndef __PHYSICS_BODY_REGISTRY_H__
+#define __PHYSICS_BODY_REGISTRY_H__
+
+#include "../SharedDefines.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// PhysicsBodyRegistry
+//
+// Box2D bodies of actors. Bodies live in slots of a slot array, each slot carries generation which is bumped when its
+// body is removed so handles to removed bodies can be detected instead of resolving to whatever reuses the slot.
+// Actor ID -> slot lookups go through open addressing (linear probing) index, bodies are additionally kept in dense
+// array for iteration which is compacted by swap-remove. Add, remove and lookups are O(1).
+//---------------------------------------------------------------------------------------------------------------------
+
+struct PhysicsBodyHandle
+{
+    PhysicsBodyHandle()
+    {
+        slotIdx = UINT32_MAX;
+        generation = 0;
+    }
+
+    bool IsValid() const { return slotIdx != UINT32_MAX; }
+
+    uint32 slotIdx;
+    uint32 generation;
+};
+
+struct PhysicsBodyEntry
+{
+    uint32 actorId;
+    b2Body* pBody;
+};
+
+class PhysicsBodyRegistry
+{
+public:
+    PhysicsBodyRegistry();
+
+    // Returns invalid handle if actor already has body registered
+    PhysicsBodyHandle Add(uint32 actorId, b2Body* pBody);
+    bool Remove(PhysicsBodyHandle handle);
+    bool Remove(uint32 actorId) { return Remove(FindHandle(actorId)); }
+    void Clear();
+
+    PhysicsBodyHandle FindHandle(uint32 actorId) const;
+    // NULL for invalid or stale handles
+    b2Body* GetBody(PhysicsBodyHandle handle) const;
+    b2Body* FindBody(uint32 actorId) const { return GetBody(FindHandle(actorId)); }
+
+    // Order changes when bodies are removed
+    const std::vector<PhysicsBodyEntry>& GetBodies() const { return m_DenseBodies; }
+    uint32 GetCount() const { return m_DenseBodies.size(); }
+
+private:
+    struct Slot
+    {
+        b2Body* pBody;
+        uint32 actorId;
+        uint32 generation;
+        // Index to m_DenseBodies when used, next free slot otherwise
+        uint32 denseIdxOrNextFree;
+    };
+
+    struct IndexEntry
+    {
+        uint32 actorId;
+        uint32 slotIdx;
+    };
+
+    uint32 FindIndexPosition(uint32 actorId) const;
+    void InsertToIndex(uint32 actorId, uint32 slotIdx);
+    void RemoveFromIndex(uint32 actorId);
+    void GrowIndex();
+
+    std::vector<Slot> m_Slots;
+    uint32 m_FirstFreeSlot;
+
+    // Size is power of two, INVALID_ACTOR_ID marks empty entry
+    std::vector<IndexEntry> m_Index;
+    uint32 m_IndexCount;
+
+    std::vector<PhysicsBodyEntry> m_DenseBodies;
+    std::vector<uint32> m_DenseToSlot;
+};
+
+#endif
@@ -26,9 +26,88 @@ int numFootContacts = 0;
         std::swap(FixtureA, FixtureB); \
         } \
 
+typedef bool (*ContactHandler)(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB);
 
-template<typename T>
+//---------------------------------------------------------------------------------------------------------------------
+// ContactDispatchTable
+//
+// Handlers indexed by fixture types of both contacting fixtures. Each handler is keyed by fixture type which one of
+// the fixtures has to have, so contacts only go through handlers which can act on them. Handlers run in order of
+// their registration and swap fixtures in place, returning false stops dispatching of the contact.
+//---------------------------------------------------------------------------------------------------------------------
+class ContactDispatchTable
+{
+public:
+    ContactDispatchTable()
+    {
+        memset(m_HandlerMasks, 0, sizeof(m_HandlerMasks));
+    }
+
+    // Registering the same handler with more key types keeps its original order
+    void Register(ContactHandler handler, FixtureType keyType)
+    {
+        uint32 handlerIdx = std::find(m_Handlers.begin(), m_Handlers.end(), handler) - m_Handlers.begin();
+        if (handlerIdx == m_Handlers.size())
+        {
+            assert(m_Handlers.size() < 32 && "Handler mask is 32 bits");
+            m_Handlers.push_back(handler);
+        }
+
+        for (int otherType = 0; otherType < FixtureType_Max; otherType++)
+        {
+            m_HandlerMasks[keyType][otherType] |= (1 << handlerIdx);
+            m_HandlerMasks[otherType][keyType] |= (1 << handlerIdx);
+        }
+    }
+
+    void Dispatch(PhysicsContactListener& listener, b2Contact* pContact) const
+    {
+        b2Fixture* pFixtureA = pContact->GetFixtureA();
+        b2Fixture* pFixtureB = pContact->GetFixtureB();
+
+        uint32 handlerMask = m_HandlerMasks[GetFixtureType(pFixtureA)][GetFixtureType(pFixtureB)];
+        for (uint32 handlerIdx = 0; handlerMask != 0; handlerIdx++, handlerMask >>= 1)
+        {
+            if ((handlerMask & 1) && !m_Handlers[handlerIdx](listener, pContact, pFixtureA, pFixtureB))
+            {
+                return;
+            }
+        }
+    }
+
+private:
+    static FixtureType GetFixtureType(const b2Fixture* pFixture)
+    {
+        std::intptr_t fixtureType = reinterpret_cast<std::intptr_t>(pFixture->GetUserData());
+        if (fixtureType < 0 || fixtureType >= FixtureType_Max)
+        {
+            return FixtureType_None;
+        }
+
+        return FixtureType(fixtureType);
+    }
+
+    std::vector<ContactHandler> m_Handlers;
+    uint32 m_HandlerMasks[FixtureType_Max][FixtureType_Max];
+};
+
+// Bodies of tiles have no actor
+static const ContactComponents& GetContactComponentsFromB2Body(PhysicsContactListener& listener, const b2Body* pBody)
+{
+    static const ContactComponents s_NoComponents = ContactComponents();
+
+    Actor* pActor = static_cast<Actor*>(pBody->GetUserData());
+    if (!pActor)
+    {
+        return s_NoComponents;
+    }
+
+    return listener.GetContactComponents(pActor);
+}
+
+template<typename T, T* ContactComponents::*pStateComponentMember>
 void TryCallActorEnteredOrLeftAgroRange(
+    PhysicsContactListener& listener,
     b2Fixture* pFixtureA,
     b2Fixture* pFixtureB,
     FixtureType agroFixtureType,
@@ -44,8 +123,7 @@ void TryCallActorEnteredOrLeftAgroRange(
 
             if (pActorwhoEntered && pActorWithMeleeSensor)
             {
-                shared_ptr<T> pStateComponent =
-                    MakeStrongPtr(pActorWithMeleeSensor->GetComponent<T>(T::g_Name));
+                T* pStateComponent = listener.GetContactComponents(pActorWithMeleeSensor).*pStateComponentMember;
                 assert(pStateComponent != nullptr);
                 if (pStateComponent)
                 {
@@ -63,32 +141,19 @@ void TryCallActorEnteredOrLeftAgroRange(
     }
 }
 
-// lol
-template<typename T>
-void TryCallActorEnteredAgroRange(
-    b2Fixture* pFixtureA,
-    b2Fixture* pFixtureB,
-    FixtureType agroFixtureType)
+// Agro sensors do not swap the fixtures of the contact
+template<typename T, T* ContactComponents::*pStateComponentMember, FixtureType agroFixtureType>
+static bool BeginAgroContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
 {
-    TryCallActorEnteredOrLeftAgroRange<T>(
-        pFixtureA,
-        pFixtureB,
-        agroFixtureType,
-        true);
+    TryCallActorEnteredOrLeftAgroRange<T, pStateComponentMember>(listener, pFixtureA, pFixtureB, agroFixtureType, true);
+    return true;
 }
 
-// lol
-template<typename T>
-void TryCallActorLeftAgroRange(
-    b2Fixture* pFixtureA,
-    b2Fixture* pFixtureB,
-    FixtureType agroFixtureType)
+template<typename T, T* ContactComponents::*pStateComponentMember, FixtureType agroFixtureType>
+static bool EndAgroContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
 {
-    TryCallActorEnteredOrLeftAgroRange<T>(
-        pFixtureA,
-        pFixtureB,
-        agroFixtureType,
-        false);
+    TryCallActorEnteredOrLeftAgroRange<T, pStateComponentMember>(listener, pFixtureA, pFixtureB, agroFixtureType, false);
+    return true;
 }
 
 static bool IsTriggerFixture(FixtureType fixtureType)
@@ -103,650 +168,754 @@ static bool IsTriggerFixture(FixtureType fixtureType)
 
 //=====================================================================================================================
 //
-// PhysicsContactListener::BeginContact
+// BeginContact handlers
 //
 
-void PhysicsContactListener::BeginContact(b2Contact* pContact)
+// Foot contact
+static bool BeginFootContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
 {
-    b2Fixture* pFixtureA = pContact->GetFixtureA();
-    b2Fixture* pFixtureB = pContact->GetFixtureB();
-
-    // Foot contact
+    // Make it in predictable order
+    if (pFixtureB->GetUserData() == (void*)FixtureType_FootSensor)
     {
-        // Make it in predictable order
-        if (pFixtureB->GetUserData() == (void*)FixtureType_FootSensor)
-        {
-            std::swap(pFixtureA, pFixtureB);
-        }
+        std::swap(pFixtureA, pFixtureB);
+    }
 
-        if (pFixtureA->GetUserData() == (void*)FixtureType_FootSensor)
+    if (pFixtureA->GetUserData() == (void*)FixtureType_FootSensor)
+    {
+        if (pFixtureB->GetUserData() == (void*)FixtureType_Solid ||
+            pFixtureB->GetUserData() == (void*)FixtureType_Death)
         {
-            if (pFixtureB->GetUserData() == (void*)FixtureType_Solid ||
-                pFixtureB->GetUserData() == (void*)FixtureType_Death)
-            {
-                shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureA->GetBody());
-                assert(pPhysicsComponent != nullptr);
+            shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureA->GetBody());
+            assert(pPhysicsComponent != nullptr);
 
-                pPhysicsComponent->OnBeginFootContact();
-            }
+            pPhysicsComponent->OnBeginFootContact();
         }
     }
-    // Ladder contact
+
+    return true;
+}
+
+// Ladder contact
+static bool BeginLadderContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Climb);
+    if (pFixtureA->GetUserData() == (void*)FixtureType_Climb)
     {
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Climb);
-        if (pFixtureA->GetUserData() == (void*)FixtureType_Climb)
+        if (pFixtureB->GetBody()->GetType() == b2_dynamicBody)
         {
-            if (pFixtureB->GetBody()->GetType() == b2_dynamicBody)
-            {
-                shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
-                assert(pPhysicsComponent != nullptr);
+            shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
+            assert(pPhysicsComponent != nullptr);
 
-                pPhysicsComponent->AddOverlappingLadder(pFixtureA);
-            }
+            pPhysicsComponent->AddOverlappingLadder(pFixtureA);
         }
     }
-    // Collision with "One-Way Ground" tile - mostly platforms, elevators and such
+
+    return true;
+}
+
+// Collision with "One-Way Ground" tile - mostly platforms, elevators and such
+static bool BeginGroundContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Ground);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_TopLadderGround);
+    if ((pFixtureA->GetUserData() == (void*)FixtureType_Ground) ||
+        (pFixtureA->GetUserData() == (void*)FixtureType_TopLadderGround))
     {
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Ground);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_TopLadderGround);
-        if ((pFixtureA->GetUserData() == (void*)FixtureType_Ground) ||
-            (pFixtureA->GetUserData() == (void*)FixtureType_TopLadderGround))
+        if (pFixtureB->GetBody()->GetType() == b2_dynamicBody/* && pFixtureB->GetUserData() != (void*)FixtureType_Trigger*/)
         {
-            if (pFixtureB->GetBody()->GetType() == b2_dynamicBody/* && pFixtureB->GetUserData() != (void*)FixtureType_Trigger*/)
+            shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
+            if (pPhysicsComponent == nullptr)
             {
-                shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
-                if (pPhysicsComponent == nullptr)
-                {
-                    LOG_ERROR("Ground fixture: Box2D step with already deleted physics component !");
-                    return;
-                }
-                //LOG("bodyAABB y: " + ToStr(MetersToPixels(bodyAABB.upperBound.y)) + ", Fixture lower: " + ToStr(MetersToPixels(pFixtureA->GetAABB(0).lowerBound.y)));
+                LOG_CATEGORY(LogCategory_Physics, LogLevel_Error, "Ground fixture: Box2D step with already deleted physics component !");
+                return false;
+            }
+            //LOG("bodyAABB y: " + ToStr(MetersToPixels(bodyAABB.upperBound.y)) + ", Fixture lower: " + ToStr(MetersToPixels(pFixtureA->GetAABB(0).lowerBound.y)));
 
-                int numPoints = pContact->GetManifold()->pointCount;
-                b2WorldManifold worldManifold;
-                pContact->GetWorldManifold(&worldManifold);
+            int numPoints = pContact->GetManifold()->pointCount;
+            b2WorldManifold worldManifold;
+            pContact->GetWorldManifold(&worldManifold);
 
-                if (GetLowermostFixture(pFixtureB->GetBody()) != pFixtureB)
-                {
-                    pContact->SetEnabled(false);
-                    return;
-                }
+            if (GetLowermostFixture(pFixtureB->GetBody()) != pFixtureB)
+            {
+                pContact->SetEnabled(false);
+                return false;
+            }
 
-                bool checkFurther = false;
-                Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                Actor* pGroundActor = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
-                /*if (pActor->GetName() == "Claw" && pGroundActor && pGroundActor->GetName() == "Level7_SpringBoard")
-                {
-                    LOG("Contact");
-                    checkFurther = true;
-                }*/
+            bool checkFurther = false;
+            Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+            Actor* pGroundActor = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
+            /*if (pActor->GetName() == "Claw" && pGroundActor && pGroundActor->GetName() == "Level7_SpringBoard")
+            {
+                LOG("Contact");
+                checkFurther = true;
+            }*/
 
-                pContact->SetEnabled(false);
-                for (int pointIdx = 0; pointIdx < numPoints; pointIdx++)
-                {
-                    b2Vec2 pointVelocity = pFixtureB->GetBody()->GetLinearVelocityFromWorldPoint(worldManifold.points[pointIdx]);
+            pContact->SetEnabled(false);
+            for (int pointIdx = 0; pointIdx < numPoints; pointIdx++)
+            {
+                b2Vec2 pointVelocity = pFixtureB->GetBody()->GetLinearVelocityFromWorldPoint(worldManifold.points[pointIdx]);
 
-                    if (pointVelocity.y > -2)
+                if (pointVelocity.y > -2)
+                {
+                    b2AABB bodyAABB = GetBodyAABB(pFixtureB->GetBody(), true);
+                    /*LOG("Actor upper AABB.y: " + ToStr(bodyAABB.upperBound.y));
+                    LOG("Fixture lower AABB.y: " + ToStr(pFixtureA->GetAABB(0).lowerBound.y));
+                    LOG("Lowermost fixture y: " + ToStr(GetLowermostFixture(pFixtureB->GetBody())->GetAABB(0).upperBound.y));*/
+                    /*if ((bodyAABB.upperBound.y - PixelsToMeters(5)) < pFixtureA->GetAABB(0).lowerBound.y)
                     {
-                        b2AABB bodyAABB = GetBodyAABB(pFixtureB->GetBody(), true);
-                        /*LOG("Actor upper AABB.y: " + ToStr(bodyAABB.upperBound.y));
-                        LOG("Fixture lower AABB.y: " + ToStr(pFixtureA->GetAABB(0).lowerBound.y));
-                        LOG("Lowermost fixture y: " + ToStr(GetLowermostFixture(pFixtureB->GetBody())->GetAABB(0).upperBound.y));*/
-                        /*if ((bodyAABB.upperBound.y - PixelsToMeters(5)) < pFixtureA->GetAABB(0).lowerBound.y)
-                        {
-                            pContact->SetEnabled(true);
-                            pPhysicsComponent->AddOverlappingGround(pFixtureA);
-                        }*/
-                        //pFixtureA->GetAABB()
+                        pContact->SetEnabled(true);
+                        pPhysicsComponent->AddOverlappingGround(pFixtureA);
+                    }*/
+                    //pFixtureA->GetAABB()
 
-                        b2Vec2 relativePointA = pFixtureA->GetBody()->GetLocalPoint(worldManifold.points[pointIdx]);
-                        b2Vec2 relativePointB = pFixtureB->GetBody()->GetLocalPoint(worldManifold.points[pointIdx]);
-                        //LOG("Relative point Y: " + ToStr(relativePoint.y));
-                        float platformFaceY = 0.5f;//front of platform, from fixture definition :(
+                    b2Vec2 relativePointA = pFixtureA->GetBody()->GetLocalPoint(worldManifold.points[pointIdx]);
+                    b2Vec2 relativePointB = pFixtureB->GetBody()->GetLocalPoint(worldManifold.points[pointIdx]);
+                    //LOG("Relative point Y: " + ToStr(relativePoint.y));
+                    float platformFaceY = 0.5f;//front of platform, from fixture definition :(
 
-                        /*if (pActor->GetName() == "Claw" && pGroundActor && pGroundActor->GetName() == "Level7_SpringBoard")
-                        {
-                            LOG("RelativePointA.y: " + ToStr(relativePointA.y));
-                        }*/
+                    /*if (pActor->GetName() == "Claw" && pGroundActor && pGroundActor->GetName() == "Level7_SpringBoard")
+                    {
+                        LOG("RelativePointA.y: " + ToStr(relativePointA.y));
+                    }*/
 
-                        //platformFaceY *= (width / height);
+                    //platformFaceY *= (width / height);
 
-                        const b2AABB& groundAABB = pFixtureA->GetAABB(0);
-                        /*float width = aabb.upperBound.x - aabb.lowerBound.x;
-                        float height = aabb.upperBound.y - aabb.lowerBound.y;
-                        float ratio = width / height;
+                    const b2AABB& groundAABB = pFixtureA->GetAABB(0);
+                    /*float width = aabb.upperBound.x - aabb.lowerBound.x;
+                    float height = aabb.upperBound.y - aabb.lowerBound.y;
+                    float ratio = width / height;
 
-                        // Extra wide and thin stuff.. First appearance on level 7 - Aircart elevators
-                        if (ratio > 3.0)
-                        {
-                            //relativePointA.y /= 2 * ratio;
-                        }*/
+                    // Extra wide and thin stuff.. First appearance on level 7 - Aircart elevators
+                    if (ratio > 3.0)
+                    {
+                        //relativePointA.y /= 2 * ratio;
+                    }*/
 
-                        /*Point bodyPos = b2Vec2ToPoint(MetersToPixels(pFixtureA->GetBody()->GetPosition()));
-                        Point fixturePos = b2Vec2ToPoint(MetersToPixels(aabb.GetCenter()));
+                    /*Point bodyPos = b2Vec2ToPoint(MetersToPixels(pFixtureA->GetBody()->GetPosition()));
+                    Point fixturePos = b2Vec2ToPoint(MetersToPixels(aabb.GetCenter()));
 
-                        LOG("BodyPos: " + bodyPos.ToString() + ", FixturePos: " + fixturePos.ToString());*/
+                    LOG("BodyPos: " + bodyPos.ToString() + ", FixturePos: " + fixturePos.ToString());*/
 
-                        // In case the origin of the fixture is not in the body's center
-                        relativePointA += pFixtureA->GetBody()->GetPosition() - groundAABB.GetCenter();
+                    // In case the origin of the fixture is not in the body's center
+                    relativePointA += pFixtureA->GetBody()->GetPosition() - groundAABB.GetCenter();
 
-                        if (relativePointA.y < (platformFaceY - 0.05))
+                    if (relativePointA.y < (platformFaceY - 0.05))
+                    {
+                        
+                        /*if (pActor->GetName() == "Claw" && pFixtureA->GetBody()->GetType() == b2_kinematicBody)
                         {
-                            
-                            /*if (pActor->GetName() == "Claw" && pFixtureA->GetBody()->GetType() == b2_kinematicBody)
-                            {
-                                LOG("y: " + ToStr(relativePointA.y));
-                                LOG("x: " + ToStr(relativePointA.x));
-                                LOG("PointVelocity.y: " + ToStr(pointVelocity.y));
-                            }*/
-                            
-                            // Only allow to actually land from ABOVE not from the side when still below
-                            // Still hacked though... Causes some items to fall through when level load maybe ? (crates level 2)
-                            if (fabs(relativePointA.y) < 0.1f && fabs(relativePointA.x) > 0.1f && fabs(relativePointB.x) > 0.01)
+                            LOG("y: " + ToStr(relativePointA.y));
+                            LOG("x: " + ToStr(relativePointA.x));
+                            LOG("PointVelocity.y: " + ToStr(pointVelocity.y));
+                        }*/
+                        
+                        // Only allow to actually land from ABOVE not from the side when still below
+                        // Still hacked though... Causes some items to fall through when level load maybe ? (crates level 2)
+                        if (fabs(relativePointA.y) < 0.1f && fabs(relativePointA.x) > 0.1f && fabs(relativePointB.x) > 0.01)
+                        {
+                            /*if (pActor->GetName() == "Claw")
                             {
-                                /*if (pActor->GetName() == "Claw")
-                                {
-                                    LOG("-------------");
-                                    LOG("NOT DE");
-                                    LOG("relativePointA.x: " + ToStr(relativePointA.x) + ", relativePointA.y: " + ToStr(relativePointA.y));
-                                    LOG("RelativePointB.x: " + ToStr(relativePointB.x) + ", RelativePointB.y: " + ToStr(relativePointB.y));
-                                    
-                                }
-                                return;*/
+                                LOG("-------------");
+                                LOG("NOT DE");
+                                LOG("relativePointA.x: " + ToStr(relativePointA.x) + ", relativePointA.y: " + ToStr(relativePointA.y));
+                                LOG("RelativePointB.x: " + ToStr(relativePointB.x) + ", RelativePointB.y: " + ToStr(relativePointB.y));
+                                
                             }
-                            /*else
-                            {
-                                if (pActor->GetName() == "Claw")
-                                {
-                                    LOG("-------------");
-                                    LOG("DESTR");
-                                    LOG("relativePointA.x: " + ToStr(relativePointA.x) + ", relativePointA.y: " + ToStr(relativePointA.y));
-                                    LOG("RelativePointB.x: " + ToStr(relativePointB.x) + ", RelativePointB.y: " + ToStr(relativePointB.y));
-                                }
-                            }*/
-
-                            // If bellow the platform the contact should be disabled
-                            if (relativePointA.y > 0.1f)
+                            return false;*/
+                        }
+                        /*else
+                        {
+                            if (pActor->GetName() == "Claw")
                             {
-                                /*if (pActor->GetName() == "Claw" && pGroundActor && pGroundActor->GetName() == "Level7_SpringBoard")
-                                {
-                                    LOG("Nope 2: RelativePointA.y: " + ToStr(relativePointA.y));
-                                }*/
-                                return;
+                                LOG("-------------");
+                                LOG("DESTR");
+                                LOG("relativePointA.x: " + ToStr(relativePointA.x) + ", relativePointA.y: " + ToStr(relativePointA.y));
+                                LOG("RelativePointB.x: " + ToStr(relativePointB.x) + ", RelativePointB.y: " + ToStr(relativePointB.y));
                             }
+                        }*/
 
+                        // If bellow the platform the contact should be disabled
+                        if (relativePointA.y > 0.1f)
+                        {
                             /*if (pActor->GetName() == "Claw" && pGroundActor && pGroundActor->GetName() == "Level7_SpringBoard")
                             {
-                                LOG("Yep: RelativePointA.y: " + ToStr(relativePointA.y));
+                                LOG("Nope 2: RelativePointA.y: " + ToStr(relativePointA.y));
                             }*/
+                            return false;
+                        }
 
-                            // TODO: Think about better solution and rename this to something better
-                            if (pFixtureA->GetUserData() == (void*)FixtureType_TopLadderGround)
-                            {
-                                pPhysicsComponent->SetTopLadderContact(pContact);
-                            }
-                            
-                            //pFixtureB->GetBody()->SetLinearVelocity(pFixtureA->GetBody()->GetLinearVelocity());
+                        /*if (pActor->GetName() == "Claw" && pGroundActor && pGroundActor->GetName() == "Level7_SpringBoard")
+                        {
+                            LOG("Yep: RelativePointA.y: " + ToStr(relativePointA.y));
+                        }*/
 
-                            /*if (pActor->GetName() == "Claw")
-                            {
-                                LOG("Enabling");
-                            }*/
-                            
-                            pContact->SetEnabled(true);
-                            pPhysicsComponent->AddOverlappingGround(pFixtureA);
-                            break;
+                        // TODO: Think about better solution and rename this to something better
+                        if (pFixtureA->GetUserData() == (void*)FixtureType_TopLadderGround)
+                        {
+                            pPhysicsComponent->SetTopLadderContact(pContact);
                         }
-                    }
-                    else
-                    {
-                        //LOG("Velocity = " + ToStr(pointVelocity.y));
-                    }
+                        
+                        //pFixtureB->GetBody()->SetLinearVelocity(pFixtureA->GetBody()->GetLinearVelocity());
 
-                    /*if (pActor->GetName() == "Claw" && pFixtureA->GetBody()->GetType() == b2_kinematicBody)
-                    {
-                        LOG("TEST 2");
-                    }*/
+                        /*if (pActor->GetName() == "Claw")
+                        {
+                            LOG("Enabling");
+                        }*/
+                        
+                        pContact->SetEnabled(true);
+                        pPhysicsComponent->AddOverlappingGround(pFixtureA);
+                        break;
+                    }
+                }
+                else
+                {
+                    //LOG("Velocity = " + ToStr(pointVelocity.y));
                 }
 
-                /*if (checkFurther)
+                /*if (pActor->GetName() == "Claw" && pFixtureA->GetBody()->GetType() == b2_kinematicBody)
                 {
-                    LOG("Is enabled in the end: " + ToStr(pContact->IsEnabled()));
+                    LOG("TEST 2");
                 }*/
+            }
+
+            /*if (checkFurther)
+            {
+                LOG("Is enabled in the end: " + ToStr(pContact->IsEnabled()));
+            }*/
 #if 0
-                b2AABB bodyAABB = GetBodyAABB(pFixtureB->GetBody());
-                if (/*pFixtureB->GetBody()->GetLinearVelocity().y >= 0 &&*/
-                    (bodyAABB.upperBound.y - PixelsToMeters(20)) < pFixtureA->GetAABB(0).lowerBound.y)
-                {
-                    
-                    //pFixtureA->SetSensor(false);
-                    pContact->SetEnabled(true);
-                    pPhysicsComponent->AddOverlappingGround(pFixtureA);
-                }
-                else
-                {
-                    pContact->SetEnabled(false);
-                }
+            b2AABB bodyAABB = GetBodyAABB(pFixtureB->GetBody());
+            if (/*pFixtureB->GetBody()->GetLinearVelocity().y >= 0 &&*/
+                (bodyAABB.upperBound.y - PixelsToMeters(20)) < pFixtureA->GetAABB(0).lowerBound.y)
+            {
+                
+                //pFixtureA->SetSensor(false);
+                pContact->SetEnabled(true);
+                pPhysicsComponent->AddOverlappingGround(pFixtureA);
+            }
+            else
+            {
+                pContact->SetEnabled(false);
+            }
 #endif
-                // Moving platform (elevator)
-                if (pContact->IsEnabled() /*!pFixtureA->IsSensor()*/ && pFixtureA->GetBody()->GetType() == b2_kinematicBody && !pFixtureB->IsSensor())
+            // Moving platform (elevator)
+            if (pContact->IsEnabled() /*!pFixtureA->IsSensor()*/ && pFixtureA->GetBody()->GetType() == b2_kinematicBody && !pFixtureB->IsSensor())
+            {
+                const ContactComponents& elevatorComponents = GetContactComponentsFromB2Body(listener, pFixtureA->GetBody());
+                if (KinematicComponent* pKinematicComponent = elevatorComponents.pKinematicComponent)
                 {
-                    if (shared_ptr<KinematicComponent> pKinematicComponent = GetKinematicComponentFromB2Body(pFixtureA->GetBody()))
-                    {
-                        pKinematicComponent->AddCarriedBody(pFixtureB->GetBody());
-                    }
-                    else if (shared_ptr<PathElevatorComponent> pPathElevatorComponent = GetPathElevatorComponentFromB2Body(pFixtureA->GetBody()))
-                    {
-                        pPathElevatorComponent->AddCarriedBody(pFixtureB->GetBody());
-                    }
-                    /*shared_ptr<KinematicComponent> pKinematicComponent = GetKinematicComponentFromB2Body(pFixtureA->GetBody());
-                    pKinematicComponent->AddCarriedBody(pFixtureB->GetBody());*/
-                    pPhysicsComponent->AddOverlappingKinematicBody(pFixtureA->GetBody());
-                    pContact->SetFriction(100.0f);
-                    pPhysicsComponent->SetMovingPlatformContact(pContact);
+                    pKinematicComponent->AddCarriedBody(pFixtureB->GetBody());
                 }
-
-                // TODO: HACK: Crumbling peg, hackerino but who cares
-                if (pContact->IsEnabled() /*!pFixtureA->IsSensor()*/ && !pFixtureB->IsSensor() && 
-                    pFixtureA->GetBody()->GetType() == b2_staticBody && pFixtureA->GetBody()->GetUserData())
+                else if (PathElevatorComponent* pPathElevatorComponent = elevatorComponents.pPathElevatorComponent)
                 {
-                    Actor* pActor = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
-                    assert(pActor);
+                    pPathElevatorComponent->AddCarriedBody(pFixtureB->GetBody());
+                }
+                /*shared_ptr<KinematicComponent> pKinematicComponent = GetKinematicComponentFromB2Body(pFixtureA->GetBody());
+                pKinematicComponent->AddCarriedBody(pFixtureB->GetBody());*/
+                pPhysicsComponent->AddOverlappingKinematicBody(pFixtureA->GetBody());
+                pContact->SetFriction(100.0f);
+                pPhysicsComponent->SetMovingPlatformContact(pContact);
+            }
 
-                    bool bIsClaw = MakeStrongPtr(static_cast<Actor*>(pFixtureB->GetBody()->GetUserData())->GetComponent<ClawControllableComponent>()) != nullptr;
+            // TODO: HACK: Crumbling peg, hackerino but who cares
+            if (pContact->IsEnabled() /*!pFixtureA->IsSensor()*/ && !pFixtureB->IsSensor() && 
+                pFixtureA->GetBody()->GetType() == b2_staticBody && pFixtureA->GetBody()->GetUserData())
+            {
+                Actor* pActor = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
+                assert(pActor);
 
-                    shared_ptr<CrumblingPegAIComponent> pCrumblingPegComponent =
-                        MakeStrongPtr(pActor->GetComponent<CrumblingPegAIComponent>(CrumblingPegAIComponent::g_Name));
-                    if (pCrumblingPegComponent && bIsClaw)
-                    {
-                        pCrumblingPegComponent->OnContact(pFixtureB->GetBody());
-                    }
+                const ContactComponents& groundComponents = listener.GetContactComponents(pActor);
+                bool bIsClaw = listener.GetContactComponents(
+                    static_cast<Actor*>(pFixtureB->GetBody()->GetUserData())).pClawControllableComponent != nullptr;
 
-                    shared_ptr<SteppingGroundComponent> pSteppingGroundComponent =
-                        MakeStrongPtr(pActor->GetComponent<SteppingGroundComponent>());
-                    if (pSteppingGroundComponent && bIsClaw)
-                    {
-                        Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                        pSteppingGroundComponent->OnActorContact(pOtherActor);
-                    }
+                CrumblingPegAIComponent* pCrumblingPegComponent = groundComponents.pCrumblingPegComponent;
+                if (pCrumblingPegComponent && bIsClaw)
+                {
+                    pCrumblingPegComponent->OnContact(pFixtureB->GetBody());
+                }
 
-                    shared_ptr<SpringBoardComponent> pSpringBoardComponent =
-                        MakeStrongPtr(pActor->GetComponent<SpringBoardComponent>());
-                    if (pSpringBoardComponent && bIsClaw)
-                    {
-                        Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                        pSpringBoardComponent->OnActorBeginContact(pOtherActor);
-                    }
+                SteppingGroundComponent* pSteppingGroundComponent = groundComponents.pSteppingGroundComponent;
+                if (pSteppingGroundComponent && bIsClaw)
+                {
+                    Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+                    pSteppingGroundComponent->OnActorContact(pOtherActor);
+                }
 
-                    shared_ptr<ConveyorBeltComponent> pConveyorBeltComponent =
-                        MakeStrongPtr(pActor->GetComponent<ConveyorBeltComponent>());
-                    if (pConveyorBeltComponent && bIsClaw)
-                    {
-                        Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                        pConveyorBeltComponent->OnActorBeginContact(pOtherActor);
-                    }
+                SpringBoardComponent* pSpringBoardComponent = groundComponents.pSpringBoardComponent;
+                if (pSpringBoardComponent && bIsClaw)
+                {
+                    Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+                    pSpringBoardComponent->OnActorBeginContact(pOtherActor);
                 }
 
-                /*if (pActor->GetName() == "Claw")
+                ConveyorBeltComponent* pConveyorBeltComponent = groundComponents.pConveyorBeltComponent;
+                if (pConveyorBeltComponent && bIsClaw)
                 {
-                    //LOG("Contact was enabled: " + ToStr(pContact->IsEnabled()));
-                }*/
+                    Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+                    pConveyorBeltComponent->OnActorBeginContact(pOtherActor);
+                }
             }
+
+            /*if (pActor->GetName() == "Claw")
+            {
+                //LOG("Contact was enabled: " + ToStr(pContact->IsEnabled()));
+            }*/
         }
     }
-    // , contact
+
+    return true;
+}
+
+// Trigger contact
+static bool BeginTriggerContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_SpawnArea);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_GabrielButton);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_ChaseEnemyAreaSensor);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_RollAreaSensor);
+    FixtureType fixtureType = FixtureType(reinterpret_cast<std::intptr_t>(pFixtureA->GetUserData()));
+    if (IsTriggerFixture(fixtureType))
     {
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_SpawnArea);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_GabrielButton);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_ChaseEnemyAreaSensor);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_RollAreaSensor);
-        FixtureType fixtureType = FixtureType(reinterpret_cast<std::intptr_t>(pFixtureA->GetUserData()));
-        if (IsTriggerFixture(fixtureType))
+        if (pFixtureB->GetBody()->GetUserData() != NULL)
         {
-            if (pFixtureB->GetBody()->GetUserData() != NULL)
-            {
-                Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                assert(pActor);
+            Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+            assert(pActor);
 
-                shared_ptr<TriggerComponent> pTriggerComponent = GetTriggerComponentFromB2Body(pFixtureA->GetBody());
-                if (pTriggerComponent)
-                {
-                    pTriggerComponent->OnActorEntered(pActor, fixtureType);
-                }
+            TriggerComponent* pTriggerComponent = GetContactComponentsFromB2Body(listener, pFixtureA->GetBody()).pTriggerComponent;
+            if (pTriggerComponent)
+            {
+                pTriggerComponent->OnActorEntered(pActor, fixtureType);
             }
         }
     }
-    // Projectile contact
+
+    return true;
+}
+
+// Projectile contact
+static bool BeginProjectileContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    if (pFixtureB->GetUserData() == (void*)FixtureType_Projectile)
     {
-        if (pFixtureB->GetUserData() == (void*)FixtureType_Projectile)
-        {
-            std::swap(pFixtureA, pFixtureB);
-        }
+        std::swap(pFixtureA, pFixtureB);
+    }
 
-        if (pFixtureA->GetUserData() == (void*)FixtureType_Projectile)
+    if (pFixtureA->GetUserData() == (void*)FixtureType_Projectile)
+    {
+        // Collided with some actor
+        if (pFixtureB->GetBody()->GetUserData() != (void*)NULL)
         {
-            // Collided with some actor
-            if (pFixtureB->GetBody()->GetUserData() != (void*)NULL)
-            {
-                Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                assert(pActor);
+            Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+            assert(pActor);
 
-                shared_ptr<ProjectileAIComponent> pProjectileComponent = GetProjectileAIComponentFromB2Body(pFixtureA->GetBody());
+            ProjectileAIComponent* pProjectileComponent =
+                GetContactComponentsFromB2Body(listener, pFixtureA->GetBody()).pProjectileAIComponent;
 
-                if (pProjectileComponent)
+            if (pProjectileComponent)
+            {
+                // HACK:
+                /*if (shared_ptr<ClawControllableComponent> pClaw =
+                    MakeStrongPtr(pActor->GetComponent<ClawControllableComponent>(ClawControllableComponent::g_Name)))
                 {
-                    // HACK:
-                    /*if (shared_ptr<ClawControllableComponent> pClaw =
-                        MakeStrongPtr(pActor->GetComponent<ClawControllableComponent>(ClawControllableComponent::g_Name)))
-                    {
-                        Actor* pProjectileActor = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
-                        shared_ptr<PositionComponent> pProjectilePositionComponent =
-                            MakeStrongPtr(pProjectileActor->GetComponent<PositionComponent>(PositionComponent::g_Name));
+                    Actor* pProjectileActor = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
+                    shared_ptr<PositionComponent> pProjectilePositionComponent =
+                        MakeStrongPtr(pProjectileActor->GetComponent<PositionComponent>(PositionComponent::g_Name));
 
-                        shared_ptr<PositionComponent> pClawPositionComponent =
-                            MakeStrongPtr(pActor->GetComponent<PositionComponent>(PositionComponent::g_Name));
+                    shared_ptr<PositionComponent> pClawPositionComponent =
+                        MakeStrongPtr(pActor->GetComponent<PositionComponent>(PositionComponent::g_Name));
 
-                        assert(pProjectilePositionComponent);
-                        assert(pClawPositionComponent);
-                        if (pProjectilePositionComponent->GetX() < pClawPositionComponent->GetX())
-                        {
-                            pClaw->m_LastHitDirection = Direction_Left;
-                        }
-                        else
-                        {
-                            pClaw->m_LastHitDirection = Direction_Right;
-                        }
-                    }*/
+                    assert(pProjectilePositionComponent);
+                    assert(pClawPositionComponent);
+                    if (pProjectilePositionComponent->GetX() < pClawPositionComponent->GetX())
+                    {
+                        pClaw->m_LastHitDirection = Direction_Left;
+                    }
+                    else
+                    {
+                        pClaw->m_LastHitDirection = Direction_Right;
+                    }
+                }*/
 
-                    pProjectileComponent->OnCollidedWithActor(pActor);
-                }
+                pProjectileComponent->OnCollidedWithActor(pActor);
             }
-            // Projectile collided with solid tile
-            else if (pFixtureB->GetBody()->GetType() == b2_staticBody/* &&
-                (pFixtureB->GetUserData() == (void*)FixtureType_Solid ||
-                 pFixtureB->GetUserData() == (void*)FixtureType_TopLadderGround ||
-                 pFixtureB->GetUserData() == (void*)FixtureType_Ground)*/)
+        }
+        // Projectile collided with solid tile
+        else if (pFixtureB->GetBody()->GetType() == b2_staticBody/* &&
+            (pFixtureB->GetUserData() == (void*)FixtureType_Solid ||
+             pFixtureB->GetUserData() == (void*)FixtureType_TopLadderGround ||
+             pFixtureB->GetUserData() == (void*)FixtureType_Ground)*/)
+        {
+            if (pFixtureB->GetUserData() == (void*)FixtureType_TopLadderGround)
             {
-                if (pFixtureB->GetUserData() == (void*)FixtureType_TopLadderGround)
-                {
-                    pContact->SetEnabled(false);
-                    return;
-                }
+                pContact->SetEnabled(false);
+                return false;
+            }
 
-                shared_ptr<ProjectileAIComponent> pProjectileComponent = GetProjectileAIComponentFromB2Body(pFixtureA->GetBody());
-                if (pProjectileComponent)
-                {
-                    pProjectileComponent->OnCollidedWithSolidTile();
-                }
+            ProjectileAIComponent* pProjectileComponent =
+                GetContactComponentsFromB2Body(listener, pFixtureA->GetBody()).pProjectileAIComponent;
+            if (pProjectileComponent)
+            {
+                pProjectileComponent->OnCollidedWithSolidTile();
             }
         }
     }
-    // Death contact
+
+    return true;
+}
+
+// Death contact
+static bool BeginDeathContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    if (pFixtureB->GetUserData() == (void*)FixtureType_Death)
     {
-        if (pFixtureB->GetUserData() == (void*)FixtureType_Death)
-        {
-            std::swap(pFixtureA, pFixtureB);
-        }
+        std::swap(pFixtureA, pFixtureB);
+    }
 
-        if (pFixtureA->GetUserData() == (void*)FixtureType_Death)
+    if (pFixtureA->GetUserData() == (void*)FixtureType_Death)
+    {
+        if (pFixtureB->GetBody()->GetUserData() != NULL)
         {
-            if (pFixtureB->GetBody()->GetUserData() != NULL)
-            {
-                Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                assert(pActor);
+            Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+            assert(pActor);
 
-                shared_ptr<HealthComponent> pHealthComponent =
-                    MakeStrongPtr(pActor->GetComponent<HealthComponent>(HealthComponent::g_Name));
-                if (pHealthComponent)
-                {
-                    pHealthComponent->AddHealth(-1 * (pHealthComponent->GetHealth() + 1), DamageType_DeathTile, Point(0, 0), INVALID_ACTOR_ID);
-                }
+            HealthComponent* pHealthComponent = listener.GetContactComponents(pActor).pHealthComponent;
+            if (pHealthComponent)
+            {
+                pHealthComponent->AddHealth(-1 * (pHealthComponent->GetHealth() + 1), DamageType_DeathTile, Point(0, 0), INVALID_ACTOR_ID);
             }
         }
     }
-    // Enemy agro melee contact
-    {
-        TryCallActorEnteredAgroRange<MeleeAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIMeleeSensor);
-    }
-    // Enemy duck agro melee contact
-    {
-        TryCallActorEnteredAgroRange<DuckMeleeAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIDuckMeleeSensor);
-    }
-    // Enemy ranged agro range contact
-    {
-        TryCallActorEnteredAgroRange<RangedAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIRangedSensor);
-    }
-    // Enemy duck ranged agro range contact
-    {
-        TryCallActorEnteredAgroRange<DuckRangedAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIDuckRangedSensor);
-    }
-    // Enemy dive area agro range contact
+
+    return true;
+}
+
+// Damage aura
+static bool BeginDamageAuraContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    if (pFixtureB->GetUserData() == (void*)FixtureType_DamageAura)
     {
-        TryCallActorEnteredAgroRange<DiveAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIDiveAreaSensor);
+        std::swap(pFixtureA, pFixtureB);
     }
-    // Damage aura
+
+    if (pFixtureA->GetUserData() == (void*)FixtureType_DamageAura)
     {
-        if (pFixtureB->GetUserData() == (void*)FixtureType_DamageAura)
+        if (pFixtureB->GetBody()->GetUserData() != NULL)
         {
-            std::swap(pFixtureA, pFixtureB);
-        }
+            Actor* pActorwhoEntered = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+            Actor* pActorWithDamageAura = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
 
-        if (pFixtureA->GetUserData() == (void*)FixtureType_DamageAura)
-        {
-            if (pFixtureB->GetBody()->GetUserData() != NULL)
+            if (pActorwhoEntered && pActorWithDamageAura)
             {
-                Actor* pActorwhoEntered = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                Actor* pActorWithDamageAura = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
-
-                if (pActorwhoEntered && pActorWithDamageAura)
+                DamageAuraComponent* pDamageAuraComponent =
+                    listener.GetContactComponents(pActorWithDamageAura).pDamageAuraComponent;
+                if (pDamageAuraComponent)
                 {
-                    shared_ptr<DamageAuraComponent> pDamageAuraComponent =
-                        MakeStrongPtr(pActorWithDamageAura->GetComponent<DamageAuraComponent>(DamageAuraComponent::g_Name));
-                    if (pDamageAuraComponent)
-                    {
-                        pDamageAuraComponent->OnActorEntered(pActorwhoEntered);
-                    }
+                    pDamageAuraComponent->OnActorEntered(pActorwhoEntered);
                 }
             }
         }
     }
+
+    return true;
 }
 
 //=====================================================================================================================
 //
-// PhysicsContactListener::EndContact
+// EndContact handlers
 //
 
-void PhysicsContactListener::EndContact(b2Contact* pContact)
+// Foot contact
+static bool EndFootContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
 {
-    b2Fixture* pFixtureA = pContact->GetFixtureA();
-    b2Fixture* pFixtureB = pContact->GetFixtureB();
-
+    // Make it in predictable order
+    if (pFixtureB->GetUserData() == (void*)FixtureType_FootSensor)
     {
-        // Make it in predictable order
-        if (pFixtureB->GetUserData() == (void*)FixtureType_FootSensor)
-        {
-            std::swap(pFixtureA, pFixtureB);
-        }
+        std::swap(pFixtureA, pFixtureB);
+    }
 
-        if (pFixtureA->GetUserData() == (void*)FixtureType_FootSensor)
+    if (pFixtureA->GetUserData() == (void*)FixtureType_FootSensor)
+    {
+        if (pFixtureB->GetUserData() == (void*)FixtureType_Solid || 
+            pFixtureB->GetUserData() == (void*)FixtureType_Death)
         {
-            if (pFixtureB->GetUserData() == (void*)FixtureType_Solid || 
-                pFixtureB->GetUserData() == (void*)FixtureType_Death)
-            {
-                shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureA->GetBody());
-                assert(pPhysicsComponent != nullptr);
+            shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureA->GetBody());
+            assert(pPhysicsComponent != nullptr);
 
-                pPhysicsComponent->OnEndFootContact();
-            }
+            pPhysicsComponent->OnEndFootContact();
         }
     }
-    // Ladder contact
+
+    return true;
+}
+
+// Ladder contact
+static bool EndLadderContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    if (pFixtureB->GetUserData() == (void*)FixtureType_Climb)
     {
-        if (pFixtureB->GetUserData() == (void*)FixtureType_Climb)
-        {
-            std::swap(pFixtureA, pFixtureB);
-        }
+        std::swap(pFixtureA, pFixtureB);
+    }
 
-        if (pFixtureA->GetUserData() == (void*)FixtureType_Climb)
+    if (pFixtureA->GetUserData() == (void*)FixtureType_Climb)
+    {
+        if (pFixtureB->GetBody()->GetType() == b2_dynamicBody)
         {
-            if (pFixtureB->GetBody()->GetType() == b2_dynamicBody)
-            {
-                shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
-                assert(pPhysicsComponent != nullptr);
+            shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
+            assert(pPhysicsComponent != nullptr);
 
-                pPhysicsComponent->RemoveOverlappingLadder(pFixtureA);
-            }
+            pPhysicsComponent->RemoveOverlappingLadder(pFixtureA);
         }
     }
-    // Collision with "One-Way Ground" tile - mostly platforms, elevators and such
+
+    return true;
+}
+
+// Collision with "One-Way Ground" tile - mostly platforms, elevators and such
+static bool EndGroundContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Ground);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_TopLadderGround);
+    if ((pFixtureA->GetUserData() == (void*)FixtureType_Ground) ||
+        (pFixtureA->GetUserData() == (void*)FixtureType_TopLadderGround))
     {
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Ground);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_TopLadderGround);
-        if ((pFixtureA->GetUserData() == (void*)FixtureType_Ground) ||
-            (pFixtureA->GetUserData() == (void*)FixtureType_TopLadderGround))
+        if (pFixtureB->GetBody()->GetType() == b2_dynamicBody && pFixtureB->GetUserData() != (void*)FixtureType_Trigger)
         {
-            if (pFixtureB->GetBody()->GetType() == b2_dynamicBody && pFixtureB->GetUserData() != (void*)FixtureType_Trigger)
+            shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
+            if (pPhysicsComponent)
             {
-                shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
-                if (pPhysicsComponent)
+                // Moving platform (elevator)
+                if (pContact->IsEnabled()/*!pFixtureA->IsSensor()*/ && pFixtureA->GetBody()->GetType() == b2_kinematicBody && !pFixtureB->IsSensor())
                 {
-                    // Moving platform (elevator)
-                    if (pContact->IsEnabled()/*!pFixtureA->IsSensor()*/ && pFixtureA->GetBody()->GetType() == b2_kinematicBody && !pFixtureB->IsSensor())
+                    //LOG("REMOVED");
+                    const ContactComponents& elevatorComponents = GetContactComponentsFromB2Body(listener, pFixtureA->GetBody());
+                    if (KinematicComponent* pKinematicComponent = elevatorComponents.pKinematicComponent)
                     {
-                        //LOG("REMOVED");
-                        if (shared_ptr<KinematicComponent> pKinematicComponent = GetKinematicComponentFromB2Body(pFixtureA->GetBody()))
-                        {
-                            pKinematicComponent->RemoveCarriedBody(pFixtureB->GetBody());
-                        }
-                        else if (shared_ptr<PathElevatorComponent> pPathElevatorComponent = GetPathElevatorComponentFromB2Body(pFixtureA->GetBody()))
-                        {
-                            pPathElevatorComponent->RemoveCarriedBody(pFixtureB->GetBody());
-                        }
-                        /*shared_ptr<KinematicComponent> pKinematicComponent = GetKinematicComponentFromB2Body(pFixtureA->GetBody());
-                        pKinematicComponent->RemoveCarriedBody(pFixtureB->GetBody());*/
-                        pPhysicsComponent->RemoveOverlappingKinematicBody(pFixtureA->GetBody());
-                        pPhysicsComponent->SetMovingPlatformContact(NULL);
+                        pKinematicComponent->RemoveCarriedBody(pFixtureB->GetBody());
                     }
-
-                    /*if (!pFixtureA->IsSensor())
+                    else if (PathElevatorComponent* pPathElevatorComponent = elevatorComponents.pPathElevatorComponent)
                     {
-                        pPhysicsComponent->RemoveOverlappingGround(pFixtureA);
+                        pPathElevatorComponent->RemoveCarriedBody(pFixtureB->GetBody());
                     }
-                    pFixtureA->SetSensor(true);*/
+                    /*shared_ptr<KinematicComponent> pKinematicComponent = GetKinematicComponentFromB2Body(pFixtureA->GetBody());
+                    pKinematicComponent->RemoveCarriedBody(pFixtureB->GetBody());*/
+                    pPhysicsComponent->RemoveOverlappingKinematicBody(pFixtureA->GetBody());
+                    pPhysicsComponent->SetMovingPlatformContact(NULL);
+                }
+
+                /*if (!pFixtureA->IsSensor())
+                {
+                    pPhysicsComponent->RemoveOverlappingGround(pFixtureA);
+                }
+                pFixtureA->SetSensor(true);*/
+
+                if (pContact->IsEnabled() || pPhysicsComponent->GetTopLadderContact() == pContact)
+                {
+                    pPhysicsComponent->RemoveOverlappingGround(pFixtureA);
+                }
 
-                    if (pContact->IsEnabled() || pPhysicsComponent->GetTopLadderContact() == pContact)
+                Actor* pGroundActor = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
+                if (pGroundActor)
+                {
+                    const ContactComponents& groundComponents = listener.GetContactComponents(pGroundActor);
+                    SpringBoardComponent* pSpringBoardComponent = groundComponents.pSpringBoardComponent;
+                    if (pSpringBoardComponent)
                     {
-                        pPhysicsComponent->RemoveOverlappingGround(pFixtureA);
+                        Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+                        pSpringBoardComponent->OnActorEndContact(pOtherActor);
                     }
 
-                    Actor* pGroundActor = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
-                    if (pGroundActor)
+                    ConveyorBeltComponent* pConveyorBeltComponent = groundComponents.pConveyorBeltComponent;
+                    if (pConveyorBeltComponent)
                     {
-                        shared_ptr<SpringBoardComponent> pSpringBoardComponent =
-                            MakeStrongPtr(pGroundActor->GetComponent<SpringBoardComponent>());
-                        if (pSpringBoardComponent)
-                        {
-                            Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                            pSpringBoardComponent->OnActorEndContact(pOtherActor);
-                        }
-
-                        shared_ptr<ConveyorBeltComponent> pConveyorBeltComponent =
-                            MakeStrongPtr(pGroundActor->GetComponent<ConveyorBeltComponent>());
-                        if (pConveyorBeltComponent)
-                        {
-                            Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                            pConveyorBeltComponent->OnActorEndContact(pOtherActor);
-                        }
+                        Actor* pOtherActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+                        pConveyorBeltComponent->OnActorEndContact(pOtherActor);
                     }
+                }
 
-                    pContact->SetEnabled(false);
+                pContact->SetEnabled(false);
 
-                    /*if (pFixtureB->GetBody()->GetLinearVelocity().y >= 0)
-                    {
-                    LOG("HERE");
-                    pFixtureA->SetSensor(false);
-                    shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
-                    pPhysicsComponent->OnBeginFootContact();
-                    }
-                    else
-                    {
-                    pFixtureA->SetSensor(true);
-                    }*/
+                /*if (pFixtureB->GetBody()->GetLinearVelocity().y >= 0)
+                {
+                LOG("HERE");
+                pFixtureA->SetSensor(false);
+                shared_ptr<PhysicsComponent> pPhysicsComponent = GetPhysicsComponentFromB2Body(pFixtureB->GetBody());
+                pPhysicsComponent->OnBeginFootContact();
                 }
+                else
+                {
+                pFixtureA->SetSensor(true);
+                }*/
             }
         }
     }
-    // Trigger contact
+
+    return true;
+}
+
+// Trigger contact
+static bool EndTriggerContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_SpawnArea);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_GabrielButton);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_ChaseEnemyAreaSensor);
+    SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_RollAreaSensor);
+    FixtureType fixtureType = FixtureType(reinterpret_cast<std::intptr_t>(pFixtureA->GetUserData()));
+    if (IsTriggerFixture(fixtureType))
     {
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_SpawnArea);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_GabrielButton);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_ChaseEnemyAreaSensor);
-        SWAP_IF_FIXTURE_B_EQUALS(pFixtureA, pFixtureB, FixtureType_Trigger_RollAreaSensor);
-        FixtureType fixtureType = FixtureType(reinterpret_cast<std::intptr_t>(pFixtureA->GetUserData()));
-        if (IsTriggerFixture(fixtureType))
+        if (pFixtureB->GetBody()->GetUserData() != NULL)
         {
-            if (pFixtureB->GetBody()->GetUserData() != NULL)
-            {
-                Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                assert(pActor);
+            Actor* pActor = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+            assert(pActor);
 
-                shared_ptr<TriggerComponent> pTriggerComponent = GetTriggerComponentFromB2Body(pFixtureA->GetBody());
-                if (pTriggerComponent)
-                {
-                    pTriggerComponent->OnActorLeft(pActor, fixtureType);
-                }
+            TriggerComponent* pTriggerComponent = GetContactComponentsFromB2Body(listener, pFixtureA->GetBody()).pTriggerComponent;
+            if (pTriggerComponent)
+            {
+                pTriggerComponent->OnActorLeft(pActor, fixtureType);
             }
         }
     }
-    // Enemy agro melee contact
-    {
-        TryCallActorLeftAgroRange<MeleeAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIMeleeSensor);
-    }
-    // Enemy duck agro melee contact
-    {
-        TryCallActorLeftAgroRange<DuckMeleeAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIDuckMeleeSensor);
-    }
-    // Enemy ranged agro range contact
-    {
-        TryCallActorLeftAgroRange<RangedAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIRangedSensor);
-    }
-    // Enemy duck ranged agro range contact
-    {
-        TryCallActorLeftAgroRange<DuckRangedAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIDuckRangedSensor);
-    }
-    // Enemy dive area agro range contact
+
+    return true;
+}
+
+// Damage aura
+static bool EndDamageAuraContact(PhysicsContactListener& listener, b2Contact* pContact, b2Fixture*& pFixtureA, b2Fixture*& pFixtureB)
+{
+    if (pFixtureB->GetUserData() == (void*)FixtureType_DamageAura)
     {
-        TryCallActorLeftAgroRange<DiveAttackAIStateComponent>(pFixtureA, pFixtureB, FixtureType_EnemyAIDiveAreaSensor);
+        std::swap(pFixtureA, pFixtureB);
     }
-    // Damage aura
+
+    if (pFixtureA->GetUserData() == (void*)FixtureType_DamageAura)
     {
-        if (pFixtureB->GetUserData() == (void*)FixtureType_DamageAura)
+        if (pFixtureB->GetBody()->GetUserData() != NULL)
         {
-            std::swap(pFixtureA, pFixtureB);
-        }
+            Actor* pActorwhoEntered = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
+            Actor* pActorWithDamageAura = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
 
-        if (pFixtureA->GetUserData() == (void*)FixtureType_DamageAura)
-        {
-            if (pFixtureB->GetBody()->GetUserData() != NULL)
+            if (pActorwhoEntered && pActorWithDamageAura)
             {
-                Actor* pActorwhoEntered = static_cast<Actor*>(pFixtureB->GetBody()->GetUserData());
-                Actor* pActorWithDamageAura = static_cast<Actor*>(pFixtureA->GetBody()->GetUserData());
-
-                if (pActorwhoEntered && pActorWithDamageAura)
+                DamageAuraComponent* pDamageAuraComponent =
+                    listener.GetContactComponents(pActorWithDamageAura).pDamageAuraComponent;
+                if (pDamageAuraComponent)
                 {
-                    shared_ptr<DamageAuraComponent> pDamageAuraComponent =
-                        MakeStrongPtr(pActorWithDamageAura->GetComponent<DamageAuraComponent>(DamageAuraComponent::g_Name));
-                    if (pDamageAuraComponent)
-                    {
-                        pDamageAuraComponent->OnActorLeft(pActorwhoEntered);
-                    }
+                    pDamageAuraComponent->OnActorLeft(pActorwhoEntered);
                 }
             }
         }
     }
+
+    return true;
+}
+
+static ContactDispatchTable CreateBeginContactTable()
+{
+    ContactDispatchTable table;
+    table.Register(BeginFootContact, FixtureType_FootSensor);
+    table.Register(BeginLadderContact, FixtureType_Climb);
+    table.Register(BeginGroundContact, FixtureType_Ground);
+    table.Register(BeginGroundContact, FixtureType_TopLadderGround);
+    table.Register(BeginTriggerContact, FixtureType_Trigger);
+    table.Register(BeginTriggerContact, FixtureType_Trigger_SpawnArea);
+    table.Register(BeginTriggerContact, FixtureType_Trigger_GabrielButton);
+    table.Register(BeginTriggerContact, FixtureType_Trigger_ChaseEnemyAreaSensor);
+    table.Register(BeginTriggerContact, FixtureType_Trigger_RollAreaSensor);
+    table.Register(BeginProjectileContact, FixtureType_Projectile);
+    table.Register(BeginDeathContact, FixtureType_Death);
+    table.Register(BeginAgroContact<MeleeAttackAIStateComponent,
+        &ContactComponents::pMeleeAttackComponent, FixtureType_EnemyAIMeleeSensor>, FixtureType_EnemyAIMeleeSensor);
+    table.Register(BeginAgroContact<DuckMeleeAttackAIStateComponent,
+        &ContactComponents::pDuckMeleeAttackComponent, FixtureType_EnemyAIDuckMeleeSensor>, FixtureType_EnemyAIDuckMeleeSensor);
+    table.Register(BeginAgroContact<RangedAttackAIStateComponent,
+        &ContactComponents::pRangedAttackComponent, FixtureType_EnemyAIRangedSensor>, FixtureType_EnemyAIRangedSensor);
+    table.Register(BeginAgroContact<DuckRangedAttackAIStateComponent,
+        &ContactComponents::pDuckRangedAttackComponent, FixtureType_EnemyAIDuckRangedSensor>, FixtureType_EnemyAIDuckRangedSensor);
+    table.Register(BeginAgroContact<DiveAttackAIStateComponent,
+        &ContactComponents::pDiveAttackComponent, FixtureType_EnemyAIDiveAreaSensor>, FixtureType_EnemyAIDiveAreaSensor);
+    table.Register(BeginDamageAuraContact, FixtureType_DamageAura);
+
+    return table;
+}
+
+static ContactDispatchTable CreateEndContactTable()
+{
+    ContactDispatchTable table;
+    table.Register(EndFootContact, FixtureType_FootSensor);
+    table.Register(EndLadderContact, FixtureType_Climb);
+    table.Register(EndGroundContact, FixtureType_Ground);
+    table.Register(EndGroundContact, FixtureType_TopLadderGround);
+    table.Register(EndTriggerContact, FixtureType_Trigger);
+    table.Register(EndTriggerContact, FixtureType_Trigger_SpawnArea);
+    table.Register(EndTriggerContact, FixtureType_Trigger_GabrielButton);
+    table.Register(EndTriggerContact, FixtureType_Trigger_ChaseEnemyAreaSensor);
+    table.Register(EndTriggerContact, FixtureType_Trigger_RollAreaSensor);
+    table.Register(EndAgroContact<MeleeAttackAIStateComponent,
+        &ContactComponents::pMeleeAttackComponent, FixtureType_EnemyAIMeleeSensor>, FixtureType_EnemyAIMeleeSensor);
+    table.Register(EndAgroContact<DuckMeleeAttackAIStateComponent,
+        &ContactComponents::pDuckMeleeAttackComponent, FixtureType_EnemyAIDuckMeleeSensor>, FixtureType_EnemyAIDuckMeleeSensor);
+    table.Register(EndAgroContact<RangedAttackAIStateComponent,
+        &ContactComponents::pRangedAttackComponent, FixtureType_EnemyAIRangedSensor>, FixtureType_EnemyAIRangedSensor);
+    table.Register(EndAgroContact<DuckRangedAttackAIStateComponent,
+        &ContactComponents::pDuckRangedAttackComponent, FixtureType_EnemyAIDuckRangedSensor>, FixtureType_EnemyAIDuckRangedSensor);
+    table.Register(EndAgroContact<DiveAttackAIStateComponent,
+        &ContactComponents::pDiveAttackComponent, FixtureType_EnemyAIDiveAreaSensor>, FixtureType_EnemyAIDiveAreaSensor);
+    table.Register(EndDamageAuraContact, FixtureType_DamageAura);
+
+    return table;
+}
+
+static const ContactDispatchTable g_BeginContactTable = CreateBeginContactTable();
+static const ContactDispatchTable g_EndContactTable = CreateEndContactTable();
+
+//=====================================================================================================================
+//
+// PhysicsContactListener
+//
+
+void PhysicsContactListener::BeginContact(b2Contact* pContact)
+{
+    g_BeginContactTable.Dispatch(*this, pContact);
+}
+
+void PhysicsContactListener::EndContact(b2Contact* pContact)
+{
+    g_EndContactTable.Dispatch(*this, pContact);
+}
+
+const ContactComponents& PhysicsContactListener::GetContactComponents(Actor* pActor)
+{
+    assert(pActor);
+
+    auto findIt = m_ContactComponentsCache.find(pActor);
+    if (findIt != m_ContactComponentsCache.end() &&
+        findIt->second.actorId == pActor->GetGUID() &&
+        findIt->second.componentsVersion == pActor->GetComponentsVersion())
+    {
+        return findIt->second;
+    }
+
+    ContactComponents& components = m_ContactComponentsCache[pActor];
+    components.actorId = pActor->GetGUID();
+    components.componentsVersion = pActor->GetComponentsVersion();
+    components.pKinematicComponent = pActor->GetRawComponent<KinematicComponent>();
+    components.pPathElevatorComponent = pActor->GetRawComponent<PathElevatorComponent>();
+    components.pTriggerComponent = pActor->GetRawComponent<TriggerComponent>();
+    components.pProjectileAIComponent = pActor->GetRawComponent<ProjectileAIComponent>();
+    components.pHealthComponent = pActor->GetRawComponent<HealthComponent>();
+    components.pDamageAuraComponent = pActor->GetRawComponent<DamageAuraComponent>();
+    components.pCrumblingPegComponent = pActor->GetRawComponent<CrumblingPegAIComponent>();
+    components.pSteppingGroundComponent = pActor->GetRawComponent<SteppingGroundComponent>();
+    components.pSpringBoardComponent = pActor->GetRawComponent<SpringBoardComponent>();
+    components.pConveyorBeltComponent = pActor->GetRawComponent<ConveyorBeltComponent>();
+    components.pClawControllableComponent = pActor->GetRawComponent<ClawControllableComponent>();
+    components.pMeleeAttackComponent = pActor->GetRawComponent<MeleeAttackAIStateComponent>();
+    components.pDuckMeleeAttackComponent = pActor->GetRawComponent<DuckMeleeAttackAIStateComponent>();
+    components.pRangedAttackComponent = pActor->GetRawComponent<RangedAttackAIStateComponent>();
+    components.pDuckRangedAttackComponent = pActor->GetRawComponent<DuckRangedAttackAIStateComponent>();
+    components.pDiveAttackComponent = pActor->GetRawComponent<DiveAttackAIStateComponent>();
+
+    return components;
 }
 
 void PhysicsContactListener::PreSolve(b2Contact* pContact, const b2Manifold* pOldManifold)
@@ -2,6 +2,52 @@
 #define __PHYSICSCONTACTLISTENER_H__
 
 #include <Box2D/Box2D.h>
+#include <stdint.h>
+#include <unordered_map>
+
+class Actor;
+class PhysicsComponent;
+class KinematicComponent;
+class PathElevatorComponent;
+class TriggerComponent;
+class ProjectileAIComponent;
+class HealthComponent;
+class DamageAuraComponent;
+class CrumblingPegAIComponent;
+class SteppingGroundComponent;
+class SpringBoardComponent;
+class ConveyorBeltComponent;
+class ClawControllableComponent;
+class MeleeAttackAIStateComponent;
+class DuckMeleeAttackAIStateComponent;
+class RangedAttackAIStateComponent;
+class DuckRangedAttackAIStateComponent;
+class DiveAttackAIStateComponent;
+
+// Components of one actor which contact handlers need. Looked up once per actor instead of on every contact
+struct ContactComponents
+{
+    // Actor memory can be reused by another actor, ID is checked as well
+    uint32_t actorId;
+    uint32_t componentsVersion;
+
+    KinematicComponent* pKinematicComponent;
+    PathElevatorComponent* pPathElevatorComponent;
+    TriggerComponent* pTriggerComponent;
+    ProjectileAIComponent* pProjectileAIComponent;
+    HealthComponent* pHealthComponent;
+    DamageAuraComponent* pDamageAuraComponent;
+    CrumblingPegAIComponent* pCrumblingPegComponent;
+    SteppingGroundComponent* pSteppingGroundComponent;
+    SpringBoardComponent* pSpringBoardComponent;
+    ConveyorBeltComponent* pConveyorBeltComponent;
+    ClawControllableComponent* pClawControllableComponent;
+    MeleeAttackAIStateComponent* pMeleeAttackComponent;
+    DuckMeleeAttackAIStateComponent* pDuckMeleeAttackComponent;
+    RangedAttackAIStateComponent* pRangedAttackComponent;
+    DuckRangedAttackAIStateComponent* pDuckRangedAttackComponent;
+    DiveAttackAIStateComponent* pDiveAttackComponent;
+};
 
 class PhysicsContactListener : public b2ContactListener
 {
@@ -11,6 +57,13 @@ public:
 
     virtual void PreSolve(b2Contact* pContact, const b2Manifold* pOldManifold) override;
     virtual void PostSolve(b2Contact* pContact, const b2ContactImpulse* pImpulse) override;
+
+    // Cached until the actor is removed from physics or gets new component
+    const ContactComponents& GetContactComponents(Actor* pActor);
+    void OnActorRemoved(const Actor* pActor) { m_ContactComponentsCache.erase(pActor); }
+
+private:
+    std::unordered_map<const Actor*, ContactComponents> m_ContactComponentsCache;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,12 +1,20 @@
 #include "PhysicsDebugDrawer.h"
 #include "../SharedDefines.h"
 #include "../Scene/SceneNodes.h"
+#include "../Graphics2D/RenderCommands.h"
 
-#include <SDL2/SDL2_gfxPrimitives.h>
-
-// Conversion warnings from Box2D -> SDL2_gfx
+// Conversion warnings from Box2D -> SDL
 #pragma warning(disable: 4244)
 
+// Outlines are drawn through RenderCommands so that they can be recorded by the pipelined loop
+static const int CIRCLE_SEGMENT_COUNT = 32;
+
+static void SetDebugDrawColor(SDL_Renderer* pRenderer, const b2Color& color)
+{
+    RenderCommands::SetDrawBlendMode(pRenderer, color.a < 1.0f ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+    RenderCommands::SetDrawColor(pRenderer, color.r * 255, color.g * 255, color.b * 255, color.a * 255);
+}
+
 PhysicsDebugDrawer::PhysicsDebugDrawer()
 {
     SetFlags(b2Draw::e_shapeBit);
@@ -16,20 +24,26 @@ void PhysicsDebugDrawer::DrawPolygon(const b2Vec2* vertices, int32 vertexCount,
 {
     Point cameraPos = m_pCamera->GetPosition();
 
-    std::vector<int16> vaX;
-    std::vector<int16> vaY;
+    if (vertexCount < 2)
+    {
+        return;
+    }
+
+    std::vector<SDL_Point> points;
 
-    vaX.reserve(vertexCount);
-    vaY.reserve(vertexCount);
+    points.reserve(vertexCount + 1);
     for (int32 vertexIdx = 0; vertexIdx < vertexCount; vertexIdx++)
     {
         b2Vec2 worldPos = MetersToPixels(vertices[vertexIdx]);
 
-        vaX.push_back(worldPos.x - cameraPos.x);
-        vaY.push_back(worldPos.y - cameraPos.y);
+        SDL_Point point = { (int)(worldPos.x - cameraPos.x), (int)(worldPos.y - cameraPos.y) };
+        points.push_back(point);
     }
+    // Close the outline
+    points.push_back(points.front());
 
-    polygonRGBA(m_pRenderer, vaX.data(), vaY.data(), vertexCount, color.r * 255, color.g * 255, color.b * 255, color.a * 255);
+    SetDebugDrawColor(m_pRenderer, color);
+    RenderCommands::DrawLines(m_pRenderer, points.data(), points.size());
 }
 
 // This is ~20 times more cpu taxing than DrawPolygon
@@ -58,7 +72,16 @@ void PhysicsDebugDrawer::DrawCircle(const b2Vec2& center, float32 radius, const
     b2Vec2 worldPos = MetersToPixels(center);
     float worldRadius = MetersToPixels(radius);
 
-    circleRGBA(m_pRenderer, worldPos.x - cameraPos.x, worldPos.y - cameraPos.y, worldRadius, color.r * 255, color.g * 255, color.b * 255, color.a * 255);
+    SDL_Point points[CIRCLE_SEGMENT_COUNT + 1];
+    for (int segmentIdx = 0; segmentIdx <= CIRCLE_SEGMENT_COUNT; segmentIdx++)
+    {
+        float angle = (2.0f * b2_pi * segmentIdx) / CIRCLE_SEGMENT_COUNT;
+        points[segmentIdx].x = (int)(worldPos.x - cameraPos.x + worldRadius * cosf(angle));
+        points[segmentIdx].y = (int)(worldPos.y - cameraPos.y + worldRadius * sinf(angle));
+    }
+
+    SetDebugDrawColor(m_pRenderer, color);
+    RenderCommands::DrawLines(m_pRenderer, points, CIRCLE_SEGMENT_COUNT + 1);
 }
 
 void PhysicsDebugDrawer::DrawSolidCircle(const b2Vec2& center, float32 radius, const b2Vec2& axis, const b2Color& color)
@@ -78,9 +101,9 @@ void PhysicsDebugDrawer::DrawTransform(const b2Transform& xf)
 
 void PhysicsDebugDrawer::DrawPoint(const b2Vec2& p, float32 size, const b2Color& color)
 {
-    SDL_SetRenderDrawColor(m_pRenderer, color.r * 255, color.g, color.b * 255, color.a * 255);
+    SetDebugDrawColor(m_pRenderer, color);
 
-    SDL_RenderDrawPoint(m_pRenderer, p.x, p.y);
+    RenderCommands::DrawPoint(m_pRenderer, p.x, p.y);
 }
 
 void PhysicsDebugDrawer::PrepareForDraw(SDL_Renderer* pRenderer, std::shared_ptr<CameraNode> pCamera)
@@ -13,6 +13,7 @@ public:
     virtual void VOnUpdate(uint32 msDiff) override;
     virtual void VOnSuccess() override;
     virtual void VOnAbort() override;
+    virtual const char* VGetName() const override { return "PowerupProcess"; }
 
 protected:
     int32 m_MsTimeLeft;
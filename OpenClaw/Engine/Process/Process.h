@@ -5,12 +5,25 @@
 #include <stdint.h>
 #include <memory>
 
+#include "../Util/Memory/MemoryMacros.h"
+
 class Process;
 typedef std::shared_ptr<Process> StrongProcessPtr;
 typedef std::weak_ptr<Process> WeakProcessPtr;
 
+// Order in which ProcessMgr updates its buckets
+enum ProcessPriority
+{
+    ProcessPriority_Critical = 0,   // Never deferred
+    ProcessPriority_Normal,
+    ProcessPriority_Low,            // Deferred to the next frame when over budget
+    ProcessPriority_Max
+};
+
 class Process
 {
+    POOLED_ALLOCATION_DECLARATION()
+
 public:
     enum State
     {
@@ -57,6 +70,11 @@ public:
     virtual void VOnFail() { }
     virtual void VOnAbort() { }
 
+    // Scheduling, priority is read when the process is attached
+    virtual ProcessPriority VGetPriority() const { return ProcessPriority_Normal; }
+    // Processes with the same name share timing stats
+    virtual const char* VGetName() const { return "Process"; }
+
 private:
     State _state;
     StrongProcessPtr _pChild;
@@ -1,4 +1,35 @@
 #include "ProcessMgr.h"
+#include "../GameApp/Benchmark.h"
+
+#include <chrono>
+#include <stdio.h>
+
+// Low priority work (score rows, spawned images) gets 1 ms per frame by default
+const uint32_t DEFAULT_LOW_PRIORITY_BUDGET_US = 1000;
+
+static inline uint32_t ElapsedUs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+ProcessMgr::ProcessMgr()
+    :
+    _isUpdating(false),
+    _firstFreeSlot(UINT32_MAX),
+    _processCount(0)
+{
+    for (int priority = 0; priority < ProcessPriority_Max; priority++)
+    {
+        _buckets[priority].budgetUs = 0;
+        _buckets[priority].resumeIdx = 0;
+    }
+
+    // Budgets depend on speed of the machine, headless runs have to give the same result everywhere
+    if (!Benchmark::GetOptions().isHeadless)
+    {
+        _buckets[ProcessPriority_Low].budgetUs = DEFAULT_LOW_PRIORITY_BUDGET_US;
+    }
+}
 
 ProcessMgr::~ProcessMgr()
 {
@@ -10,98 +41,346 @@ uint32_t ProcessMgr::UpdateProcesses(uint32_t msDiff)
     uint16_t successCount = 0;
     uint16_t failCount = 0;
 
-    ProcessList::iterator processIter = _processList.begin();
-    while (processIter != _processList.end())
+    _isUpdating = true;
+    for (int priority = 0; priority < ProcessPriority_Max; priority++)
+    {
+        UpdateBucket(_buckets[priority], msDiff, successCount, failCount);
+    }
+    _isUpdating = false;
+
+    for (int priority = 0; priority < ProcessPriority_Max; priority++)
+    {
+        CompactBucket(_buckets[priority]);
+    }
+    MergePendingEntries();
+
+    return ((successCount << 16) | failCount);
+}
+
+void ProcessMgr::UpdateBucket(ProcessBucket& bucket, uint32_t msDiff, uint16_t& successCount, uint16_t& failCount)
+{
+    // Nothing can be added to the bucket while updating, so entries stay where they are
+    const uint32_t entryCount = bucket.entries.size();
+    if (entryCount == 0)
+    {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point bucketStart = std::chrono::steady_clock::now();
+    const uint32_t startIdx = bucket.resumeIdx < entryCount ? bucket.resumeIdx : 0;
+    bucket.resumeIdx = 0;
+
+    bool isOverBudget = false;
+    for (uint32_t i = 0; i < entryCount; i++)
     {
-        StrongProcessPtr currentProcess = (*processIter);
+        const uint32_t entryIdx = (startIdx + i) % entryCount;
+        ProcessEntry& entry = bucket.entries[entryIdx];
+        if (entry.isRemoved)
+        {
+            continue;
+        }
+
+        if (isOverBudget)
+        {
+            entry.deferredMs += msDiff;
+            entry.pStats->deferCount++;
+            continue;
+        }
+
+        Process* pProcess = entry.pProcess;
+        const uint32_t processMsDiff = msDiff + entry.deferredMs;
+        entry.deferredMs = 0;
+
+        const std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+
+        if (pProcess->GetState() == Process::UNITIALIZED)
+        {
+            pProcess->VOnInit();
+        }
 
-        // Save the iterator and increment the old one in case we need to remove this process from the list
-        ProcessList::iterator currentIter = processIter;
-        ++processIter;
+        if (pProcess->GetState() == Process::RUNNING)
+        {
+            pProcess->VOnUpdate(processMsDiff);
+        }
 
-        if (currentProcess->GetState() == Process::UNITIALIZED)
+        const std::chrono::steady_clock::time_point updateEnd = std::chrono::steady_clock::now();
+
+        const uint32_t updateUs = ElapsedUs(updateStart, updateEnd);
+        entry.pStats->updateCount++;
+        entry.pStats->totalUpdateUs += updateUs;
+        if (updateUs > entry.pStats->maxUpdateUs)
         {
-            currentProcess->VOnInit();
+            entry.pStats->maxUpdateUs = updateUs;
         }
 
-        if (currentProcess->GetState() == Process::RUNNING)
+        // Process could have been aborted by something it triggered
+        if (!entry.isRemoved && pProcess->IsDead())
         {
-            currentProcess->VOnUpdate(msDiff);
+            FinishProcess(entry, successCount, failCount);
         }
 
-        if (currentProcess->IsDead())
+        if (bucket.budgetUs != 0 && ElapsedUs(bucketStart, updateEnd) >= bucket.budgetUs)
+        {
+            isOverBudget = true;
+            bucket.resumeIdx = (entryIdx + 1) % entryCount;
+        }
+    }
+}
+
+void ProcessMgr::FinishProcess(ProcessEntry& entry, uint16_t& successCount, uint16_t& failCount)
+{
+    Process* pProcess = entry.pProcess;
+
+    // Run appropriate exit function
+    switch (pProcess->GetState())
+    {
+        case Process::SUCCEEDED:
         {
-            // Run appropriate exit function
-            switch (currentProcess->GetState())
+            pProcess->VOnSuccess();
+            StrongProcessPtr child = pProcess->RemoveChild();
+            if (child)
+            {
+                AttachProcess(child);
+            }
+            else
             {
-                case Process::SUCCEEDED:
-                {
-                    currentProcess->VOnSuccess();
-                    StrongProcessPtr child = currentProcess->RemoveChild();
-                    if (child)
-                    {
-                        AttachProcess(child);
-                    }
-                    else
-                    {
-                        ++successCount;
-                    }
-                    break;
-                }
-                case Process::FAILED:
-                {
-                    currentProcess->VOnFail();
-                    ++failCount;
-                    break;
-                }
-                case Process::ABORTED:
-                {
-                    currentProcess->VOnAbort();
-                    ++failCount;
-                    break;
-                }
-                default:
-                {
-                    break;
-                }
+                ++successCount;
             }
+            break;
+        }
+        case Process::FAILED:
+        {
+            pProcess->VOnFail();
+            ++failCount;
+            break;
+        }
+        case Process::ABORTED:
+        {
+            pProcess->VOnAbort();
+            ++failCount;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    // Process is destroyed when its slot is freed during compaction
+    entry.isRemoved = true;
+}
+
+void ProcessMgr::CompactBucket(ProcessBucket& bucket)
+{
+    uint32_t resumeIdx = 0;
+    uint32_t writeIdx = 0;
+    for (uint32_t readIdx = 0; readIdx < bucket.entries.size(); readIdx++)
+    {
+        if (readIdx == bucket.resumeIdx)
+        {
+            resumeIdx = writeIdx;
+        }
 
-            // Remove the process and destroy it
-            _processList.erase(currentIter);
+        ProcessEntry& entry = bucket.entries[readIdx];
+        if (entry.isRemoved)
+        {
+            FreeSlot(entry.slotIdx);
+            continue;
         }
+
+        if (writeIdx != readIdx)
+        {
+            bucket.entries[writeIdx] = entry;
+        }
+        writeIdx++;
     }
 
-    return ((successCount << 16) | failCount);
+    bucket.entries.resize(writeIdx);
+    bucket.resumeIdx = resumeIdx;
+}
+
+void ProcessMgr::MergePendingEntries()
+{
+    for (const ProcessEntry& entry : _pendingEntries)
+    {
+        if (entry.isRemoved)
+        {
+            FreeSlot(entry.slotIdx);
+            continue;
+        }
+
+        ProcessPriority priority = entry.pProcess->VGetPriority();
+        assert(priority >= 0 && priority < ProcessPriority_Max);
+
+        _buckets[priority].entries.push_back(entry);
+    }
+
+    _pendingEntries.clear();
+}
+
+ProcessHandle ProcessMgr::AttachProcess(StrongProcessPtr process)
+{
+    assert(process != nullptr);
+
+    ProcessEntry entry;
+    entry.pProcess = process.get();
+    entry.pStats = &_typeStats[process->VGetName()];
+    entry.slotIdx = AllocateSlot(process);
+    entry.deferredMs = 0;
+    entry.isRemoved = false;
+
+    if (_isUpdating)
+    {
+        _pendingEntries.push_back(entry);
+    }
+    else
+    {
+        ProcessPriority priority = process->VGetPriority();
+        assert(priority >= 0 && priority < ProcessPriority_Max);
+
+        _buckets[priority].entries.push_back(entry);
+    }
+
+    ProcessHandle handle;
+    handle.slotIdx = entry.slotIdx;
+    handle.generation = _slots[entry.slotIdx].generation;
+
+    return handle;
+}
+
+StrongProcessPtr ProcessMgr::GetProcess(ProcessHandle handle) const
+{
+    if (handle.slotIdx >= _slots.size() || _slots[handle.slotIdx].generation != handle.generation)
+    {
+        return nullptr;
+    }
+
+    return _slots[handle.slotIdx].pProcess;
+}
+
+uint32_t ProcessMgr::AllocateSlot(StrongProcessPtr process)
+{
+    uint32_t slotIdx = _firstFreeSlot;
+    if (slotIdx != UINT32_MAX)
+    {
+        _firstFreeSlot = _slots[slotIdx].nextFreeSlot;
+    }
+    else
+    {
+        slotIdx = _slots.size();
+        Slot newSlot;
+        newSlot.generation = 0;
+        newSlot.nextFreeSlot = UINT32_MAX;
+        _slots.push_back(newSlot);
+    }
+
+    _slots[slotIdx].pProcess = process;
+    _processCount++;
+
+    return slotIdx;
+}
+
+void ProcessMgr::FreeSlot(uint32_t slotIdx)
+{
+    Slot& slot = _slots[slotIdx];
+    slot.pProcess.reset();
+    slot.generation++;
+    slot.nextFreeSlot = _firstFreeSlot;
+    _firstFreeSlot = slotIdx;
+    _processCount--;
 }
 
-WeakProcessPtr ProcessMgr::AttachProcess(StrongProcessPtr process)
+void ProcessMgr::SetBucketBudget(ProcessPriority priority, uint32_t budgetUs)
 {
-    _processList.push_front(process);
-    return WeakProcessPtr(process);
+    // Critical processes always run
+    assert(priority > ProcessPriority_Critical && priority < ProcessPriority_Max);
+    if (priority <= ProcessPriority_Critical || priority >= ProcessPriority_Max ||
+        Benchmark::GetOptions().isHeadless)
+    {
+        return;
+    }
+
+    _buckets[priority].budgetUs = budgetUs;
 }
 
 void ProcessMgr::ClearAllProcesses()
 {
-    _processList.clear();
+    for (int priority = 0; priority < ProcessPriority_Max; priority++)
+    {
+        _buckets[priority].entries.clear();
+        _buckets[priority].resumeIdx = 0;
+    }
+    _pendingEntries.clear();
+
+    _slots.clear();
+    _firstFreeSlot = UINT32_MAX;
+    _processCount = 0;
+}
+
+void ProcessMgr::AbortEntry(ProcessEntry& entry, bool immediate)
+{
+    if (entry.isRemoved || !entry.pProcess->IsAlive())
+    {
+        return;
+    }
+
+    entry.pProcess->SetState(Process::ABORTED);
+    if (immediate)
+    {
+        entry.pProcess->VOnAbort();
+        entry.isRemoved = true;
+    }
 }
 
 void ProcessMgr::AbortAllProcesses(bool immediate)
 {
-    ProcessList::iterator processIter = _processList.begin();
-    while (processIter != _processList.end())
+    for (int priority = 0; priority < ProcessPriority_Max; priority++)
+    {
+        for (ProcessEntry& entry : _buckets[priority].entries)
+        {
+            AbortEntry(entry, immediate);
+        }
+    }
+
+    for (ProcessEntry& entry : _pendingEntries)
     {
-        ProcessList::iterator currentIter = processIter;
-        ++processIter;
+        AbortEntry(entry, immediate);
+    }
 
-        StrongProcessPtr currentProcess = (*currentIter);
-        if (currentProcess->IsAlive())
+    // When updating, removed processes are compacted out once the update is done
+    if (immediate && !_isUpdating)
+    {
+        for (int priority = 0; priority < ProcessPriority_Max; priority++)
         {
-            currentProcess->SetState(Process::ABORTED);
-            if (immediate)
-            {
-                currentProcess->VOnAbort();
-                _processList.erase(currentIter);
-            }
+            CompactBucket(_buckets[priority]);
         }
     }
 }
+
+void ProcessMgr::ResetProcessTypeStats()
+{
+    for (auto& statsPair : _typeStats)
+    {
+        statsPair.second = ProcessTypeStats();
+    }
+}
+
+void ProcessMgr::DumpProcessTypeStats(std::vector<std::string>& outLines) const
+{
+    char line[256];
+    snprintf(line, sizeof(line), "%-28s %10s %8s %12s %8s %8s", "process", "updates", "defers", "total us", "avg us", "max us");
+    outLines.push_back(line);
+
+    for (const auto& statsPair : _typeStats)
+    {
+        const ProcessTypeStats& stats = statsPair.second;
+        snprintf(line, sizeof(line), "%-28s %10u %8u %12llu %8u %8u",
+            statsPair.first.c_str(),
+            stats.updateCount,
+            stats.deferCount,
+            (unsigned long long)stats.totalUpdateUs,
+            stats.updateCount > 0 ? (uint32_t)(stats.totalUpdateUs / stats.updateCount) : 0,
+            stats.maxUpdateUs);
+        outLines.push_back(line);
+    }
+}
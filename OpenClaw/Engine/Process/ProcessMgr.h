@@ -2,30 +2,132 @@
 #define ENGINE_PROCESSMGR_H_
 
 #include <memory>
-#include <list>
+#include <vector>
+#include <map>
+#include <string>
 #include <stdint.h>
 
 #include "Process.h"
 
-typedef std::list<StrongProcessPtr> ProcessList;
+//-----------------------------------------------------------------------------
+// ProcessMgr
+//
+// Processes are kept in contiguous arrays, one per priority, and updated from
+// the most important bucket to the least important one. Each bucket can have
+// time budget - once it is spent, remaining processes of the bucket are
+// deferred to the next frame and get the skipped time added to their next
+// msDiff. At least one process of each bucket is updated every frame and the
+// deferred ones are updated first in the next frame.
+//
+// Processes attached during update (including child processes) start running
+// in the next frame. Removed processes are compacted out at the end of the
+// update so the update order of the remaining ones does not change.
+//-----------------------------------------------------------------------------
+
+struct ProcessHandle
+{
+    ProcessHandle()
+    {
+        slotIdx = UINT32_MAX;
+        generation = 0;
+    }
+
+    bool IsValid() const { return slotIdx != UINT32_MAX; }
+
+    uint32_t slotIdx;
+    uint32_t generation;
+};
+
+// Accumulated over all processes with the same VGetName()
+struct ProcessTypeStats
+{
+    ProcessTypeStats()
+    {
+        updateCount = 0;
+        deferCount = 0;
+        totalUpdateUs = 0;
+        maxUpdateUs = 0;
+    }
+
+    uint32_t updateCount;
+    uint32_t deferCount;
+    uint64_t totalUpdateUs;
+    uint32_t maxUpdateUs;
+};
+
+typedef std::map<std::string, ProcessTypeStats> ProcessTypeStatsMap;
 
 class ProcessMgr
 {
 public:
-    ProcessMgr() { }
+    ProcessMgr();
     ~ProcessMgr();
 
     // Interface
     uint32_t UpdateProcesses(uint32_t msDiff);
-    WeakProcessPtr AttachProcess(StrongProcessPtr process);
+    ProcessHandle AttachProcess(StrongProcessPtr process);
     void AbortAllProcesses(bool immediate);
 
-    uint32_t GetProcessCount() const { return _processList.size(); }
+    // NULL for stale handles
+    StrongProcessPtr GetProcess(ProcessHandle handle) const;
+    uint32_t GetProcessCount() const { return _processCount; }
+
+    // Budget in microseconds, 0 means unlimited. Critical bucket has no budget. Headless runs have no budgets, so they
+    // do not depend on speed of the machine
+    void SetBucketBudget(ProcessPriority priority, uint32_t budgetUs);
+    uint32_t GetBucketBudget(ProcessPriority priority) const { return _buckets[priority].budgetUs; }
+
+    const ProcessTypeStatsMap& GetProcessTypeStats() const { return _typeStats; }
+    void ResetProcessTypeStats();
+    void DumpProcessTypeStats(std::vector<std::string>& outLines) const;
 
 private:
+    struct ProcessEntry
+    {
+        Process* pProcess;
+        ProcessTypeStats* pStats;
+        uint32_t slotIdx;
+        uint32_t deferredMs;
+        bool isRemoved;
+    };
+
+    struct ProcessBucket
+    {
+        std::vector<ProcessEntry> entries;
+        uint32_t budgetUs;
+        // Where to continue next frame if some processes were deferred
+        uint32_t resumeIdx;
+    };
+
+    struct Slot
+    {
+        // Slot owns the process, entries only point to it
+        StrongProcessPtr pProcess;
+        uint32_t generation;
+        uint32_t nextFreeSlot;
+    };
+
+    void UpdateBucket(ProcessBucket& bucket, uint32_t msDiff, uint16_t& successCount, uint16_t& failCount);
+    void FinishProcess(ProcessEntry& entry, uint16_t& successCount, uint16_t& failCount);
+    void AbortEntry(ProcessEntry& entry, bool immediate);
+    void CompactBucket(ProcessBucket& bucket);
+    void MergePendingEntries();
+
+    uint32_t AllocateSlot(StrongProcessPtr process);
+    void FreeSlot(uint32_t slotIdx);
+
     void ClearAllProcesses();
 
-    ProcessList _processList;
+    ProcessBucket _buckets[ProcessPriority_Max];
+    // Processes attached while updating
+    std::vector<ProcessEntry> _pendingEntries;
+    bool _isUpdating;
+
+    std::vector<Slot> _slots;
+    uint32_t _firstFreeSlot;
+    uint32_t _processCount;
+
+    ProcessTypeStatsMap _typeStats;
 };
 
-#endif
\ No newline at end of file
+#endif
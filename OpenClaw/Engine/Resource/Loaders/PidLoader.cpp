@@ -29,6 +29,12 @@ void PidResourceExtraData::LoadPid(char* rawBuffer, uint32 size, WapPal* palette
 
 void PidResourceExtraData::LoadImage(char* rawBuffer, uint32 size, WapPal* palette, const char* resourceString)
 {
+    // Indexed images keep palette indices and upload their texture when it is first rendered
+    if (_pid == NULL && palette != NULL && g_pApp->GetGameConfig()->useIndexedSprites)
+    {
+        _pid = WAP_PidLoadIndexedFromData(rawBuffer, size, palette);
+        OnPidLoaded(resourceString, _pid);
+    }
     if (_pid == NULL)
     {
         LoadPid(rawBuffer, size, palette, resourceString);
@@ -36,7 +42,14 @@ void PidResourceExtraData::LoadImage(char* rawBuffer, uint32 size, WapPal* palet
     if (_image == NULL)
     {
         SDL_Renderer* renderer = g_pApp->GetRenderer();
-        _image = shared_ptr<Image>(Image::CreateImage(_pid, renderer));
+        if (_pid != NULL && _pid->colorIndices != NULL)
+        {
+            _image = shared_ptr<Image>(Image::CreateIndexedImage(_pid, palette, renderer));
+        }
+        else
+        {
+            _image = shared_ptr<Image>(Image::CreateImage(_pid, renderer));
+        }
         WAP_PidDestroy(_pid); _pid = NULL;
         //SAFE_DELETE_ARRAY(rawBuffer);
     }
@@ -16,6 +16,28 @@ Resource::Resource(const std::string& name)
     std::transform(_name.begin(), _name.end(), _name.begin(), (int(*)(int)) std::tolower);
 }
 
+//=================================================================================================
+// class IResourceFile
+//
+
+bool IResourceFile::VGetRawResourceChecksum(Resource* r, uint64& outChecksum)
+{
+    int32 rawSize = VGetRawResourceSize(r);
+    if (rawSize < 0)
+    {
+        return false;
+    }
+
+    std::vector<char> rawData(rawSize + 1);
+    if (VGetRawResource(r, rawData.data()) < 0)
+    {
+        return false;
+    }
+
+    outChecksum = Util::CalcFNV1a64(rawData.data(), rawSize);
+    return true;
+}
+
 //=================================================================================================
 // class ResourceRezArchive
 //
@@ -191,25 +213,37 @@ std::string ResourceZipArchive::VGetResourceName(int num) const
 
 std::vector<std::string> ResourceZipArchive::GetAllFilesInDirectory(const char* directoryPath)
 {
-    std::vector<std::string> filesInDirectory;
+    return m_pZipFile->GetAllFilesInDirectory(directoryPath);
+}
 
-    std::string dirPath = directoryPath;
-    // Our directories beging and end with "/"
-    if (dirPath.size() > 0 && dirPath[0] != '/')
+void ResourceZipArchive::VGetRawResources(std::vector<RawResourceRequest>& requests)
+{
+    std::vector<ZipReadRequest> zipRequests(requests.size());
+    for (uint32 requestIdx = 0; requestIdx < requests.size(); requestIdx++)
     {
-        dirPath.insert(0, "/");
+        zipRequests[requestIdx].fileIdx = m_pZipFile->Find(requests[requestIdx].pResource->GetName());
+        zipRequests[requestIdx].pBuf = requests[requestIdx].pBuffer;
     }
-    if (dirPath.back() != '/')
+
+    m_pZipFile->ReadFiles(zipRequests);
+
+    for (uint32 requestIdx = 0; requestIdx < requests.size(); requestIdx++)
     {
-        dirPath += "/";
+        requests[requestIdx].success = zipRequests[requestIdx].success;
     }
-    auto findIt = m_pZipFile->m_DirToFileListMap.find(dirPath);
-    if (findIt != m_pZipFile->m_DirToFileListMap.end())
+}
+
+bool ResourceZipArchive::VGetRawResourceChecksum(Resource* r, uint64& outChecksum)
+{
+    int resourceNum = m_pZipFile->Find(r->GetName());
+    if (resourceNum == -1)
     {
-        filesInDirectory.insert(filesInDirectory.end(), findIt->second.begin(), findIt->second.end());
+        return false;
     }
 
-    return filesInDirectory;
+    // Size is mixed in since CRC-32 alone is rather weak
+    outChecksum = ((uint64)m_pZipFile->GetFileLen(resourceNum) << 32) | m_pZipFile->GetFileCrc(resourceNum);
+    return true;
 }
 
 //=================================================================================================
@@ -286,9 +320,29 @@ std::shared_ptr<ResourceHandle> ResourceCache::GetHandle(Resource* r)
 
 std::shared_ptr<ResourceHandle> ResourceCache::Load(Resource* r)
 {
+    TRACK_ALLOCATIONS(AllocTag_Resources);
+
     std::shared_ptr<IResourceLoader> loader;
-    std::shared_ptr<ResourceHandle> handle;
+    int32 rawSize = 0;
+    char* rawBuffer = AllocateRawBuffer(r, loader, rawSize);
+    if (rawBuffer == NULL)
+    {
+        return nullptr;
+    }
 
+    if (_resourceFile->VGetRawResource(r, rawBuffer) < 0)
+    {
+        LOG_ERROR("Could not retrieve data buffer from resource: " + r->GetName() + 
+            " in resource file: " + _resourceFile->VGetName());
+        FreeRawBuffer(loader, rawBuffer, rawSize);
+        return nullptr;
+    }
+
+    return LoadFromRawBuffer(r, loader, rawBuffer, rawSize);
+}
+
+char* ResourceCache::AllocateRawBuffer(Resource* r, std::shared_ptr<IResourceLoader>& loader, int32& rawSize)
+{
     for (auto resourceLoader : _resourceLoaderList)
     {
         std::shared_ptr<IResourceLoader> testLoader = resourceLoader;
@@ -303,14 +357,14 @@ std::shared_ptr<ResourceHandle> ResourceCache::Load(Resource* r)
     if (!loader)
     {
         LOG_ERROR("Default resource loader for resource: " + r->GetName() + " not found");
-        return nullptr;
+        return NULL;
     }
 
-    int32 rawSize = _resourceFile->VGetRawResourceSize(r);
+    rawSize = _resourceFile->VGetRawResourceSize(r);
     if (rawSize < 0)
     {
         LOG_ERROR("Resource size return -1 => Resource not found. Resource: " + r->GetName());
-        return nullptr;
+        return NULL;
     }
 
     int32 allocSize = rawSize + ((loader->VAddNullZero()) ? (1) : (0));
@@ -319,17 +373,26 @@ std::shared_ptr<ResourceHandle> ResourceCache::Load(Resource* r)
     {
         LOG_ERROR("Could not allocate enough memory for resource: " + r->GetName() + 
             " in resource file: " + _resourceFile->VGetName());
-        return nullptr;
+        return NULL;
     }
     memset(rawBuffer, 0, allocSize);
 
-    if (_resourceFile->VGetRawResource(r, rawBuffer) < 0)
+    return rawBuffer;
+}
+
+void ResourceCache::FreeRawBuffer(std::shared_ptr<IResourceLoader> loader, char* rawBuffer, int32 rawSize)
+{
+    // Raw file buffers were allocated from the cache budget
+    if (loader->VUseRawFile())
     {
-        LOG_ERROR("Could not retrieve data buffer from resource: " + r->GetName() + 
-            " in resource file: " + _resourceFile->VGetName());
-        return nullptr;
+        MemoryHasBeenFreed(rawSize + ((loader->VAddNullZero()) ? (1) : (0)));
     }
+    SAFE_DELETE_ARRAY(rawBuffer);
+}
 
+std::shared_ptr<ResourceHandle> ResourceCache::LoadFromRawBuffer(Resource* r, std::shared_ptr<IResourceLoader> loader, char* rawBuffer, int32 rawSize)
+{
+    std::shared_ptr<ResourceHandle> handle;
     char* buffer = NULL;
     uint32 size = 0;
 
@@ -347,6 +410,7 @@ std::shared_ptr<ResourceHandle> ResourceCache::Load(Resource* r)
         {
             LOG_ERROR("Could not allocate enough memory for resource: " + r->GetName() +
                 " in resource file: " + _resourceFile->VGetName());
+            FreeRawBuffer(loader, rawBuffer, rawSize);
             return shared_ptr<ResourceHandle>();
         }
          
@@ -508,6 +572,11 @@ int32 ResourceCache::Preload(const std::string pattern, void(*progressCallback)(
     std::string patternCopy = pattern;
     std::transform(patternCopy.begin(), patternCopy.end(), patternCopy.begin(), (int(*)(int)) std::tolower);
 
+    // Bounds raw buffers which are alive at once
+    const uint32 PRELOAD_BATCH_SIZE = 64;
+    std::vector<Resource> batch;
+    batch.reserve(PRELOAD_BATCH_SIZE);
+
     for (int32 fileIdx = 0; fileIdx < numFiles; ++fileIdx)
     {
         Resource resource(_resourceFile->VGetResourceName(fileIdx));
@@ -515,8 +584,21 @@ int32 ResourceCache::Preload(const std::string pattern, void(*progressCallback)(
 
         if (WildcardMatch(patternCopy.c_str(), resource.GetName().c_str()))
         {
-            // This loads unloaded resource and skips loaded ones
-            GetHandle(&resource);
+            // Loaded resources are skipped, unloaded ones are loaded in batches
+            auto findIt = _resourceMap.find(resource.GetName());
+            if (findIt != _resourceMap.end() && findIt->second)
+            {
+                Update(findIt->second);
+            }
+            else
+            {
+                batch.push_back(resource);
+                if (batch.size() == PRELOAD_BATCH_SIZE)
+                {
+                    PreloadBatch(batch);
+                    batch.clear();
+                }
+            }
             ++loaded;
         }
 
@@ -526,10 +608,73 @@ int32 ResourceCache::Preload(const std::string pattern, void(*progressCallback)(
         }
     }
 
+    PreloadBatch(batch);
+
     return loaded;
 }
 
+void ResourceCache::PreloadBatch(std::vector<Resource>& resources)
+{
+    TRACK_ALLOCATIONS(AllocTag_Resources);
+
+    std::vector<RawResourceRequest> requests;
+    std::vector<std::shared_ptr<IResourceLoader>> loaders;
+    std::vector<int32> rawSizes;
+    requests.reserve(resources.size());
+    loaders.reserve(resources.size());
+    rawSizes.reserve(resources.size());
+
+    for (Resource& resource : resources)
+    {
+        std::shared_ptr<IResourceLoader> loader;
+        int32 rawSize = 0;
+        char* rawBuffer = AllocateRawBuffer(&resource, loader, rawSize);
+        if (rawBuffer == NULL)
+        {
+            continue;
+        }
+
+        RawResourceRequest request = { &resource, rawBuffer, false };
+        requests.push_back(request);
+        loaders.push_back(loader);
+        rawSizes.push_back(rawSize);
+    }
+
+    if (requests.empty())
+    {
+        return;
+    }
+
+    _resourceFile->VGetRawResources(requests);
+
+    // Loaders are not thread safe, raw data are processed here
+    for (uint32 requestIdx = 0; requestIdx < requests.size(); requestIdx++)
+    {
+        const RawResourceRequest& request = requests[requestIdx];
+        if (!request.success)
+        {
+            LOG_ERROR("Could not retrieve data buffer from resource: " + request.pResource->GetName() +
+                " in resource file: " + _resourceFile->VGetName());
+            FreeRawBuffer(loaders[requestIdx], request.pBuffer, rawSizes[requestIdx]);
+            continue;
+        }
+
+        LoadFromRawBuffer(request.pResource, loaders[requestIdx], request.pBuffer, rawSizes[requestIdx]);
+    }
+}
+
 std::vector<std::string> ResourceCache::GetAllFilesInDirectory(const char* directoryPath)
 {
     return _resourceFile->GetAllFilesInDirectory(directoryPath);
+}
+
+bool ResourceCache::GetRawResourceChecksum(const std::string& resourceName, uint64& outChecksum)
+{
+    if (_resourceFile == NULL)
+    {
+        return false;
+    }
+
+    Resource resource(resourceName);
+    return _resourceFile->VGetRawResourceChecksum(&resource, outChecksum);
 }
\ No newline at end of file
@@ -59,6 +59,14 @@ protected:
     T* _extraData;
 };*/
 
+// Raw data of resource read in bulk, buffer has to be at least VGetRawResourceSize large
+struct RawResourceRequest
+{
+    Resource* pResource;
+    char* pBuffer;
+    bool success;
+};
+
 class IResourceFile
 {
 public:
@@ -70,6 +78,17 @@ public:
     virtual std::string VGetResourceName(int32 num) const = 0;
     virtual bool VIsUsingDevelopmentDIrectories() const = 0;
     virtual std::vector<std::string> GetAllFilesInDirectory(const char* directoryPath) = 0;
+    // Reads raw data of many resources at once, files which can extract in parallel override it
+    virtual void VGetRawResources(std::vector<RawResourceRequest>& requests)
+    {
+        for (RawResourceRequest& request : requests)
+        {
+            request.success = VGetRawResource(request.pResource, request.pBuffer) >= 0;
+        }
+    }
+    // Checksum of raw data which changes whenever the data does. Default one hashes the data, archives which
+    // store checksums of their files override it
+    virtual bool VGetRawResourceChecksum(Resource* r, uint64& outChecksum);
     virtual ~IResourceFile() { }
 };
 
@@ -122,6 +141,8 @@ public:
     virtual std::string VGetResourceName(int num) const;
     virtual bool VIsUsingDevelopmentDIrectories() const { return false; }
     virtual std::vector<std::string> GetAllFilesInDirectory(const char* directoryPath);
+    virtual void VGetRawResources(std::vector<RawResourceRequest>& requests);
+    virtual bool VGetRawResourceChecksum(Resource* r, uint64& outChecksum);
 
 private:
     ZipFile *m_pZipFile;
@@ -176,6 +197,8 @@ public:
     int32 Preload(const std::string pattern, void(*progressCallback)(int32, bool &));
     std::vector<std::string> Match(const std::string pattern);
     std::vector<std::string> GetAllFilesInDirectory(const char* directoryPath);
+    // Reads straight from the resource file, the resource is not loaded to the cache
+    bool GetRawResourceChecksum(const std::string& resourceName, uint64& outChecksum);
 
     void Flush();
 
@@ -189,6 +212,13 @@ protected:
     void Free(std::shared_ptr<ResourceHandle> gonner);
 
     std::shared_ptr<ResourceHandle> Load(Resource* r);
+    // Finds loader of the resource and allocates buffer for its raw data, NULL if it can not be loaded
+    char* AllocateRawBuffer(Resource* r, std::shared_ptr<IResourceLoader>& loader, int32& rawSize);
+    // Frees buffer from AllocateRawBuffer which did not make it to a resource handle
+    void FreeRawBuffer(std::shared_ptr<IResourceLoader> loader, char* rawBuffer, int32 rawSize);
+    std::shared_ptr<ResourceHandle> LoadFromRawBuffer(Resource* r, std::shared_ptr<IResourceLoader> loader, char* rawBuffer, int32 rawSize);
+    // Raw data of all resources are read at once so that archive can extract them in parallel
+    void PreloadBatch(std::vector<Resource>& resources);
     std::shared_ptr<ResourceHandle> Find(Resource* r);
     void Update(std::shared_ptr<ResourceHandle> handle);
 
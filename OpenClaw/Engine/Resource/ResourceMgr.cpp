@@ -129,6 +129,31 @@ std::vector<std::string> ResourceMgrImpl::VGetAllFilesInDirectory(const char* di
     return allFiles;
 }
 
+bool ResourceMgrImpl::VGetRawResourceChecksum(const std::string& resourceName, uint64& outChecksum, const std::string& resCacheName)
+{
+    assert(!m_ResourceCacheList.empty());
+
+    if (!resCacheName.empty())
+    {
+        std::shared_ptr<ResourceCache> pResCache = VGetResourceCacheFromName(resCacheName);
+        assert(pResCache != NULL);
+
+        return pResCache->GetRawResourceChecksum(resourceName, outChecksum);
+    }
+    else // First res cache which has the resource
+    {
+        for (auto &pResCache : m_ResourceCacheList)
+        {
+            if (pResCache->GetRawResourceChecksum(resourceName, outChecksum))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 void ResourceMgrImpl::VFlush(const std::string& resCacheName)
 {
     assert(!m_ResourceCacheList.empty());
@@ -17,6 +17,7 @@ public:
     virtual int32 VPreload(const std::string pattern, void(*progressCallback)(int32, bool &), const std::string& resCacheName = "") = 0;
     virtual std::vector<std::string> VMatch(const std::string pattern, const std::string& resCacheName = "") = 0;
     virtual std::vector<std::string> VGetAllFilesInDirectory(const char* directoryPath, const std::string& resCacheName = "") = 0;
+    virtual bool VGetRawResourceChecksum(const std::string& resourceName, uint64& outChecksum, const std::string& resCacheName = "") = 0;
     virtual void VFlush(const std::string& resCacheName = "") = 0;
     virtual bool VHasResourceCache(const std::string& resCacheName) = 0;
 };
@@ -33,6 +34,7 @@ public:
     virtual int32 VPreload(const std::string pattern, void(*progressCallback)(int32, bool &), const std::string& resCacheName = "");
     virtual std::vector<std::string> VMatch(const std::string pattern, const std::string& resCacheName = "");
     virtual std::vector<std::string> VGetAllFilesInDirectory(const char* directoryPath, const std::string& resCacheName = "");
+    virtual bool VGetRawResourceChecksum(const std::string& resourceName, uint64& outChecksum, const std::string& resCacheName = "");
     virtual void VFlush(const std::string& resCacheName = "");
     virtual bool VHasResourceCache(const std::string& resCacheName);
 
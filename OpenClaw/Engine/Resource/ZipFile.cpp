@@ -22,12 +22,24 @@
 
 #include <cctype>            // for std::tolower
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
 #include "ZipFile.h"
 
 #include "Miniz.h"
 #include <string.h>
 
+#ifdef _WIN32
+#include <Windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 // Windows...
 #ifndef _MAX_PATH
 #define _MAX_PATH 260
@@ -113,6 +125,108 @@ struct ZipFile::TZipDirFileHeader
 
 #pragma pack()
 
+// Maximal number of threads used by ReadFiles, including the calling thread
+const uint32 MAX_INFLATE_THREADS = 8;
+
+// --------------------------------------------------------------------------
+// class ZipFile::InflateWorkerPool
+//
+// Threads waiting for jobs. Run() hands the same job to all workers, runs it
+// on the calling thread too and returns when every one of them finished it.
+// --------------------------------------------------------------------------
+class ZipFile::InflateWorkerPool
+{
+public:
+    explicit InflateWorkerPool(uint32 numWorkers);
+    ~InflateWorkerPool();
+
+    void Run(const std::function<void()>& job);
+
+private:
+    void WorkerMain();
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_JobCondition;
+    std::condition_variable m_DoneCondition;
+    const std::function<void()>* m_pJob;
+    uint64 m_JobNumber;
+    uint32 m_NumBusyWorkers;
+    bool m_IsStopping;
+};
+
+ZipFile::InflateWorkerPool::InflateWorkerPool(uint32 numWorkers)
+    :
+    m_pJob(NULL),
+    m_JobNumber(0),
+    m_NumBusyWorkers(0),
+    m_IsStopping(false)
+{
+    m_Workers.reserve(numWorkers);
+    for (uint32 workerIdx = 0; workerIdx < numWorkers; workerIdx++)
+    {
+        m_Workers.push_back(std::thread(&InflateWorkerPool::WorkerMain, this));
+    }
+}
+
+ZipFile::InflateWorkerPool::~InflateWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_IsStopping = true;
+    }
+    m_JobCondition.notify_all();
+
+    for (std::thread& worker : m_Workers)
+    {
+        worker.join();
+    }
+}
+
+void ZipFile::InflateWorkerPool::Run(const std::function<void()>& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_pJob = &job;
+        m_JobNumber++;
+        m_NumBusyWorkers = (uint32)m_Workers.size();
+    }
+    m_JobCondition.notify_all();
+
+    job();
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_DoneCondition.wait(lock, [this]() { return m_NumBusyWorkers == 0; });
+    m_pJob = NULL;
+}
+
+void ZipFile::InflateWorkerPool::WorkerMain()
+{
+    uint64 lastJobNumber = 0;
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;)
+    {
+        m_JobCondition.wait(lock, [this, lastJobNumber]() { return m_IsStopping || m_JobNumber != lastJobNumber; });
+        if (m_IsStopping)
+        {
+            return;
+        }
+
+        lastJobNumber = m_JobNumber;
+        const std::function<void()>* pJob = m_pJob;
+
+        lock.unlock();
+        (*pJob)();
+        lock.lock();
+
+        if (--m_NumBusyWorkers == 0)
+        {
+            m_DoneCondition.notify_one();
+        }
+    }
+}
+
 static bool IsZipDir(const std::string& node)
 {
     return node.back() == '/';
@@ -129,6 +243,35 @@ static char* string_to_lowercase(char* s)
     return s;
 }
 
+// Lower case path with leading "/", directories also end with "/"
+static std::string NormalizePath(const std::string& path, bool isDirectory)
+{
+    std::string normalizedPath = path;
+    std::transform(normalizedPath.begin(), normalizedPath.end(), normalizedPath.begin(), (int(*)(int)) std::tolower);
+    if (normalizedPath.empty() || normalizedPath[0] != '/')
+    {
+        normalizedPath.insert(0, "/");
+    }
+    if (isDirectory && normalizedPath.back() != '/')
+    {
+        normalizedPath += '/';
+    }
+
+    return normalizedPath;
+}
+
+// "/a/b/file" -> "/a/b/", "/a/b/" -> "/a/", "/" -> ""
+static std::string GetParentDirectory(const std::string& path)
+{
+    if (path.size() <= 1)
+    {
+        return "";
+    }
+
+    size_t pos = path.rfind('/', path.size() - 2);
+    return path.substr(0, pos + 1);
+}
+
 // --------------------------------------------------------------------------
 // Function:      Init
 // Purpose:       Initialize the object and read the zip file directory.
@@ -149,22 +292,19 @@ bool ZipFile::Init(const std::string &resFileName)
     fseek(m_pFile, -(int)sizeof(dh), SEEK_END);
     long dhOffset = ftell(m_pFile);
     memset(&dh, 0, sizeof(dh));
-    if (fread(&dh, sizeof(dh), 1, m_pFile) != 1)
+    if (!ReadAt(dhOffset, &dh, sizeof(dh)))
         return false;
 
     // Check
     if (dh.sig != TZipDirHeader::SIGNATURE)
         return false;
 
-    // Go to the beginning of the directory.
-    fseek(m_pFile, dhOffset - dh.dirSize, SEEK_SET);
-
     // Allocate the data buffer, and read the whole thing.
     m_pDirData = new /*(std::nothrow)*/ char[dh.dirSize + dh.nDirEntries*sizeof(*m_papDir)];
     if (!m_pDirData)
         return false;
     memset(m_pDirData, 0, dh.dirSize + dh.nDirEntries*sizeof(*m_papDir));
-    if (fread(m_pDirData, dh.dirSize, 1, m_pFile) != 1)
+    if (!ReadAt(dhOffset - dh.dirSize, m_pDirData, dh.dirSize))
         return false;
 
     // Now process each entry.
@@ -173,8 +313,8 @@ bool ZipFile::Init(const std::string &resFileName)
 
     bool success = true;
 
-    //std::string lastDirPath = "/";
-    std::string dirPath;
+    m_ZipContentsMap.reserve(dh.nDirEntries);
+    AddDirectory("/");
 
     for (int i = 0; i < dh.nDirEntries && success; i++)
     {
@@ -198,30 +338,18 @@ bool ZipFile::Init(const std::string &resFileName)
             spath.insert(0, "/");
             m_ZipContentsMap[spath] = i;
 
-            //LOG("spath: " + spath);
-
             // Skip name, extra and comment fields.
             pfh += fh.fnameLen + fh.xtraLen + fh.cmntLen;
 
-            std::string dirName = spath;
-            auto pos = dirName.rfind("/");
-            if (pos != std::string::npos)
+            if (IsZipDir(spath))
             {
-                if (pos == 0) {
-                    dirName = "/";
-                } else {
-                    dirName.erase(pos);
-                }
+                AddDirectory(spath);
             }
-            if (dirName.back() != '/')
+            else
             {
-                dirName += '/';
-            }
-            //LOG("DirName: " + dirName);
-
-            if (!IsZipDir(spath))
-            {
-                m_DirToFileListMap[dirName].push_back(spath);
+                std::string dirPath = GetParentDirectory(spath);
+                AddDirectory(dirPath);
+                m_DirectoryMap[dirPath].files.push_back(spath);
             }
         }
     }
@@ -234,40 +362,61 @@ bool ZipFile::Init(const std::string &resFileName)
         m_nEntries = dh.nDirEntries;
     }
 
-    /*for (auto it : m_DirToFileListMap)
+    return success;
+}
+
+// Registers directory and all its parent directories which are not yet known, archives do not need
+// to have entries for directories
+void ZipFile::AddDirectory(const std::string& dirPath)
+{
+    if (m_DirectoryMap.find(dirPath) != m_DirectoryMap.end())
     {
-        LOG("DIR: " + it.first);
-        LOG("--------------");
-        for (auto it2 : it.second)
-        {
-            LOG("FILE: " + it2);
-        }
-        LOG("==============");
-    }*/
+        return;
+    }
 
-    return success;
+    m_DirectoryMap[dirPath];
+
+    std::string parentPath = GetParentDirectory(dirPath);
+    if (!parentPath.empty())
+    {
+        AddDirectory(parentPath);
+    }
 }
 
 int ZipFile::Find(const std::string &path) const
 {
-    std::string lowerCase = path;
-    std::transform(lowerCase.begin(), lowerCase.end(), lowerCase.begin(), (int(*)(int)) std::tolower);
     // In case the name doesnt start with forward flash, e.g. path == "folder1/folder2/file1", convert it
     // to "/folder1/folder2/file1 format
-    if (lowerCase.size() > 0 && lowerCase[0] != '/')
-    {
-        lowerCase.insert(0, "/");
-    }
-    ZipContentsMap::const_iterator i = m_ZipContentsMap.find(lowerCase);
+    ZipContentsMap::const_iterator i = m_ZipContentsMap.find(NormalizePath(path, false));
     if (i == m_ZipContentsMap.end())
         return -1;
 
     return i->second;
 }
 
-std::vector<std::string>  ZipFile::GetAllFilesInDirectory(const std::string& dirPath)
+std::vector<std::string> ZipFile::GetAllFilesInDirectory(const std::string& dirPath) const
+{
+    ZipDirectoryMap::const_iterator findIt = m_DirectoryMap.find(NormalizePath(dirPath, true));
+    if (findIt == m_DirectoryMap.end())
+    {
+        return {};
+    }
+
+    return findIt->second.files;
+}
+
+ZipFile::ZipFile()
+{
+    m_nEntries = 0;
+    m_pFile = NULL;
+    m_pDirData = NULL;
+}
+
+ZipFile::~ZipFile()
 {
-    return {};
+    End();
+    if (m_pFile)
+        fclose(m_pFile);
 }
 
 // --------------------------------------------------------------------------
@@ -278,6 +427,7 @@ std::vector<std::string>  ZipFile::GetAllFilesInDirectory(const std::string& dir
 void ZipFile::End()
 {
     m_ZipContentsMap.clear();
+    m_DirectoryMap.clear();
     SAFE_DELETE_ARRAY(m_pDirData);
     m_nEntries = 0;
 }
@@ -319,12 +469,83 @@ int ZipFile::GetFileLen(int i) const
         return m_papDir[i]->ucSize;
 }
 
+// --------------------------------------------------------------------------
+// Function:      GetFileCrc
+// Purpose:       Return CRC-32 of the file, it changes whenever its contents do
+// Parameters:    The file index.
+// --------------------------------------------------------------------------
+uint32 ZipFile::GetFileCrc(int i) const
+{
+    if (i < 0 || i >= m_nEntries)
+        return 0;
+    else
+        return m_papDir[i]->crc32;
+}
+
+// --------------------------------------------------------------------------
+// Function:      ReadAt
+// Purpose:       Read from given offset without moving the shared file position
+// Parameters:    The offset, destination buffer and number of bytes
+// --------------------------------------------------------------------------
+bool ZipFile::ReadAt(uint32 offset, void* pBuf, uint32 size) const
+{
+    if (size == 0)
+        return true;
+
+#ifdef _WIN32
+    HANDLE hFile = (HANDLE)_get_osfhandle(_fileno(m_pFile));
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.Offset = offset;
+
+    DWORD bytesRead = 0;
+    if (!::ReadFile(hFile, pBuf, size, &bytesRead, &overlapped))
+        return false;
+
+    return bytesRead == size;
+#else
+    int fd = fileno(m_pFile);
+    char* pDest = (char*)pBuf;
+    while (size > 0)
+    {
+        ssize_t bytesRead = pread(fd, pDest, size, offset);
+        if (bytesRead <= 0)
+            return false;
+
+        pDest += bytesRead;
+        offset += (uint32)bytesRead;
+        size -= (uint32)bytesRead;
+    }
+
+    return true;
+#endif
+}
+
+// --------------------------------------------------------------------------
+// Function:      ReadLocalHeader
+// Purpose:       Read and check the local header of a file
+// Parameters:    The file index, header to fill and offset of file data
+// --------------------------------------------------------------------------
+bool ZipFile::ReadLocalHeader(int i, TZipLocalHeader& h, uint32& dataOffset) const
+{
+    memset(&h, 0, sizeof(h));
+    if (!ReadAt(m_papDir[i]->hdrOffset, &h, sizeof(h)))
+        return false;
+    if (h.sig != TZipLocalHeader::SIGNATURE)
+        return false;
+
+    // Skip extra fields
+    dataOffset = m_papDir[i]->hdrOffset + sizeof(h) + h.fnameLen + h.xtraLen;
+
+    return true;
+}
+
 // --------------------------------------------------------------------------
 // Function:      ReadFile
 // Purpose:       Uncompress a complete file
 // Parameters:    The file index and the pre-allocated buffer
 // --------------------------------------------------------------------------
-bool ZipFile::ReadFile(int i, void *pBuf)
+bool ZipFile::ReadFile(int i, void *pBuf) const
 {
     if (pBuf == NULL || i < 0 || i >= m_nEntries)
         return false;
@@ -333,24 +554,15 @@ bool ZipFile::ReadFile(int i, void *pBuf)
     // Ungood if the ZIP has huge files inside
 
     // Go to the actual file and read the local header.
-    fseek(m_pFile, m_papDir[i]->hdrOffset, SEEK_SET);
     TZipLocalHeader h;
-
-    memset(&h, 0, sizeof(h));
-    if (fread(&h, sizeof(h), 1, m_pFile) != 1)
+    uint32 dataOffset = 0;
+    if (!ReadLocalHeader(i, h, dataOffset))
         return false;
-    if (h.sig != TZipLocalHeader::SIGNATURE)
-        return false;
-
-    // Skip extra fields
-    fseek(m_pFile, h.fnameLen + h.xtraLen, SEEK_CUR);
 
     if (h.compression == Z_NO_COMPRESSION)
     {
         // Simply read in raw stored data.
-        if (fread(pBuf, h.cSize, 1, m_pFile) != 1)
-            return false;
-        return true;
+        return ReadAt(dataOffset, pBuf, h.cSize);
     }
     else if (h.compression != Z_DEFLATED)
         return false;
@@ -361,7 +573,7 @@ bool ZipFile::ReadFile(int i, void *pBuf)
         return false;
 
     memset(pcData.get(), 0, h.cSize);
-    if (fread(pcData.get(), h.cSize, 1, m_pFile) != 1)
+    if (!ReadAt(dataOffset, pcData.get(), h.cSize))
         return false;
 
     bool ret = true;
@@ -393,6 +605,40 @@ bool ZipFile::ReadFile(int i, void *pBuf)
     return ret;
 }
 
+// --------------------------------------------------------------------------
+// Function:      ReadFiles
+// Purpose:       Uncompress many files in parallel
+// Parameters:    The requests with file indices and pre-allocated buffers,
+//                success of each is stored in the request
+// --------------------------------------------------------------------------
+void ZipFile::ReadFiles(std::vector<ZipReadRequest>& requests) const
+{
+    // Workers pick next request until all are processed, so few large files do not stall the others
+    std::atomic<uint32> nextRequestIdx(0);
+    std::function<void()> job = [this, &requests, &nextRequestIdx]()
+    {
+        for (uint32 requestIdx = nextRequestIdx++; requestIdx < requests.size(); requestIdx = nextRequestIdx++)
+        {
+            ZipReadRequest& request = requests[requestIdx];
+            request.success = ReadFile(request.fileIdx, request.pBuf);
+        }
+    };
+
+    const uint32 numThreads = min(max(1U, std::thread::hardware_concurrency()), MAX_INFLATE_THREADS);
+    if (numThreads <= 1 || requests.size() <= 1)
+    {
+        job();
+        return;
+    }
+
+    // Calling thread is one of the workers
+    if (!m_pInflateWorkers)
+    {
+        m_pInflateWorkers.reset(new InflateWorkerPool(numThreads - 1));
+    }
+    m_pInflateWorkers->Run(job);
+}
+
 
 
 // --------------------------------------------------------------------------
@@ -409,24 +655,15 @@ bool ZipFile::ReadLargeFile(int i, void *pBuf, void(*progressCallback)(int, bool
     // Ungood if the ZIP has huge files inside
 
     // Go to the actual file and read the local header.
-    fseek(m_pFile, m_papDir[i]->hdrOffset, SEEK_SET);
     TZipLocalHeader h;
-
-    memset(&h, 0, sizeof(h));
-    if (fread(&h, sizeof(h), 1, m_pFile) != 1)
-        return false;
-    if (h.sig != TZipLocalHeader::SIGNATURE)
+    uint32 dataOffset = 0;
+    if (!ReadLocalHeader(i, h, dataOffset))
         return false;
 
-    // Skip extra fields
-    fseek(m_pFile, h.fnameLen + h.xtraLen, SEEK_CUR);
-
     if (h.compression == Z_NO_COMPRESSION)
     {
         // Simply read in raw stored data.
-        if (fread(pBuf, h.cSize, 1, m_pFile) != 1)
-            return false;
-        return true;
+        return ReadAt(dataOffset, pBuf, h.cSize);
     }
     else if (h.compression != Z_DEFLATED)
         return false;
@@ -437,7 +674,7 @@ bool ZipFile::ReadLargeFile(int i, void *pBuf, void(*progressCallback)(int, bool
         return false;
 
     memset(pcData.get(), 0, h.cSize);
-    if (fread(pcData.get(), h.cSize, 1, m_pFile) != 1)
+    if (!ReadAt(dataOffset, pcData.get(), h.cSize))
         return false;
 
     bool ret = true;
@@ -22,15 +22,31 @@
 
 #include "../SharedDefines.h"
 
-typedef std::map<std::string, int> ZipContentsMap;        // maps path to a zip content id
+typedef std::unordered_map<std::string, int> ZipContentsMap;        // maps path to a zip content id
 typedef std::vector<std::string> FileList;
-typedef std::map<std::string, FileList> DirToFileListMap;
+
+// Node of directory tree built from the central directory, paths are lower case, directories begin and end with "/"
+struct ZipDirectory
+{
+    FileList files;
+};
+typedef std::unordered_map<std::string, ZipDirectory> ZipDirectoryMap;
+
+// Buffer has to be at least GetFileLen(fileIdx) bytes large
+struct ZipReadRequest
+{
+    ZipReadRequest() : fileIdx(-1), pBuf(NULL), success(false) { }
+
+    int fileIdx;
+    void* pBuf;
+    bool success;
+};
 
 class ZipFile
 {
 public:
-    ZipFile() { m_nEntries = 0; m_pFile = NULL; m_pDirData = NULL; }
-    virtual ~ZipFile() { End(); fclose(m_pFile); }
+    ZipFile();
+    virtual ~ZipFile();
 
     bool Init(const std::string &resFileName);
     void End();
@@ -38,28 +54,43 @@ public:
     int GetNumFiles()const { return m_nEntries; }
     std::string GetFilename(int i) const;
     int GetFileLen(int i) const;
-    bool ReadFile(int i, void *pBuf);
-    std::vector<std::string> GetAllFilesInDirectory(const std::string& dirPath);
+    // CRC-32 of uncompressed data as stored in the central directory
+    uint32 GetFileCrc(int i) const;
+    // Reads are positional and do not share any state, so files can be extracted from multiple threads at once
+    bool ReadFile(int i, void *pBuf) const;
+    // Inflates the files in parallel. Worker threads are started by the first call and kept until the zip file is
+    // destroyed, calling thread works too. Has to be called from one thread at a time
+    void ReadFiles(std::vector<ZipReadRequest>& requests) const;
+
+    std::vector<std::string> GetAllFilesInDirectory(const std::string& dirPath) const;
 
     // Added to show multi-threaded decompression
     bool ReadLargeFile(int i, void *pBuf, void(*progressCallback)(int, bool &));
 
     int Find(const std::string &path) const;
 
-    ZipContentsMap m_ZipContentsMap;
-    DirToFileListMap m_DirToFileListMap;
-
 private:
+    class InflateWorkerPool;
     struct TZipDirHeader;
     struct TZipDirFileHeader;
     struct TZipLocalHeader;
 
+    bool ReadAt(uint32 offset, void* pBuf, uint32 size) const;
+    // Offset of file data and its local header
+    bool ReadLocalHeader(int i, TZipLocalHeader& header, uint32& dataOffset) const;
+    void AddDirectory(const std::string& dirPath);
+
     FILE *m_pFile;        // Zip file
     char *m_pDirData;    // Raw data buffer.
     int  m_nEntries;    // Number of entries.
 
     // Pointers to the dir entries in pDirData.
     const TZipDirFileHeader **m_papDir;
+
+    ZipContentsMap m_ZipContentsMap;
+    ZipDirectoryMap m_DirectoryMap;
+
+    mutable std::unique_ptr<InflateWorkerPool> m_pInflateWorkers;
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "ActorSceneNode.h"
 #include "../Actor/Components/RenderComponent.h"
 #include "../Graphics2D/Image.h"
+#include "../Graphics2D/RenderCommands.h"
 
 SDL2ActorSceneNode::SDL2ActorSceneNode(const uint32 actorId,
     BaseRenderComponent* pRenderComponent,
@@ -69,12 +70,18 @@ void SDL2ActorSceneNode::VRender(Scene* pScene)
         return;
     }
 
-    SDL_SetTextureAlphaMod(actorImage->GetTexture(), arc->GetAlpha());
-
+    SDL_Texture* pTexture = actorImage->GetVariantTexture(arc->GetPaletteVariant());
+    int alpha = arc->GetAlpha();
     SDL_Color colorMod = arc->GetColorMod();
-    SDL_SetTextureColorMod(actorImage->GetTexture(), colorMod.r, colorMod.g, colorMod.b);
+    if (!actorImage->IsIndexed())
+    {
+        Image::ApplyVariantModulation(arc->GetPaletteVariant(), colorMod, alpha);
+    }
+
+    RenderCommands::SetTextureAlphaMod(pTexture, alpha);
+    RenderCommands::SetTextureColorMod(pTexture, colorMod.r, colorMod.g, colorMod.b);
 
     SDL_Renderer* renderer = pScene->GetRenderer();
-    SDL_RenderCopyEx(renderer, actorImage->GetTexture(), NULL, &renderRect, 0, NULL, 
+    RenderCommands::Copy(renderer, pTexture, NULL, &renderRect,
         arc->IsMirrored() ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
 }
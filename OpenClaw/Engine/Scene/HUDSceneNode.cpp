@@ -2,6 +2,7 @@
 #include "HUDSceneNode.h"
 #include "../Actor/Components/RenderComponent.h"
 #include "../Graphics2D/Image.h"
+#include "../Graphics2D/RenderCommands.h"
 #include "../GameApp/BaseGameApp.h"
 
 SDL2HUDSceneNode::SDL2HUDSceneNode(const uint32 actorId,
@@ -69,6 +70,6 @@ void SDL2HUDSceneNode::VRender(Scene* pScene)
     };
 
     SDL_Renderer* renderer = pScene->GetRenderer();
-    SDL_RenderCopyEx(renderer, actorImage->GetTexture(), NULL, &renderRect, 0, NULL,
+    RenderCommands::Copy(renderer, actorImage->GetTexture(), NULL, &renderRect,
         hrc->IsMirrored() ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
 }
\ No newline at end of file
@@ -28,11 +28,14 @@ Scene::~Scene()
 
 void Scene::OnUpdate(uint32 msDiff)
 {
+    TRACK_ALLOCATIONS(AllocTag_Scene);
     return m_pRoot->VOnUpdate(this, msDiff);
 }
 
 void Scene::OnRender()
 {
+    TRACK_ALLOCATIONS(AllocTag_Scene);
+
     if (m_pRoot && m_pCamera)
     {
         m_pCamera->SetViewPosition(this);
@@ -57,6 +60,8 @@ shared_ptr<ISceneNode> Scene::FindActor(uint32 actorId)
 
 bool Scene::AddChild(uint32 actorId, shared_ptr<ISceneNode> kid)
 {
+    TRACK_ALLOCATIONS(AllocTag_Scene);
+
     if (actorId != INVALID_ACTOR_ID)
     {
         auto result = m_ActorMap.insert(std::make_pair(actorId, kid));
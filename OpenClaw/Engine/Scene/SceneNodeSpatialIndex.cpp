@@ -0,0 +1,154 @@
+#include "SceneNodeSpatialIndex.h"
+
+static bool CompareZCoord(const shared_ptr<ISceneNode>& pLeft, const shared_ptr<ISceneNode>& pRight)
+{
+    return pLeft->GetZCoord() < pRight->GetZCoord();
+}
+
+SceneNodeSpatialIndex::SceneNodeSpatialIndex(int cellSize)
+    :
+    m_CellSize(cellSize)
+{
+    assert(m_CellSize > 0);
+}
+
+void SceneNodeSpatialIndex::Insert(shared_ptr<ISceneNode> pNode)
+{
+    assert(pNode != nullptr);
+
+    const uint32 actorId = pNode->VGetProperties()->GetActorId();
+    assert(actorId != INVALID_ACTOR_ID);
+
+    // Actor can have only one node, re-added node replaces the old one
+    Remove(actorId);
+
+    const CellKey cellKey = GetCellKey(pNode->VGetProperties()->GetPosition());
+    InsertToCell(cellKey, pNode);
+    m_ActorCells[actorId] = cellKey;
+}
+
+shared_ptr<ISceneNode> SceneNodeSpatialIndex::Remove(uint32 actorId)
+{
+    auto findIt = m_ActorCells.find(actorId);
+    if (findIt == m_ActorCells.end())
+    {
+        return nullptr;
+    }
+
+    shared_ptr<ISceneNode> pNode = RemoveFromCell(findIt->second, actorId);
+    m_ActorCells.erase(findIt);
+
+    return pNode;
+}
+
+bool SceneNodeSpatialIndex::Move(uint32 actorId, const Point& newPosition)
+{
+    auto findIt = m_ActorCells.find(actorId);
+    if (findIt == m_ActorCells.end())
+    {
+        return false;
+    }
+
+    const CellKey newCellKey = GetCellKey(newPosition);
+    if (newCellKey == findIt->second)
+    {
+        return true;
+    }
+
+    shared_ptr<ISceneNode> pNode = RemoveFromCell(findIt->second, actorId);
+    assert(pNode != nullptr);
+
+    InsertToCell(newCellKey, pNode);
+    findIt->second = newCellKey;
+
+    return true;
+}
+
+void SceneNodeSpatialIndex::Query(const SDL_Rect& worldRect, SceneNodeList& outNodes) const
+{
+    QueryCells(worldRect, outNodes, true);
+}
+
+void SceneNodeSpatialIndex::QueryUnsorted(const SDL_Rect& worldRect, SceneNodeList& outNodes) const
+{
+    QueryCells(worldRect, outNodes, false);
+}
+
+void SceneNodeSpatialIndex::QueryCells(const SDL_Rect& worldRect, SceneNodeList& outNodes, bool sortByZCoord) const
+{
+    // One more cell on every side for images reaching out of their cell
+    const int fromX = WorldToCell(worldRect.x) - 1;
+    const int fromY = WorldToCell(worldRect.y) - 1;
+    const int toX = WorldToCell(worldRect.x + worldRect.w) + 1;
+    const int toY = WorldToCell(worldRect.y + worldRect.h) + 1;
+
+    const size_t firstNodeIdx = outNodes.size();
+    for (int cellX = fromX; cellX <= toX; cellX++)
+    {
+        for (int cellY = fromY; cellY <= toY; cellY++)
+        {
+            auto findIt = m_Cells.find(GetCellKey(cellX, cellY));
+            if (findIt == m_Cells.end())
+            {
+                continue;
+            }
+
+            // Cells are sorted, so merging them keeps the result sorted
+            const SceneNodeList& cellNodes = findIt->second;
+            const size_t mergeIdx = outNodes.size();
+            outNodes.insert(outNodes.end(), cellNodes.begin(), cellNodes.end());
+            if (sortByZCoord)
+            {
+                std::inplace_merge(outNodes.begin() + firstNodeIdx, outNodes.begin() + mergeIdx, outNodes.end(),
+                    CompareZCoord);
+            }
+        }
+    }
+}
+
+int SceneNodeSpatialIndex::WorldToCell(double worldCoord) const
+{
+    return (int)std::floor(worldCoord / m_CellSize);
+}
+
+SceneNodeSpatialIndex::CellKey SceneNodeSpatialIndex::GetCellKey(int cellX, int cellY) const
+{
+    return ((CellKey)(uint32)cellX << 32) | (CellKey)(uint32)cellY;
+}
+
+SceneNodeSpatialIndex::CellKey SceneNodeSpatialIndex::GetCellKey(const Point& position) const
+{
+    return GetCellKey(WorldToCell(position.x), WorldToCell(position.y));
+}
+
+void SceneNodeSpatialIndex::InsertToCell(CellKey cellKey, shared_ptr<ISceneNode>& pNode)
+{
+    SceneNodeList& cellNodes = m_Cells[cellKey];
+    cellNodes.insert(std::lower_bound(cellNodes.begin(), cellNodes.end(), pNode, CompareZCoord), pNode);
+}
+
+shared_ptr<ISceneNode> SceneNodeSpatialIndex::RemoveFromCell(CellKey cellKey, uint32 actorId)
+{
+    auto cellIt = m_Cells.find(cellKey);
+    if (cellIt == m_Cells.end())
+    {
+        return nullptr;
+    }
+
+    SceneNodeList& cellNodes = cellIt->second;
+    for (auto nodeIt = cellNodes.begin(); nodeIt != cellNodes.end(); ++nodeIt)
+    {
+        if ((*nodeIt)->VGetProperties()->GetActorId() == actorId)
+        {
+            shared_ptr<ISceneNode> pNode = *nodeIt;
+            cellNodes.erase(nodeIt);
+            if (cellNodes.empty())
+            {
+                m_Cells.erase(cellIt);
+            }
+            return pNode;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,58 @@
+#ifndef __SCENE_NODE_SPATIAL_INDEX_H__
+#define __SCENE_NODE_SPATIAL_INDEX_H__
+
+#include "SceneNodes.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// SceneNodeSpatialIndex
+//
+// Sparse grid of scene nodes with cells of fixed size in world units, so neither window size nor level size changes
+// how many nodes share a cell. Only cells which contain some node exist and coordinates are not limited, nodes which
+// fall out of the level still get their own cells.
+//
+// Nodes are indexed by their position, which is the center of their image, so the index is "loose" - queries look one
+// cell further in every direction to catch images reaching out of the cell of their node. Queries therefore return
+// candidates, exact visibility is still decided by the node itself.
+//
+// Each cell is kept sorted by z-coord and queries merge the cells, so returned nodes are in render order.
+//---------------------------------------------------------------------------------------------------------------------
+
+class SceneNodeSpatialIndex
+{
+public:
+    explicit SceneNodeSpatialIndex(int cellSize);
+
+    // Node has to have valid actor ID, it is used to find the node later. Replaces previous node of the actor
+    void Insert(shared_ptr<ISceneNode> pNode);
+    // Returns removed node, NULL if there is no node of the actor
+    shared_ptr<ISceneNode> Remove(uint32 actorId);
+    // Moves the node to the cell of new position if it changed. Returns false if there is no node of the actor
+    bool Move(uint32 actorId, const Point& newPosition);
+
+    // Appends nodes which may intersect given world rect, sorted by z-coord
+    void Query(const SDL_Rect& worldRect, SceneNodeList& outNodes) const;
+    // Same nodes in no particular order (but the same for the same index state), cheaper when order does not matter
+    void QueryUnsorted(const SDL_Rect& worldRect, SceneNodeList& outNodes) const;
+
+    bool Contains(uint32 actorId) const { return m_ActorCells.count(actorId) > 0; }
+    uint32 GetNodeCount() const { return m_ActorCells.size(); }
+    uint32 GetCellCount() const { return m_Cells.size(); }
+
+private:
+    typedef uint64 CellKey;
+
+    int WorldToCell(double worldCoord) const;
+    CellKey GetCellKey(int cellX, int cellY) const;
+    CellKey GetCellKey(const Point& position) const;
+
+    void QueryCells(const SDL_Rect& worldRect, SceneNodeList& outNodes, bool sortByZCoord) const;
+
+    void InsertToCell(CellKey cellKey, shared_ptr<ISceneNode>& pNode);
+    shared_ptr<ISceneNode> RemoveFromCell(CellKey cellKey, uint32 actorId);
+
+    const int m_CellSize;
+    std::unordered_map<CellKey, SceneNodeList> m_Cells;
+    std::unordered_map<uint32, CellKey> m_ActorCells;
+};
+
+#endif
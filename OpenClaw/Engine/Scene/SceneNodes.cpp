@@ -1,6 +1,7 @@
 #include <cmath>
 #include "SceneNodes.h"
 #include "Scene.h"
+#include "SceneNodeSpatialIndex.h"
 #include "../Actor/ActorComponent.h"
 #include "../Actor/Components/RenderComponent.h"
 #include "../GameApp/BaseGameApp.h"
@@ -224,15 +225,20 @@ void RootNode::VRenderChildren(Scene* pScene)
 // GridNode Implementation
 // This implementation uses actor positions to store nodes and reduce visibility checks
 // It's useless for UI or another nodes storing without actor position.
-// Each cell stores sorted collection of nodes.
-// VOnUpdate() UPDATES ONLY VISIBLE NODES IN RANDOM ORDER!!! BE CAREFUL
+// VOnUpdate() UPDATES ONLY NODES NEAR THE CAMERA!!! BE CAREFUL
 
-// I hope map won't be greater than 1000 tiles. So it's about 1000 tiles * 64 px / 640 px ~ 100 cells for the worst cases
-GridNode::GridNode(RenderPass renderPass) : m_CellWidth((int) (g_pApp->GetWindowSizeScaled().x * 1.3)),
-                                            m_CellHeight((int) (g_pApp->GetWindowSizeScaled().y * 1.3)),
-                                            m_MaxRowCount(100),
-                                            m_MaxColumnCount(100),
-                                            SceneNode(INVALID_ACTOR_ID, nullptr, renderPass, {0, 0}) {
+// 8 tiles. Small enough to keep cells sparse, big enough for any actor image to reach at most to neighbouring cell
+static const int GRID_NODE_CELL_SIZE = 512;
+
+GridNode::GridNode(RenderPass renderPass)
+    : SceneNode(INVALID_ACTOR_ID, nullptr, renderPass, {0, 0}),
+    m_pIndex(new SceneNodeSpatialIndex(GRID_NODE_CELL_SIZE))
+{
+
+}
+
+GridNode::~GridNode()
+{
 
 }
 
@@ -242,56 +248,24 @@ bool GridNode::VAddChild(shared_ptr<ISceneNode> kid) {
         LOG_WARNING("SceneNode without actor id will be added to GridNode");
         return SceneNode::VAddChild(kid);
     }
-    const Point actorPos = kid->VGetProperties()->GetPosition();
-    const SDL_Point cellPos = WorldToGridPosition((int) actorPos.x, (int) actorPos.y);
-    AddToGrid(cellPos.x, cellPos.y, kid);
-    return true;
-}
-
-SDL_Point GridNode::WorldToGridPosition(int x, int y) const {
-    // Max column/row count prevents infinite memory growing if an actor falls out of bound
-    return SDL_Point{
-            min(max(x, 0) / m_CellWidth, m_MaxColumnCount),
-            min(max(y, 0) / m_CellHeight, m_MaxRowCount)
-    };
-}
-
-void GridNode::AddToGrid(int x, int y, shared_ptr<ISceneNode> &ikid) {
-    if (m_Grid.size() <= x) {
-        m_Grid.resize(x + 1);
-    }
-    auto &col = m_Grid[x];
-    if (col.size() <= y) {
-        col.resize(y + 1);
-    }
-    auto &cell = col[y];
 
-    // Nodes in grid cells are always ordered
-    cell.insert(
-            std::lower_bound(cell.begin(), cell.end(), ikid, NodeCompare),
-            ikid
-    );
+    m_pIndex->Insert(kid);
 
-    shared_ptr<SceneNode> kid = static_pointer_cast<SceneNode>(ikid);
-    kid->SetParent(this);
+    shared_ptr<SceneNode> pSceneNode = static_pointer_cast<SceneNode>(kid);
+    pSceneNode->SetParent(this);
+    return true;
 }
 
 bool GridNode::VRemoveChild(uint32 actorId) {
-    // TODO: Expensive
-    for (auto &column : m_Grid) {
-        for (auto &nodes : column) {
-            for (auto it = nodes.begin(); it != nodes.end(); ++it) {
-                if ((*it)->VGetProperties()->GetActorId() == actorId) {
-                    nodes.erase(it);
-                    return true;
-                }
-            }
-        }
+    shared_ptr<ISceneNode> pNode = m_pIndex->Remove(actorId);
+    if (pNode) {
+        // Nodes of pooled actors are kept and moved around while out of the scene
+        static_pointer_cast<SceneNode>(pNode)->SetParent(NULL);
+        return true;
     }
     return SceneNode::VRemoveChild(actorId);
 }
 
-
 void GridNode::VRenderChildren(Scene* pScene)
 {
     shared_ptr<CameraNode> pCamera = pScene->GetCamera();
@@ -301,46 +275,19 @@ void GridNode::VRenderChildren(Scene* pScene)
         return;
     }
 
-    // Render grid elements. We need to find visible cells, collect nodes, sort it and render
-    const SDL_Rect intersect = GridIntersection(pCamera->GetCameraRect());
-
-    int nodeCount = 0;
-    for (int x = intersect.x; x < intersect.x + intersect.w && x < m_Grid.size(); ++x) {
-        auto &column = m_Grid[x];
-        for (int y = intersect.y; y < intersect.y + intersect.h && y < column.size(); ++y) {
-            nodeCount += column[y].size();
-        }
-    }
-
-    std::vector<shared_ptr<ISceneNode>> intersectedNodes;
-    intersectedNodes.reserve(nodeCount);
-    for (int x = intersect.x; x < intersect.x + intersect.w && x < m_Grid.size(); ++x) {
-        auto &column = m_Grid[x];
-        for (int y = intersect.y; y < intersect.y + intersect.h && y < column.size(); ++y) {
-            auto &nodes = column[y];
-            if (!nodes.empty()) {
-                // Insert sorted vector to the end of sorted vector
-                int oldSize = intersectedNodes.size();
-                intersectedNodes.insert(intersectedNodes.end(), nodes.begin(), nodes.end());
-                // Sort resulted vector
-                std::inplace_merge(intersectedNodes.begin(), intersectedNodes.begin() + oldSize, intersectedNodes.end(), NodeCompare);
-            }
-        }
-    }
-    for (auto &node : intersectedNodes) {
+    // Nodes come sorted by z-coord, exact visibility is checked by each node
+    m_VisibleNodes.clear();
+    m_pIndex->Query(pCamera->GetCameraRect(), m_VisibleNodes);
+    for (auto &node : m_VisibleNodes) {
         RenderNode(pScene, node);
     }
+    // Do not keep removed nodes alive until the next frame
+    m_VisibleNodes.clear();
 
     // Render another
     SceneNode::VRenderChildren(pScene);
 }
 
-SDL_Rect GridNode::GridIntersection(const SDL_Rect &cameraRect) const {
-    const SDL_Point start = WorldToGridPosition(cameraRect.x, cameraRect.y);
-    const SDL_Point end = WorldToGridPosition(cameraRect.x + cameraRect.w, cameraRect.y + cameraRect.h);
-    return SDL_Rect{max(start.x - 1, 0), max(start.y - 1, 0), end.x - start.x + 3, end.y - start.y + 3};
-}
-
 void GridNode::VOnUpdate(Scene *pScene, uint32 msDiff) {
     shared_ptr<CameraNode> pCamera = pScene->GetCamera();
     if (!pCamera)
@@ -349,61 +296,28 @@ void GridNode::VOnUpdate(Scene *pScene, uint32 msDiff) {
         return;
     }
 
-    // NOW UPDATE ONLY VISIBLE CELLS IN RANDOM ORDER!!!
-    const SDL_Rect intersect = GridIntersection(pCamera->GetCameraRect());
-    for (int x = intersect.x; x < intersect.x + intersect.w && x < m_Grid.size(); ++x) {
-        auto &column = m_Grid[x];
-        for (int y = intersect.y; y < intersect.y + intersect.h && y < column.size(); ++y) {
-            auto &nodes = column[y];
-            for (auto &node : nodes) {
-                node->VOnUpdate(pScene, msDiff);
-            }
-        }
+    // NOW UPDATE ONLY NODES NEAR THE CAMERA!!!
+    // Updates can move nodes between cells, so they are iterated from a copy
+    m_pIndex->QueryUnsorted(pCamera->GetCameraRect(), m_UpdatedNodes);
+    for (auto &node : m_UpdatedNodes) {
+        node->VOnUpdate(pScene, msDiff);
     }
+    m_UpdatedNodes.clear();
 
     SceneNode::VOnUpdate(pScene, msDiff);
 }
 
 void GridNode::SortChildrenByZCoord() {
-    // Grid is always sorted
+    // Index is always sorted
     SceneNode::SortChildrenByZCoord();
 }
 
 // Move node to another cell if it's needed
 void GridNode::VOnBeforeChildrenModifyPosition(SceneNode *children, const Point &position) {
     uint32 actorId = children->VGetProperties()->GetActorId();
-    if (actorId != INVALID_ACTOR_ID) {
-        const Point oldPos = children->VGetProperties()->GetPosition();
-        const SDL_Point oldGridPos = WorldToGridPosition((int) oldPos.x, (int) oldPos.y);
-
-        const SDL_Point newGridPos = WorldToGridPosition((int) position.x, (int) position.y);
-        if (oldGridPos.x != newGridPos.x || oldGridPos.y != newGridPos.y) {
-            shared_ptr<ISceneNode> node = RemoveFromGrid(oldGridPos.x, oldGridPos.y, actorId);
-            if (node) {
-                AddToGrid(newGridPos.x, newGridPos.y, node);
-            } else {
-                LOG_ERROR("Scene node was not found in GridNode!")
-                SceneNode::VOnBeforeChildrenModifyPosition(children, position);
-            }
-        }
-    }
-}
-
-shared_ptr<ISceneNode> GridNode::RemoveFromGrid(int x, int y, uint32 actorId) {
-    if (m_Grid.size() > x) {
-        auto &col = m_Grid[x];
-        if (col.size() > y) {
-            auto &cell = col[y];
-            for (auto it = cell.begin(); it != cell.end(); ++it) {
-                if ((*it)->VGetProperties()->GetActorId() == actorId) {
-                    shared_ptr<ISceneNode> node = *it;
-                    it = cell.erase(it);
-                    return node;
-                }
-            }
-        }
+    if (actorId != INVALID_ACTOR_ID && !m_pIndex->Move(actorId, position)) {
+        LOG_ERROR("Scene node was not found in GridNode!")
     }
-    return shared_ptr<ISceneNode>();
 }
 
 //=================================================================================================
@@ -21,6 +21,7 @@ class Scene;
 class MovementController;
 class BaseRenderComponent;
 class SceneNodeProperties;
+class SceneNodeSpatialIndex;
 
 class ISceneNode
 {
@@ -73,6 +74,8 @@ typedef std::vector <shared_ptr<ISceneNode>> SceneNodeList;
 
 class SceneNode : public ISceneNode
 {
+    POOLED_ALLOCATION_DECLARATION()
+
 public:
     SceneNode(uint32 actorId, BaseRenderComponent* renderComponent, RenderPass renderPass, Point position, int32 zCoord = 0);
     virtual ~SceneNode();
@@ -95,6 +98,9 @@ public:
     void VSetPosition(const Point& position) override;
     Point GetPosition() { return m_Properties.m_Position; }
 
+    // Nodes of pooled actors are reused under new actor ID
+    void SetActorId(uint32 actorId) { m_Properties.m_ActorId = actorId; }
+
     void SetParent(SceneNode *node) { m_pParent = node; }
     SceneNode* GetParent() { return m_pParent; }
 
@@ -131,10 +137,12 @@ public:
     virtual bool VIsVisible(Scene* pScene) const override { return true; }
 };
 
+// Keeps actor nodes in spatial index with fixed world size cells, only nodes near the camera are visited
 class GridNode : public SceneNode
 {
 public:
     GridNode(RenderPass renderPass);
+    virtual ~GridNode();
     bool VAddChild(shared_ptr<ISceneNode> kid) override;
     void VRenderChildren(Scene* pScene) override;
     bool VRemoveChild(uint32 actorId) override;
@@ -146,14 +154,12 @@ public:
 
 protected:
     void VOnBeforeChildrenModifyPosition(SceneNode *children, const Point &position) override;
-    SDL_Point WorldToGridPosition(int x, int y) const;
-    SDL_Rect GridIntersection(const SDL_Rect &cameraRect) const;
-    void AddToGrid(int x, int y, shared_ptr<ISceneNode> &kid);
-    shared_ptr<ISceneNode> RemoveFromGrid(int x, int y, uint32 actorId);
-
-    std::vector<std::vector<SceneNodeList>> m_Grid; // m_Grid[x][y]
-    const int m_CellWidth, m_CellHeight;
-    const int m_MaxRowCount, m_MaxColumnCount;
+
+    unique_ptr<SceneNodeSpatialIndex> m_pIndex;
+    // Reused every render pass so that collecting visible nodes does not allocate
+    SceneNodeList m_VisibleNodes;
+    // Scratch list of nodes updated in the current frame
+    SceneNodeList m_UpdatedNodes;
 };
 
 class CameraNode : public SceneNode
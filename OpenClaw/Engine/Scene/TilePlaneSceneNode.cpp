@@ -3,15 +3,20 @@
 #include "TilePlaneSceneNode.h"
 #include "../Actor/Components/RenderComponent.h"
 #include "../Graphics2D/Image.h"
+#include "../Graphics2D/RenderCommands.h"
 #include "../GameApp/BaseGameApp.h"
 
 SDL2TilePlaneSceneNode::SDL2TilePlaneSceneNode(const uint32 actorId,
     BaseRenderComponent* pRenderComponent,
     RenderPass renderPass,
     Point position)
-    : SceneNode(actorId, pRenderComponent, renderPass, position)
+    : SceneNode(actorId, pRenderComponent, renderPass, position),
+    m_CachedStartRow(0),
+    m_CachedStartCol(0),
+    m_CachedRowCount(0),
+    m_CachedColCount(0)
 {
-
+    m_pPlaneProperties = static_cast<TilePlaneRenderComponent*>(pRenderComponent)->GetTilePlaneProperties();
 }
 
 SDL2TilePlaneSceneNode::~SDL2TilePlaneSceneNode()
@@ -21,10 +26,7 @@ SDL2TilePlaneSceneNode::~SDL2TilePlaneSceneNode()
 
 void SDL2TilePlaneSceneNode::VRender(Scene* pScene)
 {
-    TilePlaneRenderComponent* pRenderComponent = static_cast<TilePlaneRenderComponent*>(m_pRenderComponent);
-
-    const TilePlaneProperties* pProperties = pRenderComponent->GetTilePlaneProperties();
-    const TileImageList* pImageList = pRenderComponent->GetTileImageList();
+    const TilePlaneProperties* pProperties = m_pPlaneProperties;
 
     shared_ptr<CameraNode> camera = pScene->GetCamera();
     SDL_Renderer* renderer = pScene->GetRenderer();
@@ -50,55 +52,123 @@ void SDL2TilePlaneSceneNode::VRender(Scene* pScene)
     int32_t colTilesToRender = (uint32_t)(cameraRect.w / tilePixelWidth) + 2 + numTilesPadding;
     int32_t rowTilesToRender = (uint32_t)(cameraRect.h / tilePixelHeight) + 2 + numTilesPadding;
 
-    // Some planes (Back, Front) repeat themselves, which means they can be rendered
-    // even when out of bounds
-    int32_t maxTileIdxX = pProperties->tilesOnAxisX;
-    int32_t maxTileIdxY = pProperties->tilesOnAxisY;
-    int32_t minTileIdxX = 0;
-    int32_t minTileIdxY = 0;
-    // TODO: Wrap even when when out of bounds on the negative side
-    if (pProperties->isWrappedX)
+    UpdateVisibleTiles(startRow, startCol, rowTilesToRender, colTilesToRender);
+
+    int32_t row, col;
+    for (row = startRow; row < (startRow + rowTilesToRender); row++)
     {
-        maxTileIdxX = INT32_MAX;
-        minTileIdxX = 0;
+        for (col = startCol; col < (startCol + colTilesToRender); col++)
+        {
+            Image* image = GetCachedTile(row, col);
+            if (image && image->GetTexture() != NULL)
+            {
+                int32_t x = col * tilePixelWidth - parallaxCameraPosX;
+                int32_t y = row * tilePixelHeight - parallaxCameraPosY;
+                SDL_Rect tileRect = { x,
+                    y,
+                    tilePixelWidth,
+                    tilePixelHeight };
+
+                RenderCommands::Copy(renderer, image->GetTexture(), NULL, &tileRect);
+            }
+        }
     }
-    if (pProperties->isWrappedY)
+}
+
+void SDL2TilePlaneSceneNode::UpdateVisibleTiles(int32 startRow, int32 startCol, int32 rowCount, int32 colCount)
+{
+    const bool isSizeChanged = rowCount != m_CachedRowCount || colCount != m_CachedColCount;
+    const int32 rowShift = startRow - m_CachedStartRow;
+    const int32 colShift = startCol - m_CachedStartCol;
+
+    if (!isSizeChanged && rowShift == 0 && colShift == 0)
     {
-        maxTileIdxY = INT32_MAX;
-        minTileIdxY = 0;
+        return;
     }
 
-    int32_t row, col;
-    for (row = startRow; row < (startRow + rowTilesToRender) && row <= maxTileIdxY; row++)
+    const int32 endRow = startRow + rowCount;
+    const int32 endCol = startCol + colCount;
+
+    if (isSizeChanged || abs(rowShift) >= rowCount || abs(colShift) >= colCount)
     {
-        if (row < minTileIdxY)
+        // Nothing cached can be reused, ring buffer size has to be set before caching the tiles
+        m_CachedRowCount = rowCount;
+        m_CachedColCount = colCount;
+        m_VisibleTiles.assign(rowCount * colCount, NULL);
+        for (int32 row = startRow; row < endRow; row++)
         {
-            continue;
+            for (int32 col = startCol; col < endCol; col++)
+            {
+                CacheTile(row, col);
+            }
         }
-        const int rowTileIndex = row % pProperties->tilesOnAxisY;
+    }
+    else
+    {
+        const int32 oldEndRow = m_CachedStartRow + m_CachedRowCount;
+        const int32 oldEndCol = m_CachedStartCol + m_CachedColCount;
 
-        for (col = startCol; col < (startCol + colTilesToRender) && col <= maxTileIdxX; col++)
+        for (int32 row = startRow; row < endRow; row++)
         {
-            // Dont render anything out of bounds
-            if (col < minTileIdxX)
+            // Whole row entered the view
+            if (row < m_CachedStartRow || row >= oldEndRow)
             {
+                for (int32 col = startCol; col < endCol; col++)
+                {
+                    CacheTile(row, col);
+                }
                 continue;
             }
-            const int colTileIndex = col % pProperties->tilesOnAxisX;
 
-            Image* image = (*pImageList)[rowTileIndex * pProperties->tilesOnAxisX + colTileIndex];
-
-            if (image && image->GetTexture() != NULL)
+            // Only columns which entered the view
+            for (int32 col = startCol; col < endCol; col++)
             {
-                int32_t x = col * tilePixelWidth - parallaxCameraPosX;
-                int32_t y = row * tilePixelHeight - parallaxCameraPosY;
-                SDL_Rect tileRect = { x,
-                    y,
-                    tilePixelWidth,
-                    tilePixelHeight };
-
-                SDL_RenderCopy(renderer, image->GetTexture(), NULL, &tileRect);
+                if (col < m_CachedStartCol || col >= oldEndCol)
+                {
+                    CacheTile(row, col);
+                }
             }
         }
     }
+
+    m_CachedStartRow = startRow;
+    m_CachedStartCol = startCol;
+    m_CachedRowCount = rowCount;
+    m_CachedColCount = colCount;
+}
+
+void SDL2TilePlaneSceneNode::CacheTile(int32 row, int32 col)
+{
+    GetCachedTile(row, col) = LookupTileImage(row, col);
+}
+
+Image* SDL2TilePlaneSceneNode::LookupTileImage(int32 row, int32 col) const
+{
+    const TilePlaneProperties* pProperties = m_pPlaneProperties;
+    const TileImageList* pImageList = static_cast<TilePlaneRenderComponent*>(m_pRenderComponent)->GetTileImageList();
+
+    // Some planes (Back, Front) repeat themselves, which means they can be rendered
+    // even when out of bounds
+    int32_t maxTileIdxX = pProperties->isWrappedX ? INT32_MAX : pProperties->tilesOnAxisX;
+    int32_t maxTileIdxY = pProperties->isWrappedY ? INT32_MAX : pProperties->tilesOnAxisY;
+    // TODO: Wrap even when when out of bounds on the negative side
+    if (row < 0 || col < 0 || row > maxTileIdxY || col > maxTileIdxX)
+    {
+        return NULL;
+    }
+
+    const int rowTileIndex = row % pProperties->tilesOnAxisY;
+    const int colTileIndex = col % pProperties->tilesOnAxisX;
+
+    return (*pImageList)[rowTileIndex * pProperties->tilesOnAxisX + colTileIndex];
+}
+
+Image*& SDL2TilePlaneSceneNode::GetCachedTile(int32 row, int32 col)
+{
+    int32 ringRow = row % m_CachedRowCount;
+    int32 ringCol = col % m_CachedColCount;
+    if (ringRow < 0) ringRow += m_CachedRowCount;
+    if (ringCol < 0) ringCol += m_CachedColCount;
+
+    return m_VisibleTiles[ringRow * m_CachedColCount + ringCol];
 }
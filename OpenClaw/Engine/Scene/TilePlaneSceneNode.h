@@ -4,6 +4,16 @@
 #include "../SharedDefines.h"
 #include "../Scene/SceneNodes.h"
 
+class Image;
+struct TilePlaneProperties;
+
+//---------------------------------------------------------------------------------------------------------------------
+// SDL2TilePlaneSceneNode
+//
+// Images of tiles in view are cached in a ring buffer indexed by tile row and column modulo size of the view, so when
+// camera scrolls only tiles of rows and columns entering the view are looked up, they overwrite slots of the ones
+// which left. When the camera does not move to another tile, rendering just copies the cached images.
+//---------------------------------------------------------------------------------------------------------------------
 class SDL2TilePlaneSceneNode : public SceneNode
 {
 public:
@@ -18,6 +28,19 @@ public:
     virtual void VRender(Scene* pScene);
 
 protected:
+    void UpdateVisibleTiles(int32 startRow, int32 startCol, int32 rowCount, int32 colCount);
+    void CacheTile(int32 row, int32 col);
+    Image* LookupTileImage(int32 row, int32 col) const;
+    Image*& GetCachedTile(int32 row, int32 col);
+
+    const TilePlaneProperties* m_pPlaneProperties;
+
+    // Ring buffer of rowCount * colCount tile images
+    std::vector<Image*> m_VisibleTiles;
+    int32 m_CachedStartRow;
+    int32 m_CachedStartCol;
+    int32 m_CachedRowCount;
+    int32 m_CachedColCount;
 };
 
 #endif
\ No newline at end of file
@@ -22,6 +22,8 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <tinyxml.h>
 #include <Box2D/Box2D.h>
 #include <algorithm>
@@ -31,6 +33,8 @@
 #include "Util/StringUtil.h"
 #include "Util/Util.h"
 #include "Util/Profilers.h"
+#include "Util/Memory/AllocationTracker.h"
+#include "Util/Memory/MemoryMacros.h"
 #include "Util/CustomAssert.h"
 #include "Interfaces.h"
 #include "Events/EventMgr.h"
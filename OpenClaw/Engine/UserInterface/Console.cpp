@@ -1,4 +1,5 @@
 #include "Console.h"
+#include "../Graphics2D/RenderCommands.h"
 #include <algorithm>
 #include <assert.h>
 
@@ -17,7 +18,7 @@ static SDL_Texture* GetTextureFromTtfText(TTF_Font* font, SDL_Color textColor, S
 {
     //cout << "GetTextureFromTtfText" << endl;
     SDL_Surface* surfaceText = TTF_RenderText_Blended(font, text.c_str(), textColor);
-    SDL_Texture* textureText = SDL_CreateTextureFromSurface(renderer, surfaceText);
+    SDL_Texture* textureText = RenderCommands::CreateTextureFromSurface(renderer, surfaceText);
     SDL_FreeSurface(surfaceText);
 
     return textureText;
@@ -35,21 +36,21 @@ void RenderText(SDL_Renderer* renderer, std::string text, TTF_Font* font, SDL_Co
 {
     SDL_Texture* texture = GetTextureFromTtfText(font, color, renderer, text);
     SDL_Rect rect = GetRenderRectFromTexture(texture, x, y);
-    SDL_RenderCopy(renderer, texture, NULL, &rect);
-    SDL_DestroyTexture(texture);
+    RenderCommands::Copy(renderer, texture, NULL, &rect);
+    RenderCommands::DestroyTexture(texture);
 }
 
 void RenderRectangle(SDL_Renderer* renderer, SDL_Rect rect, SDL_Color color)
 {
     // Save defaults
     Uint8 r, g, b, a;
-    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    RenderCommands::GetDrawColor(renderer, &r, &g, &b, &a);
 
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-    SDL_RenderFillRect(renderer, &rect);
+    RenderCommands::SetDrawColor(renderer, color.r, color.g, color.b, color.a);
+    RenderCommands::FillRect(renderer, &rect);
 
     // Restore defaults
-    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    RenderCommands::SetDrawColor(renderer, r, g, b, a);
 }
 
 void SplitStringIntoVector(std::string str, std::vector<std::string>& vec)
@@ -131,7 +132,7 @@ ConsoleText::~ConsoleText()
 {
     if (_texture != NULL)
     {
-        SDL_DestroyTexture(_texture);
+        RenderCommands::DestroyTexture(_texture);
         _texture = NULL;
     }
 }
@@ -153,7 +154,7 @@ void ConsoleText::Render(SDL_Renderer* renderer, int16_t startX, int16_t startY)
 
     SDL_Rect screenRect = { _renderRect.x - startX, _renderRect.y - startY, _renderRect.w, _renderRect.h };
     //PrintRect(screenRect, "ScreenRect");
-    SDL_RenderCopy(renderer, _texture, NULL, &screenRect);
+    RenderCommands::Copy(renderer, _texture, NULL, &screenRect);
 }
 
 //#####################################################################
@@ -331,7 +332,7 @@ Console::Console(const ConsoleConfig* const pConsoleConfig, SDL_Renderer* pRende
     int windowWidth, windowHeight;
     float scaleX, scaleY;
     SDL_GetWindowSize(m_pWindow, &windowWidth, &windowHeight);
-    SDL_RenderGetScale(pRenderer, &scaleX, &scaleY);
+    RenderCommands::GetScale(pRenderer, &scaleX, &scaleY);
 
     windowWidth = (int)(windowWidth / scaleX);
     windowHeight = (int)(windowHeight / scaleY);
@@ -363,7 +364,7 @@ Console::~Console()
     _consoleTextLines.clear();
     if (_backgroundTexture != NULL)
     {
-        SDL_DestroyTexture(_backgroundTexture);
+        RenderCommands::DestroyTexture(_backgroundTexture);
         _backgroundTexture = NULL;
     }
     if (_font) {
@@ -592,7 +593,7 @@ void Console::RenderBackground(SDL_Renderer* renderer)
                 SDL_Rect srcTextureRect = { 0, 0, w, h };
                 SDL_Rect dstRect = { coordX, coordY - (int16_t)_animationOffsetY, w, h };
 
-                SDL_RenderCopy(renderer, _backgroundTexture, &srcTextureRect, &dstRect);
+                RenderCommands::Copy(renderer, _backgroundTexture, &srcTextureRect, &dstRect);
             }
         }
     }
@@ -4,6 +4,7 @@
 #include "../Scene/SceneNodes.h"
 #include "../Resource/Loaders/PidLoader.h"
 #include "../Graphics2D/Image.h"
+#include "../Graphics2D/RenderCommands.h"
 #include "../UserInterface/HumanView.h"
 
 #include <SDL2/SDL_ttf.h>
@@ -28,8 +29,14 @@
 ScreenElementHUD::ScreenElementHUD()
     :
     m_IsVisible(true),
+    m_pNumberLayer(NULL),
+    m_NumberLayerWidth(0),
+    m_NumberLayerHeight(0),
+    m_bIsNumberLayerSupported(false),
+    m_bIsNumberLayerValid(false),
     m_pFPSTexture(NULL),
     m_pPositionTexture(NULL),
+    m_LastFPS(0),
     m_pBossBarTexture(NULL)
 {
     IEventMgr::Get()->VAddListener(MakeDelegate(this, &ScreenElementHUD::BossHealthChangedDelegate), EventData_Boss_Health_Changed::sk_EventType);
@@ -43,9 +50,10 @@ ScreenElementHUD::~ScreenElementHUD()
 
     m_HUDElementsMap.clear();
 
-    SDL_DestroyTexture(m_pFPSTexture);
-    SDL_DestroyTexture(m_pPositionTexture);
-    SDL_DestroyTexture(m_pBossBarTexture);
+    RenderCommands::DestroyTexture(m_pNumberLayer);
+    RenderCommands::DestroyTexture(m_pFPSTexture);
+    RenderCommands::DestroyTexture(m_pPositionTexture);
+    RenderCommands::DestroyTexture(m_pBossBarTexture);
 }
 
 bool ScreenElementHUD::Initialize(SDL_Renderer* pRenderer, shared_ptr<CameraNode> pCamera)
@@ -53,29 +61,16 @@ bool ScreenElementHUD::Initialize(SDL_Renderer* pRenderer, shared_ptr<CameraNode
     m_pRenderer = pRenderer;
     m_pCamera = pCamera;
 
-    for (uint32 i = 0; i < SCORE_NUMBERS_COUNT; i++)
-    {
-        m_ScoreNumbers[i] = PidResourceLoader::LoadAndReturnImage("/game/images/interface/scorenumbers/000.pid", g_pApp->GetCurrentPalette());
-    }
-
-    for (uint32 i = 0; i < STOPWATCH_NUMBERS_COUNT; i++)
-    {
-        m_StopwatchNumbers[i] = PidResourceLoader::LoadAndReturnImage("/game/images/interface/scorenumbers/000.pid", g_pApp->GetCurrentPalette());
-    }
+    InitNumberField(HUDNumberField_Score, SCORE_NUMBERS_COUNT, "/game/images/interface/scorenumbers/000.pid");
+    InitNumberField(HUDNumberField_Stopwatch, STOPWATCH_NUMBERS_COUNT, "/game/images/interface/scorenumbers/000.pid");
+    InitNumberField(HUDNumberField_Health, HEALTH_NUMBERS_COUNT, "/game/images/interface/healthnumbers/000.pid");
+    InitNumberField(HUDNumberField_Ammo, AMMO_NUMBERS_COUNT, "/game/images/interface/smallnumbers/000.pid");
+    InitNumberField(HUDNumberField_Lives, LIVES_NUMBERS_COUNT, "/game/images/interface/smallnumbers/000.pid");
 
-    for (uint32 i = 0; i < HEALTH_NUMBERS_COUNT; i++)
+    m_bIsNumberLayerSupported = SDL_RenderTargetSupported(pRenderer) == SDL_TRUE;
+    if (!m_bIsNumberLayerSupported)
     {
-        m_HealthNumbers[i] = PidResourceLoader::LoadAndReturnImage("/game/images/interface/healthnumbers/000.pid", g_pApp->GetCurrentPalette());
-    }
-
-    for (uint32 i = 0; i < AMMO_NUMBERS_COUNT; i++)
-    {
-        m_AmmoNumbers[i] = PidResourceLoader::LoadAndReturnImage("/game/images/interface/smallnumbers/000.pid", g_pApp->GetCurrentPalette());
-    }
-
-    for (uint32 i = 0; i < LIVES_NUMBERS_COUNT; i++)
-    {
-        m_LivesNumbers[i] = PidResourceLoader::LoadAndReturnImage("/game/images/interface/smallnumbers/000.pid", g_pApp->GetCurrentPalette());
+        LOG_WARNING("Render targets are not supported, HUD numbers will be drawn every frame");
     }
 
     UpdateFPS(0);
@@ -85,73 +80,46 @@ bool ScreenElementHUD::Initialize(SDL_Renderer* pRenderer, shared_ptr<CameraNode
 
 void ScreenElementHUD::VOnLostDevice()
 {
-
+    // Contents of render targets are lost with the device
+    m_bIsNumberLayerValid = false;
 }
 
 void ScreenElementHUD::VOnRender(uint32 msDiff)
 {
     Point scale = g_pApp->GetScale();
-    int cameraWidth = m_pCamera->GetWidth();
+    const int layerWidth = (int)(m_pCamera->GetWidth() / scale.x);
+    const int layerHeight = (int)(m_pCamera->GetHeight() / scale.y);
 
-    if (IsElementVisible("score"))
+    for (int type = 0; type < HUDNumberField_Max; type++)
     {
-        // Render score numbers
-        for (int i = 0; i < SCORE_NUMBERS_COUNT; i++)
+        HUDNumberField& field = m_NumberFields[type];
+        bool isVisible = IsNumberFieldVisible((HUDNumberFieldType)type);
+        if (isVisible != field.isVisible)
         {
-            SDL_Rect renderRect = { 40 + i * 13, 5, m_ScoreNumbers[i]->GetWidth(), m_ScoreNumbers[i]->GetHeight() };
-            SDL_RenderCopy(m_pRenderer, m_ScoreNumbers[i]->GetTexture(), NULL, &renderRect);
+            field.isVisible = isVisible;
+            field.isDirty = true;
         }
     }
 
-    if (IsElementVisible("health"))
+    if (UpdateNumberLayer(layerWidth, layerHeight))
     {
-        // Render health numbers
-        for (int i = 0; i < HEALTH_NUMBERS_COUNT; i++)
+        // Copy only the areas with numbers, the rest of the layer is transparent
+        for (const HUDNumberField& field : m_NumberFields)
         {
-            SDL_Rect renderRect = { 
-                (int)(cameraWidth / scale.x) - 60 + i * (m_HealthNumbers[i]->GetWidth() - 0) + m_HealthNumbers[i]->GetOffsetX(),
-                2 + m_HealthNumbers[i]->GetOffsetY(),
-                m_HealthNumbers[i]->GetWidth(), 
-                m_HealthNumbers[i]->GetHeight() };
-            SDL_RenderCopy(m_pRenderer, m_HealthNumbers[i]->GetTexture(), NULL, &renderRect);
+            if (field.isVisible && field.bounds.w > 0 && field.bounds.h > 0)
+            {
+                RenderCommands::Copy(m_pRenderer, m_pNumberLayer, &field.bounds, &field.bounds);
+            }
         }
     }
-
-    if (IsElementVisible("pistol") || IsElementVisible("dynamite") || IsElementVisible("magic"))
+    else
     {
-        // Render ammo numbers
-        for (int i = 0; i < AMMO_NUMBERS_COUNT; i++)
+        for (int type = 0; type < HUDNumberField_Max; type++)
         {
-            SDL_Rect renderRect = { 
-                (int)(cameraWidth / scale.x) - 46 + i * (m_AmmoNumbers[i]->GetWidth() + m_AmmoNumbers[i]->GetOffsetX()), 
-                43 + m_AmmoNumbers[i]->GetOffsetY(), 
-                m_AmmoNumbers[i]->GetWidth(), 
-                m_AmmoNumbers[i]->GetHeight() };
-            SDL_RenderCopy(m_pRenderer, m_AmmoNumbers[i]->GetTexture(), NULL, &renderRect);
-        }
-    }
-
-    if (IsElementVisible("lives"))
-    {
-        // Render lives numbers
-        for (int i = 0; i < LIVES_NUMBERS_COUNT; i++)
-        {
-            SDL_Rect renderRect = { 
-                (int)(cameraWidth / scale.x) - 36 + i * (m_LivesNumbers[i]->GetWidth() + m_LivesNumbers[i]->GetOffsetX()),
-                71 + m_LivesNumbers[i]->GetOffsetY(),
-                m_LivesNumbers[i]->GetWidth(), 
-                m_LivesNumbers[i]->GetHeight() };
-            SDL_RenderCopy(m_pRenderer, m_LivesNumbers[i]->GetTexture(), NULL, &renderRect);
-        }
-    }
-
-    if (IsElementVisible("stopwatch"))
-    {
-        // Render stopwatch numbers
-        for (int i = 0; i < STOPWATCH_NUMBERS_COUNT; i++)
-        {
-            SDL_Rect renderRect = { 40 + i * 13, 45, m_StopwatchNumbers[i]->GetWidth(), m_StopwatchNumbers[i]->GetHeight() };
-            SDL_RenderCopy(m_pRenderer, m_StopwatchNumbers[i]->GetTexture(), NULL, &renderRect);
+            if (m_NumberFields[type].isVisible)
+            {
+                DrawNumberField((HUDNumberFieldType)type, layerWidth);
+            }
         }
     }
 
@@ -161,7 +129,7 @@ void ScreenElementHUD::VOnRender(uint32 msDiff)
         SDL_QueryTexture(m_pFPSTexture, NULL, NULL, &renderRect.w, &renderRect.h);
         renderRect.x = (int)((m_pCamera->GetWidth() / 2) / scale.x - 20);
         renderRect.y = (int)(15 / scale.y);
-        SDL_RenderCopy(m_pRenderer, m_pFPSTexture, NULL, &renderRect);
+        RenderCommands::Copy(m_pRenderer, m_pFPSTexture, NULL, &renderRect);
     }
 
     if (m_pPositionTexture)
@@ -170,7 +138,7 @@ void ScreenElementHUD::VOnRender(uint32 msDiff)
         SDL_QueryTexture(m_pPositionTexture, NULL, NULL, &renderRect.w, &renderRect.h);
         renderRect.x = (int)(m_pCamera->GetWidth() / scale.x - renderRect.w - 1);
         renderRect.y = (int)(m_pCamera->GetHeight() / scale.y - renderRect.h - 1);
-        SDL_RenderCopy(m_pRenderer, m_pPositionTexture, NULL, &renderRect);
+        RenderCommands::Copy(m_pRenderer, m_pPositionTexture, NULL, &renderRect);
     }
 
     if (m_pBossBarTexture)
@@ -187,7 +155,7 @@ void ScreenElementHUD::VOnRender(uint32 msDiff)
         SDL_QueryTexture(m_pBossBarTexture, NULL, NULL, &renderRect.w, &renderRect.h);
         renderRect.x = pos.x;
         renderRect.y = pos.y;
-        SDL_RenderCopy(m_pRenderer, m_pBossBarTexture, NULL, &renderRect);
+        RenderCommands::Copy(m_pRenderer, m_pBossBarTexture, NULL, &renderRect);
     }
 }
 
@@ -230,9 +198,234 @@ static void SetImageText(uint32 newValue, uint32 divider, shared_ptr<Image>* pFi
     }
 }
 
+void ScreenElementHUD::InitNumberField(HUDNumberFieldType type, uint32 numDigits, const char* zeroDigitPath)
+{
+    HUDNumberField& field = m_NumberFields[type];
+    field.digits.resize(numDigits);
+    for (uint32 i = 0; i < numDigits; i++)
+    {
+        field.digits[i] = PidResourceLoader::LoadAndReturnImage(zeroDigitPath, g_pApp->GetCurrentPalette());
+    }
+
+    field.value = 0;
+    field.isDirty = true;
+}
+
+void ScreenElementHUD::SetNumberFieldValue(HUDNumberFieldType type, uint32 newValue, uint32 divider, const std::string& textResourcePrefixPath)
+{
+    HUDNumberField& field = m_NumberFields[type];
+    if (newValue == field.value)
+    {
+        return;
+    }
+
+    SetImageText(newValue, divider, field.digits.data(), field.digits.size(), textResourcePrefixPath);
+    field.value = newValue;
+    field.isDirty = true;
+}
+
+bool ScreenElementHUD::IsNumberFieldVisible(HUDNumberFieldType type)
+{
+    switch (type)
+    {
+        case HUDNumberField_Score: return IsElementVisible("score");
+        case HUDNumberField_Health: return IsElementVisible("health");
+        case HUDNumberField_Ammo: return IsElementVisible("pistol") || IsElementVisible("dynamite") || IsElementVisible("magic");
+        case HUDNumberField_Lives: return IsElementVisible("lives");
+        case HUDNumberField_Stopwatch: return IsElementVisible("stopwatch");
+        default: return false;
+    }
+}
+
+SDL_Rect ScreenElementHUD::GetDigitRect(HUDNumberFieldType type, uint32 digitIdx, int layerWidth) const
+{
+    const shared_ptr<Image>& pDigit = m_NumberFields[type].digits[digitIdx];
+    const int i = (int)digitIdx;
+
+    SDL_Rect digitRect = { 0, 0, pDigit->GetWidth(), pDigit->GetHeight() };
+    switch (type)
+    {
+        case HUDNumberField_Score:
+            digitRect.x = 40 + i * 13;
+            digitRect.y = 5;
+            break;
+        case HUDNumberField_Health:
+            digitRect.x = layerWidth - 60 + i * pDigit->GetWidth() + pDigit->GetOffsetX();
+            digitRect.y = 2 + pDigit->GetOffsetY();
+            break;
+        case HUDNumberField_Ammo:
+            digitRect.x = layerWidth - 46 + i * (pDigit->GetWidth() + pDigit->GetOffsetX());
+            digitRect.y = 43 + pDigit->GetOffsetY();
+            break;
+        case HUDNumberField_Lives:
+            digitRect.x = layerWidth - 36 + i * (pDigit->GetWidth() + pDigit->GetOffsetX());
+            digitRect.y = 71 + pDigit->GetOffsetY();
+            break;
+        case HUDNumberField_Stopwatch:
+            digitRect.x = 40 + i * 13;
+            digitRect.y = 45;
+            break;
+        default:
+            break;
+    }
+
+    return digitRect;
+}
+
+void ScreenElementHUD::DrawNumberField(HUDNumberFieldType type, int layerWidth)
+{
+    HUDNumberField& field = m_NumberFields[type];
+    field.bounds = { 0, 0, 0, 0 };
+
+    for (uint32 i = 0; i < field.digits.size(); i++)
+    {
+        SDL_Rect renderRect = GetDigitRect(type, i, layerWidth);
+        RenderCommands::Copy(m_pRenderer, field.digits[i]->GetTexture(), NULL, &renderRect);
+
+        if (field.bounds.w == 0)
+        {
+            field.bounds = renderRect;
+        }
+        else
+        {
+            SDL_UnionRect(&field.bounds, &renderRect, &field.bounds);
+        }
+    }
+}
+
+bool ScreenElementHUD::UpdateNumberLayer(int layerWidth, int layerHeight)
+{
+    if (!m_bIsNumberLayerSupported)
+    {
+        return false;
+    }
+
+    if (m_pNumberLayer == NULL || m_NumberLayerWidth != layerWidth || m_NumberLayerHeight != layerHeight)
+    {
+        if (m_pNumberLayer)
+        {
+            RenderCommands::DestroyTexture(m_pNumberLayer);
+        }
+
+        RenderCommands::RunOnRenderThread([&]()
+        {
+            m_pNumberLayer = SDL_CreateTexture(m_pRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, layerWidth, layerHeight);
+            if (m_pNumberLayer == NULL)
+            {
+                LOG_WARNING("Could not create HUD number layer, numbers will be drawn every frame: " + std::string(SDL_GetError()));
+                return;
+            }
+
+            SDL_SetTextureBlendMode(m_pNumberLayer, SDL_BLENDMODE_BLEND);
+        });
+
+        if (m_pNumberLayer == NULL)
+        {
+            m_bIsNumberLayerSupported = false;
+            return false;
+        }
+        m_NumberLayerWidth = layerWidth;
+        m_NumberLayerHeight = layerHeight;
+        m_bIsNumberLayerValid = false;
+    }
+
+    if (!m_bIsNumberLayerValid)
+    {
+        for (HUDNumberField& field : m_NumberFields)
+        {
+            field.isDirty = true;
+            field.bounds = { 0, 0, 0, 0 };
+        }
+    }
+
+    // Erasing a dirty field also erases whatever it overlaps, so overlapped fields are redrawn too
+    bool isAnyDirty = false;
+    bool isDirtyChanged = true;
+    while (isDirtyChanged)
+    {
+        isDirtyChanged = false;
+        for (const HUDNumberField& dirtyField : m_NumberFields)
+        {
+            if (!dirtyField.isDirty)
+            {
+                continue;
+            }
+
+            isAnyDirty = true;
+            for (HUDNumberField& field : m_NumberFields)
+            {
+                if (!field.isDirty && SDL_HasIntersection(&dirtyField.bounds, &field.bounds))
+                {
+                    field.isDirty = true;
+                    isDirtyChanged = true;
+                }
+            }
+        }
+    }
+
+    if (!isAnyDirty)
+    {
+        return true;
+    }
+
+    SDL_Texture* pPrevTarget = RenderCommands::GetTarget(m_pRenderer);
+    if (RenderCommands::SetTarget(m_pRenderer, m_pNumberLayer) != 0)
+    {
+        LOG_WARNING("Could not render to HUD number layer, numbers will be drawn every frame: " + std::string(SDL_GetError()));
+        m_bIsNumberLayerSupported = false;
+        return false;
+    }
+
+    SDL_Color prevColor;
+    SDL_BlendMode prevBlendMode;
+    RenderCommands::GetDrawColor(m_pRenderer, &prevColor.r, &prevColor.g, &prevColor.b, &prevColor.a);
+    RenderCommands::GetDrawBlendMode(m_pRenderer, &prevBlendMode);
+
+    // Erase to fully transparent
+    RenderCommands::SetDrawBlendMode(m_pRenderer, SDL_BLENDMODE_NONE);
+    RenderCommands::SetDrawColor(m_pRenderer, 0, 0, 0, 0);
+    if (!m_bIsNumberLayerValid)
+    {
+        RenderCommands::Clear(m_pRenderer);
+        m_bIsNumberLayerValid = true;
+    }
+
+    for (HUDNumberField& field : m_NumberFields)
+    {
+        if (field.isDirty && field.bounds.w > 0 && field.bounds.h > 0)
+        {
+            RenderCommands::FillRect(m_pRenderer, &field.bounds);
+            field.bounds = { 0, 0, 0, 0 };
+        }
+    }
+
+    for (int type = 0; type < HUDNumberField_Max; type++)
+    {
+        HUDNumberField& field = m_NumberFields[type];
+        if (field.isDirty && field.isVisible)
+        {
+            DrawNumberField((HUDNumberFieldType)type, layerWidth);
+
+            // Whatever was drawn outside of the layer was discarded
+            SDL_Rect layerRect = { 0, 0, layerWidth, layerHeight };
+            if (!SDL_IntersectRect(&field.bounds, &layerRect, &field.bounds))
+            {
+                field.bounds = { 0, 0, 0, 0 };
+            }
+        }
+        field.isDirty = false;
+    }
+
+    RenderCommands::SetDrawColor(m_pRenderer, prevColor.r, prevColor.g, prevColor.b, prevColor.a);
+    RenderCommands::SetDrawBlendMode(m_pRenderer, prevBlendMode);
+    RenderCommands::SetTarget(m_pRenderer, pPrevTarget);
+
+    return true;
+}
+
 void ScreenElementHUD::UpdateScore(uint32 newScore)
 {
-    SetImageText(newScore, 10000000, m_ScoreNumbers, SCORE_NUMBERS_COUNT, "/game/images/interface/scorenumbers/00");
+    SetNumberFieldValue(HUDNumberField_Score, newScore, 10000000, "/game/images/interface/scorenumbers/00");
 }
 
 void ScreenElementHUD::UpdateHealth(uint32 newHealth)
@@ -243,7 +436,7 @@ void ScreenElementHUD::UpdateHealth(uint32 newHealth)
         newHealth = 999;
     }
 
-    SetImageText(newHealth, 100, m_HealthNumbers, HEALTH_NUMBERS_COUNT, "/game/images/interface/healthnumbers/00");
+    SetNumberFieldValue(HUDNumberField_Health, newHealth, 100, "/game/images/interface/healthnumbers/00");
 }
 
 void ScreenElementHUD::ChangeAmmoType(AmmoType newAmmoType)
@@ -259,7 +452,7 @@ void ScreenElementHUD::UpdateAmmo(uint32 newAmmo)
         newAmmo = 99;
     }
 
-    SetImageText(newAmmo, 10, m_AmmoNumbers, AMMO_NUMBERS_COUNT, "/game/images/interface/smallnumbers/00");
+    SetNumberFieldValue(HUDNumberField_Ammo, newAmmo, 10, "/game/images/interface/smallnumbers/00");
 }
 
 void ScreenElementHUD::UpdateLives(uint32 newLives)
@@ -270,19 +463,24 @@ void ScreenElementHUD::UpdateLives(uint32 newLives)
         newLives = 9;
     }
 
-    SetImageText(newLives, 1, m_LivesNumbers, LIVES_NUMBERS_COUNT, "/game/images/interface/smallnumbers/00");
+    SetNumberFieldValue(HUDNumberField_Lives, newLives, 1, "/game/images/interface/smallnumbers/00");
 }
 
 void ScreenElementHUD::UpdateStopwatchTime(uint32 newTime)
 {
-    SetImageText(newTime, 100, m_StopwatchNumbers, STOPWATCH_NUMBERS_COUNT, "/game/images/interface/scorenumbers/00");
+    SetNumberFieldValue(HUDNumberField_Stopwatch, newTime, 100, "/game/images/interface/scorenumbers/00");
 }
 
 void ScreenElementHUD::UpdateFPS(uint32 newFPS)
 {
+    if (m_pFPSTexture && newFPS == m_LastFPS && g_pApp->GetGlobalOptions()->showFps)
+    {
+        return;
+    }
+
     if (m_pFPSTexture)
     {
-        SDL_DestroyTexture(m_pFPSTexture);
+        RenderCommands::DestroyTexture(m_pFPSTexture);
         m_pFPSTexture = NULL;
     }
 
@@ -291,22 +489,22 @@ void ScreenElementHUD::UpdateFPS(uint32 newFPS)
         return;
     }
 
+    m_LastFPS = newFPS;
     std::string fpsString = "FPS: " + ToStr(newFPS);
     SDL_Surface* pFPSSurface = TTF_RenderText_Blended(g_pApp->GetConsoleFont(), fpsString.c_str(), { 255, 255, 255, 255 });
-    m_pFPSTexture = SDL_CreateTextureFromSurface(m_pRenderer, pFPSSurface);
+    m_pFPSTexture = RenderCommands::CreateTextureFromSurface(m_pRenderer, pFPSSurface);
     SDL_FreeSurface(pFPSSurface);
 }
 
 void ScreenElementHUD::UpdateCameraPosition()
 {
-    if (m_pPositionTexture)
-    {
-        SDL_DestroyTexture(m_pPositionTexture);
-        m_pPositionTexture = NULL;
-    }
-
     if (!g_pApp->GetGlobalOptions()->showPosition)
     {
+        if (m_pPositionTexture)
+        {
+            RenderCommands::DestroyTexture(m_pPositionTexture);
+            m_pPositionTexture = NULL;
+        }
         return;
     }
 
@@ -318,8 +516,21 @@ void ScreenElementHUD::UpdateCameraPosition()
     std::string positionString = "Position: [X = " + ToStr((int)cameraCenter.x) +
         ", Y = " + ToStr((int)cameraCenter.y) + "]";
 
+    // Camera stands still most of the time, do not render the same text again
+    if (m_pPositionTexture && positionString == m_LastPositionText)
+    {
+        return;
+    }
+
+    if (m_pPositionTexture)
+    {
+        RenderCommands::DestroyTexture(m_pPositionTexture);
+        m_pPositionTexture = NULL;
+    }
+
+    m_LastPositionText = positionString;
     SDL_Surface* pPositionSurface = TTF_RenderText_Blended(g_pApp->GetConsoleFont(), positionString.c_str(), { 255, 255, 255, 255 });
-    m_pPositionTexture = SDL_CreateTextureFromSurface(m_pRenderer, pPositionSurface);
+    m_pPositionTexture = RenderCommands::CreateTextureFromSurface(m_pRenderer, pPositionSurface);
     SDL_FreeSurface(pPositionSurface);
 }
 
@@ -353,7 +564,8 @@ void ScreenElementHUD::BossHealthChangedDelegate(IEventDataPtr pEvent)
 
     if (pCastEventData->GetNewHealthLeft() <= 0)
     {
-        SDL_DestroyTexture(m_pBossBarTexture);
+        RenderCommands::DestroyTexture(m_pBossBarTexture);
+        m_pBossBarTexture = NULL;
         return;
     }
 
@@ -363,7 +575,7 @@ void ScreenElementHUD::BossHealthChangedDelegate(IEventDataPtr pEvent)
 
     if (m_pBossBarTexture)
     {
-        SDL_DestroyTexture(m_pBossBarTexture);
+        RenderCommands::DestroyTexture(m_pBossBarTexture);
     }
 
     m_pBossBarTexture = Util::CreateSDLTextureRect(length, 7, COLOR_RED, m_pRenderer);
@@ -374,7 +586,7 @@ void ScreenElementHUD::BossFightEndedDelegate(IEventDataPtr pEvent)
     LOG("GOTIT!")
     if (m_pBossBarTexture)
     {
-        SDL_DestroyTexture(m_pBossBarTexture);
+        RenderCommands::DestroyTexture(m_pBossBarTexture);
         m_pBossBarTexture = NULL;
     }
 }
\ No newline at end of file
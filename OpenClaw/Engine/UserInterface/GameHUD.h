@@ -13,7 +13,38 @@ const uint32 STOPWATCH_NUMBERS_COUNT = 3;
 
 typedef std::map<std::string, shared_ptr<SDL2HUDSceneNode>> HUDElementsMap;
 
+enum HUDNumberFieldType
+{
+    HUDNumberField_Score,
+    HUDNumberField_Health,
+    HUDNumberField_Ammo,
+    HUDNumberField_Lives,
+    HUDNumberField_Stopwatch,
+    HUDNumberField_Max
+};
+
 class Image;
+
+// Digits of one number displayed in HUD. Field is drawn to the cached number layer only when its value or
+// visibility changes.
+struct HUDNumberField
+{
+    HUDNumberField()
+    {
+        value = 0;
+        isVisible = false;
+        isDirty = true;
+        bounds = { 0, 0, 0, 0 };
+    }
+
+    std::vector<shared_ptr<Image>> digits;
+    uint32 value;
+    bool isVisible;
+    bool isDirty;
+    // Area of the number layer covered when the field was last drawn
+    SDL_Rect bounds;
+};
+
 class CameraNode;
 class ScreenElementHUD : public IScreenElement
 {
@@ -54,12 +85,23 @@ private:
 
     void UpdateCameraPosition();
 
+    void InitNumberField(HUDNumberFieldType type, uint32 numDigits, const char* zeroDigitPath);
+    void SetNumberFieldValue(HUDNumberFieldType type, uint32 newValue, uint32 divider, const std::string& textResourcePrefixPath);
+    bool IsNumberFieldVisible(HUDNumberFieldType type);
+    SDL_Rect GetDigitRect(HUDNumberFieldType type, uint32 digitIdx, int layerWidth) const;
+    void DrawNumberField(HUDNumberFieldType type, int layerWidth);
+    // Returns false if number layer cannot be used and the fields have to be drawn directly
+    bool UpdateNumberLayer(int layerWidth, int layerHeight);
+
     bool m_IsVisible;
-    shared_ptr<Image> m_ScoreNumbers[SCORE_NUMBERS_COUNT];
-    shared_ptr<Image> m_HealthNumbers[HEALTH_NUMBERS_COUNT];
-    shared_ptr<Image> m_AmmoNumbers[AMMO_NUMBERS_COUNT];
-    shared_ptr<Image> m_LivesNumbers[LIVES_NUMBERS_COUNT];
-    shared_ptr<Image> m_StopwatchNumbers[STOPWATCH_NUMBERS_COUNT];
+    HUDNumberField m_NumberFields[HUDNumberField_Max];
+
+    // Render target with all number fields, blitted once per frame
+    SDL_Texture* m_pNumberLayer;
+    int m_NumberLayerWidth;
+    int m_NumberLayerHeight;
+    bool m_bIsNumberLayerSupported;
+    bool m_bIsNumberLayerValid;
 
     SDL_Renderer* m_pRenderer;
     shared_ptr<CameraNode> m_pCamera;
@@ -68,6 +110,9 @@ private:
 
     SDL_Texture* m_pFPSTexture;
     SDL_Texture* m_pPositionTexture;
+    // Text overlays are rendered again only when their text changes
+    uint32 m_LastFPS;
+    std::string m_LastPositionText;
     SDL_Texture* m_pBossBarTexture;
 };
 
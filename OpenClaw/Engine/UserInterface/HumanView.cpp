@@ -8,6 +8,7 @@
 #include "../Resource/Loaders/WavLoader.h"
 #include "../Resource/Loaders/XmlLoader.h"
 #include "../Util/PrimeSearch.h"
+#include "../Graphics2D/RenderCommands.h"
 #include "ScoreScreen/EndLevelScoreScreen.h"
 
 const uint32 g_InvalidGameViewId = 0xFFFFFFFF;
@@ -43,10 +44,7 @@ HumanView::~HumanView()
 {
     RemoveAllDelegates();
 
-    while (!m_ScreenElements.empty())
-    {
-        m_ScreenElements.pop_front();
-    }
+    m_ScreenElements.Clear();
 
     SAFE_DELETE(m_pProcessMgr);
 }
@@ -63,7 +61,7 @@ void HumanView::VOnRender(uint32 msDiff)
 {
     //PROFILE_CPU("HumanView Render");
 
-    m_CurrentTick = SDL_GetTicks();
+    m_CurrentTick = Util::GetTicks();
     if (m_CurrentTick == m_LastDraw)
     {
         return;
@@ -81,18 +79,18 @@ void HumanView::VOnRender(uint32 msDiff)
         //PROFILE_CPU(".");
 
         // If we render out of bounds, render it as black color
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        RenderCommands::SetDrawColor(renderer, 0, 0, 0, 255);
 
-        SDL_RenderClear(renderer);
+        RenderCommands::Clear(renderer);
 
-        // Sort screen elements
-        m_ScreenElements.sort(SortBy_SharedPtr_Content<IScreenElement>());
-
-        for (shared_ptr<IScreenElement>& screenElement : m_ScreenElements)
+        // Elements are kept sorted by z-order, they can be pushed or removed while rendering
+        const ScreenElementArray& renderOrder = m_ScreenElements.GetRenderOrder();
+        for (uint32 elementIdx = 0; elementIdx < renderOrder.size(); elementIdx++)
         {
-            if (screenElement->VIsVisible())
+            shared_ptr<IScreenElement> pScreenElement = renderOrder[elementIdx];
+            if (pScreenElement->VIsVisible())
             {
-                screenElement->VOnRender(msDiff);
+                pScreenElement->VOnRender(msDiff);
             }
         }
         //LOG("SCREEN ELEMENTS: " + ToStr(m_ScreenElements.size()))
@@ -103,7 +101,7 @@ void HumanView::VOnRender(uint32 msDiff)
 
         if (!m_bPostponeRenderPresent)
         {
-            SDL_RenderPresent(renderer);
+            RenderCommands::Present(renderer);
         }
     }
 }
@@ -114,9 +112,11 @@ void HumanView::VOnUpdate(uint32 msDiff)
 
     m_pConsole->OnUpdate(msDiff);
 
-    for (shared_ptr<IScreenElement> &element : m_ScreenElements)
+    const ScreenElementArray& updateOrder = m_ScreenElements.GetRenderOrder();
+    for (uint32 elementIdx = 0; elementIdx < updateOrder.size(); elementIdx++)
     {
-        element->VOnUpdate(msDiff);
+        shared_ptr<IScreenElement> pScreenElement = updateOrder[elementIdx];
+        pScreenElement->VOnUpdate(msDiff);
     }
 }
 
@@ -130,11 +130,13 @@ bool HumanView::VOnEvent(SDL_Event& evt)
     }
 
     // Then screen layers in reverse order
-    for (ScreenElementList::reverse_iterator i = m_ScreenElements.rbegin(); i != m_ScreenElements.rend(); ++i)
+    const ScreenElementArray& inputOrder = m_ScreenElements.GetInputOrder();
+    for (uint32 elementIdx = 0; elementIdx < inputOrder.size(); elementIdx++)
     {
-        if ((*i)->VIsVisible())
+        shared_ptr<IScreenElement> pScreenElement = inputOrder[elementIdx];
+        if (pScreenElement->VIsVisible())
         {
-            if ((*i)->VOnEvent(evt))
+            if (pScreenElement->VOnEvent(evt))
             {
                 return true;
             }
@@ -201,7 +203,12 @@ bool HumanView::VOnEvent(SDL_Event& evt)
 
 void HumanView::VOnLostDevice()
 {
-
+    const ScreenElementArray& renderOrder = m_ScreenElements.GetRenderOrder();
+    for (uint32 elementIdx = 0; elementIdx < renderOrder.size(); elementIdx++)
+    {
+        shared_ptr<IScreenElement> pScreenElement = renderOrder[elementIdx];
+        pScreenElement->VOnLostDevice();
+    }
 }
 
 bool HumanView::EnterMenu(TiXmlElement* pMenuData)
@@ -216,7 +223,7 @@ bool HumanView::EnterMenu(TiXmlElement* pMenuData)
         }
     }
 
-    m_ScreenElements.clear();
+    m_ScreenElements.Clear();
     VPushElement(m_pMenu);
 
     return true;
@@ -224,7 +231,7 @@ bool HumanView::EnterMenu(TiXmlElement* pMenuData)
 
 void HumanView::LoadScoreScreen(TiXmlElement* pScoreScreenRootElem)
 {
-    m_ScreenElements.clear();
+    m_ScreenElements.Clear();
     m_pScene.reset();
     m_pHUD.reset();
 
@@ -242,7 +249,7 @@ void HumanView::LoadScoreScreen(TiXmlElement* pScoreScreenRootElem)
         LOG("Score screen initialized OK");
         pScoreScreen->SetCamera(m_pCamera);
         VPushElement(pScoreScreen);
-        assert(m_ScreenElements.size() == 1);
+        assert(m_ScreenElements.GetCount() == 1);
     }
     else
     {
@@ -270,12 +277,12 @@ bool HumanView::LoadGame(TiXmlElement* pLevelXmlElem, LevelData* pLevelData)
 
 void HumanView::VPushElement(shared_ptr<IScreenElement> element)
 {
-    m_ScreenElements.push_front(element);
+    m_ScreenElements.Push(element);
 }
 
 void HumanView::VRemoveElement(shared_ptr<IScreenElement> element)
 {
-    m_ScreenElements.remove(element);
+    m_ScreenElements.Remove(element);
 }
 
 void HumanView::VSetCameraOffset(int32 offsetX, int32 offsetY)
@@ -546,6 +553,8 @@ void HumanView::PowerupUpdatedStatusDelegate(IEventDataPtr pEventData)
 // Music has only 1 channel as far as I know so setting volume for music globally should be fine
 void HumanView::RequestPlaySoundDelegate(IEventDataPtr pEventData)
 {
+    TRACK_ALLOCATIONS(AllocTag_Audio);
+
     shared_ptr<EventData_Request_Play_Sound> pCastEventData = static_pointer_cast<EventData_Request_Play_Sound>(pEventData);
     if (pCastEventData)
     {
@@ -658,7 +667,7 @@ void HumanView::RequestResetLevelDelegate(IEventDataPtr pEventData)
         static_pointer_cast<EventData_Request_Reset_Level>(pEventData);
 
     // Reset Graphical representation of level
-    m_ScreenElements.clear();
+    m_ScreenElements.Clear();
 
     m_pScene.reset(new ScreenElementScene(g_pApp->GetRenderer()));
     //m_pCamera.reset(new CameraNode(Point(0, 0), 0, 0));
@@ -682,7 +691,7 @@ void HumanView::LoadGameDelegate(IEventDataPtr pEventData)
         int checkpointNumber = pCastEventData->GetCheckpointNumber();
 
         // Reset Graphical representation of level
-        m_ScreenElements.clear();
+        m_ScreenElements.Clear();
         m_pMenu.reset();
         m_pScene.reset(new ScreenElementScene(g_pApp->GetRenderer()));
         m_pHUD.reset(new ScreenElementHUD());
@@ -712,7 +721,7 @@ void HumanView::EnterMenuDelegate(IEventDataPtr pEventData)
         return;
     }
 
-    m_ScreenElements.clear();
+    m_ScreenElements.Clear();
     m_pScene.reset(new ScreenElementScene(g_pApp->GetRenderer()));
     m_pHUD.reset();
     m_pIngameMenu.reset();
@@ -863,15 +872,22 @@ void HumanView::ClawDiedDelegate(IEventDataPtr pEventData)
         shared_ptr<ScreenElementMenu> pGameOverMenu(new ScreenElementMenu(g_pApp->GetRenderer()));
         DO_AND_CHECK(pGameOverMenu->Initialize(pXmlGameOverMenuRoot));
 
-        m_ScreenElements.push_back(pGameOverMenu);
+        m_ScreenElements.PushOnTop(pGameOverMenu);
         pGameOverMenu->VSetVisible(true);
 
         IEventMgr::Get()->VAbortAllEvents();
     }
     else
     {
+        ScreenFadeDef fadeDef;
+        fadeDef.fadeInDuration = 1450;
+        fadeDef.fadeOutDuration = 1450;
+        fadeDef.closingEdges = ScreenEdge_All;
+        fadeDef.fadeInSound = SOUND_GAME_DEATH_FADE_IN_SOUND;
+        fadeDef.fadeOutSound = SOUND_GAME_DEATH_FADE_OUT_SOUND;
+
         StrongProcessPtr pDeathProcess(
-            new DeathFadeInOutProcess(pCastEventData->GetDeathPosition(), 1450, 1450, 0, 0));
+            new DeathFadeInOutProcess(pCastEventData->GetDeathPosition(), fadeDef));
         m_pProcessMgr->AttachProcess(pDeathProcess);
         // Needs to be called here
         pDeathProcess->VOnInit();
@@ -885,8 +901,13 @@ void HumanView::TeleportActorDelegate(IEventDataPtr pEventData)
 
     if (pCastEventData->GetHasScreenSfx())
     {
+        ScreenFadeDef fadeDef;
+        fadeDef.fadeInDuration = 1150;
+        fadeDef.fadeOutDuration = 1150;
+        fadeDef.closingEdges = ScreenEdge_Horizontal;
+
         StrongProcessPtr pTeleportSfxProcess(
-            new TeleportFadeInOutProcess(1150, 1150));
+            new TeleportFadeInOutProcess(fadeDef));
         m_pProcessMgr->AttachProcess(pTeleportSfxProcess);
         // Needs to be called here
         pTeleportSfxProcess->VOnInit();
@@ -917,189 +938,6 @@ void SpecialEffectProcess::VRestoreStates()
     }
 }
 
-//=================================================================================================
-// 
-// class DeathFadeInOutProcess
-//
-//=================================================================================================
-
-DeathFadeInOutProcess::DeathFadeInOutProcess(Point epicenter, int fadeInDuration, int fadeOutDuration, int startDelay, int endDelay)
-    :
-    SpecialEffectProcess(),
-    m_Epicenter(epicenter),
-    m_FadeInDuration(fadeInDuration),
-    m_FadeOutDuration(fadeOutDuration),
-    m_StartDelay(startDelay),
-    m_EndDelay(endDelay),
-    m_DeathFadeState(DeathFadeState_Started),
-    m_CurrentTime(0)
-{
-    m_Epicenter.Set(epicenter.x, epicenter.y);
-}
-
-DeathFadeInOutProcess::~DeathFadeInOutProcess()
-{
-
-}
-
-void DeathFadeInOutProcess::VOnInit()
-{
-    Process::VOnInit();
-
-    assert(g_pApp);
-    assert(g_pApp->GetGameLogic());
-    assert(g_pApp->GetHumanView());
-    assert(g_pApp->GetHumanView()->GetCamera());
-
-    // Recalc epicenter to screen-local coordinates
-    Point windowSize = g_pApp->GetWindowSizeScaled();
-    shared_ptr<CameraNode> pCamera = g_pApp->GetHumanView()->GetCamera();
-    Point cameraPos = pCamera->GetPosition();
-
-    m_Epicenter.Set(m_Epicenter.x - cameraPos.x, m_Epicenter.y - cameraPos.y);
-
-    // Apply scale
-    Point scale = g_pApp->GetScale();
-    m_Epicenter.Set(m_Epicenter.x / scale.x, m_Epicenter.y / scale.y);
-
-    // Stop game logic update during fade in/out
-    g_pApp->GetGameLogic()->SetRunning(false);
-
-    // Also we will render as we want to
-    g_pApp->GetHumanView()->SetRendering(false);
-    g_pApp->GetHumanView()->SetPostponeRenderPresent(true);
-
-    // Calculate graphics fade speed
-    m_FadeInSpeed.x = (windowSize.x / (double)m_FadeInDuration) / 2.0;
-    m_FadeInSpeed.y = (windowSize.y / (double)m_FadeInDuration) / 2.0;
-
-    m_FadeOutSpeed.x = (windowSize.x / (double)m_FadeOutDuration) / 2.0;
-    m_FadeOutSpeed.y = (windowSize.y / (double)m_FadeOutDuration) / 2.0;
-}
-
-void DeathFadeInOutProcess::VOnUpdate(uint32 msDiff)
-{
-    m_CurrentTime += msDiff;
-
-    switch (m_DeathFadeState)
-    {
-        case DeathFadeState_Started:
-        {
-            if (m_CurrentTime >= m_StartDelay)
-            {
-                SoundInfo soundInfo(SOUND_GAME_DEATH_FADE_IN_SOUND);
-                IEventMgr::Get()->VTriggerEvent(IEventDataPtr(
-                    new EventData_Request_Play_Sound(soundInfo)));
-
-                m_CurrentTime = 0;
-                m_DeathFadeState = DeathFadeState_FadingIn;
-            }
-            break;
-        }
-
-        case DeathFadeState_FadingIn:
-        {
-            if (m_CurrentTime >= m_FadeInDuration)
-            {
-                SoundInfo soundInfo(SOUND_GAME_DEATH_FADE_OUT_SOUND);
-                IEventMgr::Get()->VTriggerEvent(IEventDataPtr(
-                    new EventData_Request_Play_Sound(soundInfo)));
-
-                g_pApp->GetHumanView()->SetRendering(true);
-                m_CurrentTime = 0;
-                m_DeathFadeState = DeathFadeState_FadingOut;
-            }
-            break;
-        }
-
-        case DeathFadeState_FadingOut:
-        {
-            if (m_CurrentTime >= m_FadeOutDuration)
-            {
-                m_CurrentTime = 0;
-                m_DeathFadeState = DeathFadeState_Ended;
-            }
-            break;
-        }
-
-        case DeathFadeState_Ended:
-        {
-            if (m_CurrentTime >= m_EndDelay)
-            {
-                Succeed();
-
-                // This should not be here, since it does not know that Claw died here...
-                StrongActorPtr pClaw = g_pApp->GetGameLogic()->GetClawActor();
-                assert(pClaw != nullptr);
-
-                IEventMgr::Get()->VQueueEvent(IEventDataPtr(new EventData_Claw_Respawned(pClaw->GetGUID())));
-            }
-            break;
-        }
-        default:
-            LOG_ERROR("Unknown DeathFadeState: " + ToStr((int)m_DeathFadeState));
-            break;
-    }
-
-    //LOG("State: " + ToStr((int)m_DeathFadeState));
-
-    VRender(msDiff);
-}
-
-void DeathFadeInOutProcess::VRender(uint32 msDiff)
-{
-    SDL_Renderer* pRenderer = g_pApp->GetRenderer();
-
-    Point windowSize = g_pApp->GetWindowSizeScaled();
-    
-    /*g_pApp->GetHumanView()->SetRendering(true);
-    g_pApp->GetHumanView()->VOnRender(msDiff);
-    g_pApp->GetHumanView()->SetRendering(false);*/
-
-    // Render fade in/outs according to current state
-    int referenceTime = 0;
-    Point *fadeSpeed = &m_FadeInSpeed;
-    if (m_DeathFadeState == DeathFadeState_FadingIn)
-    {
-        referenceTime = m_CurrentTime;
-    }
-    else if (m_DeathFadeState == DeathFadeState_FadingOut)
-    {
-        referenceTime = m_FadeOutDuration - m_CurrentTime;
-        fadeSpeed = &m_FadeOutSpeed;
-    }
-
-    // Left -> right rect
-    int currentWidth = (int)((double)referenceTime * fadeSpeed->x);
-    //LOG("Current width: " + ToStr(currentWidth));
-    SDL_Rect leftRect = { 0, 0, currentWidth, (int)windowSize.y };
-    SDL_Texture* pLeftRectTexture = Util::CreateSDLTextureRect(leftRect.w, leftRect.h, COLOR_BLACK, pRenderer);
-    SDL_RenderCopy(pRenderer, pLeftRectTexture, NULL, &leftRect);
-
-    // Right -> left rect
-    SDL_Rect rightRect = { (int)windowSize.x - currentWidth , 0, currentWidth, (int)windowSize.y };
-    SDL_Texture* pRightRectTexture = Util::CreateSDLTextureRect(rightRect.w, rightRect.h, COLOR_BLACK, pRenderer);
-    SDL_RenderCopy(pRenderer, pRightRectTexture, NULL, &rightRect);
-
-    int currentHeight = (int)((double)referenceTime * fadeSpeed->y);
-    // Top -> Down
-    SDL_Rect topRect = { 0, 0, (int)windowSize.x, currentHeight };
-    SDL_Texture* pTopTexture = Util::CreateSDLTextureRect(topRect.w, topRect.h, COLOR_BLACK, pRenderer);
-    SDL_RenderCopy(pRenderer, pTopTexture, NULL, &topRect);
-
-    // Down -> Top
-    SDL_Rect bottomRect = { 0, (int)windowSize.y - currentHeight, (int)windowSize.x, currentHeight };
-    SDL_Texture* pBottomTexture = Util::CreateSDLTextureRect(bottomRect.w, bottomRect.h, COLOR_BLACK, pRenderer);
-    SDL_RenderCopy(pRenderer, pBottomTexture, NULL, &bottomRect);
-
-    SDL_DestroyTexture(pLeftRectTexture);
-    SDL_DestroyTexture(pRightRectTexture);
-    SDL_DestroyTexture(pTopTexture);
-    SDL_DestroyTexture(pBottomTexture);
-
-    Util::RenderForcePresent(pRenderer);
-}
-
 //=================================================================================================
 // 
 // class FadingLine - helper that represents line on the screen that is fading in or out
@@ -1120,17 +958,7 @@ FadingLine::FadingLine(int length, Point fragmentSize, int fadeDelay, int fadeDu
     m_FragmentCount(0)
 {
     m_FragmentCount = (length / (int)fragmentSize.x) + 1;
-    m_SingleFragmentFadeTime = fadeDuration / m_FragmentCount;
-    m_pPrimeSearch.reset(new PrimeSearch(m_FragmentCount));
-
-    for (int fragIdx = 0; fragIdx < m_FragmentCount; fragIdx++)
-    {
-        m_FadedFragments.push_back(!m_bIsFadingIn);
-    }
-
-    LOG("length: " + ToStr(m_Length) + ", fadeDelay: " + ToStr(m_FadeDelay) + 
-        ", fadeDuration: " + ToStr(m_FadeDuration) + ", fragmentCount: " + ToStr(m_FragmentCount) + 
-        ", isFadingIn: " + ToStr(m_bIsFadingIn));
+    Reset(fadeDelay, fadeDuration, isFadingIn);
 }
 
 FadingLine::~FadingLine()
@@ -1151,9 +979,7 @@ void FadingLine::Update(uint32 msDiff)
         if (m_CurrentTime >= m_FadeDelay)
         {
             m_bIsActive = true;
-            //m_CurrentTime = m_CurrentTime - m_FadeDelay;
-            LOG("Activated");
-            m_CurrentTime = 0;
+            m_CurrentTime -= m_FadeDelay;
         }
         else
         {
@@ -1161,11 +987,10 @@ void FadingLine::Update(uint32 msDiff)
         }
     }
 
-    if (m_CurrentTime >= m_SingleFragmentFadeTime)
+    // Fragments can fade faster than frames go, fade all of them which should have faded by now
+    while (m_CurrentTime >= m_SingleFragmentFadeTime)
     {
-        // TODO: Handle possible overflow
-        //m_CurrentTime -= m_SingleFragmentFadeTime;
-        m_CurrentTime = 0;
+        m_CurrentTime -= m_SingleFragmentFadeTime;
         int fadedElemIdx = m_pPrimeSearch->GetNext();
         if (fadedElemIdx == -1)
         {
@@ -1177,204 +1002,300 @@ void FadingLine::Update(uint32 msDiff)
     }
 }
 
-void FadingLine::Reset(int fadeDelay, bool isFadingIn)
+void FadingLine::Reset(int fadeDelay, int fadeDuration, bool isFadingIn)
 {
     m_bIsActive = false;
     m_bIsDone = false;
     m_bIsFadingIn = isFadingIn;
     m_FadeDelay = fadeDelay;
+    m_FadeDuration = fadeDuration;
+    m_CurrentTime = 0;
+    m_SingleFragmentFadeTime = fadeDuration / m_FragmentCount;
 
-    m_FadedFragments.clear();
-    for (int fragIdx = 0; fragIdx < m_FragmentCount; fragIdx++)
-    {
-        m_FadedFragments.push_back(!m_bIsFadingIn);
-    }
+    m_FadedFragments.assign(m_FragmentCount, !m_bIsFadingIn);
 
     m_pPrimeSearch.reset(new PrimeSearch(m_FragmentCount));
 }
 
-void FadingLine::Render(SDL_Renderer* pRenderer, SDL_Texture* pFragmentTexture, Point& lineOffset, bool asRow)
+void FadingLine::Render(ScreenEffectBatch& batch, const Point& lineOffset, bool asRow)
 {
-    assert(pRenderer != NULL);
-    assert(pFragmentTexture != NULL);
+    const int fragmentWidth = (int)m_FragmentSize.x;
+    const int fragmentHeight = (int)m_FragmentSize.y;
 
-    int fragIdx = 0;
-    for (bool shouldRender : m_FadedFragments)
+    for (int fragIdx = 0; fragIdx < m_FragmentCount; fragIdx++)
     {
-        if (!shouldRender)
+        if (!m_FadedFragments[fragIdx])
         {
-            fragIdx++;
-            //LOG("Should NOT render");
             continue;
         }
-        else
-        {
-            //LOG("Should render")
-        }
 
-        SDL_Rect renderRect;
-        renderRect.w = (int)m_FragmentSize.x;
-        renderRect.y = (int)m_FragmentSize.y;
         if (asRow)
         {
-            renderRect.x = (int)lineOffset.x + fragIdx * (int)m_FragmentSize.x;
-            renderRect.y = (int)lineOffset.y;
+            batch.AddQuad((int)lineOffset.x + fragIdx * fragmentWidth, (int)lineOffset.y, fragmentWidth, fragmentHeight);
         }
         else
         {
-            renderRect.x = (int)lineOffset.x;
-            renderRect.y = (int)lineOffset.y + fragIdx * (int)m_FragmentSize.y;
+            batch.AddQuad((int)lineOffset.x, (int)lineOffset.y + fragIdx * fragmentHeight, fragmentWidth, fragmentHeight);
         }
-
-        SDL_RenderCopy(pRenderer, pFragmentTexture, NULL, &renderRect);
-
-        fragIdx++;
     }
 }
 
 //=================================================================================================
 // 
-// class TeleportFadeInOutProcess
+// class ScreenFadeProcess
 //
 //=================================================================================================
 
-TeleportFadeInOutProcess::TeleportFadeInOutProcess(int fadeInDuration, int fadeOutDuration)
+ScreenFadeProcess::ScreenFadeProcess(const ScreenFadeDef& fadeDef)
     :
     SpecialEffectProcess(),
-    m_FadeInDuration(fadeInDuration),
-    m_FadeOutDuration(fadeOutDuration),
-    m_TeleportState(TeleportState_FadingIn),
+    m_FadeDef(fadeDef),
+    m_FadeState(ScreenFadeState_Started),
     m_CurrentTime(0)
 {
 }
 
-TeleportFadeInOutProcess::~TeleportFadeInOutProcess()
+ScreenFadeProcess::~ScreenFadeProcess()
 {
 
 }
 
-void TeleportFadeInOutProcess::VOnInit()
+void ScreenFadeProcess::VOnInit()
 {
     SpecialEffectProcess::VOnInit();
 
     assert(g_pApp);
     assert(g_pApp->GetGameLogic());
     assert(g_pApp->GetHumanView());
-    assert(g_pApp->GetHumanView()->GetCamera());
 
     // Stop game logic update during fade in/out
     g_pApp->GetGameLogic()->SetRunning(false);
-    g_pApp->GetHumanView()->SetPostponeRenderPresent(true);
+
+    // Also we will render as we want to
     g_pApp->GetHumanView()->SetRendering(false);
+    g_pApp->GetHumanView()->SetPostponeRenderPresent(true);
+
+    if (m_FadeDef.fragmentSize.x > 0 && m_FadeDef.fragmentSize.y > 0)
+    {
+        CreateFadingLines();
+    }
+
+    if (m_FadeDef.startDelay <= 0)
+    {
+        EnterState(ScreenFadeState_FadingIn);
+    }
+}
 
+// Every line fades over half of the duration, start of the lines is spread over the other half
+static int GetLineFadeDelay(int lineIdx, int numLines, int duration)
+{
+    return (duration / 2) * lineIdx / numLines;
+}
+
+void ScreenFadeProcess::CreateFadingLines()
+{
     Point windowSize = g_pApp->GetWindowSizeScaled();
 
-    // Calculate graphics fade speed
-    m_FadeInSpeed.x = (windowSize.x / (double)m_FadeInDuration) / 2.0;
-    m_FadeInSpeed.y = (windowSize.y / (double)m_FadeInDuration) / 2.0;
+    int numLines = (int)(windowSize.y / m_FadeDef.fragmentSize.y) + 1;
+    for (int lineIdx = 0; lineIdx < numLines; lineIdx++)
+    {
+        int fadeDelay = GetLineFadeDelay(lineIdx, numLines, m_FadeDef.fadeInDuration);
+        shared_ptr<FadingLine> pLine(new FadingLine(
+            (int)windowSize.x, m_FadeDef.fragmentSize, fadeDelay, m_FadeDef.fadeInDuration / 2, true));
+        m_Lines.push_back(pLine);
+    }
+}
 
-    m_FadeOutSpeed.x = (windowSize.x / (double)m_FadeOutDuration) / 2.0;
-    m_FadeOutSpeed.y = (windowSize.y / (double)m_FadeOutDuration) / 2.0;
+void ScreenFadeProcess::EnterState(ScreenFadeState state)
+{
+    m_FadeState = state;
+    m_CurrentTime = 0;
 
-    /*m_FragmentSize.Set(8, 8);
+    std::string sound;
+    if (state == ScreenFadeState_FadingIn)
+    {
+        sound = m_FadeDef.fadeInSound;
+    }
+    else if (state == ScreenFadeState_FadingOut)
+    {
+        sound = m_FadeDef.fadeOutSound;
 
-    m_pFadingTexture = Util::CreateSDLTextureRect(
-        (int)m_FragmentSize.x, (int)m_FragmentSize.y, COLOR_BLACK, g_pApp->GetRenderer());
-    assert(m_pFadingTexture != NULL);
-    if (m_pFadingTexture == NULL)
+        int numLines = m_Lines.size();
+        for (int lineIdx = 0; lineIdx < numLines; lineIdx++)
+        {
+            int fadeDelay = GetLineFadeDelay(lineIdx, numLines, m_FadeDef.fadeOutDuration);
+            m_Lines[lineIdx]->Reset(fadeDelay, m_FadeDef.fadeOutDuration / 2, false);
+        }
+    }
+    else if (state == ScreenFadeState_Ended && m_FadeDef.endDelay <= 0)
     {
-        LOG_ERROR("Could not create fading texture for TeleportFadeInOutProcess");
-       Fail();
+        Succeed();
     }
 
-    int numLines = (int)(windowSize.y / m_FragmentSize.y);
-    int msPerLine = (m_FadeInDuration / numLines) + 1;
-    for (int lineIdx = 0; lineIdx < numLines; lineIdx++)
+    if (!sound.empty())
     {
-        int fadeDelay = (m_FadeInDuration - (lineIdx * msPerLine)) / 2;
-        LOG("FadeDelay: " + ToStr(fadeDelay));
-        shared_ptr<FadingLine> pLine(new FadingLine((int)windowSize.x, m_FragmentSize, fadeDelay, msPerLine, true));
-        m_Lines.push_back(pLine);
-    }*/
+        SoundInfo soundInfo(sound);
+        IEventMgr::Get()->VTriggerEvent(IEventDataPtr(
+            new EventData_Request_Play_Sound(soundInfo)));
+    }
 }
 
-void TeleportFadeInOutProcess::VOnUpdate(uint32 msDiff)
+void ScreenFadeProcess::VOnUpdate(uint32 msDiff)
 {
     m_CurrentTime += msDiff;
 
-    switch (m_TeleportState)
+    switch (m_FadeState)
     {
-        case TeleportState_FadingIn:
-            /*for (shared_ptr<FadingLine> pLine : m_Lines)
+        case ScreenFadeState_Started:
+        {
+            if (m_CurrentTime >= m_FadeDef.startDelay)
             {
-                pLine->Update(msDiff);
-            }*/
+                EnterState(ScreenFadeState_FadingIn);
+            }
+            break;
+        }
 
-            if (m_CurrentTime >= m_FadeInDuration)
+        case ScreenFadeState_FadingIn:
+        {
+            if (m_CurrentTime >= m_FadeDef.fadeInDuration)
             {
-                m_CurrentTime = 0;
-                m_TeleportState = TeleportState_FadingOut;
+                // Screen is covered, game is rendered again while it is being uncovered
                 g_pApp->GetHumanView()->SetRendering(true);
+                EnterState(ScreenFadeState_FadingOut);
+            }
+            break;
+        }
 
-                /*for (shared_ptr<FadingLine> pLine : m_Lines)
-                {
-                    pLine->Reset(false);
-                }*/
-
-                //Succeed();
+        case ScreenFadeState_FadingOut:
+        {
+            if (m_CurrentTime >= m_FadeDef.fadeOutDuration)
+            {
+                EnterState(ScreenFadeState_Ended);
             }
             break;
+        }
 
-        case TeleportState_FadingOut:
-            if (m_CurrentTime >= m_FadeOutDuration)
+        case ScreenFadeState_Ended:
+        {
+            if (m_CurrentTime >= m_FadeDef.endDelay)
             {
                 Succeed();
             }
             break;
+        }
 
         default:
-            LOG_ERROR("Unknown TeleportState: " + ToStr((int)m_TeleportState));
+            LOG_ERROR("Unknown ScreenFadeState: " + ToStr((int)m_FadeState));
             break;
     }
 
+    if (m_FadeState == ScreenFadeState_FadingIn || m_FadeState == ScreenFadeState_FadingOut)
+    {
+        for (shared_ptr<FadingLine> pLine : m_Lines)
+        {
+            pLine->Update(msDiff);
+        }
+    }
+
     VRender(msDiff);
 }
 
-void TeleportFadeInOutProcess::VRender(uint32 msDiff)
+void ScreenFadeProcess::VRender(uint32 msDiff)
 {
     SDL_Renderer* pRenderer = g_pApp->GetRenderer();
 
     Point windowSize = g_pApp->GetWindowSizeScaled();
 
-    // Render fade in/outs according to current state
-    int referenceTime = 0;
-    Point *fadeSpeed = &m_FadeInSpeed;
-    if (m_TeleportState == TeleportState_FadingIn)
+    m_Batch.Clear();
+    if (!m_Lines.empty())
     {
-        referenceTime = m_CurrentTime;
+        Point lineOffset(0, 0);
+        for (shared_ptr<FadingLine> pLine : m_Lines)
+        {
+            pLine->Render(m_Batch, lineOffset, true);
+            lineOffset.y += m_FadeDef.fragmentSize.y;
+        }
     }
-    else if (m_TeleportState == TeleportState_FadingOut)
+    else
     {
-        referenceTime = m_FadeOutDuration - m_CurrentTime;
-        fadeSpeed = &m_FadeOutSpeed;
+        // Render fade in/outs according to current state
+        double coverage = 0.0;
+        if (m_FadeState == ScreenFadeState_FadingIn && m_FadeDef.fadeInDuration > 0)
+        {
+            coverage = (double)m_CurrentTime / m_FadeDef.fadeInDuration;
+        }
+        else if (m_FadeState == ScreenFadeState_FadingOut && m_FadeDef.fadeOutDuration > 0)
+        {
+            coverage = 1.0 - (double)m_CurrentTime / m_FadeDef.fadeOutDuration;
+        }
+
+        m_Batch.AddClosingEdges(windowSize, m_FadeDef.closingEdges, coverage);
     }
 
-    referenceTime = max(0, referenceTime);
+    m_Batch.Render(pRenderer, m_FadeDef.color);
+
+    Util::RenderForcePresent(pRenderer);
+}
+
+//=================================================================================================
+// 
+// class DeathFadeInOutProcess
+//
+//=================================================================================================
+
+DeathFadeInOutProcess::DeathFadeInOutProcess(Point epicenter, const ScreenFadeDef& fadeDef)
+    :
+    ScreenFadeProcess(fadeDef),
+    m_Epicenter(epicenter)
+{
+}
 
-    // Left -> right rect
-    int currentWidth = (int)((double)referenceTime * fadeSpeed->x);
-    //LOG("Current width: " + ToStr(currentWidth));
-    SDL_Rect leftRect = { 0, 0, currentWidth, (int)windowSize.y };
-    SDL_Texture* pLeftRectTexture = Util::CreateSDLTextureRect(leftRect.w, leftRect.h, COLOR_BLACK, pRenderer);
-    SDL_RenderCopy(pRenderer, pLeftRectTexture, NULL, &leftRect);
+DeathFadeInOutProcess::~DeathFadeInOutProcess()
+{
 
-    // Right -> left rect
-    SDL_Rect rightRect = { (int)windowSize.x - currentWidth, 0, currentWidth, (int)windowSize.y };
-    SDL_Texture* pRightRectTexture = Util::CreateSDLTextureRect(rightRect.w, rightRect.h, COLOR_BLACK, pRenderer);
-    SDL_RenderCopy(pRenderer, pRightRectTexture, NULL, &rightRect);
+}
 
-    SDL_DestroyTexture(pLeftRectTexture);
-    SDL_DestroyTexture(pRightRectTexture);
+void DeathFadeInOutProcess::VOnInit()
+{
+    ScreenFadeProcess::VOnInit();
+
+    assert(g_pApp->GetHumanView()->GetCamera());
+
+    // Recalc epicenter to screen-local coordinates
+    shared_ptr<CameraNode> pCamera = g_pApp->GetHumanView()->GetCamera();
+    Point cameraPos = pCamera->GetPosition();
+
+    m_Epicenter.Set(m_Epicenter.x - cameraPos.x, m_Epicenter.y - cameraPos.y);
+
+    // Apply scale
+    Point scale = g_pApp->GetScale();
+    m_Epicenter.Set(m_Epicenter.x / scale.x, m_Epicenter.y / scale.y);
+}
+
+void DeathFadeInOutProcess::VOnSuccess()
+{
+    ScreenFadeProcess::VOnSuccess();
+
+    // This should not be here, since it does not know that Claw died here...
+    StrongActorPtr pClaw = g_pApp->GetGameLogic()->GetClawActor();
+    assert(pClaw != nullptr);
+
+    IEventMgr::Get()->VQueueEvent(IEventDataPtr(new EventData_Claw_Respawned(pClaw->GetGUID())));
+}
+
+//=================================================================================================
+// 
+// class TeleportFadeInOutProcess
+//
+//=================================================================================================
+
+TeleportFadeInOutProcess::TeleportFadeInOutProcess(const ScreenFadeDef& fadeDef)
+    :
+    ScreenFadeProcess(fadeDef)
+{
+}
+
+TeleportFadeInOutProcess::~TeleportFadeInOutProcess()
+{
 
-    Util::RenderForcePresent(pRenderer);
 }
\ No newline at end of file
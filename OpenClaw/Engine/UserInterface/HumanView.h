@@ -7,6 +7,8 @@
 #include "../Process/ProcessMgr.h"
 #include "Console.h"
 #include "GameHUD.h"
+#include "ScreenEffect.h"
+#include "ScreenElementLayers.h"
 
 #include "UserInterface.h"
 
@@ -50,6 +52,7 @@ public:
     void RegisterConsoleCommandHandler(void(*handler)(const char*, void*), void* userdata);
 
     shared_ptr<Console> GetConsole() const { return m_pConsole; }
+    ProcessMgr* GetProcessMgr() const { return m_pProcessMgr; }
 
     void SetRendering(bool rendering) { m_bRendering = rendering; }
     bool IsRendering() { return m_bRendering; }
@@ -102,7 +105,7 @@ protected:
     shared_ptr<IPointerHandler> m_pPointerHandler;
     shared_ptr<ITouchHandler> m_pTouchHandler;
 
-    ScreenElementList m_ScreenElements;
+    ScreenElementLayers m_ScreenElements;
 
     bool m_bRendering;
     bool m_bPostponeRenderPresent;
@@ -114,15 +117,6 @@ private:
     void RemoveAllDelegates();
 };
 
-// TODO: Make generic way of making new special effects
-// Should be constructed from 1 parameter - struct SpecialEffectDef
-// This should contain all informations about transitions (could be like 20 transitions) -
-// - struct SpecialEffectTransitionDef or struct SfxTransitionDef - duration, what to do in this
-// transition etc.
-//
-// Right now I am only interested in death and teleport special effects so this is fine albeit
-// unflexible
-
 class SpecialEffectProcess : public Process
 {
 public:
@@ -131,43 +125,13 @@ public:
     virtual void VOnSuccess() override { VRestoreStates(); }
     virtual void VOnFail() override { VRestoreStates(); }
     virtual void VOnAbort() override { VRestoreStates(); }
+    // Effects draw as they update, deferring them would drop the effect from the frame
+    virtual ProcessPriority VGetPriority() const override { return ProcessPriority_Normal; }
 
     virtual void VRestoreStates();
     virtual void VRender(uint32 msDiff) = 0;
 };
 
-class DeathFadeInOutProcess : public SpecialEffectProcess
-{
-public:
-    enum DeathFadeState
-    {
-        DeathFadeState_Started,
-        DeathFadeState_FadingIn,
-        DeathFadeState_FadingOut,
-        DeathFadeState_Ended
-    };
-
-    DeathFadeInOutProcess(Point epicenter, int fadeInDuration, int fadeOutDuration, int startDelay, int endDelay);
-    virtual ~DeathFadeInOutProcess();
-
-    virtual void VOnInit() override;
-    virtual void VOnUpdate(uint32 msDiff) override;
-    virtual void VRender(uint32 msDiff) override;
-
-private:
-    Point m_Epicenter;
-    int m_StartDelay;
-    int m_FadeInDuration;
-    int m_FadeOutDuration;
-    int m_EndDelay;
-
-    DeathFadeState m_DeathFadeState;
-    int m_CurrentTime;
-
-    Point m_FadeInSpeed;
-    Point m_FadeOutSpeed;
-};
-
 class PrimeSearch;
 class FadingLine
 {
@@ -176,12 +140,12 @@ public:
     ~FadingLine();
 
     void Update(uint32 msDiff);
-    void Reset(int fadeDelay, bool isFadingIn);
+    void Reset(int fadeDelay, int fadeDuration, bool isFadingIn);
 
     void Activate() { m_bIsActive = true; }
     bool IsDone() { return m_bIsDone; }
 
-    void Render(SDL_Renderer* pRenderer, SDL_Texture* pFragmentTexture, Point& lineOffset, bool asRow);
+    void Render(ScreenEffectBatch& batch, const Point& lineOffset, bool asRow);
 
 private:
     int m_Length;
@@ -200,34 +164,61 @@ private:
     std::vector<bool> m_FadedFragments;
 };
 
-class TeleportFadeInOutProcess : public SpecialEffectProcess
+// Screen is covered (fade in) and uncovered again (fade out) as described by ScreenFadeDef. Game logic is stopped
+// for the whole duration, game is not rendered while the screen is being covered.
+class ScreenFadeProcess : public SpecialEffectProcess
 {
 public:
-    enum TeleportState
+    enum ScreenFadeState
     {
-        TeleportState_FadingIn,
-        TeleportState_FadingOut,
+        ScreenFadeState_Started,
+        ScreenFadeState_FadingIn,
+        ScreenFadeState_FadingOut,
+        ScreenFadeState_Ended
     };
 
-    TeleportFadeInOutProcess(int fadeInDuration, int fadeOutDuration);
-    virtual ~TeleportFadeInOutProcess();
+    ScreenFadeProcess(const ScreenFadeDef& fadeDef);
+    virtual ~ScreenFadeProcess();
 
     virtual void VOnInit() override;
     virtual void VOnUpdate(uint32 msDiff) override;
     virtual void VRender(uint32 msDiff) override;
+    virtual const char* VGetName() const override { return "ScreenFadeProcess"; }
 
-private:
-    int m_FadeInDuration;
-    int m_FadeOutDuration;
-    Point m_FadeInSpeed;
-    Point m_FadeOutSpeed;
+protected:
+    void EnterState(ScreenFadeState state);
+    void CreateFadingLines();
 
-    TeleportState m_TeleportState;
+    ScreenFadeDef m_FadeDef;
+    ScreenFadeState m_FadeState;
     int m_CurrentTime;
 
-    Point m_FragmentSize;
-    SDL_Texture* m_pFadingTexture;
+    ScreenEffectBatch m_Batch;
+    // Rows of fragments, only used when fragment size is set
     std::vector<shared_ptr<FadingLine>> m_Lines;
 };
 
+class DeathFadeInOutProcess : public ScreenFadeProcess
+{
+public:
+    DeathFadeInOutProcess(Point epicenter, const ScreenFadeDef& fadeDef);
+    virtual ~DeathFadeInOutProcess();
+
+    virtual void VOnInit() override;
+    virtual void VOnSuccess() override;
+    virtual const char* VGetName() const override { return "DeathFadeInOutProcess"; }
+
+private:
+    Point m_Epicenter;
+};
+
+class TeleportFadeInOutProcess : public ScreenFadeProcess
+{
+public:
+    TeleportFadeInOutProcess(const ScreenFadeDef& fadeDef);
+    virtual ~TeleportFadeInOutProcess();
+
+    virtual const char* VGetName() const override { return "TeleportFadeInOutProcess"; }
+};
+
 #endif
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "../../Resource/Loaders/PcxLoader.h"
 #include "../../Resource/Loaders/PidLoader.h"
 #include "../../Graphics2D/Image.h"
+#include "../../Graphics2D/RenderCommands.h"
 
 #include "../../Actor/ActorTemplates.h"
 #include "../../Actor/Actor.h"
@@ -370,7 +371,7 @@ void ScreenElementScoreScreen::VOnRender(uint32 msDiff)
     assert(m_pBackground != nullptr);
 
     SDL_Rect backgroundRect = GetScreenRect();
-    SDL_RenderCopy(m_pRenderer, m_pBackground->GetTexture(), &backgroundRect, NULL);
+    RenderCommands::Copy(m_pRenderer, m_pBackground->GetTexture(), &backgroundRect, NULL);
     //LOG("Rendered. Image width: " + ToStr(m_pBackground->GetWidth()));
 
     Scene::OnRender();
@@ -77,7 +77,14 @@ FireEventProcess::FireEventProcess(IEventDataPtr pEvent, bool isTriggered)
 
 void FireEventProcess::VOnUpdate(uint32 msDiff)
 {
-    IEventMgr::Get()->VTriggerEvent(m_pEvent);
+    if (m_bIsTriggered)
+    {
+        IEventMgr::Get()->VTriggerEvent(m_pEvent);
+    }
+    else
+    {
+        IEventMgr::Get()->VQueueEvent(m_pEvent);
+    }
     Succeed();
 }
 
@@ -19,6 +19,7 @@ public:
     DelayedProcess(int delay);
 
     virtual void VOnUpdate(uint32 msDiff) override;
+    virtual const char* VGetName() const override { return "DelayedProcess"; }
 
 private:
     int m_Delay;
@@ -36,6 +37,8 @@ public:
     ImageSpawnProcess(const std::string& imagePath, const Point& position, const AnimationDef& aniDef);
 
     virtual void VOnUpdate(uint32 msDiff) override;
+    virtual ProcessPriority VGetPriority() const override { return ProcessPriority_Low; }
+    virtual const char* VGetName() const override { return "ImageSpawnProcess"; }
 
 private:
     const std::string m_ImagePath;
@@ -55,6 +58,7 @@ public:
     PlaySoundProcess(const SoundInfo& sound);
 
     virtual void VOnUpdate(uint32 msDiff) override;
+    virtual const char* VGetName() const override { return "PlaySoundProcess"; }
 
 private:
     const SoundInfo m_Sound;
@@ -72,6 +76,7 @@ public:
     FireEventProcess(IEventDataPtr pEvent, bool isTriggered);
 
     virtual void VOnUpdate(uint32 msDiff) override;
+    virtual const char* VGetName() const override { return "FireEventProcess"; }
 
 private:
     IEventDataPtr m_pEvent;
@@ -123,6 +128,8 @@ public:
 
     virtual void VOnInit() override;
     virtual void VOnUpdate(uint32 msDiff) override;
+    virtual ProcessPriority VGetPriority() const override { return ProcessPriority_Low; }
+    virtual const char* VGetName() const override { return "SpawnScoreRowProcess"; }
 
     void ForceSpawnImmediately();
 
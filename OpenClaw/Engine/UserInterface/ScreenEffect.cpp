@@ -0,0 +1,62 @@
+#include "ScreenEffect.h"
+#include "../Graphics2D/RenderCommands.h"
+
+void ScreenEffectBatch::AddQuad(int x, int y, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    SDL_Rect quad = { x, y, width, height };
+    m_Quads.push_back(quad);
+}
+
+void ScreenEffectBatch::AddClosingEdges(const Point& screenSize, uint32 edges, double coverage)
+{
+    coverage = max(0.0, min(1.0, coverage));
+
+    const int screenWidth = (int)screenSize.x;
+    const int screenHeight = (int)screenSize.y;
+    const int currentWidth = (int)(coverage * screenSize.x / 2.0);
+    const int currentHeight = (int)(coverage * screenSize.y / 2.0);
+
+    if (edges & ScreenEdge_Left)
+    {
+        AddQuad(0, 0, currentWidth, screenHeight);
+    }
+    if (edges & ScreenEdge_Right)
+    {
+        AddQuad(screenWidth - currentWidth, 0, currentWidth, screenHeight);
+    }
+    if (edges & ScreenEdge_Top)
+    {
+        AddQuad(0, 0, screenWidth, currentHeight);
+    }
+    if (edges & ScreenEdge_Bottom)
+    {
+        AddQuad(0, screenHeight - currentHeight, screenWidth, currentHeight);
+    }
+}
+
+void ScreenEffectBatch::Render(SDL_Renderer* pRenderer, const SDL_Color& color) const
+{
+    assert(pRenderer != NULL);
+
+    if (m_Quads.empty())
+    {
+        return;
+    }
+
+    SDL_Color prevColor;
+    SDL_BlendMode prevBlendMode;
+    RenderCommands::GetDrawColor(pRenderer, &prevColor.r, &prevColor.g, &prevColor.b, &prevColor.a);
+    RenderCommands::GetDrawBlendMode(pRenderer, &prevBlendMode);
+
+    RenderCommands::SetDrawBlendMode(pRenderer, color.a == 255 ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+    RenderCommands::SetDrawColor(pRenderer, color.r, color.g, color.b, color.a);
+    RenderCommands::FillRects(pRenderer, m_Quads.data(), (int)m_Quads.size());
+
+    RenderCommands::SetDrawColor(pRenderer, prevColor.r, prevColor.g, prevColor.b, prevColor.a);
+    RenderCommands::SetDrawBlendMode(pRenderer, prevBlendMode);
+}
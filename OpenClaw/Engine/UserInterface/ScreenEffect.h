@@ -0,0 +1,76 @@
+#ifndef __SCREEN_EFFECT_H__
+#define __SCREEN_EFFECT_H__
+
+#include <SDL2/SDL.h>
+#include "../SharedDefines.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// Screen effects
+//
+// Full screen transitions (death, teleport) are described by ScreenFadeDef and drawn through ScreenEffectBatch. The
+// batch collects all quads of the effect for the frame and draws them with single SDL_RenderFillRects call, so no
+// textures are created per frame and the number of draw calls does not grow with the number of fragments.
+//---------------------------------------------------------------------------------------------------------------------
+
+enum ScreenEdge
+{
+    ScreenEdge_None = 0,
+    ScreenEdge_Left = 1 << 0,
+    ScreenEdge_Right = 1 << 1,
+    ScreenEdge_Top = 1 << 2,
+    ScreenEdge_Bottom = 1 << 3,
+    ScreenEdge_Horizontal = ScreenEdge_Left | ScreenEdge_Right,
+    ScreenEdge_All = ScreenEdge_Horizontal | ScreenEdge_Top | ScreenEdge_Bottom
+};
+
+struct ScreenFadeDef
+{
+    ScreenFadeDef()
+    {
+        fadeInDuration = 0;
+        fadeOutDuration = 0;
+        startDelay = 0;
+        endDelay = 0;
+        closingEdges = ScreenEdge_All;
+        fragmentSize.Set(0, 0);
+        color.r = 0;
+        color.g = 0;
+        color.b = 0;
+        color.a = 255;
+    }
+
+    int fadeInDuration;
+    int fadeOutDuration;
+    int startDelay;
+    int endDelay;
+
+    // Edges which close towards the center of the screen
+    uint32 closingEdges;
+    // When set, screen dissolves in fragments of this size instead of closing edges
+    Point fragmentSize;
+    SDL_Color color;
+
+    // Played when fading in / out starts, empty for none
+    std::string fadeInSound;
+    std::string fadeOutSound;
+};
+
+class ScreenEffectBatch
+{
+public:
+    void Clear() { m_Quads.clear(); }
+
+    void AddQuad(int x, int y, int width, int height);
+    // Coverage is in range [0, 1], 1 means that the edges met in the middle of the screen
+    void AddClosingEdges(const Point& screenSize, uint32 edges, double coverage);
+
+    // Draw color and blend mode of the renderer are restored afterwards
+    void Render(SDL_Renderer* pRenderer, const SDL_Color& color) const;
+
+    uint32 GetQuadCount() const { return m_Quads.size(); }
+
+private:
+    std::vector<SDL_Rect> m_Quads;
+};
+
+#endif
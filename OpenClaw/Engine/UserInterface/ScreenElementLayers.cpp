@@ -0,0 +1,82 @@
+#include "ScreenElementLayers.h"
+
+static bool CompareZOrder(const shared_ptr<IScreenElement>& pLeft, const shared_ptr<IScreenElement>& pRight)
+{
+    return pLeft->VGetZOrder() < pRight->VGetZOrder();
+}
+
+ScreenElementLayers::ScreenElementLayers()
+    :
+    m_bIsOrderDirty(false),
+    m_bIsInputOrderDirty(false)
+{
+
+}
+
+void ScreenElementLayers::Push(shared_ptr<IScreenElement> pElement)
+{
+    Insert(pElement, false);
+}
+
+void ScreenElementLayers::PushOnTop(shared_ptr<IScreenElement> pElement)
+{
+    Insert(pElement, true);
+}
+
+void ScreenElementLayers::Insert(shared_ptr<IScreenElement> pElement, bool isOnTop)
+{
+    assert(pElement != nullptr);
+
+    // Binary search needs sorted array
+    if (m_bIsOrderDirty)
+    {
+        std::stable_sort(m_Elements.begin(), m_Elements.end(), CompareZOrder);
+        m_bIsOrderDirty = false;
+    }
+
+    ScreenElementArray::iterator insertIter = isOnTop ?
+        std::upper_bound(m_Elements.begin(), m_Elements.end(), pElement, CompareZOrder) :
+        std::lower_bound(m_Elements.begin(), m_Elements.end(), pElement, CompareZOrder);
+    m_Elements.insert(insertIter, pElement);
+
+    m_bIsInputOrderDirty = true;
+}
+
+void ScreenElementLayers::Remove(shared_ptr<IScreenElement> pElement)
+{
+    // Removing keeps the order, no need to sort
+    m_Elements.erase(std::remove(m_Elements.begin(), m_Elements.end(), pElement), m_Elements.end());
+    m_bIsInputOrderDirty = true;
+}
+
+void ScreenElementLayers::Clear()
+{
+    m_Elements.clear();
+    m_InputOrder.clear();
+    m_bIsOrderDirty = false;
+    m_bIsInputOrderDirty = false;
+}
+
+const ScreenElementArray& ScreenElementLayers::GetRenderOrder()
+{
+    if (m_bIsOrderDirty)
+    {
+        std::stable_sort(m_Elements.begin(), m_Elements.end(), CompareZOrder);
+        m_bIsOrderDirty = false;
+        m_bIsInputOrderDirty = true;
+    }
+
+    return m_Elements;
+}
+
+const ScreenElementArray& ScreenElementLayers::GetInputOrder()
+{
+    const ScreenElementArray& renderOrder = GetRenderOrder();
+    if (m_bIsInputOrderDirty)
+    {
+        m_InputOrder.assign(renderOrder.rbegin(), renderOrder.rend());
+        m_bIsInputOrderDirty = false;
+    }
+
+    return m_InputOrder;
+}
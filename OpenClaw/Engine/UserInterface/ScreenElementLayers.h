@@ -0,0 +1,52 @@
+#ifndef __SCREEN_ELEMENT_LAYERS_H__
+#define __SCREEN_ELEMENT_LAYERS_H__
+
+#include "../SharedDefines.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// ScreenElementLayers
+//
+// Screen elements of a view kept in a contiguous array ordered by their z-order (back to front). Elements are inserted
+// straight to their place, so nothing is sorted per frame - the array is re-sorted only when InvalidateOrder() is
+// called after z-order of some element changed. Front to back order used for routing input is cached and rebuilt
+// only when the elements change.
+//
+// Elements can be pushed or removed while the arrays are being iterated (e.g. from event handlers), so they are meant
+// to be iterated by index with bounds checked every step.
+//---------------------------------------------------------------------------------------------------------------------
+
+typedef std::vector<shared_ptr<IScreenElement>> ScreenElementArray;
+
+class ScreenElementLayers
+{
+public:
+    ScreenElementLayers();
+
+    // Goes behind elements with the same z-order
+    void Push(shared_ptr<IScreenElement> pElement);
+    // Goes in front of elements with the same z-order
+    void PushOnTop(shared_ptr<IScreenElement> pElement);
+    void Remove(shared_ptr<IScreenElement> pElement);
+    void Clear();
+
+    // Has to be called when z-order of any pushed element changes
+    void InvalidateOrder() { m_bIsOrderDirty = true; }
+
+    // Back to front
+    const ScreenElementArray& GetRenderOrder();
+    // Front to back
+    const ScreenElementArray& GetInputOrder();
+
+    uint32 GetCount() const { return m_Elements.size(); }
+    bool IsEmpty() const { return m_Elements.empty(); }
+
+private:
+    void Insert(shared_ptr<IScreenElement> pElement, bool isOnTop);
+
+    ScreenElementArray m_Elements;
+    ScreenElementArray m_InputOrder;
+    bool m_bIsOrderDirty;
+    bool m_bIsInputOrderDirty;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "UserInterface.h"
 
 #include "../Graphics2D/Image.h"
+#include "../Graphics2D/RenderCommands.h"
 #include "../GameApp/BaseGameApp.h"
 #include "../GameApp/BaseGameLogic.h"
 #include "../GameApp/GameSaves.h"
@@ -428,20 +429,20 @@ void ScreenElementMenu::VOnUpdate(uint32 msDiff)
 void ScreenElementMenu::VOnRender(uint32 msDiff)
 {
     // Menu DOES NOT use renderer scaling
-    SDL_RenderSetScale(m_pRenderer, 1.0f, 1.0f);
+    RenderCommands::SetScale(m_pRenderer, 1.0f, 1.0f);
 
     assert(m_pBackground != nullptr);
     assert(m_pBackground->GetTexture() != NULL);
 
     SDL_Rect backgroundRect = GetScreenRect();
-    SDL_RenderCopy(m_pRenderer, m_pBackground->GetTexture(), &backgroundRect, NULL);
+    RenderCommands::Copy(m_pRenderer, m_pBackground->GetTexture(), &backgroundRect, NULL);
 
     assert(m_pActiveMenuPage);
     m_pActiveMenuPage->VOnRender(msDiff);
 
     // Restore scale
     Point scale = Point(g_pApp->GetGameConfig()->scale, g_pApp->GetGameConfig()->scale);
-    SDL_RenderSetScale(m_pRenderer, (float)scale.x, (float)scale.y);
+    RenderCommands::SetScale(m_pRenderer, (float)scale.x, (float)scale.y);
 }
 
 bool ScreenElementMenu::VOnEvent(SDL_Event& evt)
@@ -689,7 +690,7 @@ void ScreenElementMenuPage::VOnRender(uint32 msDiff)
         assert(m_pBackground->GetTexture() != NULL);
 
         SDL_Rect backgroundRect = GetScreenRect();
-        SDL_RenderCopy(m_pRenderer, m_pBackground->GetTexture(), &backgroundRect, NULL);
+        RenderCommands::Copy(m_pRenderer, m_pBackground->GetTexture(), &backgroundRect, NULL);
     }
 
     for (shared_ptr<ScreenElementMenuItem> pMenuItem : m_MenuItems)
@@ -1011,7 +1012,7 @@ void ScreenElementMenuItem::VOnRender(uint32 msDiff)
     renderRect.w = (int)(pCurrImage->GetWidth() * g_MenuScale.x);
     renderRect.h = (int)(pCurrImage->GetHeight() * g_MenuScale.y);
 
-    SDL_RenderCopy(m_pRenderer, pCurrImage->GetTexture(), NULL, &renderRect);
+    RenderCommands::Copy(m_pRenderer, pCurrImage->GetTexture(), NULL, &renderRect);
 }
 
 bool ScreenElementMenuItem::VOnEvent(SDL_Event& evt)
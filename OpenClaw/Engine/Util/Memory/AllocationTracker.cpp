@@ -0,0 +1,376 @@
+#include "AllocationTracker.h"
+#include "../../Logger/Logger.h"
+#include "../StringUtil.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#ifdef ALLOCATION_TRACKING
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+// Every tracked block is prefixed by this header so that delete knows how much
+// memory and which tag it is returning. Header size keeps the user pointer aligned
+// the same way malloc would align it.
+struct AllocHeader
+{
+    size_t size;
+    uint32_t tag;
+};
+
+static const size_t ALLOC_HEADER_SIZE =
+    ((sizeof(AllocHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t)) * alignof(std::max_align_t);
+
+struct AllocTagCounters
+{
+    std::atomic<int64_t> liveBytes;
+    std::atomic<int64_t> peakBytes;
+    std::atomic<int64_t> liveAllocs;
+    std::atomic<int64_t> totalAllocs;
+    std::atomic<int64_t> totalBytes;
+};
+
+// Zero initialized before any dynamic initialization takes place, so allocations
+// made by static constructors are accounted correctly
+static AllocTagCounters g_AllocTagCounters[AllocTag_Max];
+static thread_local AllocTag t_CurrentAllocTag = AllocTag_General;
+
+// Per-frame bookkeeping, touched only from the main loop thread
+static AllocTagStats g_FrameStats[AllocTag_Max];
+static int64_t g_LastFrameTotalAllocs[AllocTag_Max];
+static int64_t g_LastFrameTotalBytes[AllocTag_Max];
+static bool g_IsOverBudget[AllocTag_Max];
+static uint64_t g_FrameCount = 0;
+
+static void* TrackedMalloc(size_t size, AllocTag tag)
+{
+    unsigned char* pRaw = (unsigned char*)malloc(size + ALLOC_HEADER_SIZE);
+    if (pRaw == NULL)
+    {
+        return NULL;
+    }
+
+    AllocHeader* pHeader = (AllocHeader*)pRaw;
+    pHeader->size = size;
+    pHeader->tag = tag;
+
+    AllocTagCounters& counters = g_AllocTagCounters[tag];
+    int64_t liveBytes = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    counters.liveAllocs.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocs.fetch_add(1, std::memory_order_relaxed);
+    counters.totalBytes.fetch_add(size, std::memory_order_relaxed);
+
+    int64_t peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    while (liveBytes > peakBytes &&
+        !counters.peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+    {
+    }
+
+    return pRaw + ALLOC_HEADER_SIZE;
+}
+
+static void TrackedFree(void* pMem)
+{
+    if (pMem == NULL)
+    {
+        return;
+    }
+
+    unsigned char* pRaw = ((unsigned char*)pMem) - ALLOC_HEADER_SIZE;
+    AllocHeader* pHeader = (AllocHeader*)pRaw;
+
+    AllocTagCounters& counters = g_AllocTagCounters[pHeader->tag];
+    counters.liveBytes.fetch_sub(pHeader->size, std::memory_order_relaxed);
+    counters.liveAllocs.fetch_sub(1, std::memory_order_relaxed);
+
+    free(pRaw);
+}
+
+static void* TrackedNew(size_t size, AllocTag tag)
+{
+    // operator new must return unique pointer even for 0 sized requests
+    if (size == 0)
+    {
+        size = 1;
+    }
+
+    for (;;)
+    {
+        if (void* pMem = TrackedMalloc(size, tag))
+        {
+            return pMem;
+        }
+
+        std::new_handler handler = std::set_new_handler(NULL);
+        std::set_new_handler(handler);
+        if (handler == NULL)
+        {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+//=====================================================================================================================
+// Global operator new / delete replacements
+//=====================================================================================================================
+
+void* operator new(size_t size)
+{
+    return TrackedNew(size, t_CurrentAllocTag);
+}
+
+void* operator new[](size_t size)
+{
+    return TrackedNew(size, t_CurrentAllocTag);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedMalloc(size == 0 ? 1 : size, t_CurrentAllocTag);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedMalloc(size == 0 ? 1 : size, t_CurrentAllocTag);
+}
+
+void operator delete(void* pMem) noexcept
+{
+    TrackedFree(pMem);
+}
+
+void operator delete[](void* pMem) noexcept
+{
+    TrackedFree(pMem);
+}
+
+void operator delete(void* pMem, const std::nothrow_t&) noexcept
+{
+    TrackedFree(pMem);
+}
+
+void operator delete[](void* pMem, const std::nothrow_t&) noexcept
+{
+    TrackedFree(pMem);
+}
+
+#endif // ALLOCATION_TRACKING
+
+static const char* g_AllocTagNames[AllocTag_Max] =
+{
+    "general",
+    "resources",
+    "events",
+    "actors",
+    "scene",
+    "physics",
+    "audio",
+    "pools"
+};
+
+namespace AllocationTracker
+{
+    bool IsEnabled()
+    {
+#ifdef ALLOCATION_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void* TaggedAlloc(size_t size, AllocTag tag)
+    {
+#ifdef ALLOCATION_TRACKING
+        return TrackedNew(size, tag);
+#else
+        return ::operator new(size);
+#endif
+    }
+
+    void TaggedFree(void* pMem)
+    {
+#ifdef ALLOCATION_TRACKING
+        TrackedFree(pMem);
+#else
+        ::operator delete(pMem);
+#endif
+    }
+
+    AllocTag GetCurrentTag()
+    {
+#ifdef ALLOCATION_TRACKING
+        return t_CurrentAllocTag;
+#else
+        return AllocTag_General;
+#endif
+    }
+
+    AllocTag SetCurrentTag(AllocTag tag)
+    {
+#ifdef ALLOCATION_TRACKING
+        AllocTag prevTag = t_CurrentAllocTag;
+        t_CurrentAllocTag = tag;
+        return prevTag;
+#else
+        return AllocTag_General;
+#endif
+    }
+
+    void OnFrameEnd()
+    {
+#ifdef ALLOCATION_TRACKING
+        g_FrameCount++;
+
+        for (int tagIdx = 0; tagIdx < AllocTag_Max; tagIdx++)
+        {
+            AllocTagStats& frameStats = g_FrameStats[tagIdx];
+
+            int64_t totalAllocs = g_AllocTagCounters[tagIdx].totalAllocs.load(std::memory_order_relaxed);
+            int64_t totalBytes = g_AllocTagCounters[tagIdx].totalBytes.load(std::memory_order_relaxed);
+
+            frameStats.frameAllocs = totalAllocs - g_LastFrameTotalAllocs[tagIdx];
+            frameStats.frameBytes = totalBytes - g_LastFrameTotalBytes[tagIdx];
+            frameStats.peakFrameAllocs = std::max(frameStats.peakFrameAllocs, frameStats.frameAllocs);
+
+            g_LastFrameTotalAllocs[tagIdx] = totalAllocs;
+            g_LastFrameTotalBytes[tagIdx] = totalBytes;
+
+            // Warn only once when the budget gets exceeded, not every frame
+            bool isOverBudget = frameStats.frameAllocBudget > 0 &&
+                frameStats.frameAllocs > (int64_t)frameStats.frameAllocBudget;
+            if (isOverBudget && !g_IsOverBudget[tagIdx])
+            {
+                LOG_WARNING("Allocation budget of [" + std::string(g_AllocTagNames[tagIdx]) + "] exceeded: " +
+                    ToStr((int)frameStats.frameAllocs) + " / " + ToStr(frameStats.frameAllocBudget) + " allocations per frame");
+            }
+            g_IsOverBudget[tagIdx] = isOverBudget;
+        }
+#endif
+    }
+
+    AllocTagStats GetTagStats(AllocTag tag)
+    {
+        AllocTagStats stats;
+#ifdef ALLOCATION_TRACKING
+        assert(tag >= 0 && tag < AllocTag_Max);
+
+        const AllocTagCounters& counters = g_AllocTagCounters[tag];
+        stats = g_FrameStats[tag];
+        stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+        stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+        stats.liveAllocs = counters.liveAllocs.load(std::memory_order_relaxed);
+        stats.totalAllocs = counters.totalAllocs.load(std::memory_order_relaxed);
+        stats.totalBytes = counters.totalBytes.load(std::memory_order_relaxed);
+#endif
+        return stats;
+    }
+
+    AllocTagStats GetTotalStats()
+    {
+        AllocTagStats total;
+        for (int tagIdx = 0; tagIdx < AllocTag_Max; tagIdx++)
+        {
+            AllocTagStats stats = GetTagStats(AllocTag(tagIdx));
+            total.liveBytes += stats.liveBytes;
+            // Sum of per-tag peaks is an upper bound of the real peak
+            total.peakBytes += stats.peakBytes;
+            total.liveAllocs += stats.liveAllocs;
+            total.totalAllocs += stats.totalAllocs;
+            total.totalBytes += stats.totalBytes;
+            total.frameAllocs += stats.frameAllocs;
+            total.frameBytes += stats.frameBytes;
+            total.peakFrameAllocs += stats.peakFrameAllocs;
+        }
+
+        return total;
+    }
+
+    uint64_t GetFrameCount()
+    {
+#ifdef ALLOCATION_TRACKING
+        return g_FrameCount;
+#else
+        return 0;
+#endif
+    }
+
+    void SetFrameAllocBudget(AllocTag tag, uint32_t maxAllocsPerFrame)
+    {
+#ifdef ALLOCATION_TRACKING
+        assert(tag >= 0 && tag < AllocTag_Max);
+        g_FrameStats[tag].frameAllocBudget = maxAllocsPerFrame;
+        g_IsOverBudget[tag] = false;
+#endif
+    }
+
+    void ResetPeaks()
+    {
+#ifdef ALLOCATION_TRACKING
+        for (int tagIdx = 0; tagIdx < AllocTag_Max; tagIdx++)
+        {
+            g_AllocTagCounters[tagIdx].peakBytes.store(
+                g_AllocTagCounters[tagIdx].liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            g_FrameStats[tagIdx].peakFrameAllocs = 0;
+        }
+#endif
+    }
+
+    const char* AllocTagToString(AllocTag tag)
+    {
+        if (tag < 0 || tag >= AllocTag_Max)
+        {
+            return "unknown";
+        }
+
+        return g_AllocTagNames[tag];
+    }
+
+    AllocTag StringToAllocTag(const std::string& tagStr)
+    {
+        for (int tagIdx = 0; tagIdx < AllocTag_Max; tagIdx++)
+        {
+            if (tagStr == g_AllocTagNames[tagIdx])
+            {
+                return AllocTag(tagIdx);
+            }
+        }
+
+        return AllocTag_Max;
+    }
+
+    void DumpStats(std::vector<std::string>& outLines)
+    {
+        if (!IsEnabled())
+        {
+            outLines.push_back("Allocation tracking is disabled. Rebuild with ALLOCATION_TRACKING defined.");
+            return;
+        }
+
+        char line[256];
+        snprintf(line, sizeof(line), "%-10s %12s %12s %10s %10s %10s %8s",
+            "tag", "live KB", "peak KB", "live #", "frame #", "peak fr #", "budget");
+        outLines.push_back(line);
+
+        for (int tagIdx = 0; tagIdx <= AllocTag_Max; tagIdx++)
+        {
+            bool isTotal = tagIdx == AllocTag_Max;
+            AllocTagStats stats = isTotal ? GetTotalStats() : GetTagStats(AllocTag(tagIdx));
+
+            snprintf(line, sizeof(line), "%-10s %12.1f %12.1f %10lld %10lld %10lld %8u",
+                isTotal ? "total" : g_AllocTagNames[tagIdx],
+                stats.liveBytes / 1024.0,
+                stats.peakBytes / 1024.0,
+                (long long)stats.liveAllocs,
+                (long long)stats.frameAllocs,
+                (long long)stats.peakFrameAllocs,
+                stats.frameAllocBudget);
+            outLines.push_back(line);
+        }
+    }
+}
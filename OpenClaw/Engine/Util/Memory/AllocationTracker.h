@@ -0,0 +1,130 @@
+#ifndef __ALLOCATION_TRACKER_H__
+#define __ALLOCATION_TRACKER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// AllocationTracker
+//
+// Portable heap instrumentation. When the engine is built with ALLOCATION_TRACKING defined (CMake option
+// "Allocation_Tracking"), global operator new / delete are replaced and every allocation is accounted to the
+// subsystem tag which is active on the allocating thread. Tags are set with TRACK_ALLOCATIONS(tag) scopes,
+// the innermost scope wins.
+//
+// Per tag we keep live / peak bytes, live allocation count and totals. OnFrameEnd() is called once per main loop
+// iteration and turns the totals into per-frame allocation rates which can be checked against per-frame budgets.
+//
+// Without ALLOCATION_TRACKING everything here compiles to no-ops and IsEnabled() returns false.
+//---------------------------------------------------------------------------------------------------------------------
+
+enum AllocTag
+{
+    AllocTag_General,
+    AllocTag_Resources,
+    AllocTag_Events,
+    AllocTag_Actors,
+    AllocTag_Scene,
+    AllocTag_Physics,
+    AllocTag_Audio,
+    AllocTag_Pools,     // Memory held by MemoryPools, objects served from the pools are not tracked separately
+    AllocTag_Max
+};
+
+struct AllocTagStats
+{
+    AllocTagStats()
+    {
+        liveBytes = 0;
+        peakBytes = 0;
+        liveAllocs = 0;
+        totalAllocs = 0;
+        totalBytes = 0;
+        frameAllocs = 0;
+        frameBytes = 0;
+        peakFrameAllocs = 0;
+        frameAllocBudget = 0;
+    }
+
+    int64_t liveBytes;
+    int64_t peakBytes;
+    int64_t liveAllocs;
+    int64_t totalAllocs;
+    int64_t totalBytes;
+
+    // Allocations made during last finished frame
+    int64_t frameAllocs;
+    int64_t frameBytes;
+    int64_t peakFrameAllocs;
+
+    // 0 = no budget
+    uint32_t frameAllocBudget;
+};
+
+namespace AllocationTracker
+{
+    bool IsEnabled();
+
+    // Allocates memory accounted to given tag regardless of the active scope.
+    // Used by classes which declare ALLOCATION_TAG_DECLARATION
+    void* TaggedAlloc(size_t size, AllocTag tag);
+    void TaggedFree(void* pMem);
+
+    AllocTag GetCurrentTag();
+    AllocTag SetCurrentTag(AllocTag tag);
+
+    // Should be called once per main loop iteration
+    void OnFrameEnd();
+
+    AllocTagStats GetTagStats(AllocTag tag);
+    AllocTagStats GetTotalStats();
+    uint64_t GetFrameCount();
+
+    void SetFrameAllocBudget(AllocTag tag, uint32_t maxAllocsPerFrame);
+    void ResetPeaks();
+
+    const char* AllocTagToString(AllocTag tag);
+    // Returns AllocTag_Max if no such tag exists
+    AllocTag StringToAllocTag(const std::string& tagStr);
+
+    // Human readable table, one line per tag
+    void DumpStats(std::vector<std::string>& outLines);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// AllocationScope - RAII helper which sets the allocation tag of current thread for its lifetime
+//---------------------------------------------------------------------------------------------------------------------
+class AllocationScope
+{
+public:
+#ifdef ALLOCATION_TRACKING
+    explicit AllocationScope(AllocTag tag) { m_PrevTag = AllocationTracker::SetCurrentTag(tag); }
+    ~AllocationScope() { AllocationTracker::SetCurrentTag(m_PrevTag); }
+
+private:
+    AllocTag m_PrevTag;
+#else
+    explicit AllocationScope(AllocTag) { }
+#endif
+};
+
+#ifdef ALLOCATION_TRACKING
+
+#define TRACK_ALLOCATIONS(tag) AllocationScope _ALLOCATION_SCOPE_(tag);
+
+// Place inside class declaration to account all heap instances of the class (and its subclasses) to given tag
+#define ALLOCATION_TAG_DECLARATION(tag) \
+    public: \
+        static void* operator new(size_t size) { return AllocationTracker::TaggedAlloc(size, tag); } \
+        static void operator delete(void* pPtr) { AllocationTracker::TaggedFree(pPtr); } \
+
+#else
+
+#define TRACK_ALLOCATIONS(tag)
+#define ALLOCATION_TAG_DECLARATION(tag)
+
+#endif // ALLOCATION_TRACKING
+
+#endif // __ALLOCATION_TRACKER_H__
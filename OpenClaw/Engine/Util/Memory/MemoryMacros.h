@@ -1,5 +1,9 @@
 #ifndef __MEMORY_MACROS_H__
 #define __MEMORY_MACROS_H__
+
+#include "MemoryPool.h"
+#include "PoolAllocator.h"
+
 //========================================================================
 // MemoryMacros.h : 
 //
@@ -125,4 +129,31 @@ static _className_ ## _AutoInitializedMemoryPool s_ ## _className_ ## _AutoIniti
 
 #define MEMORYPOOL_AUTOINIT(_className_, _numChunks_) MEMORYPOOL_AUTOINIT_DEBUGNAME(_className_, _numChunks_, #_className_)
 
+
+//---------------------------------------------------------------------------------------------------------------------
+// Lighter alternative to the macros above. Place inside a class declaration and all heap instances of the class and
+// its subclasses are served from the shared size class pools in MemoryPoolMgr (see PoolAllocator.h). No per-class
+// pool needs to be defined or initialized. Class has to have virtual destructor if it is deleted through base pointer,
+// otherwise wrong size class would be used to free the memory.
+//---------------------------------------------------------------------------------------------------------------------
+#ifdef _CRTDBG_MAP_ALLOC
+// SharedDefines.h redefines "new" to the CRT debug placement form which the class operator would hide. CRT leak
+// checking wants to see every allocation anyway, so pooling is disabled in that configuration.
+#define POOLED_ALLOCATION_DECLARATION()
+#else
+#define POOLED_ALLOCATION_DECLARATION() \
+    public: \
+        static void* operator new(size_t size) \
+        { \
+            void* pMem = MemoryPoolMgr::Alloc(size); \
+            if (pMem == NULL) \
+            { \
+                throw std::bad_alloc(); \
+            } \
+            return pMem; \
+        } \
+        static void operator delete(void* pPtr, size_t size) { MemoryPoolMgr::Free(pPtr, size); } \
+
+#endif
+
 #endif
\ No newline at end of file
@@ -22,12 +22,20 @@
 
 #include "MemoryPool.h"
 #include "../StringUtil.h"
+#include "../../Logger/Logger.h"
+#include "AllocationTracker.h"
 #include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <cstddef>
 
-const static size_t CHUNK_HEADER_SIZE = (sizeof(unsigned char*));
+// Header is padded so that the data section of every chunk keeps the same alignment malloc() would give us
+const static size_t CHUNK_ALIGNMENT = alignof(std::max_align_t);
+const static size_t CHUNK_HEADER_SIZE = ((sizeof(unsigned char*) + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT) * CHUNK_ALIGNMENT;
 
 MemoryPool::MemoryPool(void)
 {
+    m_isThreadSafe = false;
     Reset();
 }
 
@@ -43,7 +51,7 @@ bool MemoryPool::Init(unsigned int chunkSize, unsigned int numChunks)
         Destroy();
 
     // fill out our size & number members
-    m_chunkSize = chunkSize;
+    m_chunkSize = (unsigned int)(((chunkSize + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT) * CHUNK_ALIGNMENT);
     m_numChunks = numChunks;
 
     // attempt to grow the memory array
@@ -54,29 +62,88 @@ bool MemoryPool::Init(unsigned int chunkSize, unsigned int numChunks)
 
 void MemoryPool::Destroy(void)
 {
-    // dump the state of the memory pool
+    // dump the state of the memory pool. Logger may already be gone when static pools are destroyed,
+    // so use plain stdio here
 #ifdef _DEBUG
-    std::string str;
-    if (m_numAllocs != 0)
-        str = "***(" + ToStr(m_numAllocs) + ") ";
-    unsigned long totalNumChunks = m_numChunks * m_memArraySize;
-    unsigned long wastedMem = (totalNumChunks - m_allocPeak) * m_chunkSize;
-    str += "Destroying memory pool: [" + GetDebugName() + ":" + ToStr((unsigned long)m_chunkSize) + "] = " + ToStr(m_allocPeak) + "/" + ToStr((unsigned long)totalNumChunks) + " (" + ToStr(wastedMem) + " bytes wasted)\n";
-    ::OutputDebugStringA(str.c_str());  // the logger is not initialized during many of the initial memory pool growths, so let's just use the OS version
+    if (m_memArraySize > 0)
+    {
+        std::string str;
+        if (m_numAllocs != 0)
+            str = "***(" + ToStr(m_numAllocs) + ") ";
+        unsigned long totalNumChunks = m_numChunks * m_memArraySize;
+        unsigned long wastedMem = (totalNumChunks - m_allocPeak) * m_chunkSize;
+        str += "Destroying memory pool: [" + GetDebugName() + ":" + ToStr((unsigned long)m_chunkSize) + "] = " + ToStr(m_allocPeak) + "/" + ToStr((unsigned long)totalNumChunks) + " (" + ToStr(wastedMem) + " bytes wasted)\n";
+        fputs(str.c_str(), stderr);
+    }
 #endif
 
     // free all memory
     for (unsigned int i = 0; i < m_memArraySize; ++i)
     {
-        free(m_ppRawMemoryArray[i]);
+        AllocationTracker::TaggedFree(m_ppRawMemoryArray[i]);
     }
-    free(m_ppRawMemoryArray);
+    AllocationTracker::TaggedFree(m_ppRawMemoryArray);
 
     // update member variables
     Reset();
 }
 
 void* MemoryPool::Alloc(void)
+{
+    void* pMem;
+    bool hasGrown = false;
+    if (m_isThreadSafe)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        pMem = AllocUnlocked(hasGrown);
+    }
+    else
+    {
+        pMem = AllocUnlocked(hasGrown);
+    }
+
+    // Logger allocates, do not hold the lock while logging
+    if (hasGrown)
+    {
+        LogGrowth();
+    }
+
+    return pMem;
+}
+
+void MemoryPool::Free(void* pMem)
+{
+    if (m_isThreadSafe)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        FreeUnlocked(pMem);
+        return;
+    }
+
+    FreeUnlocked(pMem);
+}
+
+MemoryPoolStats MemoryPool::GetStats(void)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex, std::defer_lock);
+    if (m_isThreadSafe)
+    {
+        lock.lock();
+    }
+
+    MemoryPoolStats stats;
+    stats.name = m_debugName;
+    stats.chunkSize = m_chunkSize;
+    stats.totalChunks = (unsigned long)m_numChunks * m_memArraySize;
+    stats.numAllocs = m_numAllocs;
+    stats.allocPeak = m_allocPeak;
+    stats.totalAllocs = m_totalAllocs;
+    stats.numGrows = m_memArraySize;
+
+    return stats;
+}
+
+void* MemoryPool::AllocUnlocked(bool& hasGrown)
 {
     // If we're out of memory chunks, grow the pool.  This is very expensive.
     if (!m_pHead)
@@ -88,14 +155,14 @@ void* MemoryPool::Alloc(void)
         // attempt to grow the pool
         if (!GrowMemoryArray())
             return NULL;  // couldn't allocate anymore memory
+        hasGrown = true;
     }
 
-#ifdef _DEBUG
     // update allocation reports
     ++m_numAllocs;
+    ++m_totalAllocs;
     if (m_numAllocs > m_allocPeak)
         m_allocPeak = m_numAllocs;
-#endif
 
     // grab the first chunk from the list and move to the next chunks
     unsigned char* pRet = m_pHead;
@@ -103,7 +170,7 @@ void* MemoryPool::Alloc(void)
     return (pRet + CHUNK_HEADER_SIZE);  // make sure we return a pointer to the data section only
 }
 
-void MemoryPool::Free(void* pMem)
+void MemoryPool::FreeUnlocked(void* pMem)
 {
     if (pMem != NULL)      // calling Free() on a NULL pointer is perfectly valid
     {
@@ -114,11 +181,9 @@ void MemoryPool::Free(void* pMem)
         SetNext(pBlock, m_pHead);
         m_pHead = pBlock;
 
-#ifdef _DEBUG
         // update allocation reports
+        assert(m_numAllocs > 0);
         --m_numAllocs;
-        assert(m_numAllocs >= 0);
-#endif
     }
 }
 
@@ -130,22 +195,25 @@ void MemoryPool::Reset(void)
     m_numChunks = 0;
     m_memArraySize = 0;
     m_toAllowResize = true;
-#ifdef _DEBUG
     m_allocPeak = 0;
     m_numAllocs = 0;
-#endif
+    m_totalAllocs = 0;
 }
 
-bool MemoryPool::GrowMemoryArray(void)
+void MemoryPool::LogGrowth(void)
 {
 #ifdef _DEBUG
-    std::string str("Growing memory pool: [" + GetDebugName() + ":" + ToStr((unsigned long)m_chunkSize) + "] = " + ToStr((unsigned long)m_memArraySize + 1) + "\n");
-    LOG(str.c_str());  // the logger is not initialized during many of the initial memory pool growths, so let's just use the OS version
+    // Only growths made by Alloc() are reported, initial ones happen during static initialization. Stats are read
+    // without the lock, they are only informative
+    LOG("Growing memory pool: [" + GetDebugName() + ":" + ToStr((unsigned long)m_chunkSize) + "] = " + ToStr((unsigned long)m_memArraySize));
 #endif
+}
 
+bool MemoryPool::GrowMemoryArray(void)
+{
     // allocate a new array
     size_t allocationSize = sizeof(unsigned char*) * (m_memArraySize + 1);
-    unsigned char** ppNewMemArray = (unsigned char**)malloc(allocationSize);
+    unsigned char** ppNewMemArray = (unsigned char**)AllocationTracker::TaggedAlloc(allocationSize, AllocTag_Pools);
 
     // make sure the allocation succeeded
     if (!ppNewMemArray)
@@ -159,6 +227,11 @@ bool MemoryPool::GrowMemoryArray(void)
 
     // allocate a new block of memory
     ppNewMemArray[m_memArraySize] = AllocateNewMemoryBlock();  // indexing m_memArraySize here is safe because we haven't incremented it yet to reflect the new size    
+    if (!ppNewMemArray[m_memArraySize])
+    {
+        AllocationTracker::TaggedFree(ppNewMemArray);
+        return false;
+    }
 
     // attach the block to the end of the current memory list
     if (m_pHead)
@@ -179,7 +252,7 @@ bool MemoryPool::GrowMemoryArray(void)
 
     // destroy the old memory array
     if (m_ppRawMemoryArray)
-        free(m_ppRawMemoryArray);
+        AllocationTracker::TaggedFree(m_ppRawMemoryArray);
 
     // assign the new memory array and increment the size count
     m_ppRawMemoryArray = ppNewMemArray;
@@ -195,7 +268,7 @@ unsigned char* MemoryPool::AllocateNewMemoryBlock(void)
     size_t trueSize = blockSize * m_numChunks;
 
     // allocate the memory
-    unsigned char* pNewMem = (unsigned char*)malloc(trueSize);
+    unsigned char* pNewMem = (unsigned char*)AllocationTracker::TaggedAlloc(trueSize, AllocTag_Pools);
     if (!pNewMem)
         return NULL;
 
@@ -43,9 +43,27 @@
 // 
 // Call the Free() function to release a chunk of memory back into the memory pool for reuse.  This
 // will cause the chunk to the inserted to the front of the list, ready for the next bit.
+//
+// Pools are not thread safe by default. SetThreadSafe(true) guards Alloc() and Free() with a mutex
+// so that the pool can be shared between the game thread and loader / audio threads. Only pools which
+// really are shared should enable it.
+//
+// Memory of the pool is accounted to AllocTag_Pools by the AllocationTracker.
 //--------------------------------------------------------------------------------------------------
 
-#include "../../SharedDefines.h"
+#include <string>
+#include <mutex>
+
+struct MemoryPoolStats
+{
+    std::string name;
+    unsigned int chunkSize;
+    unsigned long totalChunks;  // number of chunks in all memory arrays
+    unsigned long numAllocs;    // chunks currently in use
+    unsigned long allocPeak;    // maximum of numAllocs during pool lifetime
+    unsigned long totalAllocs;  // number of Alloc() calls during pool lifetime
+    unsigned int numGrows;      // number of memory arrays allocated
+};
 
 class MemoryPool
 {
@@ -54,12 +72,12 @@ class MemoryPool
     unsigned int m_chunkSize, m_numChunks;  // the size of each chunk and number of chunks per array, respectively
     unsigned int m_memArraySize;  // the number elements in the memory array
     bool m_toAllowResize;  // true if we resize the memory pool when it fills up
+    bool m_isThreadSafe;  // true if Alloc() / Free() lock m_Mutex
+    std::mutex m_Mutex;
 
-    // tracking variables we only care about for debug
-#ifdef _DEBUG
+    // tracking variables, cheap enough to be kept in release builds too
     std::string m_debugName;
-    unsigned long m_allocPeak, m_numAllocs;
-#endif
+    unsigned long m_allocPeak, m_numAllocs, m_totalAllocs;
 
 public:
     // construction
@@ -75,21 +93,24 @@ public:
 
     // settings
     void SetAllowResize(bool toAllowResize) { m_toAllowResize = toAllowResize; }
+    void SetThreadSafe(bool isThreadSafe) { m_isThreadSafe = isThreadSafe; }
 
     // debug functions
-#ifdef _DEBUG
     void SetDebugName(const char* debugName) { m_debugName = debugName; }
     std::string GetDebugName(void) const { return m_debugName; }
-#else
-    void SetDebugName(const char* debugName) { }
-    //std::string GetDebugName(void) const { return (std::string("<No Name>")); }
-    const char* GetDebugName(void) const { return "<No Name>"; }
-#endif
+
+    // utilization statistics
+    MemoryPoolStats GetStats(void);
 
 private:
     // resets internal vars
     void Reset(void);
 
+    // hasGrown is set when the pool had to grow, so that it can be reported after the lock is released
+    void* AllocUnlocked(bool& hasGrown);
+    void LogGrowth(void);
+    void FreeUnlocked(void* pMem);
+
     // internal memory allocation helpers
     bool GrowMemoryArray(void);
     unsigned char* AllocateNewMemoryBlock(void);
@@ -99,7 +120,8 @@ private:
     void SetNext(unsigned char* pBlockToChange, unsigned char* pNewNext);
 
     // don't allow copy constructor
-    MemoryPool(const MemoryPool& memPool) {}
+    MemoryPool(const MemoryPool& memPool);
+    MemoryPool& operator=(const MemoryPool& memPool);
 };
 
 #endif //__MEMORY_POOL_H__
\ No newline at end of file
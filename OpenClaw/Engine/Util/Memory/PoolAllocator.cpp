@@ -0,0 +1,131 @@
+#include "PoolAllocator.h"
+
+#include <stdio.h>
+#include <mutex>
+#include <atomic>
+
+static const size_t NUM_SIZE_CLASSES = MemoryPoolMgr::MAX_POOLED_SIZE / MemoryPoolMgr::SIZE_CLASS_GRANULARITY;
+
+struct SizeClassPools
+{
+    std::atomic<MemoryPool*> pools[NUM_SIZE_CLASSES];
+    std::once_flag initFlags[NUM_SIZE_CLASSES];
+};
+
+static std::atomic<bool> s_IsThreadSafe(false);
+
+static SizeClassPools& GetSizeClassPools()
+{
+    // Leaked on purpose, see PoolAllocator.h
+    static SizeClassPools* s_pPools = new SizeClassPools();
+    return *s_pPools;
+}
+
+static inline size_t GetSizeClassIdx(size_t size)
+{
+    if (size == 0)
+    {
+        size = 1;
+    }
+
+    return (size - 1) / MemoryPoolMgr::SIZE_CLASS_GRANULARITY;
+}
+
+static MemoryPool* GetPool(size_t sizeClassIdx)
+{
+    SizeClassPools& sizeClassPools = GetSizeClassPools();
+    std::call_once(sizeClassPools.initFlags[sizeClassIdx], [&sizeClassPools, sizeClassIdx]()
+    {
+        unsigned int chunkSize = (unsigned int)((sizeClassIdx + 1) * MemoryPoolMgr::SIZE_CLASS_GRANULARITY);
+        char debugName[32];
+        snprintf(debugName, sizeof(debugName), "pool_%u", chunkSize);
+
+        MemoryPool* pPool = new MemoryPool();
+        pPool->SetDebugName(debugName);
+        pPool->SetThreadSafe(s_IsThreadSafe.load());
+        pPool->Init(chunkSize, MemoryPoolMgr::CHUNKS_PER_GROW);
+        sizeClassPools.pools[sizeClassIdx] = pPool;
+    });
+
+    return sizeClassPools.pools[sizeClassIdx].load(std::memory_order_relaxed);
+}
+
+namespace MemoryPoolMgr
+{
+    void* Alloc(size_t size)
+    {
+        if (size > MAX_POOLED_SIZE)
+        {
+            return ::operator new(size);
+        }
+
+        return GetPool(GetSizeClassIdx(size))->Alloc();
+    }
+
+    void Free(void* pMem, size_t size)
+    {
+        if (pMem == NULL)
+        {
+            return;
+        }
+
+        if (size > MAX_POOLED_SIZE)
+        {
+            ::operator delete(pMem);
+            return;
+        }
+
+        GetPool(GetSizeClassIdx(size))->Free(pMem);
+    }
+
+    void SetThreadSafe(bool isThreadSafe)
+    {
+        s_IsThreadSafe.store(isThreadSafe);
+
+        SizeClassPools& sizeClassPools = GetSizeClassPools();
+        for (size_t sizeClassIdx = 0; sizeClassIdx < NUM_SIZE_CLASSES; sizeClassIdx++)
+        {
+            MemoryPool* pPool = sizeClassPools.pools[sizeClassIdx].load();
+            if (pPool != NULL)
+            {
+                pPool->SetThreadSafe(isThreadSafe);
+            }
+        }
+    }
+
+    void GetPoolStats(std::vector<MemoryPoolStats>& outStats)
+    {
+        SizeClassPools& sizeClassPools = GetSizeClassPools();
+        for (size_t sizeClassIdx = 0; sizeClassIdx < NUM_SIZE_CLASSES; sizeClassIdx++)
+        {
+            // Do not create pools just to report them as empty
+            MemoryPool* pPool = sizeClassPools.pools[sizeClassIdx].load();
+            if (pPool != NULL)
+            {
+                outStats.push_back(pPool->GetStats());
+            }
+        }
+    }
+
+    void DumpStats(std::vector<std::string>& outLines)
+    {
+        std::vector<MemoryPoolStats> poolStats;
+        GetPoolStats(poolStats);
+
+        char line[256];
+        snprintf(line, sizeof(line), "%-10s %8s %8s %8s %10s %6s", "pool", "used", "peak", "chunks", "allocs", "grows");
+        outLines.push_back(line);
+
+        for (const MemoryPoolStats& stats : poolStats)
+        {
+            snprintf(line, sizeof(line), "%-10s %8lu %8lu %8lu %10lu %6u",
+                stats.name.c_str(),
+                stats.numAllocs,
+                stats.allocPeak,
+                stats.totalChunks,
+                stats.totalAllocs,
+                stats.numGrows);
+            outLines.push_back(line);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef __POOL_ALLOCATOR_H__
+#define __POOL_ALLOCATOR_H__
+
+#include <stddef.h>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "MemoryPool.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// MemoryPoolMgr
+//
+// Process wide set of MemoryPools, one per size class. Small, frequently created objects (actors, components,
+// scene nodes, processes, shared_ptr control blocks) are served from these pools instead of the general heap.
+// Requests bigger than MAX_POOLED_SIZE fall back to ::operator new.
+//
+// All of these objects live on the game thread, so the pools do not lock by default. Creating the pools is thread
+// safe, using them from other threads is safe only after SetThreadSafe(true) - pipelined main loop turns it on while
+// its simulation thread runs (see PipelinedLoop.h).
+//
+// Pools are created lazily on first use and are intentionally never destroyed, so objects released during
+// static destruction are still returned to a valid pool.
+//---------------------------------------------------------------------------------------------------------------------
+namespace MemoryPoolMgr
+{
+    const size_t SIZE_CLASS_GRANULARITY = 16;
+    const size_t MAX_POOLED_SIZE = 512;
+    const unsigned int CHUNKS_PER_GROW = 64;
+
+    void* Alloc(size_t size);
+    // Size has to match the size passed to Alloc()
+    void Free(void* pMem, size_t size);
+
+    // Guards Alloc() and Free() of all pools, including the ones created later, with a lock. Has to be called while
+    // no other thread uses the pools
+    void SetThreadSafe(bool isThreadSafe);
+
+    // Stats of pools which were used at least once
+    void GetPoolStats(std::vector<MemoryPoolStats>& outStats);
+    // Human readable table, one line per pool
+    void DumpStats(std::vector<std::string>& outLines);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// PoolAllocator - standard allocator on top of MemoryPoolMgr. Meant to be used with std::allocate_shared so that
+// both the object and the shared_ptr control block come from the pools.
+//---------------------------------------------------------------------------------------------------------------------
+template <class T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template <class U>
+    struct rebind { typedef PoolAllocator<U> other; };
+
+    PoolAllocator() { }
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>&) { }
+
+    T* allocate(size_t count)
+    {
+        void* pMem = MemoryPoolMgr::Alloc(count * sizeof(T));
+        if (pMem == NULL)
+        {
+            throw std::bad_alloc();
+        }
+
+        return static_cast<T*>(pMem);
+    }
+
+    void deallocate(T* pMem, size_t count)
+    {
+        MemoryPoolMgr::Free(pMem, count * sizeof(T));
+    }
+};
+
+template <class T, class U>
+inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) { return true; }
+
+template <class T, class U>
+inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) { return false; }
+
+#endif // __POOL_ALLOCATOR_H__
@@ -21,6 +21,7 @@
 
 #include <assert.h>
 #include "PrimeSearch.h"
+#include "Util.h"
 #include <stdlib.h>
 
 
@@ -94,9 +95,9 @@ PrimeSearch::PrimeSearch(int elements)
 
     maxElements = elements;
 
-    int a = (rand() % 13) + 1;
-    int b = (rand() % 7) + 1;
-    int c = (rand() % 5) + 1;
+    int a = Util::GetRandomNumber(1, 13);
+    int b = Util::GetRandomNumber(1, 7);
+    int c = Util::GetRandomNumber(1, 5);
 
     skip = (a * maxElements * maxElements) + (b * maxElements) + c;
     skip &= ~0xc0000000;        // this keeps skip from becoming too large....
@@ -44,7 +44,14 @@ MEMORY_PROFILER::MEMORY_PROFILER(std::string tag)
     GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
     m_StartingMemory = pmc.WorkingSetSize;
 #else
-    LOG_ERROR("Memory profiler not supported on this platform !");
+    if (AllocationTracker::IsEnabled())
+    {
+        m_StartingMemory = AllocationTracker::GetTotalStats().liveBytes;
+    }
+    else
+    {
+        LOG_ERROR("Memory profiler needs ALLOCATION_TRACKING on this platform !");
+    }
 #endif
 }
 
@@ -54,18 +61,25 @@ MEMORY_PROFILER::~MEMORY_PROFILER()
     PROCESS_MEMORY_COUNTERS pmc;
     GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
     SIZE_T currentMemory = pmc.WorkingSetSize;
+#else
+    if (!AllocationTracker::IsEnabled())
+    {
+        return;
+    }
 
-    int32_t memoryDiff = currentMemory - m_StartingMemory;
+    int64_t currentMemory = AllocationTracker::GetTotalStats().liveBytes;
+#endif
+
+    int64_t memoryDiff = (int64_t)currentMemory - m_StartingMemory;
 
     if (!m_Tag.empty())
     {
-        std::string s("[" + m_Tag + "]: Memory difference: " + ToStr(memoryDiff));
+        std::string s("[" + m_Tag + "]: Memory difference: " + std::to_string((long long)memoryDiff));
         std::cout << s << std::endl;
     }
     else
     {
-        std::string s("Memory difference: " + ToStr(memoryDiff));
+        std::string s("Memory difference: " + std::to_string((long long)memoryDiff));
         std::cout << s << std::endl;
     }
-#endif
 }
\ No newline at end of file
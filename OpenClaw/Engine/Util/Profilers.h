@@ -23,7 +23,7 @@ public:
 
 private:
     std::string m_Tag;
-    int32_t m_StartingMemory;
+    int64_t m_StartingMemory;
 };
 
 #endif
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include "../Events/Events.h"
 
 #include "../GameApp/BaseGameApp.h"
+#include "../Graphics2D/RenderCommands.h"
 
 #include "../Resource/Loaders/WavLoader.h"
 
@@ -384,15 +385,65 @@ namespace Util
         }*/
     }
 
-    int GetRandomNumber(int fromRange, int toRange)
+    static std::mt19937& GetSessionRng()
     {
         static std::random_device rd;
-        std::mt19937 rng(rd());
+        static std::mt19937 rng(rd());
+        return rng;
+    }
+
+    int GetRandomNumber(int fromRange, int toRange)
+    {
+        std::uniform_int_distribution<int> uni(fromRange, toRange);
+
+        return uni(GetSessionRng());
+    }
+
+    void SetRandomSeed(uint32_t seed)
+    {
+        GetSessionRng().seed(seed);
+    }
+
+    int GetSeededRandomNumber(uint32_t seed, int fromRange, int toRange)
+    {
+        std::mt19937 rng(seed);
         std::uniform_int_distribution<int> uni(fromRange, toRange);
 
         return uni(rng);
     }
 
+    static bool s_IsClockSimulated = false;
+    static bool s_WereTicksRead = false;
+    static uint32_t s_SimulatedTicks = 0;
+
+    uint32_t GetTicks()
+    {
+        if (s_IsClockSimulated)
+        {
+            return s_SimulatedTicks;
+        }
+
+        s_WereTicksRead = true;
+        return SDL_GetTicks();
+    }
+
+    void EnableSimulatedClock()
+    {
+        // Same start in every run, real time would depend on how long the startup took
+        if (s_WereTicksRead)
+        {
+            LOG_WARNING("Simulated clock enabled after real time was read, runs may not be deterministic");
+        }
+
+        s_SimulatedTicks = 0;
+        s_IsClockSimulated = true;
+    }
+
+    void AdvanceSimulatedClock(uint32_t ms)
+    {
+        s_SimulatedTicks += ms;
+    }
+
     bool RollDice(int chanceToSucceed)
     {
         return (GetRandomNumber(0, 100) < chanceToSucceed);
@@ -518,8 +569,12 @@ namespace Util
     SDL_Texture* CreateSDLTextureFromRenderer(int rendererWidth, int rendererHeight, SDL_Renderer* pRenderer)
     {
         SDL_Surface* pSurface = CreateRGBSurface(0, rendererWidth, rendererHeight, 32);
-        SDL_RenderReadPixels(pRenderer, NULL, SDL_PIXELFORMAT_ARGB8888, pSurface->pixels, pSurface->pitch);
-        SDL_Texture* pTextureRect = SDL_CreateTextureFromSurface(pRenderer, pSurface);
+        SDL_Texture* pTextureRect = NULL;
+        RenderCommands::RunOnRenderThread([&]()
+        {
+            SDL_RenderReadPixels(pRenderer, NULL, SDL_PIXELFORMAT_ARGB8888, pSurface->pixels, pSurface->pitch);
+            pTextureRect = SDL_CreateTextureFromSurface(pRenderer, pSurface);
+        });
 
         SDL_FreeSurface(pSurface);
         return pTextureRect;
@@ -529,7 +584,7 @@ namespace Util
     {
         SDL_Surface* pSurface = SDL_CreateRGBSurface(0, width, height, 32, 0, 0, 0, 0);
         SDL_FillRect(pSurface, NULL, SDL_MapRGB(pSurface->format, color.r, color.g, color.b));
-        SDL_Texture* pTextureRect = SDL_CreateTextureFromSurface(pRenderer, pSurface);
+        SDL_Texture* pTextureRect = RenderCommands::CreateTextureFromSurface(pRenderer, pSurface);
 
         SDL_FreeSurface(pSurface);
         return pTextureRect;
@@ -539,7 +594,7 @@ namespace Util
     {
         SDL_Surface* pSurface = CreateRGBSurface(0, width, height, 32);
         SDL_FillRect(pSurface, NULL, SDL_MapRGBA(pSurface->format, color.r, color.g, color.b, alpha));
-        SDL_Texture* pTextureRect = SDL_CreateTextureFromSurface(pRenderer, pSurface);
+        SDL_Texture* pTextureRect = RenderCommands::CreateTextureFromSurface(pRenderer, pSurface);
 
         SDL_FreeSurface(pSurface);
 
@@ -547,7 +602,7 @@ namespace Util
     }
 
     void RenderForcePresent(SDL_Renderer* pRenderer) {
-        SDL_RenderPresent(pRenderer);
+        RenderCommands::Present(pRenderer);
 #ifdef __EMSCRIPTEN__
         // Update screen manually. SDL_RenderPresent does nothing.
         emscripten_sleep(0);
@@ -583,6 +638,18 @@ namespace Util
         return ~crcu32;
     }
 
+    uint64_t CalcFNV1a64(const void* pData, size_t dataLen, uint64_t hash)
+    {
+        const uint8* pBytes = (const uint8*)pData;
+        for (size_t byteIdx = 0; byteIdx < dataLen; byteIdx++)
+        {
+            hash ^= pBytes[byteIdx];
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
 #ifdef __EMSCRIPTEN__
     bool GetCanvasSize(SDL_Point &canvasSize) {
         int width = EM_ASM_INT(
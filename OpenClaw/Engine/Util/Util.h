@@ -23,8 +23,18 @@ namespace Util
 
     void PrintRect(SDL_Rect rect, std::string comment);
 
+    // Session RNG, seeded from random device unless SetRandomSeed is called (deterministic headless runs)
     int GetRandomNumber(int fromRange, int toRange);
     bool RollDice(int chanceToSucceed);
+    void SetRandomSeed(uint32_t seed);
+    // Does not touch session RNG, same seed always gives the same number
+    int GetSeededRandomNumber(uint32_t seed, int fromRange, int toRange);
+
+    // Milliseconds since start. SDL_GetTicks unless simulated clock is enabled, which then only moves
+    // when advanced explicitly. Simulated clock starts at 0, so it has to be enabled before anything reads the ticks
+    uint32_t GetTicks();
+    void EnableSimulatedClock();
+    void AdvanceSimulatedClock(uint32_t ms);
 
     std::string PlayRandomSoundFromList(const std::vector<std::string>& sounds, int volume = 100);
     void PlaySimpleSound(const std::string& sound, int volume = 100);
@@ -45,6 +55,8 @@ namespace Util
     void PlayRandomHitSound();
 
     uint32_t CalcCRC32(const char* pData, size_t dataLen);
+    // 64-bit FNV-1a, hash of previous data can be passed to continue hashing
+    uint64_t CalcFNV1a64(const void* pData, size_t dataLen, uint64_t hash = 14695981039346656037ULL);
 
     template<typename T>
     T GetRandomValueFromVector(const std::vector<T>& container)
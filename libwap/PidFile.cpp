@@ -7,7 +7,17 @@
 
 #include <iostream>
 using namespace std;
-WapPid* WAP_PidLoadFromData(char* data, size_t size, WapPal* palette)
+
+static inline void PutColor(WapPid* wapPid, uint32_t colorIdx, const WapPal* palette, uint8_t paletteIdx)
+{
+    wapPid->colors[colorIdx] = palette->colors[paletteIdx];
+    if (wapPid->colorIndices != NULL)
+    {
+        wapPid->colorIndices[colorIdx] = paletteIdx;
+    }
+}
+
+static WapPid* LoadPidFromData(char* data, size_t size, WapPal* palette, bool keepColorIndices)
 {
     uint32_t x, y;
     uint8_t byte;
@@ -63,6 +73,12 @@ WapPid* WAP_PidLoadFromData(char* data, size_t size, WapPal* palette)
     wapPid->colorsCount = wapPid->width * wapPid->height;
     wapPid->colors = new WAP_ColorRGBA[wapPid->colorsCount];
 
+    // Indices into embedded palette would be useless once the palette is destroyed
+    if (keepColorIndices && !(wapPid->flags & WAP_PID_FLAG_EMBEDDED_PALETTE))
+    {
+        wapPid->colorIndices = new uint8_t[wapPid->colorsCount];
+    }
+
     if (wapPid->colors == NULL)
     {
         delete wapPid;
@@ -85,6 +101,11 @@ WapPid* WAP_PidLoadFromData(char* data, size_t size, WapPal* palette)
                     while ((i > 0) && (y < wapPid->height))
                     {
                         wapPid->colors[y * wapPid->width + x] = WAP_ColorRGBA{ 0, 0, 0, 1 };
+                        if (wapPid->colorIndices != NULL)
+                        {
+                            // First color of the palette is the transparent one
+                            wapPid->colorIndices[y * wapPid->width + x] = 0;
+                        }
                         x++;
                         if (x == wapPid->width)
                         {
@@ -101,10 +122,7 @@ WapPid* WAP_PidLoadFromData(char* data, size_t size, WapPal* palette)
                     {
                         pidFileStream.read(byte);
 
-                        wapPid->colors[y * wapPid->width + x] = WAP_ColorRGBA{ imagePalette->colors[byte].r,
-                            imagePalette->colors[byte].g,
-                            imagePalette->colors[byte].b,
-                            imagePalette->colors[byte].a };
+                        PutColor(wapPid, y * wapPid->width + x, imagePalette, byte);
 
                         x++;
                         if (x == wapPid->width)
@@ -134,10 +152,7 @@ WapPid* WAP_PidLoadFromData(char* data, size_t size, WapPal* palette)
 
                 while ((i > 0) && (y < wapPid->height))
                 {
-                    wapPid->colors[y * wapPid->width + x] = WAP_ColorRGBA{ imagePalette->colors[byte].r,
-                        imagePalette->colors[byte].g,
-                        imagePalette->colors[byte].b,
-                        imagePalette->colors[byte].a };
+                    PutColor(wapPid, y * wapPid->width + x, imagePalette, byte);
 
                     x++;
                     if (x == wapPid->width)
@@ -172,6 +187,16 @@ WapPid* WAP_PidLoadFromData(char* data, size_t size, WapPal* palette)
     return wapPid;
 }
 
+WapPid* WAP_PidLoadFromData(char* data, size_t size, WapPal* palette)
+{
+    return LoadPidFromData(data, size, palette, false);
+}
+
+WapPid* WAP_PidLoadIndexedFromData(char* data, size_t size, WapPal* palette)
+{
+    return LoadPidFromData(data, size, palette, true);
+}
+
 WapPid* WAP_PidLoadFromFile(const char* pidFilePath, WapPal* palette)
 {
     std::ifstream pidFileStream(pidFilePath, std::ios::binary);
@@ -232,6 +257,7 @@ void WAP_PidDestroy(WapPid* wapPid)
     }
 
     delete[] wapPid->colors;
+    delete[] wapPid->colorIndices;
     delete wapPid;
     wapPid = NULL;  
 }
\ No newline at end of file
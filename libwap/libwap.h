@@ -697,6 +697,8 @@ typedef struct
 
     WAP_ColorRGBA* colors; 
     uint32_t colorsCount; //< Count of colors calculated as width*height
+
+    uint8_t* colorIndices; //< Palette index of each color, only kept when loaded indexed and without embedded palette
 } WapPid;
 
 /**
@@ -710,6 +712,17 @@ typedef struct
  */
 LIBWAP_API WapPid* WAP_PidLoadFromData(char* data, size_t size, WapPal* palette);
 
+/**
+ * @brief Loads PID file from given data buffer and keeps palette index of every color in colorIndices
+ * @note PIDs with embedded palette are loaded without color indices
+ *
+ * @param data PID data buffer
+ * @param size PID data length
+ * @param palette Color palette to be used when decoding PID image
+ * @return Pointer to PID file structure or NULL upon failure
+ */
+LIBWAP_API WapPid* WAP_PidLoadIndexedFromData(char* data, size_t size, WapPal* palette);
+
 /**
  * @brief Loads PID file (= 2D image format) from filesystem's file path
  * @note If PID has embedded palette, embedded palette always takes preference
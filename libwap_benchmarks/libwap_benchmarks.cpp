@@ -0,0 +1,1041 @@
+//---------------------------------------------------------------------------------------------------------------------
+// libwap_benchmarks
+//
+// Microbenchmarks of REZ archive access and of WAP format decoders. Each benchmark repeats a pass over its input set
+// until the minimal measuring time is reached and reports ns/op and MB/s of consumed input data.
+//
+// Synthetic archive with generated PID, ANI, WWD and XMI files is always benchmarked so no proprietary data is
+// needed. Its contents are generated from a fixed seed, results are therefore comparable between runs and machines.
+// If a real CLAW.REZ is found (current directory or --rez <path>), the same set of benchmarks is run over it too.
+//
+// Usage:
+//   libwap_benchmarks [--rez <path>] [--min-time <ms>] [--quick] [--json <file>] [--work-dir <dir>]
+//---------------------------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <libwap.h>
+#include <Miniz.h>
+
+struct BenchmarkOptions
+{
+    BenchmarkOptions()
+    {
+        rezFilePath = "CLAW.REZ";
+        minTimeMs = 500;
+        isQuick = false;
+        workDir = ".";
+    }
+
+    std::string rezFilePath;
+    uint32_t minTimeMs;
+    // Smaller synthetic archive and shorter measuring, used by ctest
+    bool isQuick;
+    std::string jsonFilePath;
+    std::string workDir;
+};
+
+struct BenchmarkResult
+{
+    std::string dataSet;
+    std::string name;
+    uint64_t ops;
+    uint64_t bytes;
+    double seconds;
+};
+
+// What one benchmark pass processed
+struct PassStats
+{
+    PassStats() : ops(0), bytes(0) { }
+
+    uint64_t ops;
+    uint64_t bytes;
+};
+
+static std::vector<BenchmarkResult> g_Results;
+
+//=====================================================================================================================
+// Measuring
+//=====================================================================================================================
+
+template<typename PassFunc>
+static void RunBenchmark(const BenchmarkOptions& options, const char* dataSet, const char* name, PassFunc pass)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Warm up caches and lazily loaded data
+    PassStats warmupStats = pass();
+    if (warmupStats.ops == 0)
+    {
+        printf("%-10s %-28s %14s\n", dataSet, name, "no data");
+        return;
+    }
+
+    BenchmarkResult result;
+    result.dataSet = dataSet;
+    result.name = name;
+    result.ops = 0;
+    result.bytes = 0;
+
+    Clock::time_point startTime = Clock::now();
+    Clock::duration minDuration = std::chrono::milliseconds(options.minTimeMs);
+    do
+    {
+        PassStats stats = pass();
+        result.ops += stats.ops;
+        result.bytes += stats.bytes;
+    } while (Clock::now() - startTime < minDuration);
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+    double nsPerOp = (result.seconds * 1e9) / result.ops;
+    double mbPerSec = (result.bytes / (1024.0 * 1024.0)) / result.seconds;
+    printf("%-10s %-28s %14.1f ns/op %10.2f MB/s %12llu ops\n",
+        dataSet, name, nsPerOp, mbPerSec, (unsigned long long)result.ops);
+
+    g_Results.push_back(result);
+}
+
+static bool WriteJsonReport(const std::string& filePath)
+{
+    FILE* pFile = fopen(filePath.c_str(), "w");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Failed to open %s for writing\n", filePath.c_str());
+        return false;
+    }
+
+    fprintf(pFile, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < g_Results.size(); i++)
+    {
+        const BenchmarkResult& result = g_Results[i];
+        fprintf(pFile, "    { \"dataSet\": \"%s\", \"name\": \"%s\", \"ops\": %llu, \"bytes\": %llu, "
+            "\"nsPerOp\": %.1f, \"mbPerSec\": %.2f }%s\n",
+            result.dataSet.c_str(),
+            result.name.c_str(),
+            (unsigned long long)result.ops,
+            (unsigned long long)result.bytes,
+            (result.seconds * 1e9) / result.ops,
+            (result.bytes / (1024.0 * 1024.0)) / result.seconds,
+            (i + 1 < g_Results.size()) ? "," : "");
+    }
+    fprintf(pFile, "  ]\n}\n");
+
+    fclose(pFile);
+    return true;
+}
+
+//=====================================================================================================================
+// Synthetic data generation
+//=====================================================================================================================
+
+// Deterministic, so generated archives are identical in every run
+class Random
+{
+public:
+    explicit Random(uint32_t seed) : m_State(seed) { }
+
+    uint32_t Next()
+    {
+        m_State = m_State * 1664525u + 1013904223u;
+        return m_State >> 8;
+    }
+
+    uint32_t Range(uint32_t minValue, uint32_t maxValue)
+    {
+        return minValue + Next() % (maxValue - minValue + 1);
+    }
+
+private:
+    uint32_t m_State;
+};
+
+class ByteWriter
+{
+public:
+    void U8(uint8_t value) { m_Data.push_back((char)value); }
+    void U16(uint16_t value) { U8(value & 0xFF); U8(value >> 8); }
+    void U32(uint32_t value) { U16(value & 0xFFFF); U16(value >> 16); }
+    void U16BE(uint16_t value) { U8(value >> 8); U8(value & 0xFF); }
+    void U32BE(uint32_t value) { U16BE(value >> 16); U16BE(value & 0xFFFF); }
+    void Bytes(const char* pData, size_t size) { m_Data.insert(m_Data.end(), pData, pData + size); }
+    void Str(const std::string& str) { Bytes(str.c_str(), str.length()); }
+    void CStr(const std::string& str) { Bytes(str.c_str(), str.length() + 1); }
+
+    // Fixed size, zero padded string field
+    void FixedStr(const std::string& str, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            U8(i < str.length() ? str[i] : 0);
+        }
+    }
+
+    void PatchU32(size_t offset, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            m_Data[offset + i] = (char)((value >> (i * 8)) & 0xFF);
+        }
+    }
+
+    void PatchU32BE(size_t offset, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            m_Data[offset + i] = (char)((value >> ((3 - i) * 8)) & 0xFF);
+        }
+    }
+
+    size_t Size() const { return m_Data.size(); }
+    std::vector<char>& Data() { return m_Data; }
+
+private:
+    std::vector<char> m_Data;
+};
+
+static std::vector<char> GeneratePalette(Random& random)
+{
+    std::vector<char> palette(WAP_PALETTE_SIZE_BYTES);
+    for (size_t i = 0; i < palette.size(); i++)
+    {
+        palette[i] = (char)random.Range(0, 255);
+    }
+
+    return palette;
+}
+
+// Mixture of transparent runs and literal pixel runs, like sprites in original data
+static std::vector<char> GeneratePid(Random& random, uint32_t width, uint32_t height, bool isCompressed)
+{
+    ByteWriter writer;
+    writer.U32(0);
+    writer.U32(WAP_PID_FLAG_TRANSPARENCY | (isCompressed ? WAP_PID_FLAG_COMPRESSION : 0));
+    writer.U32(width);
+    writer.U32(height);
+    writer.U32((uint32_t)-(int32_t)(width / 2));
+    writer.U32((uint32_t)-(int32_t)(height / 2));
+    writer.U32(0);
+    writer.U32(0);
+
+    uint32_t remainingPixels = width * height;
+    while (remainingPixels > 0)
+    {
+        if (isCompressed)
+        {
+            if (random.Range(0, 3) == 0)
+            {
+                uint32_t runLength = std::min(remainingPixels, random.Range(1, 127));
+                writer.U8((uint8_t)(128 + runLength));
+                remainingPixels -= runLength;
+            }
+            else
+            {
+                uint32_t runLength = std::min(remainingPixels, random.Range(1, 128));
+                writer.U8((uint8_t)runLength);
+                for (uint32_t i = 0; i < runLength; i++)
+                {
+                    writer.U8((uint8_t)random.Range(1, 255));
+                }
+                remainingPixels -= runLength;
+            }
+        }
+        else
+        {
+            if (random.Range(0, 3) == 0)
+            {
+                uint32_t runLength = std::min(remainingPixels, random.Range(2, 63));
+                writer.U8((uint8_t)(192 + runLength));
+                writer.U8((uint8_t)random.Range(0, 255));
+                remainingPixels -= runLength;
+            }
+            else
+            {
+                // Values above 192 would be treated as run length
+                writer.U8((uint8_t)random.Range(0, 192));
+                remainingPixels--;
+            }
+        }
+    }
+
+    return writer.Data();
+}
+
+static std::vector<char> GenerateAni(Random& random, uint32_t framesCount)
+{
+    const std::string imageSetPath = "CLAW_IMAGES_SYNTHETIC";
+
+    ByteWriter writer;
+    writer.U32(32);
+    writer.U32(0);
+    writer.U32(0);
+    writer.U32(framesCount);
+    writer.U32(imageSetPath.length());
+    writer.U32(0);
+    writer.U32(0);
+    writer.U32(0);
+    writer.Str(imageSetPath);
+
+    for (uint32_t frameIdx = 0; frameIdx < framesCount; frameIdx++)
+    {
+        bool hasEvent = random.Range(0, 4) == 0;
+        writer.U16(hasEvent ? 2 : 0);
+        writer.U16(0);
+        writer.U16(0);
+        writer.U16(0);
+        writer.U16((uint16_t)(frameIdx + 1));
+        writer.U16((uint16_t)random.Range(50, 250));
+        writer.U16(0);
+        writer.U16(0);
+        writer.U16(0);
+        writer.U8(0);
+        writer.U8(0);
+        if (hasEvent)
+        {
+            writer.CStr("GAME_SOUNDS_SYNTHETIC_" + std::to_string(frameIdx));
+        }
+    }
+
+    return writer.Data();
+}
+
+static void WriteRect(ByteWriter& writer, uint32_t left, uint32_t top, uint32_t right, uint32_t bottom)
+{
+    writer.U32(left);
+    writer.U32(top);
+    writer.U32(right);
+    writer.U32(bottom);
+}
+
+// WWD header followed by zlib compressed main block with planes, their tiles, image sets and objects
+// and tile descriptions
+static std::vector<char> GenerateWwd(Random& random, uint32_t tilesWidth, uint32_t tilesHeight, uint32_t objectsCount)
+{
+    const uint32_t HEADER_SIZE = 1524;
+    const uint32_t PLANE_PROPERTIES_SIZE = 160;
+    const uint32_t PLANES_COUNT = 3;
+    const uint32_t TILE_DESCRIPTIONS_COUNT = 64;
+
+    // Uncompressed main block, offsets inside it are relative to WWD file start
+    ByteWriter mainBlock;
+    mainBlock.Bytes(std::vector<char>(HEADER_SIZE).data(), HEADER_SIZE);
+
+    size_t planePropertiesOffset = mainBlock.Size();
+    for (uint32_t planeIdx = 0; planeIdx < PLANES_COUNT; planeIdx++)
+    {
+        mainBlock.Bytes(std::vector<char>(PLANE_PROPERTIES_SIZE).data(), PLANE_PROPERTIES_SIZE);
+    }
+
+    for (uint32_t planeIdx = 0; planeIdx < PLANES_COUNT; planeIdx++)
+    {
+        bool isActionPlane = planeIdx == 1;
+        uint32_t planeTilesWidth = isActionPlane ? tilesWidth : tilesWidth / 4;
+        uint32_t planeTilesHeight = isActionPlane ? tilesHeight : tilesHeight / 4;
+        uint32_t planeObjectsCount = isActionPlane ? objectsCount : 0;
+
+        uint32_t tilesOffset = mainBlock.Size();
+        for (uint32_t tileIdx = 0; tileIdx < planeTilesWidth * planeTilesHeight; tileIdx++)
+        {
+            mainBlock.U32(random.Range(0, 3) == 0 ? (uint32_t)-1 : random.Range(1, TILE_DESCRIPTIONS_COUNT - 1));
+        }
+
+        uint32_t imageSetsOffset = mainBlock.Size();
+        mainBlock.CStr("LEVEL_TILES_SYNTHETIC_" + std::to_string(planeIdx));
+
+        uint32_t objectsOffset = mainBlock.Size();
+        for (uint32_t objectIdx = 0; objectIdx < planeObjectsCount; objectIdx++)
+        {
+            const std::string name = "Object" + std::to_string(objectIdx);
+            const std::string logic = (objectIdx % 3 == 0) ? "TreasurePowerup" : "Officer";
+            const std::string imageSet = (objectIdx % 3 == 0) ? "GAME_TREASURE_COINS" : "LEVEL_OFFICER";
+            const std::string sound = "";
+
+            mainBlock.U32(objectIdx + 1);
+            mainBlock.U32(name.length());
+            mainBlock.U32(logic.length());
+            mainBlock.U32(imageSet.length());
+            mainBlock.U32(sound.length());
+            mainBlock.U32(random.Range(0, tilesWidth * 64));
+            mainBlock.U32(random.Range(0, tilesHeight * 64));
+            // z, i, add/dynamic/draw/user flags, score, points, powerup, damage, smarts, health
+            for (int i = 0; i < 12; i++)
+            {
+                mainBlock.U32(random.Range(0, 3));
+            }
+            // move, hit, attack, clip, user 1, user 2 rects
+            for (int i = 0; i < 6; i++)
+            {
+                WriteRect(mainBlock, 0, 0, random.Range(0, 1000), random.Range(0, 1000));
+            }
+            // user values 1-8, min/max, speed, tweak, counter, speed, width, height, direction, face dir,
+            // time delay, frame delay, object type, hit type flags, move resolution
+            for (int i = 0; i < 28; i++)
+            {
+                mainBlock.U32(random.Range(0, 100));
+            }
+            mainBlock.Str(name);
+            mainBlock.Str(logic);
+            mainBlock.Str(imageSet);
+            mainBlock.Str(sound);
+        }
+
+        ByteWriter properties;
+        properties.U32(PLANE_PROPERTIES_SIZE);
+        properties.U32(0);
+        properties.U32(isActionPlane ? 1 : 0);
+        properties.U32(0);
+        properties.FixedStr(isActionPlane ? "Action" : "Background", 64);
+        properties.U32(planeTilesWidth * 64);
+        properties.U32(planeTilesHeight * 64);
+        properties.U32(64);
+        properties.U32(64);
+        properties.U32(planeTilesWidth);
+        properties.U32(planeTilesHeight);
+        properties.U32(0);
+        properties.U32(0);
+        properties.U32(100);
+        properties.U32(100);
+        properties.U32(0);
+        properties.U32(1);
+        properties.U32(planeObjectsCount);
+        properties.U32(tilesOffset);
+        properties.U32(imageSetsOffset);
+        properties.U32(objectsOffset);
+        properties.U32(planeIdx * 1000);
+        properties.U32(0);
+        properties.U32(0);
+        properties.U32(0);
+
+        memcpy(mainBlock.Data().data() + planePropertiesOffset + planeIdx * PLANE_PROPERTIES_SIZE,
+            properties.Data().data(), PLANE_PROPERTIES_SIZE);
+    }
+
+    uint32_t tileDescriptionsOffset = mainBlock.Size();
+    mainBlock.U32(32);
+    mainBlock.U32(0);
+    mainBlock.U32(TILE_DESCRIPTIONS_COUNT);
+    for (int i = 0; i < 5; i++)
+    {
+        mainBlock.U32(0);
+    }
+    for (uint32_t descIdx = 0; descIdx < TILE_DESCRIPTIONS_COUNT; descIdx++)
+    {
+        bool isSingle = (descIdx % 4) != 0;
+        mainBlock.U32(isSingle ? WAP_TILE_TYPE_SINGLE : WAP_TILE_TYPE_DOUBLE);
+        mainBlock.U32(0);
+        mainBlock.U32(64);
+        mainBlock.U32(64);
+        if (isSingle)
+        {
+            mainBlock.U32(random.Range(0, 4));
+        }
+        else
+        {
+            mainBlock.U32(random.Range(0, 4));
+            mainBlock.U32(random.Range(0, 4));
+            WriteRect(mainBlock, 0, 0, 63, random.Range(0, 63));
+        }
+    }
+
+    uint32_t mainBlockLength = mainBlock.Size() - HEADER_SIZE;
+
+    mz_ulong compressedSize = mz_compressBound(mainBlockLength);
+    std::vector<char> compressedMainBlock(compressedSize);
+    mz_compress((unsigned char*)compressedMainBlock.data(), &compressedSize,
+        (const unsigned char*)mainBlock.Data().data() + HEADER_SIZE, mainBlockLength);
+
+    ByteWriter writer;
+    writer.U32(HEADER_SIZE);
+    writer.U32(0);
+    writer.U32(0);
+    writer.U32(0);
+    writer.FixedStr("Synthetic Level", 64);
+    writer.FixedStr("libwap_benchmarks", 64);
+    writer.FixedStr("", 64);
+    writer.FixedStr("SYNTHETIC.REZ", 256);
+    writer.FixedStr("\\LEVEL1\\TILES", 128);
+    writer.FixedStr("\\LEVEL1\\PALETTES\\MAIN.PAL", 128);
+    writer.U32(100);
+    writer.U32(100);
+    writer.U32(0);
+    writer.U32(PLANES_COUNT);
+    writer.U32(HEADER_SIZE);
+    writer.U32(tileDescriptionsOffset);
+    writer.U32(mainBlockLength);
+    // Checksum is not verified by libwap
+    writer.U32(0);
+    writer.U32(0);
+    writer.FixedStr("", 128);
+    for (int i = 0; i < 4; i++)
+    {
+        writer.FixedStr("\\LEVEL1\\IMAGES", 128);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        writer.FixedStr("LEVEL", 32);
+    }
+
+    writer.Bytes(compressedMainBlock.data(), compressedSize);
+
+    return writer.Data();
+}
+
+// XMIDI FORM with single event track. Notes carry their duration, delays are encoded as bytes below 0x80
+static std::vector<char> GenerateXmi(Random& random, uint32_t notesCount)
+{
+    ByteWriter events;
+    // Tempo
+    events.U8(0xFF);
+    events.U8(0x51);
+    events.U8(0x03);
+    events.U8(0x07);
+    events.U8(0xA1);
+    events.U8(0x20);
+    for (uint8_t channel = 0; channel < 4; channel++)
+    {
+        events.U8(0xC0 | channel);
+        events.U8((uint8_t)random.Range(0, 127));
+        events.U8(0xB0 | channel);
+        events.U8(7);
+        events.U8(100);
+    }
+    for (uint32_t noteIdx = 0; noteIdx < notesCount; noteIdx++)
+    {
+        uint32_t delay = random.Range(0, 3) == 0 ? 0 : random.Range(1, 200);
+        while (delay > 0)
+        {
+            uint32_t delayChunk = std::min(delay, 127u);
+            events.U8((uint8_t)delayChunk);
+            delay -= delayChunk;
+        }
+
+        events.U8(0x90 | (noteIdx % 4));
+        events.U8((uint8_t)random.Range(30, 90));
+        events.U8((uint8_t)random.Range(40, 127));
+        // Duration as variable length quantity
+        uint32_t duration = random.Range(10, 400);
+        if (duration >= 128)
+        {
+            events.U8(0x80 | (uint8_t)(duration >> 7));
+        }
+        events.U8(duration & 0x7F);
+    }
+    events.U8(0xFF);
+    events.U8(0x2F);
+    events.U8(0x00);
+
+    ByteWriter writer;
+    writer.Str("FORM");
+    writer.U32BE(14);
+    writer.Str("XDIRINFO");
+    writer.U32BE(2);
+    writer.U16(1);
+    writer.Str("CAT ");
+    size_t catSizeOffset = writer.Size();
+    writer.U32BE(0);
+    writer.Str("XMIDFORM");
+    size_t formSizeOffset = writer.Size();
+    writer.U32BE(0);
+    writer.Str("XMIDEVNT");
+    writer.U32BE(events.Size());
+    writer.Bytes(events.Data().data(), events.Size());
+
+    writer.PatchU32BE(formSizeOffset, writer.Size() - formSizeOffset - 4);
+    writer.PatchU32BE(catSizeOffset, writer.Size() - catSizeOffset - 4);
+
+    return writer.Data();
+}
+
+struct SyntheticFile
+{
+    std::string name;
+    std::string extension;
+    std::vector<char> data;
+    uint32_t offset;
+};
+
+struct SyntheticDirectory
+{
+    std::string name;
+    std::vector<SyntheticDirectory> directories;
+    std::vector<SyntheticFile> files;
+    uint32_t listingOffset;
+    uint32_t listingSize;
+};
+
+static void WriteRezFileData(ByteWriter& writer, SyntheticDirectory& directory)
+{
+    for (SyntheticFile& file : directory.files)
+    {
+        file.offset = writer.Size();
+        writer.Bytes(file.data.data(), file.data.size());
+    }
+    for (SyntheticDirectory& childDirectory : directory.directories)
+    {
+        WriteRezFileData(writer, childDirectory);
+    }
+}
+
+// Children listings are written first so their offsets are known when parent directory is written
+static void WriteRezDirectoryListing(ByteWriter& writer, SyntheticDirectory& directory, uint32_t& fileId)
+{
+    for (SyntheticDirectory& childDirectory : directory.directories)
+    {
+        WriteRezDirectoryListing(writer, childDirectory, fileId);
+    }
+
+    directory.listingOffset = writer.Size();
+    for (SyntheticDirectory& childDirectory : directory.directories)
+    {
+        writer.U32(1);
+        writer.U32(childDirectory.listingOffset);
+        writer.U32(childDirectory.listingSize);
+        writer.U32(0);
+        writer.CStr(childDirectory.name);
+    }
+    for (SyntheticFile& file : directory.files)
+    {
+        writer.U32(0);
+        writer.U32(file.offset);
+        writer.U32(file.data.size());
+        writer.U32(0);
+        writer.U32(fileId++);
+        // Extension is stored in reverse order
+        std::string reversedExtension(file.extension.rbegin(), file.extension.rend());
+        writer.FixedStr(reversedExtension, 4);
+        writer.U32(0);
+        writer.CStr(file.name);
+        writer.U8(0);
+    }
+    directory.listingSize = writer.Size() - directory.listingOffset;
+}
+
+static bool WriteRezArchive(const std::string& filePath, SyntheticDirectory& rootDirectory)
+{
+    const uint32_t HEADER_SIZE = 127;
+
+    ByteWriter writer;
+    writer.FixedStr("\r\nRez Data File\r\nSynthetic archive generated by libwap_benchmarks\r\n\x1A", HEADER_SIZE);
+    writer.U32(1);
+    // Root directory offset and size, patched below
+    writer.U32(0);
+    writer.U32(0);
+
+    WriteRezFileData(writer, rootDirectory);
+
+    uint32_t fileId = 0;
+    WriteRezDirectoryListing(writer, rootDirectory, fileId);
+    writer.PatchU32(HEADER_SIZE + 4, rootDirectory.listingOffset);
+    writer.PatchU32(HEADER_SIZE + 8, rootDirectory.listingSize);
+
+    std::ofstream file(filePath.c_str(), std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    file.write(writer.Data().data(), writer.Size());
+    return file.good();
+}
+
+// Layout resembles original CLAW.REZ: LEVELx/{IMAGES/<set>, ANIS, WORLDS, MUSIC, PALETTES}
+static SyntheticDirectory GenerateSyntheticArchive(bool isQuick)
+{
+    Random random(0xC1A3);
+
+    const uint32_t levelsCount = isQuick ? 2 : 14;
+    const uint32_t imageSetsCount = isQuick ? 8 : 40;
+    const uint32_t imagesPerSet = isQuick ? 6 : 12;
+    const uint32_t anisCount = isQuick ? 10 : 60;
+
+    SyntheticDirectory rootDirectory;
+    for (uint32_t levelIdx = 1; levelIdx <= levelsCount; levelIdx++)
+    {
+        SyntheticDirectory levelDirectory;
+        levelDirectory.name = "LEVEL" + std::to_string(levelIdx);
+
+        SyntheticDirectory imagesDirectory;
+        imagesDirectory.name = "IMAGES";
+        for (uint32_t setIdx = 0; setIdx < imageSetsCount; setIdx++)
+        {
+            SyntheticDirectory imageSetDirectory;
+            imageSetDirectory.name = "SET" + std::to_string(setIdx);
+            for (uint32_t imageIdx = 1; imageIdx <= imagesPerSet; imageIdx++)
+            {
+                SyntheticFile image;
+                char imageName[16];
+                snprintf(imageName, sizeof(imageName), "%03u", imageIdx);
+                image.name = imageName;
+                image.extension = "PID";
+                image.data = GeneratePid(random, random.Range(16, 160), random.Range(16, 160), (imageIdx % 4) != 0);
+                imageSetDirectory.files.push_back(image);
+            }
+            imagesDirectory.directories.push_back(imageSetDirectory);
+        }
+        levelDirectory.directories.push_back(imagesDirectory);
+
+        SyntheticDirectory anisDirectory;
+        anisDirectory.name = "ANIS";
+        for (uint32_t aniIdx = 0; aniIdx < anisCount; aniIdx++)
+        {
+            SyntheticFile ani;
+            ani.name = "ANIM" + std::to_string(aniIdx);
+            ani.extension = "ANI";
+            ani.data = GenerateAni(random, random.Range(2, 24));
+            anisDirectory.files.push_back(ani);
+        }
+        levelDirectory.directories.push_back(anisDirectory);
+
+        SyntheticDirectory worldsDirectory;
+        worldsDirectory.name = "WORLDS";
+        SyntheticFile world;
+        world.name = "WORLD";
+        world.extension = "WWD";
+        world.data = isQuick ? GenerateWwd(random, 200, 40, 300) : GenerateWwd(random, 800, 120, 1500);
+        worldsDirectory.files.push_back(world);
+        levelDirectory.directories.push_back(worldsDirectory);
+
+        SyntheticDirectory musicDirectory;
+        musicDirectory.name = "MUSIC";
+        SyntheticFile music;
+        music.name = "PLAY";
+        music.extension = "XMI";
+        music.data = GenerateXmi(random, isQuick ? 1000 : 6000);
+        musicDirectory.files.push_back(music);
+        levelDirectory.directories.push_back(musicDirectory);
+
+        SyntheticDirectory palettesDirectory;
+        palettesDirectory.name = "PALETTES";
+        SyntheticFile palette;
+        palette.name = "MAIN";
+        palette.extension = "PAL";
+        palette.data = GeneratePalette(random);
+        palettesDirectory.files.push_back(palette);
+        levelDirectory.directories.push_back(palettesDirectory);
+
+        rootDirectory.directories.push_back(levelDirectory);
+    }
+
+    return rootDirectory;
+}
+
+//=====================================================================================================================
+// Benchmarks
+//=====================================================================================================================
+
+static uint64_t GetDirectoryListingBytes(RezDirectory* pDirectory)
+{
+    uint64_t bytes = pDirectory->size;
+    if (pDirectory->directoryContents != NULL)
+    {
+        for (uint32_t i = 0; i < pDirectory->directoryContents->rezDirectoriesCount; i++)
+        {
+            bytes += GetDirectoryListingBytes(pDirectory->directoryContents->rezDirectories[i]);
+        }
+    }
+
+    return bytes;
+}
+
+static std::vector<RezFile*> GetFilesWithExtension(RezArchive* pArchive, const char* extension)
+{
+    std::vector<RezFile*> files;
+    uint32_t filesCount = WAP_GetRezFilesCount(pArchive);
+    for (uint32_t i = 0; i < filesCount; i++)
+    {
+        RezFile* pFile = WAP_GetRezFileFromFileIdx(pArchive, i);
+        if (extension == NULL || strcmp(pFile->extension, extension) == 0)
+        {
+            files.push_back(pFile);
+        }
+    }
+
+    return files;
+}
+
+// Decoders get their own copy of data so REZ data cache does not affect them
+static std::vector<std::vector<char>> LoadFilesData(const std::vector<RezFile*>& files)
+{
+    std::vector<std::vector<char>> filesData;
+    for (RezFile* pFile : files)
+    {
+        char* pData = WAP_GetRezFileData(pFile);
+        if (pData != NULL && pFile->size > 0)
+        {
+            filesData.push_back(std::vector<char>(pData, pData + pFile->size));
+        }
+        WAP_FreeFileData(pFile);
+    }
+
+    return filesData;
+}
+
+static bool RunArchiveBenchmarks(const BenchmarkOptions& options, const char* dataSet, const std::string& rezFilePath)
+{
+    RezArchive* pArchive = WAP_LoadRezArchive(rezFilePath.c_str());
+    if (pArchive == NULL)
+    {
+        fprintf(stderr, "Failed to load REZ archive: %s\n", rezFilePath.c_str());
+        return false;
+    }
+
+    const uint64_t listingBytes = GetDirectoryListingBytes(pArchive->rootDirectory);
+    const std::vector<RezFile*> allFiles = GetFilesWithExtension(pArchive, NULL);
+
+    printf("%s: %s, %u files\n", dataSet, rezFilePath.c_str(), (uint32_t)allFiles.size());
+
+    RunBenchmark(options, dataSet, "WAP_LoadRezArchive", [&]()
+    {
+        PassStats stats;
+        RezArchive* pLoadedArchive = WAP_LoadRezArchive(rezFilePath.c_str());
+        if (pLoadedArchive != NULL)
+        {
+            WAP_DestroyRezArchive(pLoadedArchive);
+            stats.ops = 1;
+            stats.bytes = listingBytes;
+        }
+        return stats;
+    });
+
+    std::vector<std::string> filePaths;
+    for (RezFile* pFile : allFiles)
+    {
+        filePaths.push_back(pFile->fullPathAndName);
+    }
+
+    RunBenchmark(options, dataSet, "WAP_GetRezFileFromRezArchive", [&]()
+    {
+        PassStats stats;
+        for (const std::string& filePath : filePaths)
+        {
+            if (WAP_GetRezFileFromRezArchive(pArchive, filePath.c_str()) != NULL)
+            {
+                stats.ops++;
+                stats.bytes += filePath.length();
+            }
+        }
+        return stats;
+    });
+
+    // Uncached reads - data of every file is freed right after it is read
+    RunBenchmark(options, dataSet, "WAP_GetRezFileData", [&]()
+    {
+        PassStats stats;
+        for (RezFile* pFile : allFiles)
+        {
+            if (WAP_GetRezFileData(pFile) != NULL)
+            {
+                stats.ops++;
+                stats.bytes += pFile->size;
+            }
+            WAP_FreeFileData(pFile);
+        }
+        return stats;
+    });
+
+    // Palette for PIDs without embedded one
+    WapPal* pPalette = NULL;
+    std::vector<RezFile*> paletteFiles = GetFilesWithExtension(pArchive, "pal");
+    for (size_t i = 0; i < paletteFiles.size() && pPalette == NULL; i++)
+    {
+        pPalette = WAP_PalLoadFromRezFile(paletteFiles[i]);
+    }
+    if (pPalette == NULL)
+    {
+        Random random(1);
+        std::vector<char> paletteData = GeneratePalette(random);
+        pPalette = WAP_PalLoadFromData(paletteData.data(), paletteData.size());
+    }
+
+    std::vector<std::vector<char>> pidsData = LoadFilesData(GetFilesWithExtension(pArchive, "pid"));
+    RunBenchmark(options, dataSet, "WAP_PidLoadFromData", [&]()
+    {
+        PassStats stats;
+        for (std::vector<char>& pidData : pidsData)
+        {
+            WapPid* pPid = WAP_PidLoadFromData(pidData.data(), pidData.size(), pPalette);
+            if (pPid != NULL)
+            {
+                stats.ops++;
+                stats.bytes += pidData.size();
+                WAP_PidDestroy(pPid);
+            }
+        }
+        return stats;
+    });
+
+    RunBenchmark(options, dataSet, "WAP_PidLoadIndexedFromData", [&]()
+    {
+        PassStats stats;
+        for (std::vector<char>& pidData : pidsData)
+        {
+            WapPid* pPid = WAP_PidLoadIndexedFromData(pidData.data(), pidData.size(), pPalette);
+            if (pPid != NULL)
+            {
+                stats.ops++;
+                stats.bytes += pidData.size();
+                WAP_PidDestroy(pPid);
+            }
+        }
+        return stats;
+    });
+
+    std::vector<std::vector<char>> anisData = LoadFilesData(GetFilesWithExtension(pArchive, "ani"));
+    RunBenchmark(options, dataSet, "WAP_AniLoadFromData", [&]()
+    {
+        PassStats stats;
+        for (std::vector<char>& aniData : anisData)
+        {
+            WapAni* pAni = WAP_AniLoadFromData(aniData.data(), aniData.size());
+            if (pAni != NULL)
+            {
+                stats.ops++;
+                stats.bytes += aniData.size();
+                WAP_AniDestroy(pAni);
+            }
+        }
+        return stats;
+    });
+
+    std::vector<std::vector<char>> wwdsData = LoadFilesData(GetFilesWithExtension(pArchive, "wwd"));
+    RunBenchmark(options, dataSet, "WAP_WwdLoadFromData", [&]()
+    {
+        PassStats stats;
+        for (std::vector<char>& wwdData : wwdsData)
+        {
+            WapWwd* pWwd = WAP_WwdLoadFromData(wwdData.data(), wwdData.size());
+            if (pWwd != NULL)
+            {
+                stats.ops++;
+                stats.bytes += wwdData.size();
+                WAP_WwdDestroy(pWwd);
+            }
+        }
+        return stats;
+    });
+
+    std::vector<std::vector<char>> xmisData = LoadFilesData(GetFilesWithExtension(pArchive, "xmi"));
+    RunBenchmark(options, dataSet, "WAP_XmiToMidiFromData", [&]()
+    {
+        PassStats stats;
+        for (std::vector<char>& xmiData : xmisData)
+        {
+            MidiFile* pMidi = WAP_XmiToMidiFromData(xmiData.data(), xmiData.size());
+            if (pMidi != NULL)
+            {
+                stats.ops++;
+                stats.bytes += xmiData.size();
+                WAP_MidiDestroy(pMidi);
+            }
+        }
+        return stats;
+    });
+
+    WAP_PalDestroy(pPalette);
+    WAP_DestroyRezArchive(pArchive);
+
+    return true;
+}
+
+static bool ParseCommandLine(int argc, char** argv, BenchmarkOptions& outOptions)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--rez" && hasValue)
+        {
+            outOptions.rezFilePath = argv[++i];
+        }
+        else if (arg == "--min-time" && hasValue)
+        {
+            outOptions.minTimeMs = (uint32_t)atoi(argv[++i]);
+        }
+        else if (arg == "--json" && hasValue)
+        {
+            outOptions.jsonFilePath = argv[++i];
+        }
+        else if (arg == "--work-dir" && hasValue)
+        {
+            outOptions.workDir = argv[++i];
+        }
+        else if (arg == "--quick")
+        {
+            outOptions.isQuick = true;
+            outOptions.minTimeMs = 50;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--rez <path>] [--min-time <ms>] [--quick] [--json <file>] [--work-dir <dir>]\n",
+                argv[0]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkOptions options;
+    if (!ParseCommandLine(argc, argv, options))
+    {
+        return 1;
+    }
+
+    bool isSuccess = true;
+
+    const std::string syntheticRezPath = options.workDir + "/libwap_benchmarks_synthetic.rez";
+    SyntheticDirectory syntheticRoot = GenerateSyntheticArchive(options.isQuick);
+    if (!WriteRezArchive(syntheticRezPath, syntheticRoot))
+    {
+        fprintf(stderr, "Failed to write synthetic REZ archive: %s\n", syntheticRezPath.c_str());
+        return 1;
+    }
+
+    isSuccess &= RunArchiveBenchmarks(options, "synthetic", syntheticRezPath);
+    remove(syntheticRezPath.c_str());
+
+    std::ifstream realRezFile(options.rezFilePath.c_str(), std::ios::binary);
+    if (realRezFile.is_open())
+    {
+        realRezFile.close();
+        isSuccess &= RunArchiveBenchmarks(options, "claw.rez", options.rezFilePath);
+    }
+    else
+    {
+        printf("%s not found, skipping benchmarks of original data\n", options.rezFilePath.c_str());
+    }
+
+    if (!options.jsonFilePath.empty())
+    {
+        isSuccess &= WriteJsonReport(options.jsonFilePath);
+    }
+
+    // Every decoder has to succeed on synthetic data, otherwise the generator or decoder is broken
+    for (const char* name : { "WAP_PidLoadFromData", "WAP_PidLoadIndexedFromData", "WAP_AniLoadFromData",
+        "WAP_WwdLoadFromData", "WAP_XmiToMidiFromData" })
+    {
+        bool hasResult = false;
+        for (const BenchmarkResult& result : g_Results)
+        {
+            hasResult |= result.dataSet == "synthetic" && result.name == name;
+        }
+        if (!hasResult)
+        {
+            fprintf(stderr, "%s failed to decode any synthetic file\n", name);
+            isSuccess = false;
+        }
+    }
+
+    return isSuccess ? 0 : 1;
+}
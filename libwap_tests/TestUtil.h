@@ -109,6 +109,33 @@ void ForEachRezFileInRezArchive(RezArchive* rezArchive, std::function<void(RezFi
     ForEachRezFileInRezDirectoryRecursive(rezArchive->rootDirectory, f);
 }
 
+// Builds 4x3 PID in memory, pixel data is either RLE compressed (with transparent runs) or uncompressed
+std::vector<char> CreateTestPid(bool isCompressed)
+{
+    std::vector<char> pidData;
+    uint32_t header[8] = { 0, WAP_PID_FLAG_TRANSPARENCY, 4, 3, 0, 0, 0, 0 };
+    if (isCompressed)
+    {
+        header[1] |= WAP_PID_FLAG_COMPRESSION;
+    }
+    pidData.insert(pidData.end(), (char*)header, (char*)header + sizeof(header));
+
+    if (isCompressed)
+    {
+        // 2 transparent, 3 literal, 1 transparent, 6 literal
+        const uint8_t pixels[] = { 0x82, 0x03, 0x05, 0x11, 0xFF, 0x81, 0x06, 0x01, 0x02, 0x40, 0x80, 0xC8, 0x00 };
+        pidData.insert(pidData.end(), (char*)pixels, (char*)pixels + sizeof(pixels));
+    }
+    else
+    {
+        // Run of 3 same pixels followed by 9 single pixels
+        const uint8_t pixels[] = { 0xC3, 0x07, 0x00, 0x10, 0x20, 0x40, 0x80, 0xC0, 0x03, 0x2A, 0x7F };
+        pidData.insert(pidData.end(), (char*)pixels, (char*)pixels + sizeof(pixels));
+    }
+
+    return pidData;
+}
+
 #define NOMINMAX
 #include <Windows.h>
 
@@ -647,4 +647,74 @@ TEST_CASE("----- PAL FILE -----")
 
         WAP_PalDestroy(wapPal);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("----- PID FILE -----")
+{
+    WapPal* wapPal = WAP_PalLoadFromData((char*)test_palette, 768);
+    REQUIRE(wapPal != NULL);
+
+    SECTION("[WAP_PidLoadFromData]: Loading PID from invalid data returns NULL")
+    {
+        WapPid* wapPid = WAP_PidLoadFromData(NULL, 0, wapPal);
+        REQUIRE(wapPid == NULL);
+    }
+
+    SECTION("[WAP_PidLoadIndexedFromData]: Loading PID from invalid data returns NULL")
+    {
+        WapPid* wapPid = WAP_PidLoadIndexedFromData(NULL, 0, wapPal);
+        REQUIRE(wapPid == NULL);
+    }
+
+    SECTION("[WAP_PidLoadFromData]: Loading PID without indices returns NULL colorIndices")
+    {
+        std::vector<char> pidData = CreateTestPid(true);
+
+        WapPid* wapPid = WAP_PidLoadFromData(pidData.data(), pidData.size(), wapPal);
+        REQUIRE(wapPid != NULL);
+        REQUIRE(wapPid->colorIndices == NULL);
+
+        WAP_PidDestroy(wapPid);
+    }
+
+    for (bool isCompressed : { true, false })
+    {
+        SECTION(std::string("[WAP_PidLoadIndexedFromData]: Indices mapped through palette equal RGBA colors, ") +
+            (isCompressed ? "compressed" : "uncompressed"))
+        {
+            std::vector<char> pidData = CreateTestPid(isCompressed);
+
+            WapPid* rgbaPid = WAP_PidLoadFromData(pidData.data(), pidData.size(), wapPal);
+            WapPid* indexedPid = WAP_PidLoadIndexedFromData(pidData.data(), pidData.size(), wapPal);
+            REQUIRE(rgbaPid != NULL);
+            REQUIRE(indexedPid != NULL);
+            REQUIRE(indexedPid->colorIndices != NULL);
+            REQUIRE(indexedPid->width == 4);
+            REQUIRE(indexedPid->height == 3);
+            REQUIRE(indexedPid->colorsCount == rgbaPid->colorsCount);
+
+            bool valid = true;
+            for (uint32_t i = 0; i < rgbaPid->colorsCount; i++)
+            {
+                const WAP_ColorRGBA& expected = rgbaPid->colors[i];
+                const WAP_ColorRGBA& mapped = wapPal->colors[indexedPid->colorIndices[i]];
+                if (mapped.r != expected.r ||
+                    mapped.g != expected.g ||
+                    mapped.b != expected.b ||
+                    mapped.a != expected.a ||
+                    memcmp(&indexedPid->colors[i], &expected, sizeof(WAP_ColorRGBA)) != 0)
+                {
+                    valid = false;
+                    break;
+                }
+            }
+
+            REQUIRE(valid == true);
+
+            WAP_PidDestroy(indexedPid);
+            WAP_PidDestroy(rgbaPid);
+        }
+    }
+
+    WAP_PalDestroy(wapPal);
+}